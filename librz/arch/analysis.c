@@ -9,6 +9,7 @@
 #include <rz_util/rz_path.h>
 #include <rz_arch.h>
 #include <rz_lib.h>
+#include "analysis_private.h"
 
 /**
  * \brief Returns the default size byte width of memory access operations.
@@ -161,6 +162,7 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 
 	rz_hash_free(a->hash);
 	rz_analysis_il_vm_cleanup(a);
+	rz_analysis_il_cache_free(a->il_cache);
 	rz_list_free(a->fcns);
 	ht_up_free(a->ht_addr_fun);
 	ht_sp_free(a->ht_name_fun);
@@ -175,8 +177,7 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	rz_platform_target_free(a->arch_target);
 	rz_platform_target_index_free(a->platform_target);
 	rz_reg_free(a->reg);
-	ht_up_free(a->ht_xrefs_from);
-	ht_up_free(a->ht_xrefs_to);
+	rz_analysis_xrefs_free(a->xrefs);
 	rz_list_free(a->leaddrs);
 	rz_type_db_free(a->typedb);
 	sdb_free(a->sdb);
@@ -228,6 +229,7 @@ RZ_API bool rz_analysis_use(RzAnalysis *analysis, const char *name) {
 		}
 		plugin_fini(analysis);
 		analysis->cur = h;
+		rz_analysis_il_cache_clear(analysis);
 		if (h->init && !h->init(&analysis->plugin_data)) {
 			RZ_LOG_ERROR("analysis plugin '%s' failed to initialize.\n", h->name);
 			rz_iterator_free(it);
@@ -337,6 +339,7 @@ RZ_API bool rz_analysis_set_bits(RzAnalysis *analysis, int bits) {
 		if (analysis->bits != bits) {
 			bool is_hack = is_arm_thumb_hack(analysis, bits);
 			analysis->bits = bits;
+			rz_analysis_il_cache_clear(analysis);
 			int v = rz_analysis_archinfo(analysis, RZ_ANALYSIS_ARCHINFO_TEXT_ALIGN);
 			analysis->pcalign = RZ_MAX(0, v);
 			rz_type_db_set_bits(analysis->typedb, bits);
@@ -374,6 +377,7 @@ RZ_API void rz_analysis_set_cpu(RzAnalysis *analysis, const char *cpu) {
 	}
 	free(analysis->cpu);
 	analysis->cpu = rz_str_dup(cpu);
+	rz_analysis_il_cache_clear(analysis);
 	int v = rz_analysis_archinfo(analysis, RZ_ANALYSIS_ARCHINFO_TEXT_ALIGN);
 	if (v != -1) {
 		analysis->pcalign = v;
@@ -391,6 +395,7 @@ RZ_API void rz_analysis_set_cpu(RzAnalysis *analysis, const char *cpu) {
 
 RZ_API int rz_analysis_set_big_endian(RzAnalysis *analysis, int bigend) {
 	analysis->big_endian = bigend;
+	rz_analysis_il_cache_clear(analysis);
 	if (analysis->reg) {
 		analysis->reg->big_endian = bigend;
 	}
@@ -6,4 +6,7 @@
 
 #include <rz_analysis.h>
 
+RZ_IPI void rz_analysis_xrefs_free(RZ_NULLABLE RzAnalysisXRefs *xrefs);
+RZ_IPI void rz_analysis_il_cache_free(RZ_NULLABLE RzAnalysisILCache *cache);
+
 #endif // RZ_ANALYSIS_PRIVATE_H
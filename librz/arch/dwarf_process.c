@@ -608,7 +608,7 @@ static char *die_name(const RzBinDwarfDie *die, DwContext *ctx) {
 	if (!spec_at) {
 		return NULL;
 	}
-	RzBinDwarfDie *spec = ht_up_find(ctx->dw->info->die_by_offset, rz_bin_dwarf_attr_udata(spec_at), NULL);
+	RzBinDwarfDie *spec = rz_bin_dwarf_die_at(ctx->dw, rz_bin_dwarf_attr_udata(spec_at));
 	if (!spec) {
 		return NULL;
 	}
@@ -628,9 +628,13 @@ static RzPVector /*<RzBinDwarfDie *>*/ *die_children(const RzBinDwarfDie *die, R
 	if (!unit) {
 		goto err;
 	}
+	RzVector /*<RzBinDwarfDie>*/ *dies = rz_bin_dwarf_unit_dies(dw, unit);
+	if (!dies) {
+		goto err;
+	}
 
-	for (size_t i = die->index + 1; i < rz_vector_len(&unit->dies); ++i) {
-		RzBinDwarfDie *child_die = rz_vector_index_ptr(&unit->dies, i);
+	for (size_t i = die->index + 1; i < rz_vector_len(dies); ++i) {
+		RzBinDwarfDie *child_die = rz_vector_index_ptr(dies, i);
 		if (child_die->depth >= die->depth + 1) {
 			rz_pvector_push(vec, child_die);
 		} else if (child_die->depth == die->depth) {
@@ -716,7 +720,7 @@ static RzBaseType *RzBaseType_from_die(DwContext *ctx, const RzBinDwarfDie *die)
 	rz_vector_foreach (&die->attrs, attr) {
 		switch (attr->at) {
 		case DW_AT_specification: {
-			RzBinDwarfDie *decl = ht_up_find(ctx->dw->info->die_by_offset, rz_bin_dwarf_attr_udata(attr), NULL);
+			RzBinDwarfDie *decl = rz_bin_dwarf_die_at(ctx->dw, rz_bin_dwarf_attr_udata(attr));
 			if (!decl) {
 				goto err;
 			}
@@ -884,7 +888,7 @@ static RZ_OWN RzType *type_parse_from_offset_internal(
 	}
 	rz_set_u_add(visited, offset);
 
-	RzBinDwarfDie *die = ht_up_find(ctx->dw->info->die_by_offset, offset, NULL);
+	RzBinDwarfDie *die = rz_bin_dwarf_die_at(ctx->dw, offset);
 	if (!die) {
 		return NULL;
 	}
@@ -1049,7 +1053,7 @@ static inline const char *select_name(const char *demangle_name, const char *lin
 }
 
 static RzType *type_parse_from_abstract_origin(DwContext *ctx, ut64 offset, char **name_out) {
-	RzBinDwarfDie *die = ht_up_find(ctx->dw->info->die_by_offset, offset, NULL);
+	RzBinDwarfDie *die = rz_bin_dwarf_die_at(ctx->dw, offset);
 	if (!die) {
 		return NULL;
 	}
@@ -1572,7 +1576,7 @@ static bool function_from_die(
 			break;
 		case DW_AT_specification: /* u64 to declaration DIE with more info */
 		{
-			RzBinDwarfDie *spec = ht_up_find(ctx->dw->info->die_by_offset, rz_bin_dwarf_attr_udata(attr), NULL);
+			RzBinDwarfDie *spec = rz_bin_dwarf_die_at(ctx->dw, rz_bin_dwarf_attr_udata(attr));
 			if (!spec) {
 				RZ_LOG_ERROR("DWARF cannot find specification DIE at 0x%" PFMT64x " f.offset=0x%" PFMT64x "\n",
 					rz_bin_dwarf_attr_udata(attr), die->offset);
@@ -1740,13 +1744,12 @@ static void die_parse(DwContext *ctx, RzBinDwarfDie *die) {
 
 static RzBinDwarfDie *die_next(RzBinDwarfDie *die, RzBinDWARF *dw) {
 	return (die->sibling > die->offset)
-		? ht_up_find(dw->info->die_by_offset, die->sibling, NULL)
+		? rz_bin_dwarf_die_at(dw, die->sibling)
 		: die + 1;
 }
 
-static RzBinDwarfDie *die_end(RzBinDwarfCompUnit *unit) {
-	RzVector *vec = &unit->dies;
-	return (RzBinDwarfDie *)((char *)vec->a + vec->elem_size * vec->len);
+static RzBinDwarfDie *die_end(RzVector /*<RzBinDwarfDie>*/ *dies) {
+	return (RzBinDwarfDie *)((char *)dies->a + dies->elem_size * dies->len);
 }
 
 /**
@@ -1769,19 +1772,42 @@ RZ_API void rz_analysis_dwarf_preprocess_info(
 		.str_escaped = ht_up_new(NULL, (HtUPFreeValue)String_free),
 		.unit = NULL,
 	};
-	RzBinDwarfCompUnit *unit;
-	rz_vector_foreach (&dw->info->units, unit) {
-		if (rz_vector_empty(&unit->dies)) {
-			continue;
-		}
-		ctx.unit = unit;
-		for (RzBinDwarfDie *die = rz_vector_head(&unit->dies);
-			die && die < die_end(unit);
-			die = die_next(die, dw)) {
+	// the units are decoded in parallel windows of a few units per thread,
+	// so that only the DIEs of one window are kept in memory at once.
+	size_t window_size = RZ_MAX(rz_th_max_threads(RZ_THREAD_N_CORES_ALL_AVAILABLE), 1) * 4;
+	RzPVector window;
+	rz_pvector_init(&window, NULL);
+	size_t units_count = rz_vector_len(&dw->info->units);
+	for (size_t start = 0; start < units_count; start += window_size) {
+		rz_pvector_clear(&window);
+		for (size_t i = start; i < units_count && i < start + window_size; i++) {
+			rz_pvector_push(&window, rz_vector_index_ptr(&dw->info->units, i));
+		}
+		rz_bin_dwarf_units_dies_load(dw, &window);
 
-			die_parse(&ctx, die);
+		void **it;
+		rz_pvector_foreach (&window, it) {
+			RzBinDwarfCompUnit *unit = *it;
+			RzVector /*<RzBinDwarfDie>*/ *dies = rz_bin_dwarf_unit_dies(dw, unit);
+			if (!dies || rz_vector_empty(dies)) {
+				continue;
+			}
+			ctx.unit = unit;
+			for (RzBinDwarfDie *die = rz_vector_head(dies);
+				die && die < die_end(dies);
+				die = die_next(die, dw)) {
+
+				die_parse(&ctx, die);
+			}
+			// the escaped strings are cached by attribute address,
+			// so they go together with the DIEs of the unit.
+			rz_bin_dwarf_unit_dies_release(dw->info, unit);
+			ht_up_free(ctx.str_escaped);
+			ctx.str_escaped = ht_up_new(NULL, (HtUPFreeValue)String_free);
 		}
 	}
+	rz_pvector_fini(&window);
+	rz_bin_dwarf_info_dies_release(dw->info);
 	ht_up_free(ctx.str_escaped);
 }
 
@@ -1971,7 +1997,7 @@ static bool RzBinDwarfLocation_as_RzAnalysisVarStorage(
 		break;
 	}
 	case RzBinDwarfLocationKind_ADDRESS: {
-		RzBinDwarfDie *die = ht_up_find(a->debug_info->dw->info->die_by_offset, dw_var->offset, NULL);
+		RzBinDwarfDie *die = rz_bin_dwarf_die_at(a->debug_info->dw, dw_var->offset);
 		if (!die) {
 			return false;
 		}
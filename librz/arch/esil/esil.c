@@ -34,13 +34,71 @@ static inline ut64 genmask(int bits) {
 		RZ_LOG_WARN(fmtstr, ##__VA_ARGS__); \
 	}
 
-static bool isnum(RzAnalysisEsil *esil, const char *str, ut64 *num) {
+typedef enum {
+	ESIL_WORD_PUSH,
+	ESIL_WORD_OP,
+	ESIL_WORD_ELSE,
+	ESIL_WORD_ENDIF,
+} EsilWordKind;
+
+typedef struct {
+	EsilWordKind kind;
+	bool is_if; ///< "?{", which is evaluated even while skipping
+	const char *str; ///< the word, pointing into EsilCompiled.buf
+	RzAnalysisEsilOp *op; ///< the operation for ESIL_WORD_OP
+	size_t next; ///< offset in the expression right after the word and its separator
+	int parm_type; ///< rz_analysis_esil_get_parm_type() of an ESIL_WORD_PUSH
+	ut64 num; ///< pre-parsed value of a number
+	RzRegItem *reg; ///< pre-resolved register, NULL if the word is not one
+	ut32 regs_gen; ///< RzReg.items_gen when reg was resolved
+} EsilWord;
+
+/**
+ * An expression split into words, with the operations already looked up
+ * and the pushed immediates and registers already parsed.
+ * Expressions that cannot be compiled are cached with no words, so that
+ * they go straight to the string parser next time.
+ */
+typedef struct {
+	char *buf; ///< copy of the expression with the separators replaced by 0
+	EsilWord *words;
+	ut32 count;
+	ut32 nops; ///< number of registered operations at compile time
+	const RzReg *regs; ///< registers the words were resolved against, NULL if not resolved
+	ut32 regs_gen; ///< RzReg.items_gen at resolution time
+} EsilCompiled;
+
+static int esil_reg_read(RzAnalysisEsil *esil, const char *regname, const EsilWord *w, ut64 *num, int *size);
+
+/**
+ * Pops the top of the stack, like rz_analysis_esil_pop(), and sets \p word
+ * to the compiled word that pushed it, if any. Its pre-parsed value and
+ * register can then be used instead of the string.
+ */
+static char *esil_pop_word(RzAnalysisEsil *esil, const EsilWord **word) {
+	*word = NULL;
+	if (esil->stackptr < 1) {
+		return NULL;
+	}
+	esil->stackptr--;
+	const EsilWord *w = esil->stack_words[esil->stackptr];
+	if (w && w->regs_gen == esil->analysis->reg->items_gen) {
+		*word = w;
+	}
+	return esil->stack[esil->stackptr];
+}
+
+static RzRegItem *esil_reg_get(RzAnalysisEsil *esil, const char *name, const EsilWord *w) {
+	return w ? w->reg : rz_reg_get(esil->analysis->reg, name, -1);
+}
+
+static bool isnum(RzAnalysisEsil *esil, const char *str, const EsilWord *w, ut64 *num) {
 	if (!esil || !str) {
 		return false;
 	}
 	if (IS_DIGIT(*str)) {
 		if (num) {
-			*num = rz_num_get(NULL, str);
+			*num = w ? w->num : rz_num_get(NULL, str);
 		}
 		return true;
 	}
@@ -50,14 +108,14 @@ static bool isnum(RzAnalysisEsil *esil, const char *str, ut64 *num) {
 	return false;
 }
 
-static bool ispackedreg(RzAnalysisEsil *esil, const char *str) {
-	RzRegItem *ri = rz_reg_get(esil->analysis->reg, str, -1);
+static bool ispackedreg(RzAnalysisEsil *esil, const char *str, const EsilWord *w) {
+	RzRegItem *ri = esil_reg_get(esil, str, w);
 	return ri ? ri->packed_size > 0 : false;
 }
 
-static bool isregornum(RzAnalysisEsil *esil, const char *str, ut64 *num) {
-	if (!rz_analysis_esil_reg_read(esil, str, num, NULL)) {
-		if (!isnum(esil, str, num)) {
+static bool isregornum(RzAnalysisEsil *esil, const char *str, const EsilWord *w, ut64 *num) {
+	if (!esil_reg_read(esil, str, w, num, NULL)) {
+		if (!isnum(esil, str, w, num)) {
 			return false;
 		}
 	}
@@ -66,9 +124,10 @@ static bool isregornum(RzAnalysisEsil *esil, const char *str, ut64 *num) {
 
 /* pop Register or Number */
 static bool popRN(RzAnalysisEsil *esil, ut64 *n) {
-	char *str = rz_analysis_esil_pop(esil);
+	const EsilWord *w;
+	char *str = esil_pop_word(esil, &w);
 	if (str) {
-		bool ret = isregornum(esil, str, n);
+		bool ret = isregornum(esil, str, w, n);
 		free(str);
 		return ret;
 	}
@@ -90,6 +149,11 @@ RZ_API RzAnalysisEsil *rz_analysis_esil_new(int stacksize, int iotrap, unsigned
 		free(esil);
 		return NULL;
 	}
+	if (!(esil->stack_words = RZ_NEWS0(const void *, stacksize))) {
+		free(esil->stack);
+		free(esil);
+		return NULL;
+	}
 	esil->verbose = false;
 	esil->stacksize = stacksize;
 	esil->parse_goto_count = RZ_ANALYSIS_ESIL_GOTO_LIMIT;
@@ -158,6 +222,8 @@ RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil) {
 	if (esil->analysis && esil == esil->analysis->esil) {
 		esil->analysis->esil = NULL;
 	}
+	ht_sp_free(esil->compiled);
+	esil->compiled = NULL;
 	ht_sp_free(esil->ops);
 	esil->ops = NULL;
 	rz_analysis_esil_interrupts_fini(esil);
@@ -166,6 +232,7 @@ RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil) {
 	esil->stats = NULL;
 	rz_analysis_esil_stack_free(esil);
 	free(esil->stack);
+	free(esil->stack_words);
 	if (esil->analysis && esil->analysis->cur && esil->analysis->cur->esil_fini) {
 		esil->analysis->cur->esil_fini(esil);
 	}
@@ -182,9 +249,9 @@ RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil) {
 	free(esil);
 }
 
-static ut8 esil_internal_sizeof_reg(RzAnalysisEsil *esil, const char *r) {
+static ut8 esil_internal_sizeof_reg(RzAnalysisEsil *esil, const char *r, const EsilWord *w) {
 	rz_return_val_if_fail(esil && esil->analysis && esil->analysis->reg && r, 0);
-	RzRegItem *ri = rz_reg_get(esil->analysis->reg, r, -1);
+	RzRegItem *ri = esil_reg_get(esil, r, w);
 	return ri ? ri->size : 0;
 }
 
@@ -317,8 +384,7 @@ RZ_API int rz_analysis_esil_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8
 	return ret;
 }
 
-static int internal_esil_reg_read(RzAnalysisEsil *esil, const char *regname, ut64 *num, int *size) {
-	RzRegItem *reg = rz_reg_get(esil->analysis->reg, regname, -1);
+static int reg_item_read(RzAnalysisEsil *esil, RzRegItem *reg, ut64 *num, int *size) {
 	if (reg) {
 		if (size) {
 			*size = reg->size;
@@ -331,21 +397,26 @@ static int internal_esil_reg_read(RzAnalysisEsil *esil, const char *regname, ut6
 	return false;
 }
 
+static int internal_esil_reg_read(RzAnalysisEsil *esil, const char *regname, ut64 *num, int *size) {
+	return reg_item_read(esil, rz_reg_get(esil->analysis->reg, regname, -1), num, size);
+}
+
+static int reg_item_write(RzAnalysisEsil *esil, RzRegItem *reg, ut64 num) {
+	if (reg) {
+		rz_reg_set_value(esil->analysis->reg, reg, num);
+		return true;
+	}
+	return false;
+}
+
 static int internal_esil_reg_write(RzAnalysisEsil *esil, const char *regname, ut64 num) {
 	if (esil && esil->analysis) {
-		RzRegItem *reg = rz_reg_get(esil->analysis->reg, regname, -1);
-		if (reg) {
-			rz_reg_set_value(esil->analysis->reg, reg, num);
-			return true;
-		}
+		return reg_item_write(esil, rz_reg_get(esil->analysis->reg, regname, -1), num);
 	}
 	return false;
 }
 
-static int internal_esil_reg_write_no_null(RzAnalysisEsil *esil, const char *regname, ut64 num) {
-	rz_return_val_if_fail(esil && esil->analysis && esil->analysis->reg, false);
-
-	RzRegItem *reg = rz_reg_get(esil->analysis->reg, regname, -1);
+static int reg_item_write_no_null(RzAnalysisEsil *esil, RzRegItem *reg, ut64 num) {
 	const char *pc = rz_reg_get_name(esil->analysis->reg, RZ_REG_NAME_PC);
 	const char *sp = rz_reg_get_name(esil->analysis->reg, RZ_REG_NAME_SP);
 	const char *bp = rz_reg_get_name(esil->analysis->reg, RZ_REG_NAME_BP);
@@ -369,34 +440,48 @@ static int internal_esil_reg_write_no_null(RzAnalysisEsil *esil, const char *reg
 	return false;
 }
 
+static int internal_esil_reg_write_no_null(RzAnalysisEsil *esil, const char *regname, ut64 num) {
+	rz_return_val_if_fail(esil && esil->analysis && esil->analysis->reg, false);
+	return reg_item_write_no_null(esil, rz_reg_get(esil->analysis->reg, regname, -1), num);
+}
+
 RZ_API bool rz_analysis_esil_pushnum(RzAnalysisEsil *esil, ut64 num) {
 	char str[64];
 	snprintf(str, sizeof(str) - 1, "0x%" PFMT64x, num);
 	return rz_analysis_esil_push(esil, str);
 }
 
-RZ_API bool rz_analysis_esil_push(RzAnalysisEsil *esil, const char *str) {
+/**
+ * Pushes \p str like rz_analysis_esil_push(), along with the compiled word \p w that pushed it, if any.
+ */
+static bool esil_push_word(RzAnalysisEsil *esil, const char *str, const EsilWord *w) {
 	if (!str || !esil || !*str || esil->stackptr > (esil->stacksize - 1)) {
 		return false;
 	}
+	esil->stack_words[esil->stackptr] = w;
 	esil->stack[esil->stackptr++] = rz_str_dup(str);
 	return true;
 }
 
+RZ_API bool rz_analysis_esil_push(RzAnalysisEsil *esil, const char *str) {
+	return esil_push_word(esil, str, NULL);
+}
+
 RZ_API char *rz_analysis_esil_pop(RzAnalysisEsil *esil) {
 	rz_return_val_if_fail(esil, NULL);
-	if (esil->stackptr < 1) {
-		return NULL;
-	}
-	return esil->stack[--esil->stackptr];
+	const EsilWord *w;
+	return esil_pop_word(esil, &w);
 }
 
-RZ_API int rz_analysis_esil_get_parm_type(RzAnalysisEsil *esil, const char *str) {
+static int esil_get_parm_type(RzAnalysisEsil *esil, const char *str, const EsilWord *w) {
 	int len, i;
 
 	if (!str || !(len = strlen(str))) {
 		return RZ_ANALYSIS_ESIL_PARM_INVALID;
 	}
+	if (w) {
+		return w->parm_type;
+	}
 	if (!strncmp(str, "0x", 2)) {
 		return RZ_ANALYSIS_ESIL_PARM_NUM;
 	}
@@ -416,23 +501,24 @@ not_a_number:
 	return RZ_ANALYSIS_ESIL_PARM_INVALID;
 }
 
-RZ_API int rz_analysis_esil_get_parm_size(RzAnalysisEsil *esil, const char *str, ut64 *num, int *size) {
-	if (!str || !*str) {
-		return false;
-	}
-	int parm_type = rz_analysis_esil_get_parm_type(esil, str);
-	if (!num || !esil) {
+RZ_API int rz_analysis_esil_get_parm_type(RzAnalysisEsil *esil, const char *str) {
+	return esil_get_parm_type(esil, str, NULL);
+}
+
+static int esil_get_parm_size(RzAnalysisEsil *esil, const char *str, const EsilWord *w, ut64 *num, int *size) {
+	if (!str || !*str || !num || !esil) {
 		return false;
 	}
+	int parm_type = esil_get_parm_type(esil, str, w);
 	switch (parm_type) {
 	case RZ_ANALYSIS_ESIL_PARM_NUM:
-		*num = rz_num_get(NULL, str);
+		*num = w ? w->num : rz_num_get(NULL, str);
 		if (size) {
 			*size = esil->analysis->bits;
 		}
 		return true;
 	case RZ_ANALYSIS_ESIL_PARM_REG:
-		if (!rz_analysis_esil_reg_read(esil, str, num, size)) {
+		if (!esil_reg_read(esil, str, w, num, size)) {
 			break;
 		}
 		return true;
@@ -444,31 +530,61 @@ RZ_API int rz_analysis_esil_get_parm_size(RzAnalysisEsil *esil, const char *str,
 	return false;
 }
 
+RZ_API int rz_analysis_esil_get_parm_size(RzAnalysisEsil *esil, const char *str, ut64 *num, int *size) {
+	return esil_get_parm_size(esil, str, NULL, num, size);
+}
+
+static int esil_get_parm(RzAnalysisEsil *esil, const char *str, const EsilWord *w, ut64 *num) {
+	return esil_get_parm_size(esil, str, w, num, NULL);
+}
+
 RZ_API int rz_analysis_esil_get_parm(RzAnalysisEsil *esil, const char *str, ut64 *num) {
-	return rz_analysis_esil_get_parm_size(esil, str, num, NULL);
+	return esil_get_parm(esil, str, NULL, num);
 }
 
-RZ_API int rz_analysis_esil_reg_write(RzAnalysisEsil *esil, const char *dst, ut64 num) {
+/**
+ * Same as rz_analysis_esil_reg_write(), but the default callbacks use the
+ * register of \p w instead of looking \p dst up.
+ */
+static int esil_reg_write(RzAnalysisEsil *esil, const char *dst, const EsilWord *w, ut64 num) {
 	int ret = 0;
 	if (esil && esil->cb.hook_reg_write) {
 		ret = esil->cb.hook_reg_write(esil, dst, &num);
 	}
 	if (!ret && esil && esil->cb.reg_write) {
-		ret = esil->cb.reg_write(esil, dst, num);
+		if (w && esil->cb.reg_write == internal_esil_reg_write) {
+			ret = reg_item_write(esil, w->reg, num);
+		} else if (w && esil->cb.reg_write == internal_esil_reg_write_no_null) {
+			ret = reg_item_write_no_null(esil, w->reg, num);
+		} else {
+			ret = esil->cb.reg_write(esil, dst, num);
+		}
 	}
 	return ret;
 }
 
-RZ_API int rz_analysis_esil_reg_read_nocallback(RzAnalysisEsil *esil, const char *regname, ut64 *num, int *size) {
+RZ_API int rz_analysis_esil_reg_write(RzAnalysisEsil *esil, const char *dst, ut64 num) {
+	return esil_reg_write(esil, dst, NULL, num);
+}
+
+static int esil_reg_read_nocallback(RzAnalysisEsil *esil, const char *regname, const EsilWord *w, ut64 *num, int *size) {
 	int ret;
 	void *old_hook_reg_read = (void *)esil->cb.hook_reg_read;
 	esil->cb.hook_reg_read = NULL;
-	ret = rz_analysis_esil_reg_read(esil, regname, num, size);
+	ret = esil_reg_read(esil, regname, w, num, size);
 	esil->cb.hook_reg_read = old_hook_reg_read;
 	return ret;
 }
 
-RZ_API int rz_analysis_esil_reg_read(RzAnalysisEsil *esil, const char *regname, ut64 *num, int *size) {
+RZ_API int rz_analysis_esil_reg_read_nocallback(RzAnalysisEsil *esil, const char *regname, ut64 *num, int *size) {
+	return esil_reg_read_nocallback(esil, regname, NULL, num, size);
+}
+
+/**
+ * Same as rz_analysis_esil_reg_read(), but the default callback uses the
+ * register of \p w instead of looking \p regname up.
+ */
+static int esil_reg_read(RzAnalysisEsil *esil, const char *regname, const EsilWord *w, ut64 *num, int *size) {
 	bool ret = false;
 	ut64 localnum; // XXX why is this necessary?
 	if (!esil || !regname) {
@@ -485,33 +601,43 @@ RZ_API int rz_analysis_esil_reg_read(RzAnalysisEsil *esil, const char *regname,
 		ret = esil->cb.hook_reg_read(esil, regname, num, size);
 	}
 	if (!ret && esil->cb.reg_read) {
-		ret = esil->cb.reg_read(esil, regname, num, size);
+		if (w && esil->cb.reg_read == internal_esil_reg_read) {
+			ret = reg_item_read(esil, w->reg, num, size);
+		} else {
+			ret = esil->cb.reg_read(esil, regname, num, size);
+		}
 	}
 	return ret;
 }
 
+RZ_API int rz_analysis_esil_reg_read(RzAnalysisEsil *esil, const char *regname, ut64 *num, int *size) {
+	return esil_reg_read(esil, regname, NULL, num, size);
+}
+
 RZ_API int rz_analysis_esil_signext(RzAnalysisEsil *esil, bool assign) {
 	bool ret = false;
 	ut64 src, dst;
 
-	char *p_src = rz_analysis_esil_pop(esil);
+	const EsilWord *p_src_w;
+	char *p_src = esil_pop_word(esil, &p_src_w);
 	if (!p_src) {
 		return false;
 	}
 
-	if (!rz_analysis_esil_get_parm(esil, p_src, &src)) {
+	if (!esil_get_parm(esil, p_src, p_src_w, &src)) {
 		ESIL_LOG("esil_of: empty stack\n");
 		free(p_src);
 		return false;
 	}
 
-	char *p_dst = rz_analysis_esil_pop(esil);
+	const EsilWord *p_dst_w;
+	char *p_dst = esil_pop_word(esil, &p_dst_w);
 	if (!p_dst) {
 		free(p_src);
 		return false;
 	}
 
-	if (!rz_analysis_esil_get_parm(esil, p_dst, &dst)) {
+	if (!esil_get_parm(esil, p_dst, p_dst_w, &dst)) {
 		ESIL_LOG("esil_of: empty stack\n");
 		free(p_dst);
 		free(p_src);
@@ -530,7 +656,7 @@ RZ_API int rz_analysis_esil_signext(RzAnalysisEsil *esil, bool assign) {
 
 	// dst = (dst & ((1U << src_bit) - 1)); // clear upper bits
 	if (assign) {
-		ret = rz_analysis_esil_reg_write(esil, p_src, ((src ^ m) - m));
+		ret = esil_reg_write(esil, p_src, p_src_w, ((src ^ m) - m));
 	} else {
 		ret = rz_analysis_esil_pushnum(esil, ((src ^ m) - m));
 	}
@@ -562,18 +688,19 @@ static bool esil_zf(RzAnalysisEsil *esil) {
 
 // checks if there was a carry from bit x (x,$c)
 static bool esil_cf(RzAnalysisEsil *esil) {
-	char *src = rz_analysis_esil_pop(esil);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
 
 	if (!src) {
 		return false;
 	}
 
-	if (rz_analysis_esil_get_parm_type(esil, src) != RZ_ANALYSIS_ESIL_PARM_NUM) {
+	if (esil_get_parm_type(esil, src, src_w) != RZ_ANALYSIS_ESIL_PARM_NUM) {
 		free(src);
 		return false;
 	}
 	ut64 bit;
-	rz_analysis_esil_get_parm(esil, src, &bit);
+	esil_get_parm(esil, src, src_w, &bit);
 	free(src);
 	// carry from bit <src>
 	// range of src goes from 0 to 63
@@ -585,18 +712,19 @@ static bool esil_cf(RzAnalysisEsil *esil) {
 
 // checks if there was a borrow from bit x (x,$b)
 static bool esil_bf(RzAnalysisEsil *esil) {
-	char *src = rz_analysis_esil_pop(esil);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
 
 	if (!src) {
 		return false;
 	}
 
-	if (rz_analysis_esil_get_parm_type(esil, src) != RZ_ANALYSIS_ESIL_PARM_NUM) {
+	if (esil_get_parm_type(esil, src, src_w) != RZ_ANALYSIS_ESIL_PARM_NUM) {
 		free(src);
 		return false;
 	}
 	ut64 bit;
-	rz_analysis_esil_get_parm(esil, src, &bit);
+	esil_get_parm(esil, src, src_w, &bit);
 	free(src);
 	// borrow from bit <src>
 	// range of src goes from 1 to 64
@@ -622,19 +750,20 @@ static bool esil_pf(RzAnalysisEsil *esil) {
 // checks overflow from bit x (x,$o)
 //	x,$o ===> x,$c,x-1,$c,^
 static bool esil_of(RzAnalysisEsil *esil) {
-	char *p_bit = rz_analysis_esil_pop(esil);
+	const EsilWord *p_bit_w;
+	char *p_bit = esil_pop_word(esil, &p_bit_w);
 
 	if (!p_bit) {
 		return false;
 	}
 
-	if (rz_analysis_esil_get_parm_type(esil, p_bit) != RZ_ANALYSIS_ESIL_PARM_NUM) {
+	if (esil_get_parm_type(esil, p_bit, p_bit_w) != RZ_ANALYSIS_ESIL_PARM_NUM) {
 		free(p_bit);
 		return false;
 	}
 	ut64 bit;
 
-	if (!rz_analysis_esil_get_parm(esil, p_bit, &bit)) {
+	if (!esil_get_parm(esil, p_bit, p_bit_w, &bit)) {
 		ESIL_LOG("esil_of: empty stack\n");
 		free(p_bit);
 		return false;
@@ -651,15 +780,16 @@ static bool esil_of(RzAnalysisEsil *esil) {
 static bool esil_sf(RzAnalysisEsil *esil) {
 	rz_return_val_if_fail(esil, false);
 
-	char *p_size = rz_analysis_esil_pop(esil);
+	const EsilWord *p_size_w;
+	char *p_size = esil_pop_word(esil, &p_size_w);
 	rz_return_val_if_fail(p_size, false);
 
-	if (rz_analysis_esil_get_parm_type(esil, p_size) != RZ_ANALYSIS_ESIL_PARM_NUM) {
+	if (esil_get_parm_type(esil, p_size, p_size_w) != RZ_ANALYSIS_ESIL_PARM_NUM) {
 		free(p_size);
 		return false;
 	}
 	ut64 size, num;
-	rz_analysis_esil_get_parm(esil, p_size, &size);
+	esil_get_parm(esil, p_size, p_size_w, &size);
 	free(p_size);
 
 	if (size > 63) {
@@ -700,18 +830,20 @@ static bool esil_address(RzAnalysisEsil *esil) {
 
 static bool esil_weak_eq(RzAnalysisEsil *esil) {
 	rz_return_val_if_fail(esil && esil->analysis, false);
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
 
-	if (!(dst && src && (rz_analysis_esil_get_parm_type(esil, dst) == RZ_ANALYSIS_ESIL_PARM_REG))) {
+	if (!(dst && src && (esil_get_parm_type(esil, dst, dst_w) == RZ_ANALYSIS_ESIL_PARM_REG))) {
 		free(dst);
 		free(src);
 		return false;
 	}
 
 	ut64 src_num;
-	if (rz_analysis_esil_get_parm(esil, src, &src_num)) {
-		(void)rz_analysis_esil_reg_write(esil, dst, src_num);
+	if (esil_get_parm(esil, src, src_w, &src_num)) {
+		(void)esil_reg_write(esil, dst, dst_w, src_num);
 		free(src);
 		free(dst);
 		return true;
@@ -725,18 +857,21 @@ static bool esil_weak_eq(RzAnalysisEsil *esil) {
 static bool esil_eq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
 	if (!src || !dst) {
 		ESIL_LOG("Missing elements in the esil stack for '=' at 0x%08" PFMT64x "\n", esil->address);
 		free(src);
 		free(dst);
 		return false;
 	}
-	if (ispackedreg(esil, dst)) {
-		char *src2 = rz_analysis_esil_pop(esil);
+	if (ispackedreg(esil, dst, dst_w)) {
+		const EsilWord *src2_w;
+		char *src2 = esil_pop_word(esil, &src2_w);
 		char *newreg = rz_str_newf("%sl", dst);
-		if (rz_analysis_esil_get_parm(esil, src2, &num2)) {
+		if (esil_get_parm(esil, src2, src2_w, &num2)) {
 			ret = rz_analysis_esil_reg_write(esil, newreg, num2);
 		}
 		free(newreg);
@@ -744,12 +879,12 @@ static bool esil_eq(RzAnalysisEsil *esil) {
 		goto beach;
 	}
 
-	if (src && dst && rz_analysis_esil_reg_read_nocallback(esil, dst, &num, NULL)) {
-		if (rz_analysis_esil_get_parm(esil, src, &num2)) {
-			ret = rz_analysis_esil_reg_write(esil, dst, num2);
+	if (src && dst && esil_reg_read_nocallback(esil, dst, dst_w, &num, NULL)) {
+		if (esil_get_parm(esil, src, src_w, &num2)) {
+			ret = esil_reg_write(esil, dst, dst_w, num2);
 			esil->cur = num2;
 			esil->old = num;
-			esil->lastsz = esil_internal_sizeof_reg(esil, dst);
+			esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
 		} else {
 			ESIL_LOG("esil_eq: invalid src\n");
 		}
@@ -765,14 +900,15 @@ beach:
 
 static bool esil_neg(RzAnalysisEsil *esil) {
 	bool ret = false;
-	char *src = rz_analysis_esil_pop(esil);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
 	if (src) {
 		ut64 num;
-		if (rz_analysis_esil_get_parm(esil, src, &num)) {
+		if (esil_get_parm(esil, src, src_w, &num)) {
 			rz_analysis_esil_pushnum(esil, !num);
 			ret = true;
 		} else {
-			if (isregornum(esil, src, &num)) {
+			if (isregornum(esil, src, src_w, &num)) {
 				ret = true;
 				rz_analysis_esil_pushnum(esil, !num);
 			} else {
@@ -789,10 +925,11 @@ static bool esil_neg(RzAnalysisEsil *esil) {
 static bool esil_negeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num;
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_reg_read(esil, src, &num, NULL)) {
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_reg_read(esil, src, src_w, &num, NULL)) {
 		num = !num;
-		rz_analysis_esil_reg_write(esil, src, num);
+		esil_reg_write(esil, src, src_w, num);
 		ret = true;
 	} else {
 		ESIL_LOG("esil_negeq: empty stack\n");
@@ -809,14 +946,16 @@ static bool esil_nop(RzAnalysisEsil *esil) {
 static bool esil_andeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_reg_read(esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_reg_read(esil, dst, dst_w, &num, NULL)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			esil->old = num;
 			esil->cur = num & num2;
-			esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			rz_analysis_esil_reg_write(esil, dst, num & num2);
+			esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			esil_reg_write(esil, dst, dst_w, num & num2);
 			ret = true;
 		} else {
 			ESIL_LOG("esil_andeq: empty stack\n");
@@ -830,14 +969,16 @@ static bool esil_andeq(RzAnalysisEsil *esil) {
 static bool esil_oreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_reg_read(esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_reg_read(esil, dst, dst_w, &num, NULL)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			esil->old = num;
 			esil->cur = num | num2;
-			esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			ret = rz_analysis_esil_reg_write(esil, dst, num | num2);
+			esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			ret = esil_reg_write(esil, dst, dst_w, num | num2);
 		} else {
 			ESIL_LOG("esil_ordeq: empty stack\n");
 		}
@@ -850,14 +991,16 @@ static bool esil_oreq(RzAnalysisEsil *esil) {
 static bool esil_xoreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_reg_read(esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_reg_read(esil, dst, dst_w, &num, NULL)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			esil->old = num;
 			esil->cur = num ^ num2;
-			esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			ret = rz_analysis_esil_reg_write(esil, dst, num ^ num2);
+			esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			ret = esil_reg_write(esil, dst, dst_w, num ^ num2);
 		} else {
 			ESIL_LOG("esil_xoreq: empty stack\n");
 		}
@@ -902,17 +1045,19 @@ static bool esil_interrupt(RzAnalysisEsil *esil) {
 static bool esil_cmp(RzAnalysisEsil *esil) {
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get(esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			} else if (rz_reg_get(esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, src);
+			if (esil_reg_get(esil, dst, dst_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			} else if (esil_reg_get(esil, src, src_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, src, src_w);
 			} else {
 				// default size is set to 64 as internally operands are ut64
 				esil->lastsz = 64;
@@ -951,8 +1096,9 @@ static bool esil_if(RzAnalysisEsil *esil) {
 		esil->skip++;
 		return true;
 	}
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &num)) {
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &num)) {
 		// condition not matching, skipping until
 		if (!num) {
 			esil->skip++;
@@ -966,10 +1112,12 @@ static bool esil_if(RzAnalysisEsil *esil) {
 static bool esil_lsl(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			if (num2 > sizeof(ut64) * 8) {
 				ESIL_LOG("esil_lsl: shift is too big\n");
 			} else {
@@ -992,10 +1140,12 @@ static bool esil_lsl(RzAnalysisEsil *esil) {
 static bool esil_lsleq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_reg_read(esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_reg_read(esil, dst, dst_w, &num, NULL)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			if (num2 > sizeof(ut64) * 8) {
 				ESIL_LOG("esil_lsleq: shift is too big\n");
 			} else {
@@ -1006,8 +1156,8 @@ static bool esil_lsleq(RzAnalysisEsil *esil) {
 					num <<= num2;
 				}
 				esil->cur = num;
-				esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-				rz_analysis_esil_reg_write(esil, dst, num);
+				esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+				esil_reg_write(esil, dst, dst_w, num);
 				ret = true;
 			}
 		} else {
@@ -1022,10 +1172,12 @@ static bool esil_lsleq(RzAnalysisEsil *esil) {
 static bool esil_lsr(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			ut64 res = num >> RZ_MIN(num2, 63);
 			rz_analysis_esil_pushnum(esil, res);
 			ret = true;
@@ -1041,10 +1193,12 @@ static bool esil_lsr(RzAnalysisEsil *esil) {
 static bool esil_lsreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_reg_read(esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_reg_read(esil, dst, dst_w, &num, NULL)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			if (num2 > 63) {
 				ESIL_LOG("Invalid shift at 0x%08" PFMT64x "\n", esil->address);
 				num2 = 63;
@@ -1052,8 +1206,8 @@ static bool esil_lsreq(RzAnalysisEsil *esil) {
 			esil->old = num;
 			num >>= num2;
 			esil->cur = num;
-			esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			rz_analysis_esil_reg_write(esil, dst, num);
+			esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			esil_reg_write(esil, dst, dst_w, num);
 			ret = true;
 		} else {
 			ESIL_LOG("esil_lsreq: empty stack\n");
@@ -1068,10 +1222,12 @@ static bool esil_asreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	int regsize = 0;
 	ut64 op_num, param_num;
-	char *op = rz_analysis_esil_pop(esil);
-	char *param = rz_analysis_esil_pop(esil);
-	if (op && rz_analysis_esil_get_parm_size(esil, op, &op_num, &regsize)) {
-		if (param && rz_analysis_esil_get_parm(esil, param, &param_num)) {
+	const EsilWord *op_w;
+	char *op = esil_pop_word(esil, &op_w);
+	const EsilWord *param_w;
+	char *param = esil_pop_word(esil, &param_w);
+	if (op && esil_get_parm_size(esil, op, op_w, &op_num, &regsize)) {
+		if (param && esil_get_parm(esil, param, param_w, &param_num)) {
 			ut64 mask = (regsize - 1);
 			param_num &= mask;
 			bool isNegative;
@@ -1119,8 +1275,8 @@ static bool esil_asreq(RzAnalysisEsil *esil) {
 			}
 			ut64 res = op_num;
 			esil->cur = res;
-			esil->lastsz = esil_internal_sizeof_reg(esil, op);
-			rz_analysis_esil_reg_write(esil, op, res);
+			esil->lastsz = esil_internal_sizeof_reg(esil, op, op_w);
+			esil_reg_write(esil, op, op_w, res);
 			// rz_analysis_esil_pushnum (esil, res);
 			ret = true;
 		} else {
@@ -1136,10 +1292,12 @@ static bool esil_asr(RzAnalysisEsil *esil) {
 	bool ret = false;
 	int regsize = 0;
 	ut64 op_num = 0, param_num = 0;
-	char *op = rz_analysis_esil_pop(esil);
-	char *param = rz_analysis_esil_pop(esil);
-	if (op && rz_analysis_esil_get_parm_size(esil, op, &op_num, &regsize)) {
-		if (param && rz_analysis_esil_get_parm(esil, param, &param_num)) {
+	const EsilWord *op_w;
+	char *op = esil_pop_word(esil, &op_w);
+	const EsilWord *param_w;
+	char *param = esil_pop_word(esil, &param_w);
+	if (op && esil_get_parm_size(esil, op, op_w, &op_num, &regsize)) {
+		if (param && esil_get_parm(esil, param, param_w, &param_num)) {
 			if (param_num > regsize - 1) {
 				// capstone bug?
 				ESIL_LOG("Invalid asr shift of %" PFMT64d " at 0x%" PFMT64x "\n", param_num, esil->address);
@@ -1181,10 +1339,12 @@ static bool esil_ror(RzAnalysisEsil *esil) {
 	bool ret = 0;
 	int regsize;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm_size(esil, dst, &num, &regsize)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm_size(esil, dst, dst_w, &num, &regsize)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			ut64 mask = (regsize - 1);
 			num2 &= mask;
 			ut64 res = (num >> num2) | (num << ((-(st64)num2) & mask));
@@ -1203,10 +1363,12 @@ static bool esil_rol(RzAnalysisEsil *esil) {
 	bool ret = 0;
 	int regsize;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm_size(esil, dst, &num, &regsize)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm_size(esil, dst, dst_w, &num, &regsize)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			ut64 mask = (regsize - 1);
 			num2 &= mask;
 			ut64 res = (num << num2) | (num >> ((-(st64)num2) & mask));
@@ -1224,10 +1386,12 @@ static bool esil_rol(RzAnalysisEsil *esil) {
 static bool esil_and(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			num &= num2;
 			rz_analysis_esil_pushnum(esil, num);
 			ret = true;
@@ -1243,10 +1407,12 @@ static bool esil_and(RzAnalysisEsil *esil) {
 static bool esil_xor(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			num ^= num2;
 			rz_analysis_esil_pushnum(esil, num);
 			ret = true;
@@ -1262,10 +1428,12 @@ static bool esil_xor(RzAnalysisEsil *esil) {
 static bool esil_or(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			num |= num2;
 			rz_analysis_esil_pushnum(esil, num);
 			ret = true;
@@ -1321,8 +1489,9 @@ static bool esil_todo(RzAnalysisEsil *esil) {
 
 static bool esil_goto(RzAnalysisEsil *esil) {
 	ut64 num = 0;
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && *src && rz_analysis_esil_get_parm(esil, src, &num)) {
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && *src && esil_get_parm(esil, src, src_w, &num)) {
 		esil->parse_goto = num;
 	}
 	free(src);
@@ -1330,10 +1499,12 @@ static bool esil_goto(RzAnalysisEsil *esil) {
 }
 
 static bool esil_repeat(RzAnalysisEsil *esil) {
-	char *dst = rz_analysis_esil_pop(esil); // destaintion of the goto
-	char *src = rz_analysis_esil_pop(esil); // value of the counter
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w); // destaintion of the goto
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w); // value of the counter
 	ut64 n, num = 0;
-	if (rz_analysis_esil_get_parm(esil, src, &n) && rz_analysis_esil_get_parm(esil, dst, &num)) {
+	if (esil_get_parm(esil, src, src_w, &n) && esil_get_parm(esil, dst, dst_w, &num)) {
 		if (n > 1) {
 			esil->parse_goto = num;
 			rz_analysis_esil_pushnum(esil, n - 1);
@@ -1353,10 +1524,12 @@ static bool esil_pop(RzAnalysisEsil *esil) {
 static bool esil_mod(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
-		if (dst && rz_analysis_esil_get_parm(esil, dst, &d)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
+		if (dst && esil_get_parm(esil, dst, dst_w, &d)) {
 			if (s == 0) {
 				ESIL_LOG("0x%08" PFMT64x " esil_mod: Division by zero!\n", esil->address);
 				esil->trap = RZ_ANALYSIS_TRAP_DIVBYZERO;
@@ -1377,10 +1550,12 @@ static bool esil_mod(RzAnalysisEsil *esil) {
 static bool esil_signed_mod(RzAnalysisEsil *esil) {
 	bool ret = false;
 	st64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, (ut64 *)&s)) {
-		if (dst && rz_analysis_esil_get_parm(esil, dst, (ut64 *)&d)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, (ut64 *)&s)) {
+		if (dst && esil_get_parm(esil, dst, dst_w, (ut64 *)&d)) {
 			if (ST64_DIV_OVFCHK(d, s)) {
 				ESIL_LOG("0x%08" PFMT64x " esil_mod: Division by zero!\n", esil->address);
 				esil->trap = RZ_ANALYSIS_TRAP_DIVBYZERO;
@@ -1401,15 +1576,17 @@ static bool esil_signed_mod(RzAnalysisEsil *esil) {
 static bool esil_modeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
-		if (dst && rz_analysis_esil_reg_read(esil, dst, &d, NULL)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
+		if (dst && esil_reg_read(esil, dst, dst_w, &d, NULL)) {
 			if (s) {
 				esil->old = d;
 				esil->cur = d % s;
-				esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-				rz_analysis_esil_reg_write(esil, dst, d % s);
+				esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+				esil_reg_write(esil, dst, dst_w, d % s);
 			} else {
 				ESIL_LOG("esil_modeq: Division by zero!\n");
 				esil->trap = RZ_ANALYSIS_TRAP_DIVBYZERO;
@@ -1430,10 +1607,12 @@ static bool esil_modeq(RzAnalysisEsil *esil) {
 static bool esil_div(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
-		if (dst && rz_analysis_esil_get_parm(esil, dst, &d)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
+		if (dst && esil_get_parm(esil, dst, dst_w, &d)) {
 			if (s == 0) {
 				ESIL_LOG("esil_div: Division by zero!\n");
 				esil->trap = RZ_ANALYSIS_TRAP_DIVBYZERO;
@@ -1454,10 +1633,12 @@ static bool esil_div(RzAnalysisEsil *esil) {
 static bool esil_signed_div(RzAnalysisEsil *esil) {
 	bool ret = false;
 	st64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, (ut64 *)&s)) {
-		if (dst && rz_analysis_esil_get_parm(esil, dst, (ut64 *)&d)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, (ut64 *)&s)) {
+		if (dst && esil_get_parm(esil, dst, dst_w, (ut64 *)&d)) {
 			if (ST64_DIV_OVFCHK(d, s)) {
 				ESIL_LOG("esil_div: Division by zero!\n");
 				esil->trap = RZ_ANALYSIS_TRAP_DIVBYZERO;
@@ -1478,15 +1659,17 @@ static bool esil_signed_div(RzAnalysisEsil *esil) {
 static bool esil_diveq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
-		if (dst && rz_analysis_esil_reg_read(esil, dst, &d, NULL)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
+		if (dst && esil_reg_read(esil, dst, dst_w, &d, NULL)) {
 			if (s) {
 				esil->old = d;
 				esil->cur = d / s;
-				esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-				rz_analysis_esil_reg_write(esil, dst, d / s);
+				esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+				esil_reg_write(esil, dst, dst_w, d / s);
 			} else {
 				// RZ_LOG_ERROR("0x%08"PFMT64x" esil_diveq: Division by zero!\n", esil->address);
 				esil->trap = RZ_ANALYSIS_TRAP_DIVBYZERO;
@@ -1507,10 +1690,12 @@ static bool esil_diveq(RzAnalysisEsil *esil) {
 static bool esil_mul(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
-		if (dst && rz_analysis_esil_get_parm(esil, dst, &d)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
+		if (dst && esil_get_parm(esil, dst, dst_w, &d)) {
 			rz_analysis_esil_pushnum(esil, d * s);
 			ret = true;
 		} else {
@@ -1527,14 +1712,16 @@ static bool esil_mul(RzAnalysisEsil *esil) {
 static bool esil_muleq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
-		if (dst && rz_analysis_esil_reg_read(esil, dst, &d, NULL)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
+		if (dst && esil_reg_read(esil, dst, dst_w, &d, NULL)) {
 			esil->old = d;
 			esil->cur = d * s;
-			esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			ret = rz_analysis_esil_reg_write(esil, dst, s * d);
+			esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			ret = esil_reg_write(esil, dst, dst_w, s * d);
 		} else {
 			ESIL_LOG("esil_muleq: empty stack\n");
 		}
@@ -1549,9 +1736,11 @@ static bool esil_muleq(RzAnalysisEsil *esil) {
 static bool esil_add(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if ((src && rz_analysis_esil_get_parm(esil, src, &s)) && (dst && rz_analysis_esil_get_parm(esil, dst, &d))) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if ((src && esil_get_parm(esil, src, src_w, &s)) && (dst && esil_get_parm(esil, dst, dst_w, &d))) {
 		rz_analysis_esil_pushnum(esil, s + d);
 		ret = true;
 	} else {
@@ -1565,14 +1754,16 @@ static bool esil_add(RzAnalysisEsil *esil) {
 static bool esil_addeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
-		if (dst && rz_analysis_esil_reg_read(esil, dst, &d, NULL)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
+		if (dst && esil_reg_read(esil, dst, dst_w, &d, NULL)) {
 			esil->old = d;
 			esil->cur = d + s;
-			esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			ret = rz_analysis_esil_reg_write(esil, dst, s + d);
+			esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			ret = esil_reg_write(esil, dst, dst_w, s + d);
 		}
 	} else {
 		ESIL_LOG("esil_addeq: invalid parameters\n");
@@ -1585,8 +1776,9 @@ static bool esil_addeq(RzAnalysisEsil *esil) {
 static bool esil_inc(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s;
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
 		s++;
 		ret = rz_analysis_esil_pushnum(esil, s);
 	} else {
@@ -1599,13 +1791,14 @@ static bool esil_inc(RzAnalysisEsil *esil) {
 static bool esil_inceq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 sd;
-	char *src_dst = rz_analysis_esil_pop(esil);
-	if (src_dst && (rz_analysis_esil_get_parm_type(esil, src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && rz_analysis_esil_get_parm(esil, src_dst, &sd)) {
+	const EsilWord *src_dst_w;
+	char *src_dst = esil_pop_word(esil, &src_dst_w);
+	if (src_dst && (esil_get_parm_type(esil, src_dst, src_dst_w) == RZ_ANALYSIS_ESIL_PARM_REG) && esil_get_parm(esil, src_dst, src_dst_w, &sd)) {
 		// inc rax
 		esil->old = sd++;
 		esil->cur = sd;
-		rz_analysis_esil_reg_write(esil, src_dst, sd);
-		esil->lastsz = esil_internal_sizeof_reg(esil, src_dst);
+		esil_reg_write(esil, src_dst, src_dst_w, sd);
+		esil->lastsz = esil_internal_sizeof_reg(esil, src_dst, src_dst_w);
 		ret = true;
 	} else {
 		ESIL_LOG("esil_inceq: invalid parameters\n");
@@ -1617,9 +1810,11 @@ static bool esil_inceq(RzAnalysisEsil *esil) {
 static bool esil_sub(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if ((src && rz_analysis_esil_get_parm(esil, src, &s)) && (dst && rz_analysis_esil_get_parm(esil, dst, &d))) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if ((src && esil_get_parm(esil, src, src_w, &s)) && (dst && esil_get_parm(esil, dst, dst_w, &d))) {
 		ret = rz_analysis_esil_pushnum(esil, d - s);
 	} else {
 		ESIL_LOG("esil_sub: invalid parameters\n");
@@ -1632,14 +1827,16 @@ static bool esil_sub(RzAnalysisEsil *esil) {
 static bool esil_subeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
-		if (dst && rz_analysis_esil_reg_read(esil, dst, &d, NULL)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
+		if (dst && esil_reg_read(esil, dst, dst_w, &d, NULL)) {
 			esil->old = d;
 			esil->cur = d - s;
-			esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			ret = rz_analysis_esil_reg_write(esil, dst, d - s);
+			esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			ret = esil_reg_write(esil, dst, dst_w, d - s);
 		}
 	} else {
 		ESIL_LOG("esil_subeq: invalid parameters\n");
@@ -1652,8 +1849,9 @@ static bool esil_subeq(RzAnalysisEsil *esil) {
 static bool esil_dec(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s;
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
 		s--;
 		ret = rz_analysis_esil_pushnum(esil, s);
 	} else {
@@ -1666,13 +1864,14 @@ static bool esil_dec(RzAnalysisEsil *esil) {
 static bool esil_deceq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 sd;
-	char *src_dst = rz_analysis_esil_pop(esil);
-	if (src_dst && (rz_analysis_esil_get_parm_type(esil, src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && rz_analysis_esil_get_parm(esil, src_dst, &sd)) {
+	const EsilWord *src_dst_w;
+	char *src_dst = esil_pop_word(esil, &src_dst_w);
+	if (src_dst && (esil_get_parm_type(esil, src_dst, src_dst_w) == RZ_ANALYSIS_ESIL_PARM_REG) && esil_get_parm(esil, src_dst, src_dst_w, &sd)) {
 		esil->old = sd;
 		sd--;
 		esil->cur = sd;
-		rz_analysis_esil_reg_write(esil, src_dst, sd);
-		esil->lastsz = esil_internal_sizeof_reg(esil, src_dst);
+		esil_reg_write(esil, src_dst, src_dst_w, sd);
+		esil->lastsz = esil_internal_sizeof_reg(esil, src_dst, src_dst_w);
 		ret = true;
 	} else {
 		ESIL_LOG("esil_deceq: invalid parameters\n");
@@ -1687,8 +1886,10 @@ static bool esil_poke_n(RzAnalysisEsil *esil, int bits) {
 	ut64 num, num2, addr;
 	ut8 b[8] = { 0 };
 	ut64 n;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
 	int bytes = RZ_MIN(sizeof(b), bits / 8);
 	if (bits % 8) {
 		free(src);
@@ -1697,11 +1898,12 @@ static bool esil_poke_n(RzAnalysisEsil *esil, int bits) {
 	}
 	bool ret = false;
 	char *src2 = NULL;
-	if (src && rz_analysis_esil_get_parm(esil, src, &num)) {
-		if (dst && rz_analysis_esil_get_parm(esil, dst, &addr)) {
+	const EsilWord *src2_w = NULL;
+	if (src && esil_get_parm(esil, src, src_w, &num)) {
+		if (dst && esil_get_parm(esil, dst, dst_w, &addr)) {
 			if (bits == 128) {
-				src2 = rz_analysis_esil_pop(esil);
-				if (src2 && rz_analysis_esil_get_parm(esil, src2, &num2)) {
+				src2 = esil_pop_word(esil, &src2_w);
+				if (src2 && esil_get_parm(esil, src2, src2_w, &num2)) {
 					rz_write_ble(b, num, esil->analysis->big_endian, 64);
 					rz_analysis_esil_mem_write(esil, addr, b, bytes);
 					rz_write_ble(b, num2, esil->analysis->big_endian, 64);
@@ -1767,27 +1969,30 @@ static bool esil_poke_some(RzAnalysisEsil *esil) {
 	bool ret = false;
 	int i, regsize;
 	ut64 ptr, regs = 0, tmp;
-	char *count, *dst = rz_analysis_esil_pop(esil);
+	const EsilWord *count_w = NULL;
+	const EsilWord *dst_w;
+	char *count, *dst = esil_pop_word(esil, &dst_w);
 
-	if (dst && rz_analysis_esil_get_parm_size(esil, dst, &tmp, &regsize)) {
+	if (dst && esil_get_parm_size(esil, dst, dst_w, &tmp, &regsize)) {
 		// reg
-		isregornum(esil, dst, &ptr);
-		count = rz_analysis_esil_pop(esil);
+		isregornum(esil, dst, dst_w, &ptr);
+		count = esil_pop_word(esil, &count_w);
 		if (count) {
-			isregornum(esil, count, &regs);
+			isregornum(esil, count, count_w, &regs);
 			if (regs > 0) {
 				ut8 b[8] = { 0 };
 				ut64 num64;
 				for (i = 0; i < regs; i++) {
-					char *foo = rz_analysis_esil_pop(esil);
+					const EsilWord *foo_w;
+					char *foo = esil_pop_word(esil, &foo_w);
 					if (!foo) {
 						// avoid looping out of stack
 						free(dst);
 						free(count);
 						return true;
 					}
-					rz_analysis_esil_get_parm_size(esil, foo, &tmp, &regsize);
-					isregornum(esil, foo, &num64);
+					esil_get_parm_size(esil, foo, foo_w, &tmp, &regsize);
+					isregornum(esil, foo, foo_w, &num64);
 					rz_write_ble(b, num64, esil->analysis->big_endian, regsize);
 					const int size_bytes = regsize / 8;
 					const ut32 written = rz_analysis_esil_mem_write(esil, ptr, b, size_bytes);
@@ -1817,12 +2022,13 @@ static bool esil_peek_n(RzAnalysisEsil *esil, int bits) {
 	char res[32];
 	ut64 addr;
 	ut32 bytes = bits / 8;
-	char *dst = rz_analysis_esil_pop(esil);
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
 	if (!dst) {
 		RZ_LOG_ERROR("Cannot peek memory without specifying an address (esil address: 0x%08" PFMT64x ")\n", esil->address);
 		return false;
 	}
-	if (dst && isregornum(esil, dst, &addr)) {
+	if (dst && isregornum(esil, dst, dst_w, &addr)) {
 		if (bits == 128) {
 			ut8 a[sizeof(ut64) * 2] = { 0 };
 			rz_analysis_esil_mem_read(esil, addr, a, bytes);
@@ -1885,18 +2091,21 @@ static bool esil_peek_some(RzAnalysisEsil *esil) {
 	int i;
 	ut64 ptr, regs;
 	// pop ptr
-	char *count, *dst = rz_analysis_esil_pop(esil);
+	const EsilWord *count_w = NULL;
+	const EsilWord *dst_w;
+	char *count, *dst = esil_pop_word(esil, &dst_w);
 	if (dst) {
 		// reg
-		isregornum(esil, dst, &ptr);
-		count = rz_analysis_esil_pop(esil);
+		isregornum(esil, dst, dst_w, &ptr);
+		count = esil_pop_word(esil, &count_w);
 		if (count) {
-			isregornum(esil, count, &regs);
+			isregornum(esil, count, count_w, &regs);
 			if (regs > 0) {
 				ut32 num32;
 				ut8 a[4];
 				for (i = 0; i < regs; i++) {
-					char *foo = rz_analysis_esil_pop(esil);
+					const EsilWord *foo_w;
+					char *foo = esil_pop_word(esil, &foo_w);
 					if (!foo) {
 						ESIL_LOG("Cannot pop in peek\n");
 						free(dst);
@@ -1906,7 +2115,7 @@ static bool esil_peek_some(RzAnalysisEsil *esil) {
 					const ut32 read = rz_analysis_esil_mem_read(esil, ptr, a, 4);
 					if (read == 4) { // this is highly questionabla
 						num32 = rz_read_ble32(a, esil->analysis->big_endian);
-						rz_analysis_esil_reg_write(esil, foo, num32);
+						esil_reg_write(esil, foo, foo_w, num32);
 					} else {
 						ESIL_LOG("Cannot peek from 0x%08" PFMT64x "\n", ptr);
 					}
@@ -1929,13 +2138,15 @@ static bool esil_mem_oreq_n(RzAnalysisEsil *esil, int bits) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil); // save the dst-addr
-	char *src0 = rz_analysis_esil_pop(esil); // get the src
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w); // get the src
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) { // get the src
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) { // get the src
 		rz_analysis_esil_push(esil, dst); // push the dst-addr
 		ret = (!!esil_peek_n(esil, bits)); // read
-		src1 = rz_analysis_esil_pop(esil); // get the old dst-value
-		if (src1 && rz_analysis_esil_get_parm(esil, src1, &d)) { // get the old dst-value
+		src1 = esil_pop_word(esil, &src1_w); // get the old dst-value
+		if (src1 && esil_get_parm(esil, src1, src1_w, &d)) { // get the old dst-value
 			d |= s; // calculate the new dst-value
 			rz_analysis_esil_pushnum(esil, d); // push the new dst-value
 			rz_analysis_esil_push(esil, dst); // push the dst-addr
@@ -1975,13 +2186,15 @@ static bool esil_mem_xoreq_n(RzAnalysisEsil *esil, int bits) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil);
-	char *src0 = rz_analysis_esil_pop(esil);
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w);
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) {
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) {
 		rz_analysis_esil_push(esil, dst);
 		ret = (!!esil_peek_n(esil, bits));
-		src1 = rz_analysis_esil_pop(esil);
-		if (src1 && rz_analysis_esil_get_parm(esil, src1, &d)) {
+		src1 = esil_pop_word(esil, &src1_w);
+		if (src1 && esil_get_parm(esil, src1, src1_w, &d)) {
 			d ^= s;
 			rz_analysis_esil_pushnum(esil, d);
 			rz_analysis_esil_push(esil, dst);
@@ -2021,13 +2234,15 @@ static bool esil_mem_andeq_n(RzAnalysisEsil *esil, int bits) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil);
-	char *src0 = rz_analysis_esil_pop(esil);
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w);
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) {
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) {
 		rz_analysis_esil_push(esil, dst);
 		ret = (!!esil_peek_n(esil, bits));
-		src1 = rz_analysis_esil_pop(esil);
-		if (src1 && rz_analysis_esil_get_parm(esil, src1, &d)) {
+		src1 = esil_pop_word(esil, &src1_w);
+		if (src1 && esil_get_parm(esil, src1, src1_w, &d)) {
 			d &= s;
 			rz_analysis_esil_pushnum(esil, d);
 			rz_analysis_esil_push(esil, dst);
@@ -2067,13 +2282,15 @@ static bool esil_mem_addeq_n(RzAnalysisEsil *esil, int bits) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil);
-	char *src0 = rz_analysis_esil_pop(esil);
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w);
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) {
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) {
 		rz_analysis_esil_push(esil, dst);
 		ret = (!!esil_peek_n(esil, bits));
-		src1 = rz_analysis_esil_pop(esil);
-		if (src1 && rz_analysis_esil_get_parm(esil, src1, &d)) {
+		src1 = esil_pop_word(esil, &src1_w);
+		if (src1 && esil_get_parm(esil, src1, src1_w, &d)) {
 			d += s;
 			rz_analysis_esil_pushnum(esil, d);
 			rz_analysis_esil_push(esil, dst);
@@ -2113,13 +2330,15 @@ static bool esil_mem_subeq_n(RzAnalysisEsil *esil, int bits) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil);
-	char *src0 = rz_analysis_esil_pop(esil);
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w);
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) {
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) {
 		rz_analysis_esil_push(esil, dst);
 		ret = (!!esil_peek_n(esil, bits));
-		src1 = rz_analysis_esil_pop(esil);
-		if (src1 && rz_analysis_esil_get_parm(esil, src1, &d)) {
+		src1 = esil_pop_word(esil, &src1_w);
+		if (src1 && esil_get_parm(esil, src1, src1_w, &d)) {
 			d -= s;
 			rz_analysis_esil_pushnum(esil, d);
 			rz_analysis_esil_push(esil, dst);
@@ -2159,9 +2378,11 @@ static bool esil_mem_modeq_n(RzAnalysisEsil *esil, int bits) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil);
-	char *src0 = rz_analysis_esil_pop(esil);
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w);
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) {
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) {
 		if (s == 0) {
 			ESIL_LOG("esil_mem_modeq4: Division by zero!\n");
 			esil->trap = RZ_ANALYSIS_TRAP_DIVBYZERO;
@@ -2169,8 +2390,8 @@ static bool esil_mem_modeq_n(RzAnalysisEsil *esil, int bits) {
 		} else {
 			rz_analysis_esil_push(esil, dst);
 			ret = (!!esil_peek_n(esil, bits));
-			src1 = rz_analysis_esil_pop(esil);
-			if (src1 && rz_analysis_esil_get_parm(esil, src1, &d) && s >= 1) {
+			src1 = esil_pop_word(esil, &src1_w);
+			if (src1 && esil_get_parm(esil, src1, src1_w, &d) && s >= 1) {
 				rz_analysis_esil_pushnum(esil, d % s);
 				d = d % s;
 				rz_analysis_esil_pushnum(esil, d);
@@ -2212,9 +2433,11 @@ static bool esil_mem_diveq_n(RzAnalysisEsil *esil, int bits) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil);
-	char *src0 = rz_analysis_esil_pop(esil);
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w);
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) {
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) {
 		if (s == 0) {
 			ESIL_LOG("esil_mem_diveq8: Division by zero!\n");
 			esil->trap = RZ_ANALYSIS_TRAP_DIVBYZERO;
@@ -2222,8 +2445,8 @@ static bool esil_mem_diveq_n(RzAnalysisEsil *esil, int bits) {
 		} else {
 			rz_analysis_esil_push(esil, dst);
 			ret = (!!esil_peek_n(esil, bits));
-			src1 = rz_analysis_esil_pop(esil);
-			if (src1 && rz_analysis_esil_get_parm(esil, src1, &d)) {
+			src1 = esil_pop_word(esil, &src1_w);
+			if (src1 && esil_get_parm(esil, src1, src1_w, &d)) {
 				d = d / s;
 				rz_analysis_esil_pushnum(esil, d);
 				rz_analysis_esil_push(esil, dst);
@@ -2264,13 +2487,15 @@ static bool esil_mem_muleq_n(RzAnalysisEsil *esil, int bits, ut64 bitmask) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil);
-	char *src0 = rz_analysis_esil_pop(esil);
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w);
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) {
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) {
 		rz_analysis_esil_push(esil, dst);
 		ret = (!!esil_peek_n(esil, bits));
-		src1 = rz_analysis_esil_pop(esil);
-		if (src1 && rz_analysis_esil_get_parm(esil, src1, &d)) {
+		src1 = esil_pop_word(esil, &src1_w);
+		if (src1 && esil_get_parm(esil, src1, src1_w, &d)) {
 			d *= s;
 			rz_analysis_esil_pushnum(esil, d);
 			rz_analysis_esil_push(esil, dst);
@@ -2318,11 +2543,12 @@ static bool esil_mem_inceq_n(RzAnalysisEsil *esil, int bits) {
 	ut64 s;
 	char *off = rz_analysis_esil_pop(esil);
 	char *src = NULL;
+	const EsilWord *src_w = NULL;
 	if (off) {
 		rz_analysis_esil_push(esil, off);
 		ret = (!!esil_peek_n(esil, bits));
-		src = rz_analysis_esil_pop(esil);
-		if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
+		src = esil_pop_word(esil, &src_w);
+		if (src && esil_get_parm(esil, src, src_w, &s)) {
 			esil->old = s;
 			s++;
 			esil->cur = s;
@@ -2365,11 +2591,12 @@ static bool esil_mem_deceq_n(RzAnalysisEsil *esil, int bits) {
 	ut64 s;
 	char *off = rz_analysis_esil_pop(esil);
 	char *src = NULL;
+	const EsilWord *src_w = NULL;
 	if (off) {
 		rz_analysis_esil_push(esil, off);
 		ret = (!!esil_peek_n(esil, bits));
-		src = rz_analysis_esil_pop(esil);
-		if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
+		src = esil_pop_word(esil, &src_w);
+		if (src && esil_get_parm(esil, src, src_w, &s)) {
 			s--;
 			rz_analysis_esil_pushnum(esil, s);
 			rz_analysis_esil_push(esil, off);
@@ -2408,16 +2635,18 @@ static bool esil_mem_lsleq_n(RzAnalysisEsil *esil, int bits) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil);
-	char *src0 = rz_analysis_esil_pop(esil);
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w);
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) {
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) {
 		if (s > sizeof(ut64) * 8) {
 			ESIL_LOG("esil_mem_lsleq_n: shift is too big\n");
 		} else {
 			rz_analysis_esil_push(esil, dst);
 			ret = (!!esil_peek_n(esil, bits));
-			src1 = rz_analysis_esil_pop(esil);
-			if (src1 && rz_analysis_esil_get_parm(esil, src1, &d)) {
+			src1 = esil_pop_word(esil, &src1_w);
+			if (src1 && esil_get_parm(esil, src1, src1_w, &d)) {
 				if (s > 63) {
 					d = 0;
 				} else {
@@ -2462,13 +2691,15 @@ static bool esil_mem_lsreq_n(RzAnalysisEsil *esil, int bits) {
 	bool ret = false;
 	ut64 s, d;
 	char *dst = rz_analysis_esil_pop(esil);
-	char *src0 = rz_analysis_esil_pop(esil);
+	const EsilWord *src0_w;
+	char *src0 = esil_pop_word(esil, &src0_w);
 	char *src1 = NULL;
-	if (src0 && rz_analysis_esil_get_parm(esil, src0, &s)) {
+	const EsilWord *src1_w = NULL;
+	if (src0 && esil_get_parm(esil, src0, src0_w, &s)) {
 		rz_analysis_esil_push(esil, dst);
 		ret = (!!esil_peek_n(esil, bits));
-		src1 = rz_analysis_esil_pop(esil);
-		if (src1 && rz_analysis_esil_get_parm(esil, src1, &d)) {
+		src1 = esil_pop_word(esil, &src1_w);
+		if (src1 && esil_get_parm(esil, src1, src1_w, &d)) {
 			d >>= s;
 			rz_analysis_esil_pushnum(esil, d);
 			rz_analysis_esil_push(esil, dst);
@@ -2505,14 +2736,15 @@ static bool esil_mem_lsreq(RzAnalysisEsil *esil) {
 /* get value of register or memory reference and push the value */
 static bool esil_num(RzAnalysisEsil *esil) {
 	char *dup_me;
+	const EsilWord *dup_me_w = NULL;
 	ut64 dup;
 	if (!esil) {
 		return false;
 	}
-	if (!(dup_me = rz_analysis_esil_pop(esil))) {
+	if (!(dup_me = esil_pop_word(esil, &dup_me_w))) {
 		return false;
 	}
-	if (!rz_analysis_esil_get_parm(esil, dup_me, &dup)) {
+	if (!esil_get_parm(esil, dup_me, dup_me_w, &dup)) {
 		free(dup_me);
 		return false;
 	}
@@ -2525,7 +2757,7 @@ static bool esil_dup(RzAnalysisEsil *esil) {
 	if (!esil || !esil->stack || esil->stackptr < 1 || esil->stackptr > (esil->stacksize - 1)) {
 		return false;
 	}
-	return rz_analysis_esil_push(esil, esil->stack[esil->stackptr - 1]);
+	return esil_push_word(esil, esil->stack[esil->stackptr - 1], esil->stack_words[esil->stackptr - 1]);
 }
 
 static bool esil_swap(RzAnalysisEsil *esil) {
@@ -2539,6 +2771,9 @@ static bool esil_swap(RzAnalysisEsil *esil) {
 	tmp = esil->stack[esil->stackptr - 1];
 	esil->stack[esil->stackptr - 1] = esil->stack[esil->stackptr - 2];
 	esil->stack[esil->stackptr - 2] = tmp;
+	const void *tmp_word = esil->stack_words[esil->stackptr - 1];
+	esil->stack_words[esil->stackptr - 1] = esil->stack_words[esil->stackptr - 2];
+	esil->stack_words[esil->stackptr - 2] = tmp_word;
 	return true;
 }
 
@@ -2575,17 +2810,19 @@ static int signed_compare_gt(ut64 a, ut64 b, ut64 size) {
 static bool esil_smaller(RzAnalysisEsil *esil) { // 'dst < src' => 'src,dst,<'
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get(esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			} else if (rz_reg_get(esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, src);
+			if (esil_reg_get(esil, dst, dst_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			} else if (esil_reg_get(esil, src, src_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, src, src_w);
 			} else {
 				// default size is set to 64 as internally operands are ut64
 				esil->lastsz = 64;
@@ -2601,17 +2838,19 @@ static bool esil_smaller(RzAnalysisEsil *esil) { // 'dst < src' => 'src,dst,<'
 static bool esil_bigger(RzAnalysisEsil *esil) { // 'dst > src' => 'src,dst,>'
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get(esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			} else if (rz_reg_get(esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, src);
+			if (esil_reg_get(esil, dst, dst_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			} else if (esil_reg_get(esil, src, src_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, src, src_w);
 			} else {
 				// default size is set to 64 as internally operands are ut64
 				esil->lastsz = 64;
@@ -2627,17 +2866,19 @@ static bool esil_bigger(RzAnalysisEsil *esil) { // 'dst > src' => 'src,dst,>'
 static bool esil_smaller_equal(RzAnalysisEsil *esil) { // 'dst <= src' => 'src,dst,<='
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get(esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			} else if (rz_reg_get(esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, src);
+			if (esil_reg_get(esil, dst, dst_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			} else if (esil_reg_get(esil, src, src_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, src, src_w);
 			} else {
 				// default size is set to 64 as internally operands are ut64
 				esil->lastsz = 64;
@@ -2653,17 +2894,19 @@ static bool esil_smaller_equal(RzAnalysisEsil *esil) { // 'dst <= src' => 'src,d
 static bool esil_bigger_equal(RzAnalysisEsil *esil) { // 'dst >= src' => 'src,dst,>='
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop(esil);
-	char *src = rz_analysis_esil_pop(esil);
-	if (dst && rz_analysis_esil_get_parm(esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm(esil, src, &num2)) {
+	const EsilWord *dst_w;
+	char *dst = esil_pop_word(esil, &dst_w);
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (dst && esil_get_parm(esil, dst, dst_w, &num)) {
+		if (src && esil_get_parm(esil, src, src_w, &num2)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get(esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, dst);
-			} else if (rz_reg_get(esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg(esil, src);
+			if (esil_reg_get(esil, dst, dst_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, dst, dst_w);
+			} else if (esil_reg_get(esil, src, src_w)) {
+				esil->lastsz = esil_internal_sizeof_reg(esil, src, src_w);
 			} else {
 				// default size is set to 64 as internally operands are ut64
 				esil->lastsz = 64;
@@ -2679,8 +2922,9 @@ static bool esil_bigger_equal(RzAnalysisEsil *esil) { // 'dst >= src' => 'src,ds
 static bool esil_set_jump_target(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s;
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
 		esil->jump_target = s;
 		esil->jump_target_set = 1;
 		ret = true;
@@ -2695,8 +2939,9 @@ static bool esil_set_jump_target(RzAnalysisEsil *esil) {
 static bool esil_set_jump_target_set(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s;
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
 		esil->jump_target_set = s;
 		ret = true;
 	} else {
@@ -2710,8 +2955,9 @@ static bool esil_set_jump_target_set(RzAnalysisEsil *esil) {
 static bool esil_set_delay_slot(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s;
-	char *src = rz_analysis_esil_pop(esil);
-	if (src && rz_analysis_esil_get_parm(esil, src, &s)) {
+	const EsilWord *src_w;
+	char *src = esil_pop_word(esil, &src_w);
+	if (src && esil_get_parm(esil, src, src_w, &s)) {
 		esil->delay = s;
 		ret = true;
 	} else {
@@ -2731,11 +2977,11 @@ static bool iscommand(RzAnalysisEsil *esil, const char *word, RzAnalysisEsilOp *
 	return false;
 }
 
-static bool runword(RzAnalysisEsil *esil, const char *word) {
-	RzAnalysisEsilOp *op = NULL;
-	if (!word) {
-		return false;
-	}
+/**
+ * Count a word towards the goto limit
+ * \return false if the limit has been reached
+ */
+static bool count_word(RzAnalysisEsil *esil) {
 	esil->parse_goto_count--;
 	if (esil->parse_goto_count < 1) {
 		ESIL_LOG("ESIL infinite loop detected\n");
@@ -2743,19 +2989,65 @@ static bool runword(RzAnalysisEsil *esil, const char *word) {
 		esil->parse_stop = 1; // INTERNAL ERROR
 		return false;
 	}
+	return true;
+}
+
+static void run_else(RzAnalysisEsil *esil) {
+	if (esil->skip == 1) {
+		esil->skip = 0;
+	} else if (esil->skip == 0) { // this isn't perfect, but should work for valid esil
+		esil->skip = 1;
+	}
+}
 
-	if (!strcmp(word, "}{")) {
-		if (esil->skip == 1) {
-			esil->skip = 0;
-		} else if (esil->skip == 0) { // this isn't perfect, but should work for valid esil
-			esil->skip = 1;
+static void run_endif(RzAnalysisEsil *esil) {
+	if (esil->skip) {
+		esil->skip--;
+	}
+}
+
+static bool run_op(RzAnalysisEsil *esil, const char *word, RzAnalysisEsilOp *op) {
+	if (esil->cb.hook_command) {
+		if (esil->cb.hook_command(esil, word)) {
+			return 1; // XXX cannot return != 1
 		}
+	}
+	rz_strbuf_set(&esil->current_opstr, word);
+	// so this is basically just sharing what's the operation with the operation
+	// useful for wrappers
+	const bool ret = op->code(esil);
+	rz_strbuf_fini(&esil->current_opstr);
+	if (!ret) {
+		ESIL_LOG("%s returned 0\n", word);
+	}
+	return ret;
+}
+
+static bool push_word(RzAnalysisEsil *esil, const char *word, const EsilWord *w) {
+	if (!esil_push_word(esil, word, w)) {
+		ESIL_LOG("ESIL stack is full\n");
+		esil->trap = 1;
+		esil->trap_code = 1;
+		return false;
+	}
+	return true;
+}
+
+static bool runword(RzAnalysisEsil *esil, const char *word) {
+	RzAnalysisEsilOp *op = NULL;
+	if (!word) {
+		return false;
+	}
+	if (!count_word(esil)) {
+		return false;
+	}
+
+	if (!strcmp(word, "}{")) {
+		run_else(esil);
 		return true;
 	}
 	if (!strcmp(word, "}")) {
-		if (esil->skip) {
-			esil->skip--;
-		}
+		run_endif(esil);
 		return true;
 	}
 	if (esil->skip && strcmp(word, "?{")) {
@@ -2765,20 +3057,7 @@ static bool runword(RzAnalysisEsil *esil, const char *word) {
 	if (iscommand(esil, word, &op)) {
 		// run action
 		if (op) {
-			if (esil->cb.hook_command) {
-				if (esil->cb.hook_command(esil, word)) {
-					return 1; // XXX cannot return != 1
-				}
-			}
-			rz_strbuf_set(&esil->current_opstr, word);
-			// so this is basically just sharing what's the operation with the operation
-			// useful for wrappers
-			const bool ret = op->code(esil);
-			rz_strbuf_fini(&esil->current_opstr);
-			if (!ret) {
-				ESIL_LOG("%s returned 0\n", word);
-			}
-			return ret;
+			return run_op(esil, word, op);
 		}
 	}
 	if (!*word || *word == ',') {
@@ -2787,11 +3066,7 @@ static bool runword(RzAnalysisEsil *esil, const char *word) {
 	}
 
 	// push value
-	if (!rz_analysis_esil_push(esil, word)) {
-		ESIL_LOG("ESIL stack is full\n");
-		esil->trap = 1;
-		esil->trap_code = 1;
-	}
+	push_word(esil, word, NULL);
 	return true;
 }
 
@@ -2858,6 +3133,219 @@ static bool __stepOut(RzAnalysisEsil *esil, const char *cmd) {
 	return ret;
 }
 
+#define ESIL_COMPILED_MAX 0x4000
+
+static void esil_compiled_free(EsilCompiled *c) {
+	if (!c) {
+		return;
+	}
+	free(c->words);
+	free(c->buf);
+	free(c);
+}
+
+/**
+ * Only plain expressions are compiled: no `;` terminators, no `#!` commands
+ * and no empty or overlong words, since the string parser handles those in
+ * its own peculiar ways.
+ */
+static bool esil_compile_words(RzAnalysisEsil *esil, EsilCompiled *c, const char *str) {
+	if (strchr(str, ';') || strstr(str, "#!")) {
+		return false;
+	}
+	size_t len = strlen(str);
+	ut32 count = 1;
+	for (const char *s = str; *s; s++) {
+		if (*s == ',') {
+			count++;
+		}
+	}
+	c->buf = rz_str_dup(str);
+	c->words = RZ_NEWS0(EsilWord, count);
+	if (!c->buf || !c->words) {
+		return false;
+	}
+	char *s = c->buf;
+	for (ut32 i = 0; i < count; i++) {
+		char *end = strchr(s, ',');
+		size_t wlen = end ? end - s : strlen(s);
+		if (!wlen || wlen > 62) {
+			return false;
+		}
+		EsilWord *w = &c->words[i];
+		if (end) {
+			*end = 0;
+		}
+		w->str = s;
+		w->next = end ? end + 1 - c->buf : len;
+		if (!strcmp(s, "}{")) {
+			w->kind = ESIL_WORD_ELSE;
+		} else if (!strcmp(s, "}")) {
+			w->kind = ESIL_WORD_ENDIF;
+		} else if (iscommand(esil, s, &w->op)) {
+			w->kind = ESIL_WORD_OP;
+		} else {
+			w->kind = ESIL_WORD_PUSH;
+		}
+		w->is_if = !strcmp(s, "?{");
+		s = end + 1;
+	}
+	c->count = count;
+	return true;
+}
+
+static EsilCompiled *esil_compile(RzAnalysisEsil *esil, const char *str) {
+	EsilCompiled *c = RZ_NEW0(EsilCompiled);
+	if (!c) {
+		return NULL;
+	}
+	c->nops = esil->ops->count;
+	if (!esil_compile_words(esil, c, str)) {
+		RZ_FREE(c->words);
+		RZ_FREE(c->buf);
+		c->count = 0;
+	}
+	return c;
+}
+
+/**
+ * \brief Get the compiled form of \p str, compiling and caching it if needed
+ *
+ * While a compiled expression is running the cache is never flushed or
+ * overwritten, so in that case a stale or missing entry may come back as
+ * a temporary, which \p owned tells the caller to free.
+ */
+static EsilCompiled *esil_compiled_get(RzAnalysisEsil *esil, const char *str, bool *owned) {
+	*owned = false;
+	if (!esil->compiled) {
+		esil->compiled = ht_sp_new(HT_STR_DUP, NULL, (HtSPFreeValue)esil_compiled_free);
+		if (!esil->compiled) {
+			return NULL;
+		}
+	}
+	EsilCompiled *c = ht_sp_find(esil->compiled, str, NULL);
+	// operations are never removed, so a different count means new ones were registered
+	if (c && c->nops == esil->ops->count) {
+		return c;
+	}
+	EsilCompiled *nc = esil_compile(esil, str);
+	if (!nc) {
+		return NULL;
+	}
+	if (esil->compiled_running) {
+		if (c || !ht_sp_insert(esil->compiled, str, nc)) {
+			*owned = true;
+		}
+		return nc;
+	}
+	if (!c && esil->compiled->count >= ESIL_COMPILED_MAX) {
+		ht_sp_free(esil->compiled);
+		esil->compiled = ht_sp_new(HT_STR_DUP, NULL, (HtSPFreeValue)esil_compiled_free);
+		if (!esil->compiled) {
+			*owned = true;
+			return nc;
+		}
+	}
+	if (!ht_sp_update(esil->compiled, str, nc)) {
+		*owned = true;
+	}
+	return nc;
+}
+
+/**
+ * Parse the immediates and look up the registers pushed by the words of \p c,
+ * which are valid as long as the register profile of the analysis does not change.
+ */
+static void esil_compiled_resolve(RzAnalysisEsil *esil, EsilCompiled *c) {
+	RzReg *reg = esil->analysis ? esil->analysis->reg : NULL;
+	c->regs = reg;
+	if (!reg) {
+		return;
+	}
+	c->regs_gen = reg->items_gen;
+	for (ut32 i = 0; i < c->count; i++) {
+		EsilWord *w = &c->words[i];
+		if (w->kind != ESIL_WORD_PUSH) {
+			continue;
+		}
+		w->parm_type = rz_analysis_esil_get_parm_type(esil, w->str);
+		w->num = IS_DIGIT(*w->str) || w->parm_type == RZ_ANALYSIS_ESIL_PARM_NUM ? rz_num_get(NULL, w->str) : 0;
+		w->reg = rz_reg_get(reg, w->str, -1);
+		w->regs_gen = reg->items_gen;
+	}
+}
+
+static bool run_compiled_word(RzAnalysisEsil *esil, const EsilCompiled *c, const EsilWord *w) {
+	if (!count_word(esil)) {
+		return false;
+	}
+	switch (w->kind) {
+	case ESIL_WORD_ELSE:
+		run_else(esil);
+		return true;
+	case ESIL_WORD_ENDIF:
+		run_endif(esil);
+		return true;
+	default:
+		break;
+	}
+	if (esil->skip && !w->is_if) {
+		return true;
+	}
+	if (w->kind == ESIL_WORD_OP) {
+		return run_op(esil, w->str, w->op);
+	}
+	push_word(esil, w->str, c->regs ? w : NULL);
+	return true;
+}
+
+static void parse_reset(RzAnalysisEsil *esil) {
+	esil->repeat = 0;
+	esil->skip = 0;
+	esil->parse_goto = -1;
+	esil->parse_stop = 0;
+	esil->parse_goto_count = esil->analysis ? esil->analysis->esil_goto_limit : RZ_ANALYSIS_ESIL_GOTO_LIMIT;
+}
+
+/**
+ * Same as the string loop of rz_analysis_esil_parse(), including the
+ * handling of REPEAT, GOTO, BREAK and TODO, but over the compiled words.
+ */
+static bool esil_run_compiled(RzAnalysisEsil *esil, EsilCompiled *c, const char *str) {
+	const RzReg *reg = esil->analysis ? esil->analysis->reg : NULL;
+	if (c->regs != reg || (reg && c->regs_gen != reg->items_gen)) {
+		esil_compiled_resolve(esil, c);
+	}
+loop:
+	parse_reset(esil);
+	for (ut32 i = 0; i < c->count;) {
+		const EsilWord *w = &c->words[i];
+		if (!run_compiled_word(esil, c, w)) {
+			return false;
+		}
+		if (esil->repeat) {
+			goto loop;
+		}
+		if (esil->parse_goto != -1) {
+			if (esil->parse_goto < 0 || (ut32)esil->parse_goto >= c->count) {
+				ESIL_LOG("Cannot find word %d\n", esil->parse_goto);
+				return false;
+			}
+			i = esil->parse_goto;
+			esil->parse_goto = -1;
+			continue;
+		}
+		if (esil->parse_stop) {
+			if (esil->parse_stop == 2) {
+				RZ_LOG_DEBUG("[esil at 0x%08" PFMT64x "] TODO: %s\n", esil->address, str + w->next);
+			}
+			return false;
+		}
+		i++;
+	}
+	return true;
+}
+
 RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str) {
 	int wordi = 0;
 	int dorunword;
@@ -2876,14 +3364,29 @@ RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str) {
 			esil->cmd(esil, esil->cmd_todo, esil->address, 0);
 		}
 	}
+	bool owned;
+	EsilCompiled *compiled = esil_compiled_get(esil, str, &owned);
+	if (compiled && compiled->count) {
+		esil->compiled_running++;
+		bool ret = esil_run_compiled(esil, compiled, str);
+		esil->compiled_running--;
+		// the words may be freed, so the entries left on the stack forget them
+		for (int i = 0; i < esil->stackptr; i++) {
+			esil->stack_words[i] = NULL;
+		}
+		if (owned) {
+			esil_compiled_free(compiled);
+		}
+		__stepOut(esil, esil->cmd_step_out);
+		return ret;
+	}
+	if (owned) {
+		esil_compiled_free(compiled);
+	}
 loop:
-	esil->repeat = 0;
-	esil->skip = 0;
-	esil->parse_goto = -1;
-	esil->parse_stop = 0;
+	parse_reset(esil);
 	// memleak or failing aetr test. wat du
 	//	rz_analysis_esil_stack_free (esil);
-	esil->parse_goto_count = esil->analysis ? esil->analysis->esil_goto_limit : RZ_ANALYSIS_ESIL_GOTO_LIMIT;
 	str = ostr;
 repeat:
 	wordi = 0;
@@ -2975,6 +3478,7 @@ RZ_API void rz_analysis_esil_stack_free(RzAnalysisEsil *esil) {
 
 RZ_API int rz_analysis_esil_condition(RzAnalysisEsil *esil, const char *str) {
 	char *popped;
+	const EsilWord *popped_w = NULL;
 	int ret;
 	if (!esil) {
 		return false;
@@ -2983,10 +3487,10 @@ RZ_API int rz_analysis_esil_condition(RzAnalysisEsil *esil, const char *str) {
 		str++; // use proper string chop?
 	}
 	(void)rz_analysis_esil_parse(esil, str);
-	popped = rz_analysis_esil_pop(esil);
+	popped = esil_pop_word(esil, &popped_w);
 	if (popped) {
 		ut64 num;
-		if (isregornum(esil, popped, &num)) {
+		if (isregornum(esil, popped, popped_w, &num)) {
 			ret = !!num;
 		} else {
 			ret = 0;
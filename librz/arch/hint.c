@@ -81,6 +81,7 @@ void rz_analysis_hint_storage_fini(RzAnalysis *a) {
 RZ_API void rz_analysis_hint_clear(RzAnalysis *a) {
 	rz_analysis_hint_storage_fini(a);
 	rz_analysis_hint_storage_init(a);
+	rz_analysis_il_cache_clear(a);
 }
 
 typedef struct {
@@ -99,6 +100,7 @@ static bool addr_hint_range_delete_cb(void *user, const ut64 key, const void *va
 }
 
 RZ_API void rz_analysis_hint_del(RzAnalysis *a, ut64 addr, ut64 size) {
+	rz_analysis_il_cache_invalidate(a, addr, RZ_MAX(size, 1));
 	if (size <= 1) {
 		// only single address
 		ht_up_delete(a->addr_hints, addr);
@@ -134,6 +136,7 @@ RZ_API void rz_analysis_hint_del(RzAnalysis *a, ut64 addr, ut64 size) {
 }
 
 static void unset_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType type, ut64 addr) {
+	rz_analysis_il_cache_invalidate(analysis, addr, 1);
 	RzVector *records = ht_up_find(analysis->addr_hints, addr, NULL);
 	if (!records) {
 		return;
@@ -151,6 +154,7 @@ static void unset_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType
 
 // create or return the existing addr hint record of the given type at addr
 static RzAnalysisAddrHintRecord *ensure_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType type, ut64 addr) {
+	rz_analysis_il_cache_invalidate(analysis, addr, 1);
 	RzVector *records = ht_up_find(analysis->addr_hints, addr, NULL);
 	if (!records) {
 		records = rz_vector_new(sizeof(RzAnalysisAddrHintRecord), addr_hint_record_fini, NULL);
@@ -279,6 +283,8 @@ RZ_API void rz_analysis_hint_set_arch(RzAnalysis *a, ut64 addr, RZ_NULLABLE cons
 	}
 	free(record->arch);
 	record->arch = rz_str_dup(arch);
+	// ranged hints affect every op after addr
+	rz_analysis_il_cache_clear(a);
 }
 
 RZ_API void rz_analysis_hint_set_bits(RzAnalysis *a, ut64 addr, int bits) {
@@ -287,6 +293,7 @@ RZ_API void rz_analysis_hint_set_bits(RzAnalysis *a, ut64 addr, int bits) {
 		return;
 	}
 	record->bits = bits;
+	rz_analysis_il_cache_clear(a);
 	if (a->hint_cbs.on_bits) {
 		a->hint_cbs.on_bits(a, addr, bits, true);
 	}
@@ -357,10 +364,12 @@ RZ_API void rz_analysis_hint_unset_stackframe(RzAnalysis *a, ut64 addr) {
 }
 
 RZ_API void rz_analysis_hint_unset_arch(RzAnalysis *a, ut64 addr) {
+	rz_analysis_il_cache_clear(a);
 	rz_rbtree_delete(&a->arch_hints, &addr, ranged_hint_record_cmp, NULL, arch_hint_record_free_rb, NULL);
 }
 
 RZ_API void rz_analysis_hint_unset_bits(RzAnalysis *a, ut64 addr) {
+	rz_analysis_il_cache_clear(a);
 	rz_rbtree_delete(&a->bits_hints, &addr, ranged_hint_record_cmp, NULL, bits_hint_record_free_rb, NULL);
 }
 
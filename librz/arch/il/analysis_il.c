@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <rz_analysis.h>
+#include "../analysis_private.h"
 
 /**
  * \name Config and Init State
@@ -240,6 +241,212 @@ static void il_events(RzILVM *vm, RzStrBuf *sb) {
 	}
 }
 
+/**
+ * Number of bytes read for lifting a single instruction. This is also
+ * an upper bound of the size of any op stored in the lifted IL cache.
+ */
+#define IL_STEP_CODE_SIZE 32
+
+/**
+ * Maximum number of ops kept in the lifted IL cache before it is flushed.
+ */
+#define IL_CACHE_MAX_OPS 0x10000
+
+/**
+ * An instruction lifted once and reused for every following step at the same
+ * address, as long as the bytes at that address do not change.
+ */
+typedef struct {
+	RzILOpEffect *il_op;
+	RzILCompiledEffect *compiled; ///< il_op in compiled form, created on the first step
+	int size;
+	char *mnemonic;
+	ut8 code[IL_STEP_CODE_SIZE]; ///< bytes il_op was lifted from
+} ILCachedOp;
+
+struct rz_analysis_il_cache_t {
+	HtUP /*<ut64, ILCachedOp *>*/ *ops; ///< lifted ops by address, NULL when empty
+	ut64 min_addr; ///< lowest address of any cached op
+	ut64 max_end; ///< highest end address of any cached op
+};
+
+static void il_cached_op_free(ILCachedOp *cop) {
+	if (!cop) {
+		return;
+	}
+	rz_il_compiled_effect_free(cop->compiled);
+	rz_il_op_effect_free(cop->il_op);
+	free(cop->mnemonic);
+	free(cop);
+}
+
+static void il_cache_reset(RzAnalysisILCache *cache) {
+	ht_up_free(cache->ops);
+	cache->ops = NULL;
+	cache->min_addr = UT64_MAX;
+	cache->max_end = 0;
+}
+
+RZ_IPI void rz_analysis_il_cache_free(RZ_NULLABLE RzAnalysisILCache *cache) {
+	if (!cache) {
+		return;
+	}
+	ht_up_free(cache->ops);
+	free(cache);
+}
+
+/**
+ * \brief Drop all ops from the lifted IL cache
+ *
+ * This must be called whenever the result of lifting may change for
+ * any address, e.g. when switching the architecture or bits.
+ */
+RZ_API void rz_analysis_il_cache_clear(RZ_NONNULL RzAnalysis *analysis) {
+	rz_return_if_fail(analysis);
+	if (analysis->il_cache) {
+		il_cache_reset(analysis->il_cache);
+	}
+}
+
+typedef struct {
+	ut64 addr;
+	ut64 end;
+	RzVector /*<ut64>*/ keys;
+} ILCacheInvalidateCtx;
+
+static bool il_cache_collect_overlapping(void *user, const ut64 key, const void *value) {
+	ILCacheInvalidateCtx *ctx = user;
+	const ILCachedOp *cop = value;
+	if (key < ctx->end && key + RZ_MAX(cop->size, 1) > ctx->addr) {
+		rz_vector_push(&ctx->keys, (void *)&key);
+	}
+	return true;
+}
+
+/**
+ * \brief Drop all ops overlapping [\p addr, \p addr + \p size) from the lifted IL cache
+ *
+ * To be called when the memory at the given range was modified. A cached op
+ * is only reused if the bytes at its address did not change, so this just
+ * frees the stale ops early.
+ */
+RZ_API void rz_analysis_il_cache_invalidate(RZ_NONNULL RzAnalysis *analysis, ut64 addr, ut64 size) {
+	rz_return_if_fail(analysis);
+	RzAnalysisILCache *cache = analysis->il_cache;
+	if (!cache || !cache->ops || !size) {
+		return;
+	}
+	ut64 end = addr + size < addr ? UT64_MAX : addr + size;
+	if (end <= cache->min_addr || addr >= cache->max_end) {
+		// most writes while emulating go to the stack or data, far from the code
+		return;
+	}
+	ut64 from = addr > IL_STEP_CODE_SIZE - 1 ? addr - (IL_STEP_CODE_SIZE - 1) : 0;
+	if (end - from <= cache->ops->count) {
+		// small writes: only look at the addresses an overlapping op could start at
+		for (ut64 a = from; a < end; a++) {
+			ILCachedOp *cop = ht_up_find(cache->ops, a, NULL);
+			if (cop && a + RZ_MAX(cop->size, 1) > addr) {
+				ht_up_delete(cache->ops, a);
+			}
+		}
+		return;
+	}
+	ILCacheInvalidateCtx ctx = { .addr = addr, .end = end };
+	rz_vector_init(&ctx.keys, sizeof(ut64), NULL, NULL);
+	ht_up_foreach(cache->ops, il_cache_collect_overlapping, &ctx);
+	ut64 *key;
+	rz_vector_foreach (&ctx.keys, key) {
+		ht_up_delete(cache->ops, *key);
+	}
+	rz_vector_fini(&ctx.keys);
+}
+
+static ILCachedOp *il_cache_find(RzAnalysis *analysis, ut64 addr) {
+	RzAnalysisILCache *cache = analysis->il_cache;
+	return cache && cache->ops ? ht_up_find(cache->ops, addr, NULL) : NULL;
+}
+
+static bool il_cache_insert(RzAnalysis *analysis, ut64 addr, ILCachedOp *cop) {
+	RzAnalysisILCache *cache = analysis->il_cache;
+	if (!cache) {
+		cache = RZ_NEW0(RzAnalysisILCache);
+		if (!cache) {
+			return false;
+		}
+		il_cache_reset(cache);
+		analysis->il_cache = cache;
+	}
+	if (cache->ops && cache->ops->count >= IL_CACHE_MAX_OPS) {
+		il_cache_reset(cache);
+	}
+	if (!cache->ops) {
+		cache->ops = ht_up_new(NULL, (HtUPFreeValue)il_cached_op_free);
+		if (!cache->ops) {
+			return false;
+		}
+	}
+	if (!ht_up_insert(cache->ops, addr, cop)) {
+		return false;
+	}
+	cache->min_addr = RZ_MIN(cache->min_addr, addr);
+	cache->max_end = RZ_MAX(cache->max_end, addr + RZ_MAX(cop->size, 1));
+	return true;
+}
+
+/**
+ * Get the lifted op at \p addr from the cache, or lift and cache it.
+ * \return the cached op or NULL with \p res set to the reason of the failure
+ */
+static ILCachedOp *il_cache_get(RzAnalysis *analysis, ut64 addr, RzAnalysisILStepResult *res) {
+	ut8 code[IL_STEP_CODE_SIZE] = { 0 };
+	ILCachedOp *cop = il_cache_find(analysis, addr);
+	if (cop) {
+		// the memory may change without notice, e.g. while debugging
+		int size = RZ_MAX(cop->size, 1);
+		analysis->read_at(analysis, addr, code, size);
+		if (!memcmp(code, cop->code, size)) {
+			return cop;
+		}
+		ht_up_delete(analysis->il_cache->ops, addr);
+	}
+
+	analysis->read_at(analysis, addr, code, sizeof(code));
+	RzAnalysisOp op = { 0 };
+	int r = rz_analysis_op(analysis, &op, addr, code, sizeof(code), RZ_ANALYSIS_OP_MASK_IL | RZ_ANALYSIS_OP_MASK_HINT | RZ_ANALYSIS_OP_MASK_DISASM);
+	if (r < 0) {
+		*res = RZ_ANALYSIS_IL_STEP_INVALID_OP;
+		rz_analysis_op_fini(&op);
+		return NULL;
+	}
+	if (!op.il_op) {
+		*res = RZ_ANALYSIS_IL_STEP_UNIMPLEMENTED_IL;
+		rz_analysis_op_fini(&op);
+		return NULL;
+	}
+	cop = RZ_NEW0(ILCachedOp);
+	if (!cop) {
+		*res = RZ_ANALYSIS_IL_STEP_IL_RUNTIME_ERROR;
+		rz_analysis_op_fini(&op);
+		return NULL;
+	}
+	// steal the lifted effect and mnemonic from the op
+	cop->il_op = op.il_op;
+	cop->mnemonic = op.mnemonic;
+	cop->size = RZ_MIN(op.size, IL_STEP_CODE_SIZE);
+	memcpy(cop->code, code, sizeof(code));
+	op.il_op = NULL;
+	op.mnemonic = NULL;
+	rz_analysis_op_fini(&op);
+
+	if (!il_cache_insert(analysis, addr, cop)) {
+		il_cached_op_free(cop);
+		*res = RZ_ANALYSIS_IL_STEP_IL_RUNTIME_ERROR;
+		return NULL;
+	}
+	return cop;
+}
+
 static RzAnalysisILStepResult analysis_il_vm_step_while(
 	RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisILVM *vm, RZ_NULLABLE RzReg *reg,
 	bool with_events, RZ_NONNULL RzAnalysisILVMCondCallback cond, RZ_NULLABLE void *user) {
@@ -254,46 +461,72 @@ static RzAnalysisILStepResult analysis_il_vm_step_while(
 		rz_analysis_il_vm_sync_from_reg(vm, reg);
 	}
 
-	RzAnalysisOp op = { 0 };
 	RzAnalysisILStepResult res = RZ_ANALYSIS_IL_STEP_RESULT_SUCCESS;
 	while (cond(vm, user)) {
 		ut64 addr = rz_bv_to_ut64(vm->vm->pc);
-		ut8 code[32] = { 0 };
-		analysis->read_at(analysis, addr, code, sizeof(code));
-		int r = rz_analysis_op(analysis, &op, addr, code, sizeof(code), RZ_ANALYSIS_OP_MASK_IL | RZ_ANALYSIS_OP_MASK_HINT | RZ_ANALYSIS_OP_MASK_DISASM);
-
-		if (r < 0) {
-			res = RZ_ANALYSIS_IL_STEP_INVALID_OP;
-			break;
-		} else if (!op.il_op) {
-			res = RZ_ANALYSIS_IL_STEP_UNIMPLEMENTED_IL;
+		ILCachedOp *cop = il_cache_get(analysis, addr, &res);
+		if (!cop) {
 			break;
-		} else if (!rz_il_vm_step(vm->vm, op.il_op, addr + (op.size > 0 ? op.size : 1))) {
+		}
+		// Keep the op alive even if the step writes over its own code
+		// and the cache entry gets invalidated in the meantime.
+		if (!cop->compiled) {
+			cop->compiled = rz_il_compile_effect(vm->vm, cop->il_op);
+		}
+		RzILOpEffect *il_op = cop->il_op;
+		RzILCompiledEffect *compiled = cop->compiled;
+		char *mnemonic = cop->mnemonic;
+		int size = cop->size;
+		ut8 code[IL_STEP_CODE_SIZE];
+		memcpy(code, cop->code, sizeof(code));
+		cop->il_op = NULL;
+		cop->compiled = NULL;
+		cop->mnemonic = NULL;
+		ut64 fallthrough = addr + (size > 0 ? size : 1);
+		bool succ = compiled
+			? rz_il_vm_step_compiled(vm->vm, compiled, fallthrough)
+			: rz_il_vm_step(vm->vm, il_op, fallthrough);
+		cop = il_cache_find(analysis, addr);
+		if (cop && !cop->il_op) {
+			cop->il_op = il_op;
+			cop->compiled = compiled;
+			cop->mnemonic = mnemonic;
+			il_op = NULL;
+			mnemonic = NULL;
+		} else {
+			// the compiled form borrows il_op, which is freed below
+			rz_il_compiled_effect_free(compiled);
+		}
+		if (!succ) {
+			rz_il_op_effect_free(il_op);
+			free(mnemonic);
 			res = RZ_ANALYSIS_IL_STEP_IL_RUNTIME_ERROR;
 			break;
 		}
 
 		if (!with_events) {
-			rz_analysis_op_fini(&op);
+			rz_il_op_effect_free(il_op);
+			free(mnemonic);
 			continue;
 		}
 
 		RzStrBuf sb = { 0 };
 		rz_strbuf_init(&sb);
-		rz_il_op_effect_stringify(op.il_op, &sb, false);
+		rz_il_op_effect_stringify(il_op ? il_op : cop->il_op, &sb, false);
 		rz_strbuf_append(&sb, "\n");
 		il_events(vm->vm, &sb);
 
 		rz_cons_printf("0x%08" PFMT64x " [", addr);
-		for (int i = 0; i < op.size; ++i) {
+		for (int i = 0; i < size; ++i) {
 			rz_cons_printf("%02x", code[i]);
 		}
-		rz_cons_printf("] %s\n%s\n", op.mnemonic, rz_strbuf_get(&sb));
+		const char *mn = mnemonic ? mnemonic : cop->mnemonic;
+		rz_cons_printf("] %s\n%s\n", mn ? mn : "", rz_strbuf_get(&sb));
 		rz_cons_flush();
 		rz_strbuf_fini(&sb);
-		rz_analysis_op_fini(&op);
+		rz_il_op_effect_free(il_op);
+		free(mnemonic);
 	}
-	rz_analysis_op_fini(&op);
 	if (reg) {
 		rz_analysis_il_vm_sync_to_reg(vm, reg);
 	}
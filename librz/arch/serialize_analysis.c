@@ -55,6 +55,38 @@
  *
  */
 
+static const RzSerializeField case_op_fields[] = {
+	RZ_SERIALIZE_FIELD(RzAnalysisCaseOp, addr, "addr"),
+	RZ_SERIALIZE_FIELD(RzAnalysisCaseOp, jump, "jump"),
+	RZ_SERIALIZE_FIELD(RzAnalysisCaseOp, value, "value"),
+};
+
+static const RzSerializeField switch_op_fields[] = {
+	RZ_SERIALIZE_FIELD(RzAnalysisSwitchOp, addr, "addr"),
+	RZ_SERIALIZE_FIELD(RzAnalysisSwitchOp, min_val, "min"),
+	RZ_SERIALIZE_FIELD(RzAnalysisSwitchOp, max_val, "max"),
+	RZ_SERIALIZE_FIELD(RzAnalysisSwitchOp, def_val, "def"),
+	RZ_SERIALIZE_FIELD_VARIABLE("cases"),
+};
+
+/**
+ * \brief Get the fields of an RzAnalysisCaseOp, as serialized by rz_serialize_analysis_case_op_save()
+ */
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_case_op_fields(RZ_NONNULL size_t *count) {
+	rz_return_val_if_fail(count, NULL);
+	*count = RZ_ARRAY_SIZE(case_op_fields);
+	return case_op_fields;
+}
+
+/**
+ * \brief Get the fields of an RzAnalysisSwitchOp, as serialized by rz_serialize_analysis_switch_op_save()
+ */
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_switch_op_fields(RZ_NONNULL size_t *count) {
+	rz_return_val_if_fail(count, NULL);
+	*count = RZ_ARRAY_SIZE(switch_op_fields);
+	return switch_op_fields;
+}
+
 RZ_API void rz_serialize_analysis_case_op_save(RZ_NONNULL PJ *j, RZ_NONNULL RzAnalysisCaseOp *op) {
 	pj_o(j);
 	pj_kn(j, "addr", op->addr);
@@ -230,6 +262,32 @@ enum {
 	BLOCK_FIELD_CMPREG
 };
 
+static const RzSerializeField block_fields[] = {
+	[BLOCK_FIELD_SIZE] = RZ_SERIALIZE_FIELD(RzAnalysisBlock, size, "size"),
+	[BLOCK_FIELD_JUMP] = RZ_SERIALIZE_FIELD(RzAnalysisBlock, jump, "jump"),
+	[BLOCK_FIELD_FAIL] = RZ_SERIALIZE_FIELD(RzAnalysisBlock, fail, "fail"),
+	[BLOCK_FIELD_TRACED] = RZ_SERIALIZE_FIELD_BOOL(RzAnalysisBlock, traced, "traced"),
+	[BLOCK_FIELD_COLORIZE] = RZ_SERIALIZE_FIELD(RzAnalysisBlock, colorize, "colorize"),
+	[BLOCK_FIELD_SWITCH_OP] = RZ_SERIALIZE_FIELD_VARIABLE("switch_op"),
+	[BLOCK_FIELD_NINSTR] = RZ_SERIALIZE_FIELD(RzAnalysisBlock, ninstr, "ninstr"),
+	[BLOCK_FIELD_OP_POS] = RZ_SERIALIZE_FIELD_VARIABLE("op_pos"),
+	[BLOCK_FIELD_SP_ENTRY] = RZ_SERIALIZE_FIELD(RzAnalysisBlock, sp_entry, "sp"),
+	[BLOCK_FIELD_SP_DELTA] = RZ_SERIALIZE_FIELD_VARIABLE("sp_delta"),
+	[BLOCK_FIELD_CMPVAL] = RZ_SERIALIZE_FIELD(RzAnalysisBlock, cmpval, "cmpval"),
+	[BLOCK_FIELD_CMPREG] = RZ_SERIALIZE_FIELD_VARIABLE("cmpreg"),
+};
+
+/**
+ * \brief Get the fields of an RzAnalysisBlock, in the order of their keys in the json
+ *
+ * The address is not part of the fields, it is the key of the block in the sdb.
+ */
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_block_fields(RZ_NONNULL size_t *count) {
+	rz_return_val_if_fail(count, NULL);
+	*count = RZ_ARRAY_SIZE(block_fields);
+	return block_fields;
+}
+
 typedef struct {
 	RzAnalysis *analysis;
 	RzKeyParser *parser;
@@ -399,18 +457,7 @@ RZ_API bool rz_serialize_analysis_blocks_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzA
 		RZ_SERIALIZE_ERR(res, "parser init failed");
 		return false;
 	}
-	rz_key_parser_add(ctx.parser, "size", BLOCK_FIELD_SIZE);
-	rz_key_parser_add(ctx.parser, "jump", BLOCK_FIELD_JUMP);
-	rz_key_parser_add(ctx.parser, "fail", BLOCK_FIELD_FAIL);
-	rz_key_parser_add(ctx.parser, "traced", BLOCK_FIELD_TRACED);
-	rz_key_parser_add(ctx.parser, "colorize", BLOCK_FIELD_COLORIZE);
-	rz_key_parser_add(ctx.parser, "switch_op", BLOCK_FIELD_SWITCH_OP);
-	rz_key_parser_add(ctx.parser, "ninstr", BLOCK_FIELD_NINSTR);
-	rz_key_parser_add(ctx.parser, "op_pos", BLOCK_FIELD_OP_POS);
-	rz_key_parser_add(ctx.parser, "sp", BLOCK_FIELD_SP_ENTRY);
-	rz_key_parser_add(ctx.parser, "sp_delta", BLOCK_FIELD_SP_DELTA);
-	rz_key_parser_add(ctx.parser, "cmpval", BLOCK_FIELD_CMPVAL);
-	rz_key_parser_add(ctx.parser, "cmpreg", BLOCK_FIELD_CMPREG);
+	rz_serialize_fields_key_parser_add(ctx.parser, block_fields, RZ_ARRAY_SIZE(block_fields));
 	bool ret = sdb_foreach(db, block_load_cb, &ctx);
 	rz_key_parser_free(ctx.parser);
 	if (!ret) {
@@ -1182,6 +1229,36 @@ enum {
 	FUNCTION_FIELD_LABELS
 };
 
+// pure, bp_frame and noreturn are bitfields, so they are (de)serialized separately
+static const RzSerializeField function_fields[] = {
+	[FUNCTION_FIELD_NAME] = RZ_SERIALIZE_FIELD_VARIABLE("name"),
+	[FUNCTION_FIELD_BITS] = RZ_SERIALIZE_FIELD(RzAnalysisFunction, bits, "bits"),
+	[FUNCTION_FIELD_TYPE] = RZ_SERIALIZE_FIELD(RzAnalysisFunction, type, "type"),
+	[FUNCTION_FIELD_CC] = RZ_SERIALIZE_FIELD_VARIABLE("cc"),
+	[FUNCTION_FIELD_STACK] = RZ_SERIALIZE_FIELD(RzAnalysisFunction, stack, "stack"),
+	[FUNCTION_FIELD_MAXSTACK] = RZ_SERIALIZE_FIELD(RzAnalysisFunction, maxstack, "maxstack"),
+	[FUNCTION_FIELD_NINSTR] = RZ_SERIALIZE_FIELD(RzAnalysisFunction, ninstr, "ninstr"),
+	[FUNCTION_FIELD_PURE] = RZ_SERIALIZE_FIELD_VARIABLE("pure"),
+	[FUNCTION_FIELD_BP_FRAME] = RZ_SERIALIZE_FIELD_VARIABLE("bp_frame"),
+	[FUNCTION_FIELD_BP_OFF] = RZ_SERIALIZE_FIELD(RzAnalysisFunction, bp_off, "bp_off"),
+	[FUNCTION_FIELD_NORETURN] = RZ_SERIALIZE_FIELD_VARIABLE("noreturn"),
+	[FUNCTION_FIELD_BBS] = RZ_SERIALIZE_FIELD_VARIABLE("bbs"),
+	[FUNCTION_FIELD_IMPORTS] = RZ_SERIALIZE_FIELD_VARIABLE("imports"),
+	[FUNCTION_FIELD_VARS] = RZ_SERIALIZE_FIELD_VARIABLE("vars"),
+	[FUNCTION_FIELD_LABELS] = RZ_SERIALIZE_FIELD_VARIABLE("labels"),
+};
+
+/**
+ * \brief Get the fields of an RzAnalysisFunction, in the order of their keys in the json
+ *
+ * The address is not part of the fields, it is the key of the function in the sdb.
+ */
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_function_fields(RZ_NONNULL size_t *count) {
+	rz_return_val_if_fail(count, NULL);
+	*count = RZ_ARRAY_SIZE(function_fields);
+	return function_fields;
+}
+
 static bool function_load_cb(void *user, const SdbKv *kv) {
 	RzSerializeAnalysisFunctionLoadCtx *ctx = user;
 
@@ -1373,21 +1450,7 @@ RZ_API bool rz_serialize_analysis_functions_load(RZ_NONNULL Sdb *db, RZ_NONNULL
 		ret = false;
 		goto beach;
 	}
-	rz_key_parser_add(ctx.parser, "name", FUNCTION_FIELD_NAME);
-	rz_key_parser_add(ctx.parser, "bits", FUNCTION_FIELD_BITS);
-	rz_key_parser_add(ctx.parser, "type", FUNCTION_FIELD_TYPE);
-	rz_key_parser_add(ctx.parser, "cc", FUNCTION_FIELD_CC);
-	rz_key_parser_add(ctx.parser, "stack", FUNCTION_FIELD_STACK);
-	rz_key_parser_add(ctx.parser, "maxstack", FUNCTION_FIELD_MAXSTACK);
-	rz_key_parser_add(ctx.parser, "ninstr", FUNCTION_FIELD_NINSTR);
-	rz_key_parser_add(ctx.parser, "pure", FUNCTION_FIELD_PURE);
-	rz_key_parser_add(ctx.parser, "bp_frame", FUNCTION_FIELD_BP_FRAME);
-	rz_key_parser_add(ctx.parser, "bp_off", FUNCTION_FIELD_BP_OFF);
-	rz_key_parser_add(ctx.parser, "noreturn", FUNCTION_FIELD_NORETURN);
-	rz_key_parser_add(ctx.parser, "bbs", FUNCTION_FIELD_BBS);
-	rz_key_parser_add(ctx.parser, "imports", FUNCTION_FIELD_IMPORTS);
-	rz_key_parser_add(ctx.parser, "vars", FUNCTION_FIELD_VARS);
-	rz_key_parser_add(ctx.parser, "labels", FUNCTION_FIELD_LABELS);
+	rz_serialize_fields_key_parser_add(ctx.parser, function_fields, RZ_ARRAY_SIZE(function_fields));
 	ret = sdb_foreach(db, function_load_cb, &ctx);
 	if (!ret) {
 		RZ_SERIALIZE_ERR(res, "functions parsing failed");
@@ -1409,38 +1472,69 @@ RZ_API bool rz_serialize_analysis_function_noreturn_load(RZ_NONNULL Sdb *db, RZ_
 	return true;
 }
 
-static bool store_xref_cb(void *j, const ut64 k, const void *v) {
-	const RzAnalysisXRef *xref = v;
-	pj_o(j);
-	pj_kn(j, "to", k);
-	if (xref->type != RZ_ANALYSIS_XREF_TYPE_NULL) {
-		char type[2] = { xref->type, '\0' };
-		pj_ks(j, "type", type);
-	}
-	pj_end(j);
-	return true;
+static const RzSerializeField xref_fields[] = {
+	RZ_SERIALIZE_FIELD(RzAnalysisXRef, from, "from"),
+	RZ_SERIALIZE_FIELD(RzAnalysisXRef, to, "to"),
+	RZ_SERIALIZE_FIELD(RzAnalysisXRef, type, "type"),
+};
+
+/**
+ * \brief Get the fields of an RzAnalysisXRef
+ *
+ * In the json, "from" is the key of the array of xrefs in the sdb.
+ */
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_xref_fields(RZ_NONNULL size_t *count) {
+	rz_return_val_if_fail(count, NULL);
+	*count = RZ_ARRAY_SIZE(xref_fields);
+	return xref_fields;
 }
 
-static bool store_xrefs_list_cb(void *db, const ut64 k, const void *v) {
+typedef struct {
+	Sdb *db;
+	PJ *j; ///< Array of the xrefs from the current address
+	ut64 from;
+} XRefsSaveCtx;
+
+static void store_xrefs_list(XRefsSaveCtx *ctx) {
 	char key[0x20];
-	if (snprintf(key, sizeof(key), "0x%" PFMT64x, k) < 0) {
-		return false;
+	pj_end(ctx->j);
+	if (snprintf(key, sizeof(key), "0x%" PFMT64x, ctx->from) >= 0) {
+		sdb_set(ctx->db, key, pj_string(ctx->j));
 	}
-	PJ *j = pj_new();
-	if (!j) {
-		return false;
+	pj_free(ctx->j);
+	ctx->j = NULL;
+}
+
+static bool store_xref_cb(const RzAnalysisXRef *xref, void *user) {
+	XRefsSaveCtx *ctx = user;
+	if (ctx->j && ctx->from != xref->from) {
+		store_xrefs_list(ctx);
+	}
+	if (!ctx->j) {
+		ctx->j = pj_new();
+		if (!ctx->j) {
+			return false;
+		}
+		ctx->from = xref->from;
+		pj_a(ctx->j);
+	}
+	PJ *j = ctx->j;
+	pj_o(j);
+	pj_kn(j, "to", xref->to);
+	if (xref->type != RZ_ANALYSIS_XREF_TYPE_NULL) {
+		char type[2] = { xref->type, '\0' };
+		pj_ks(j, "type", type);
 	}
-	pj_a(j);
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach(ht, store_xref_cb, j);
 	pj_end(j);
-	sdb_set(db, key, pj_string(j));
-	pj_free(j);
 	return true;
 }
 
 RZ_API void rz_serialize_analysis_xrefs_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis) {
-	ht_up_foreach(analysis->ht_xrefs_from, store_xrefs_list_cb, db);
+	XRefsSaveCtx ctx = { .db = db };
+	rz_analysis_xrefs_foreach(analysis, store_xref_cb, &ctx);
+	if (ctx.j) {
+		store_xrefs_list(&ctx);
+	}
 }
 
 static bool xrefs_load_cb(void *user, const SdbKv *kv) {
@@ -17,14 +17,34 @@
  * If two signatures are of the same size, memcmp is used to perform
  * a fast compare which speeds up the computation and skips the levenshtein
  * distance calculation which is more expensive to perform.
+ *
+ * While searching for the best match, the distance calculation is bounded
+ * by the largest distance that could still replace the current best match,
+ * so that dissimilar pairs are discarded without computing their exact
+ * distance.
+ *
+ * The functions search can optionally skip most pairs: a MinHash signature
+ * of the bytes of each function is indexed with locality-sensitive hashing
+ * and only the pairs that collide (or have the same name, or the same size
+ * and number of blocks and edges) are compared.
  */
 
 #define iob_read_at(addr, buf, size) (analysis->iob.read_at(analysis->iob.io, addr, buf, size))
 
 typedef ut8 *(*AllocateBuffer)(RzAnalysis *analysis, void *data, ut8 **buffer, ut32 *buf_sz);
 
+/**
+ * Candidate pairs selected by the LSH index, see function_index_new()
+ */
+typedef struct function_index_t {
+	HtUP /*<RzAnalysisFunction *, RzVector<ut32> *>*/ *candidates; ///< Candidates of each function of list A (by address of the struct), as indexes in list_b
+	RzAnalysisFunction **list_b; ///< List B as an array
+	ut32 n_b; ///< Number of functions in list B
+} FunctionIndex;
+
 typedef struct shared_context_t {
 	const RzList /*<void *>*/ *list_b;
+	const FunctionIndex *index; ///< When set, only the candidates are compared (functions only)
 	RzThreadQueue *queue;
 	RzThreadQueue *matches;
 	RzThreadQueue *unmatch;
@@ -34,6 +54,7 @@ typedef struct shared_context_t {
 	RzAnalysis *analysis_a;
 	RzAnalysis *analysis_b;
 	RzAtomicBool *loop;
+	ut64 n_compared; ///< Number of compared pairs, protected by lock_a
 } SharedContext;
 
 typedef struct match_ui_info_t {
@@ -96,6 +117,12 @@ static bool shared_context_alloc_b(SharedContext *context, void *ptr, ut8 **buff
 	return res;
 }
 
+static void shared_context_add_compared(SharedContext *context, ut64 n_compared) {
+	rz_th_lock_enter(context->lock_a);
+	context->n_compared += n_compared;
+	rz_th_lock_leave(context->lock_a);
+}
+
 static bool basic_block_data_new(RzAnalysis *analysis, RzAnalysisBlock *bb, ut8 **buffer, ut32 *buf_sz) {
 	rz_return_val_if_fail(analysis && bb && buffer && buf_sz, false);
 	ut8 *data = NULL;
@@ -149,17 +176,53 @@ fail:
 	return false;
 }
 
-static double calculate_similarity(const ut8 *buf_a, ut32 size_a, const ut8 *buf_b, ut32 size_b) {
+/**
+ * \brief Calculates the similarity of two buffers
+ *
+ * When the distance is above \p max_distance the computation stops early and
+ * the returned similarity is the one of a distance of max_distance + 1.
+ */
+static double calculate_similarity(const ut8 *buf_a, ut32 size_a, const ut8 *buf_b, ut32 size_b, ut32 max_distance) {
 	if (size_a == size_b && !memcmp(buf_a, buf_b, size_b)) {
 		return 1.0;
 	}
 	double similarity = 0.0;
-	if (!rz_diff_levenshtein_distance(buf_a, size_a, buf_b, size_b, NULL, &similarity)) {
+	if (!rz_diff_levenshtein_distance_max(buf_a, size_a, buf_b, size_b, max_distance, NULL, &similarity)) {
 		return 0.0;
 	}
 	return similarity;
 }
 
+/**
+ * \brief Tells if \p similarity replaces the current best match, whose similarity is \p max_similarity
+ */
+static inline bool similarity_is_better(double similarity, double max_similarity) {
+	return similarity >= RZ_ANALYSIS_SIMILARITY_THRESHOLD || similarity > max_similarity;
+}
+
+/**
+ * \brief Largest distance between buffers of the given sizes which can still replace the current best match
+ *
+ * The similarity of a distance d is computed with the same formula used by
+ * rz_diff_levenshtein_distance(), so the results are the same as computing
+ * the full distance and then checking similarity_is_better().
+ */
+static ut32 similarity_max_distance(ut32 size_a, ut32 size_b, double max_similarity) {
+	const ut32 length = RZ_MAX(size_a, size_b);
+	if (!length) {
+		return 0;
+	}
+	double min_similarity = RZ_MIN(max_similarity, RZ_ANALYSIS_SIMILARITY_THRESHOLD);
+	ut32 d = min_similarity <= 0.0 ? length : (ut32)((1.0 - min_similarity) * length);
+	while (d < length && similarity_is_better(1.0 - (double)(d + 1) / length, max_similarity)) {
+		d++;
+	}
+	while (d > 0 && !similarity_is_better(1.0 - (double)d / length, max_similarity)) {
+		d--;
+	}
+	return d;
+}
+
 static double analysis_similarity_generic(RzAnalysis *analysis_a, void *ptr_a, RzAnalysis *analysis_b, void *ptr_b, AllocateBuffer callback_new) {
 	ut8 *buf_a = NULL, *buf_b = NULL;
 	ut32 size_a = 0, size_b = 0;
@@ -172,7 +235,7 @@ static double analysis_similarity_generic(RzAnalysis *analysis_a, void *ptr_a, R
 		goto fail;
 	}
 
-	similarity = calculate_similarity(buf_a, size_a, buf_b, size_b);
+	similarity = calculate_similarity(buf_a, size_a, buf_b, size_b, UT32_MAX);
 
 fail:
 	free(buf_a);
@@ -269,7 +332,7 @@ static void *match_thread_ui(MatchUIInfo *ui_info) {
 	return NULL;
 }
 
-static RZ_OWN RzAnalysisMatchResult *analysis_match_result_new(RZ_NONNULL RzAnalysisMatchOpt *opt, RZ_NONNULL RzList /*<void *>*/ *list_a, RZ_NONNULL RzList /*<void *>*/ *list_b, RzThreadFunction thread_cb, AllocateBuffer alloc_cb) {
+static RZ_OWN RzAnalysisMatchResult *analysis_match_result_new(RZ_NONNULL RzAnalysisMatchOpt *opt, RZ_NONNULL RzList /*<void *>*/ *list_a, RZ_NONNULL RzList /*<void *>*/ *list_b, RzThreadFunction thread_cb, AllocateBuffer alloc_cb, RZ_NULLABLE const FunctionIndex *index) {
 	size_t pool_size = 1;
 	RzListIter *iter;
 	RzAnalysisMatchPair *pair = NULL;
@@ -285,6 +348,7 @@ static RZ_OWN RzAnalysisMatchResult *analysis_match_result_new(RZ_NONNULL RzAnal
 		RZ_LOG_ERROR("analysis_match: cannot initialize search context\n");
 		goto fail;
 	}
+	shared.index = index;
 
 	pool_size = rz_th_pool_size(pool);
 	RZ_LOG_VERBOSE("analysis_match: using %u threads\n", (ut32)pool_size);
@@ -322,6 +386,7 @@ static RZ_OWN RzAnalysisMatchResult *analysis_match_result_new(RZ_NONNULL RzAnal
 	result->matches = rz_th_queue_pop_all(shared.matches);
 	result->unmatch_a = rz_th_queue_pop_all(shared.unmatch);
 	result->unmatch_b = unmatch_b;
+	result->n_compared = shared.n_compared;
 
 	if (user_thread) {
 		rz_th_wait(user_thread);
@@ -369,6 +434,7 @@ static void *analysis_match_basic_blocks(SharedContext *shared) {
 	RzAnalysisMatchPair *pair = NULL;
 	ut32 size_a = 0, size_b = 0;
 	ut8 *buf_a = NULL, *buf_b = NULL;
+	ut64 n_compared = 0;
 
 	while (rz_atomic_bool_get(shared->loop) && (bb_a = rz_th_queue_pop(shared->queue, false))) {
 		if (!shared_context_alloc_a(shared, bb_a, &buf_a, &size_a)) {
@@ -387,10 +453,11 @@ static void *analysis_match_basic_blocks(SharedContext *shared) {
 				continue;
 			}
 
-			calc_similarity = calculate_similarity(buf_a, size_a, buf_b, size_b);
+			calc_similarity = calculate_similarity(buf_a, size_a, buf_b, size_b, similarity_max_distance(size_a, size_b, max_similarity));
 			free(buf_b);
+			n_compared++;
 
-			if (calc_similarity < RZ_ANALYSIS_SIMILARITY_THRESHOLD && calc_similarity <= max_similarity) {
+			if (!similarity_is_better(calc_similarity, max_similarity)) {
 				continue;
 			}
 			max_similarity = calc_similarity;
@@ -408,6 +475,7 @@ static void *analysis_match_basic_blocks(SharedContext *shared) {
 		rz_th_queue_push(shared->unmatch, bb_a, true);
 	}
 
+	shared_context_add_compared(shared, n_compared);
 	return NULL;
 }
 
@@ -443,7 +511,7 @@ RZ_API RZ_OWN RzAnalysisMatchResult *rz_analysis_match_basic_blocks(RZ_NONNULL R
 		rz_list_append(list_b, *it);
 	}
 
-	RzAnalysisMatchResult *res = analysis_match_result_new(opt, list_a, list_b, (RzThreadFunction)analysis_match_basic_blocks, (AllocateBuffer)basic_block_data_new);
+	RzAnalysisMatchResult *res = analysis_match_result_new(opt, list_a, list_b, (RzThreadFunction)analysis_match_basic_blocks, (AllocateBuffer)basic_block_data_new, NULL);
 	rz_list_free(list_a);
 	rz_list_free(list_b);
 	return res;
@@ -460,13 +528,48 @@ static bool function_name_cmp(RzAnalysisFunction *fcn_a, RzAnalysisFunction *fcn
 	return !strcmp(fcn_a->name, fcn_b->name);
 }
 
+/**
+ * \brief Compares \p fcn_a with \p fcn_b and updates the best match found so far
+ *
+ * \return true when the search of a match for \p fcn_a is over
+ */
+static bool match_function_pair(SharedContext *shared, RzAnalysisFunction *fcn_a, const ut8 *buf_a, ut32 size_a, RzAnalysisFunction *fcn_b, double *max_similarity, RzAnalysisFunction **match) {
+	ut32 size_b = 0;
+	ut8 *buf_b = NULL;
+	if (!shared_context_alloc_b(shared, fcn_b, &buf_b, &size_b)) {
+		RZ_LOG_ERROR("analysis_match: cannot allocate buffer for function %s (B)\n", fcn_b->name);
+		return false;
+	}
+
+	// functions with the same name are always matched and need the exact similarity
+	bool same_name = function_name_cmp(fcn_a, fcn_b);
+	ut32 max_distance = same_name ? UT32_MAX : similarity_max_distance(size_a, size_b, *max_similarity);
+	double calc_similarity = calculate_similarity(buf_a, size_a, buf_b, size_b, max_distance);
+	free(buf_b);
+
+	if (same_name) {
+		*max_similarity = calc_similarity;
+		*match = fcn_b;
+		return true;
+	} else if (!similarity_is_better(calc_similarity, *max_similarity)) {
+		return false;
+	}
+	*max_similarity = calc_similarity;
+	*match = fcn_b;
+	return *max_similarity >= 1.0;
+}
+
 static void *analysis_match_functions(SharedContext *shared) {
-	double max_similarity = 0.0, calc_similarity = 0.0;
+	double max_similarity = 0.0;
 	const RzListIter *iter = NULL;
 	RzAnalysisFunction *fcn_a = NULL, *fcn_b = NULL, *match = NULL;
 	RzAnalysisMatchPair *pair = NULL;
-	ut32 size_a = 0, size_b = 0;
-	ut8 *buf_a = NULL, *buf_b = NULL;
+	ut32 size_a = 0;
+	ut8 *buf_a = NULL;
+	ut32 *idx;
+	ut64 n_compared = 0;
+	RzVector empty;
+	rz_vector_init(&empty, sizeof(ut32), NULL, NULL);
 
 	while (rz_atomic_bool_get(shared->loop) && (fcn_a = rz_th_queue_pop(shared->queue, false))) {
 		if (!shared_context_alloc_a(shared, fcn_a, &buf_a, &size_a)) {
@@ -477,28 +580,29 @@ static void *analysis_match_functions(SharedContext *shared) {
 
 		match = NULL;
 		max_similarity = 0.0;
-		rz_list_foreach (shared->list_b, iter, fcn_b) {
-			if (!rz_atomic_bool_get(shared->loop)) {
-				break;
-			} else if (!shared_context_alloc_b(shared, fcn_b, &buf_b, &size_b)) {
-				RZ_LOG_ERROR("analysis_match: cannot allocate buffer for function %s (B)\n", fcn_b->name);
-				continue;
+		if (shared->index) {
+			RzVector *candidates = ht_up_find(shared->index->candidates, (ut64)(size_t)fcn_a, NULL);
+			if (!candidates) {
+				candidates = &empty;
 			}
-
-			calc_similarity = calculate_similarity(buf_a, size_a, buf_b, size_b);
-			free(buf_b);
-
-			if (function_name_cmp(fcn_a, fcn_b)) {
-				max_similarity = calc_similarity;
-				match = fcn_b;
-				break;
-			} else if (calc_similarity < RZ_ANALYSIS_SIMILARITY_THRESHOLD && calc_similarity <= max_similarity) {
-				continue;
+			rz_vector_foreach (candidates, idx) {
+				if (!rz_atomic_bool_get(shared->loop)) {
+					break;
+				}
+				n_compared++;
+				if (match_function_pair(shared, fcn_a, buf_a, size_a, shared->index->list_b[*idx], &max_similarity, &match)) {
+					break;
+				}
 			}
-			max_similarity = calc_similarity;
-			match = fcn_b;
-			if (max_similarity >= 1.0) {
-				break;
+		} else {
+			rz_list_foreach (shared->list_b, iter, fcn_b) {
+				if (!rz_atomic_bool_get(shared->loop)) {
+					break;
+				}
+				n_compared++;
+				if (match_function_pair(shared, fcn_a, buf_a, size_a, fcn_b, &max_similarity, &match)) {
+					break;
+				}
 			}
 		}
 		free(buf_a);
@@ -510,6 +614,7 @@ static void *analysis_match_functions(SharedContext *shared) {
 		rz_th_queue_push(shared->unmatch, fcn_a, true);
 	}
 
+	shared_context_add_compared(shared, n_compared);
 	return NULL;
 }
 
@@ -532,8 +637,9 @@ static void *analysis_match_one_function(SharedContext *shared) {
 			return NULL;
 		}
 
-		double similarity = calculate_similarity(buf_a, size_a, buf_b, size_b);
+		double similarity = calculate_similarity(buf_a, size_a, buf_b, size_b, UT32_MAX);
 		free(buf_a);
+		shared_context_add_compared(shared, 1);
 
 		if (!(pair = match_pair_new(fcn_a, fcn_b, similarity))) {
 			RZ_LOG_ERROR("analysis_match: cannot allocate match pair\n");
@@ -547,9 +653,246 @@ static void *analysis_match_one_function(SharedContext *shared) {
 	return NULL;
 }
 
+#define MATCH_MINHASH_BITS 5
+#define MATCH_MINHASH_SIZE (1 << MATCH_MINHASH_BITS)
+#define MATCH_NGRAM_SIZE   4
+
+typedef struct function_fingerprint_t {
+	ut32 size; ///< Size of the function bytes, 0 when they could not be read
+	ut32 n_blocks;
+	ut32 n_edges;
+	ut64 minhash[MATCH_MINHASH_SIZE];
+} FunctionFingerprint;
+
+static inline ut64 fingerprint_mix(ut64 x) {
+	// splitmix64 finalizer
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ull;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebull;
+	x ^= x >> 31;
+	return x;
+}
+
+/**
+ * \brief Computes the MinHash signature of the byte n-grams of \p buf
+ *
+ * Uses one permutation hashing: every n-gram is hashed once, the top bits
+ * of the hash select a bin and each bin keeps its minimum. Empty bins then
+ * borrow the value of the next non empty bin (densification), so that the
+ * probability of two signatures having the same value in a bin is still
+ * the Jaccard similarity of their n-gram sets.
+ */
+static void fingerprint_minhash(const ut8 *buf, ut32 size, ut64 *minhash) {
+	ut64 bins[MATCH_MINHASH_SIZE];
+	for (ut32 k = 0; k < MATCH_MINHASH_SIZE; k++) {
+		bins[k] = UT64_MAX;
+	}
+	ut32 n_grams = size >= MATCH_NGRAM_SIZE ? size - MATCH_NGRAM_SIZE + 1 : 1;
+	for (ut32 i = 0; i < n_grams; i++) {
+		ut64 gram = 0;
+		if (size >= MATCH_NGRAM_SIZE) {
+			gram = rz_read_le32(buf + i);
+		} else {
+			// a single, shorter n-gram; the size keeps it apart from the longer ones
+			gram = (ut64)size << 32;
+			for (ut32 j = 0; j < size; j++) {
+				gram |= (ut64)buf[j] << (8 * j);
+			}
+		}
+		ut64 h = fingerprint_mix(gram);
+		ut32 bin = h >> (64 - MATCH_MINHASH_BITS);
+		ut64 value = h & (UT64_MAX >> MATCH_MINHASH_BITS);
+		if (value < bins[bin]) {
+			bins[bin] = value;
+		}
+	}
+	for (ut32 k = 0; k < MATCH_MINHASH_SIZE; k++) {
+		minhash[k] = bins[k];
+		for (ut32 d = 1; minhash[k] == UT64_MAX && d < MATCH_MINHASH_SIZE; d++) {
+			ut64 next = bins[(k + d) % MATCH_MINHASH_SIZE];
+			if (next != UT64_MAX) {
+				minhash[k] = fingerprint_mix(next + d);
+			}
+		}
+	}
+}
+
+static void fingerprint_init(RzAnalysis *analysis, RzAnalysisFunction *fcn, FunctionFingerprint *fp) {
+	ut8 *buf = NULL;
+	ut32 size = 0;
+	memset(fp, 0, sizeof(FunctionFingerprint));
+	fp->n_blocks = rz_pvector_len(fcn->bbs);
+	fp->n_edges = rz_analysis_function_count_edges(fcn, NULL);
+	if (!function_data_new(analysis, fcn, &buf, &size)) {
+		return;
+	}
+	fp->size = size;
+	fingerprint_minhash(buf, size, fp->minhash);
+	free(buf);
+}
+
+static ut64 fingerprint_band_key(const FunctionFingerprint *fp, ut32 band, ut32 rows) {
+	ut64 key = fingerprint_mix(band + 1);
+	for (ut32 r = 0; r < rows; r++) {
+		key = fingerprint_mix(key ^ fp->minhash[band * rows + r]);
+	}
+	return key;
+}
+
+static ut64 fingerprint_shape_key(const FunctionFingerprint *fp) {
+	// shares the buckets table with the band keys; a collision only adds candidates
+	return fingerprint_mix(fingerprint_mix(fingerprint_mix(fp->size) ^ fp->n_blocks) ^ fp->n_edges);
+}
+
+static bool bucket_add(HtUP *buckets, ut64 key, ut32 idx) {
+	RzVector *bucket = ht_up_find(buckets, key, NULL);
+	if (!bucket) {
+		bucket = rz_vector_new(sizeof(ut32), NULL, NULL);
+		if (!bucket || !ht_up_insert(buckets, key, bucket)) {
+			rz_vector_free(bucket);
+			return false;
+		}
+	}
+	return rz_vector_push(bucket, &idx);
+}
+
+static void bucket_collect(HtUP *buckets, ut64 key, ut32 *stamps, ut32 stamp, RzVector *out) {
+	RzVector *bucket = ht_up_find(buckets, key, NULL);
+	ut32 *idx;
+	if (!bucket) {
+		return;
+	}
+	rz_vector_foreach (bucket, idx) {
+		if (stamps[*idx] != stamp) {
+			stamps[*idx] = stamp;
+			rz_vector_push(out, idx);
+		}
+	}
+}
+
+static int index_cmp(const void *a, const void *b, void *user) {
+	ut32 x = *(const ut32 *)a, y = *(const ut32 *)b;
+	return x < y ? -1 : (x > y);
+}
+
+static void function_index_free(FunctionIndex *index) {
+	if (!index) {
+		return;
+	}
+	ht_up_free(index->candidates);
+	free(index->list_b);
+	free(index);
+}
+
+/**
+ * \brief Selects for each function of \p list_a the functions of \p list_b worth comparing
+ *
+ * A function of B is a candidate when it has the same name, or the same
+ * size and number of blocks and edges, or when the sizes allow a similarity
+ * above the threshold and their MinHash signatures are equal in at least
+ * one band of \p rows values (locality-sensitive hashing). Fewer rows per
+ * band give more candidates, so more matches are found at a higher cost.
+ */
+static FunctionIndex *function_index_new(RzAnalysisMatchOpt *opt, RzList /*<RzAnalysisFunction *>*/ *list_a, RzList /*<RzAnalysisFunction *>*/ *list_b, ut32 rows) {
+	const ut32 bands = MATCH_MINHASH_SIZE / rows;
+	const ut32 n_b = rz_list_length(list_b);
+	FunctionIndex *index = RZ_NEW0(FunctionIndex);
+	FunctionFingerprint *fps_b = RZ_NEWS0(FunctionFingerprint, n_b + 1);
+	ut32 *stamps = RZ_NEWS0(ut32, n_b + 1);
+	HtUP *buckets = ht_up_new(NULL, (HtUPFreeValue)rz_vector_free);
+	HtSU *names = ht_su_new(HT_STR_CONST);
+	RzAnalysisFunction *fcn;
+	RzListIter *iter;
+	ut32 i = 0;
+	if (!index || !fps_b || !stamps || !buckets || !names ||
+		!(index->list_b = RZ_NEWS0(RzAnalysisFunction *, n_b + 1)) ||
+		!(index->candidates = ht_up_new(NULL, (HtUPFreeValue)rz_vector_free))) {
+		goto fail;
+	}
+
+	index->n_b = n_b;
+	rz_list_foreach (list_b, iter, fcn) {
+		FunctionFingerprint *fp = &fps_b[i];
+		index->list_b[i] = fcn;
+		fingerprint_init(opt->analysis_b, fcn, fp);
+		if (RZ_STR_ISNOTEMPTY(fcn->name) && strncmp(fcn->name, "fcn.", strlen("fcn."))) {
+			// only the first one can match, see function_name_cmp()
+			ht_su_insert(names, fcn->name, i);
+		}
+		if (fp->size) {
+			if (!bucket_add(buckets, fingerprint_shape_key(fp), i)) {
+				goto fail;
+			}
+			for (ut32 band = 0; band < bands; band++) {
+				if (!bucket_add(buckets, fingerprint_band_key(fp, band, rows), i)) {
+					goto fail;
+				}
+			}
+		}
+		i++;
+	}
+
+	ut32 stamp = 0;
+	rz_list_foreach (list_a, iter, fcn) {
+		FunctionFingerprint fp;
+		RzVector *candidates = rz_vector_new(sizeof(ut32), NULL, NULL);
+		if (!candidates || !ht_up_insert(index->candidates, (ut64)(size_t)fcn, candidates)) {
+			rz_vector_free(candidates);
+			goto fail;
+		}
+		stamp++;
+		bool found = false;
+		ut32 named = RZ_STR_ISNOTEMPTY(fcn->name) ? (ut32)ht_su_find(names, fcn->name, &found) : 0;
+		if (found) {
+			stamps[named] = stamp;
+			rz_vector_push(candidates, &named);
+		}
+		fingerprint_init(opt->analysis_a, fcn, &fp);
+		if (!fp.size) {
+			continue;
+		}
+		bucket_collect(buckets, fingerprint_shape_key(&fp), stamps, stamp, candidates);
+		size_t n_shape = rz_vector_len(candidates);
+		for (ut32 band = 0; band < bands; band++) {
+			bucket_collect(buckets, fingerprint_band_key(&fp, band, rows), stamps, stamp, candidates);
+		}
+		// the distance is at least the size difference
+		for (size_t c = rz_vector_len(candidates); c > n_shape; c--) {
+			const FunctionFingerprint *fp_b = &fps_b[*(ut32 *)rz_vector_index_ptr(candidates, c - 1)];
+			if (RZ_MIN(fp.size, fp_b->size) < RZ_ANALYSIS_SIMILARITY_THRESHOLD * RZ_MAX(fp.size, fp_b->size)) {
+				rz_vector_remove_at(candidates, c - 1, NULL);
+			}
+		}
+		// keep the order of list B, as the exhaustive search does
+		if (rz_vector_len(candidates) > 1) {
+			rz_vector_sort(candidates, index_cmp, false, NULL);
+		}
+	}
+
+	ht_su_free(names);
+	ht_up_free(buckets);
+	free(stamps);
+	free(fps_b);
+	return index;
+
+fail:
+	RZ_LOG_ERROR("analysis_match: cannot build the function index\n");
+	ht_su_free(names);
+	ht_up_free(buckets);
+	free(stamps);
+	free(fps_b);
+	function_index_free(index);
+	return NULL;
+}
+
 /**
  * \brief      Finds matching functions of 2 given lists of functions using the same RzAnalysis core
  *
+ * When RzAnalysisMatchOpt.lsh_rows is set, each function of list A is only compared
+ * with the candidates selected by a locality-sensitive hashing index of the
+ * functions of list B instead of every function in it.
+ *
  * \param      list_a  The input list A of functions
  * \param      list_b  The input list B of functions
  * \param      opt     The RzAnalysisMatchOpt struct to use
@@ -559,9 +902,22 @@ static void *analysis_match_one_function(SharedContext *shared) {
 RZ_API RZ_OWN RzAnalysisMatchResult *rz_analysis_match_functions(RzList /*<RzAnalysisFunction *>*/ *list_a, RzList /*<RzAnalysisFunction *>*/ *list_b, RZ_NONNULL RzAnalysisMatchOpt *opt) {
 	rz_return_val_if_fail(opt && opt->analysis_a && opt->analysis_b && list_a && list_b, NULL);
 	if (rz_list_length(list_a) == 1) {
-		return analysis_match_result_new(opt, list_b, list_a, (RzThreadFunction)analysis_match_one_function, (AllocateBuffer)function_data_new);
+		return analysis_match_result_new(opt, list_b, list_a, (RzThreadFunction)analysis_match_one_function, (AllocateBuffer)function_data_new, NULL);
+	}
+	if (!opt->lsh_rows) {
+		return analysis_match_result_new(opt, list_a, list_b, (RzThreadFunction)analysis_match_functions, (AllocateBuffer)function_data_new, NULL);
+	}
+	if (opt->lsh_rows > MATCH_MINHASH_SIZE) {
+		RZ_LOG_ERROR("analysis_match: the number of LSH rows must be between 1 and %d\n", MATCH_MINHASH_SIZE);
+		return NULL;
+	}
+	FunctionIndex *index = function_index_new(opt, list_a, list_b, opt->lsh_rows);
+	if (!index) {
+		return NULL;
 	}
-	return analysis_match_result_new(opt, list_a, list_b, (RzThreadFunction)analysis_match_functions, (AllocateBuffer)function_data_new);
+	RzAnalysisMatchResult *res = analysis_match_result_new(opt, list_a, list_b, (RzThreadFunction)analysis_match_functions, (AllocateBuffer)function_data_new, index);
+	function_index_free(index);
+	return res;
 }
 
 /**
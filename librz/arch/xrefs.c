@@ -6,6 +6,7 @@
 
 #include <rz_analysis.h>
 #include <rz_cons.h>
+#include "analysis_private.h"
 
 /*
 DICT
@@ -20,88 +21,410 @@ xrefs 20->[10 C] 10 -> [16 J, 20 C]
 // TODO: is it possible to have multiple type for the same (from, to) pair?
 //       if it is, things need to be adjusted
 
-static RzAnalysisXRef *rz_analysis_xref_new(ut64 from, ut64 to, ut64 type) {
-	RzAnalysisXRef *xref = RZ_NEW(RzAnalysisXRef);
-	if (xref) {
-		xref->from = from;
-		xref->to = to;
-		xref->type = (type == -1) ? RZ_ANALYSIS_XREF_TYPE_CODE : type;
+#define XREFS_CHUNK_SIZE   256
+#define XREFS_PENDING_SIZE 1024
+
+/**
+ * A sorted run of xrefs of one index, stored by columns: key is the
+ * `from` address in the forward index and the `to` address in the reverse one.
+ */
+typedef struct xrefs_chunk_t {
+	size_t length;
+	ut64 key[XREFS_CHUNK_SIZE];
+	ut64 other[XREFS_CHUNK_SIZE];
+	ut8 type[XREFS_CHUNK_SIZE];
+} XRefsChunk;
+
+/**
+ * Array of xrefs sorted by (key, other), split in chunks
+ * so that insertions only move the entries of one chunk.
+ */
+typedef struct xrefs_index_t {
+	RzPVector /*<XRefsChunk *>*/ chunks;
+	size_t count;
+} XRefsIndex;
+
+typedef struct xrefs_pos_t {
+	size_t chunk;
+	size_t pos;
+} XRefsPos;
+
+typedef struct xrefs_pending_t {
+	RzAnalysisXRef xref;
+	size_t seq; ///< Insertion order, the last set of a (from, to) pair wins
+	bool failed; ///< Could not be added to the forward index
+	int prev_type; ///< Type of the pair in the forward index before the flush, -1 if it was not there
+} XRefsPending;
+
+struct rz_analysis_xrefs_t {
+	XRefsIndex from; ///< All the xrefs sorted by (from, to)
+	XRefsIndex to; ///< All the xrefs sorted by (to, from)
+	RzVector /*<XRefsPending>*/ pending; ///< Xrefs set since the last flush, merged by the readers
+	ut64 pending_min[2]; ///< Lowest from (0) and to (1) address of the pending xrefs
+	ut64 pending_max[2]; ///< Highest from (0) and to (1) address of the pending xrefs
+	ut64 version; ///< Increased on every change, used to detect changes while iterating
+};
+
+static inline int pair_cmp(ut64 a_key, ut64 a_other, ut64 b_key, ut64 b_other) {
+	if (a_key != b_key) {
+		return a_key < b_key ? -1 : 1;
 	}
-	return xref;
+	if (a_other != b_other) {
+		return a_other < b_other ? -1 : 1;
+	}
+	return 0;
 }
 
-static void rz_analysis_xref_free(RzAnalysisXRef *xref) {
-	free(xref);
+static void xrefs_index_init(XRefsIndex *idx) {
+	rz_pvector_init(&idx->chunks, free);
+	idx->count = 0;
 }
 
-RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_xref_list_new() {
-	return rz_list_newf((RzListFree)free);
+static void xrefs_index_fini(XRefsIndex *idx) {
+	rz_pvector_fini(&idx->chunks);
+	idx->count = 0;
 }
 
-static bool appendRef(void *u, const ut64 k, const void *v) {
-	RzList *list = (RzList *)u;
-	RzAnalysisXRef *xref = (RzAnalysisXRef *)v;
-	RzAnalysisXRef *cloned = rz_analysis_xref_new(xref->from, xref->to, xref->type);
-	if (cloned) {
-		rz_list_append(list, cloned);
-		return true;
+/**
+ * Returns the position of the first entry >= (key, other);
+ * the chunk is the number of chunks when there is none.
+ */
+static XRefsPos xrefs_index_lower_bound(XRefsIndex *idx, ut64 key, ut64 other) {
+	XRefsPos res = { 0 };
+	size_t lo = 0, hi = rz_pvector_len(&idx->chunks);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		XRefsChunk *chunk = rz_pvector_at(&idx->chunks, mid);
+		size_t last = chunk->length - 1;
+		if (pair_cmp(chunk->key[last], chunk->other[last], key, other) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	res.chunk = lo;
+	if (lo == rz_pvector_len(&idx->chunks)) {
+		return res;
 	}
-	return false;
+	XRefsChunk *chunk = rz_pvector_at(&idx->chunks, lo);
+	hi = chunk->length;
+	lo = 0;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (pair_cmp(chunk->key[mid], chunk->other[mid], key, other) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	res.pos = lo;
+	return res;
 }
 
-static bool mylistrefs_cb(void *list, const ut64 k, const void *v) {
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach(ht, appendRef, list);
+/**
+ * Sets the type of (key, other), adding the entry if needed.
+ * \p prev_type is set to the previous type, or -1 if the entry is new.
+ */
+static bool xrefs_index_set(XRefsIndex *idx, ut64 key, ut64 other, RzAnalysisXRefType type, RZ_NULLABLE int *prev_type) {
+	XRefsChunk *chunk;
+	XRefsPos p = { 0 };
+	if (prev_type) {
+		*prev_type = -1;
+	}
+	if (rz_pvector_empty(&idx->chunks)) {
+		chunk = RZ_NEW0(XRefsChunk);
+		if (!chunk || !rz_pvector_push(&idx->chunks, chunk)) {
+			free(chunk);
+			return false;
+		}
+	} else {
+		p = xrefs_index_lower_bound(idx, key, other);
+		if (p.chunk == rz_pvector_len(&idx->chunks)) {
+			// greater than all the entries, append it to the last chunk
+			p.chunk--;
+			p.pos = ((XRefsChunk *)rz_pvector_at(&idx->chunks, p.chunk))->length;
+		}
+		chunk = rz_pvector_at(&idx->chunks, p.chunk);
+		if (p.pos < chunk->length && chunk->key[p.pos] == key && chunk->other[p.pos] == other) {
+			if (prev_type) {
+				*prev_type = chunk->type[p.pos];
+			}
+			chunk->type[p.pos] = type;
+			return true;
+		}
+	}
+
+	if (chunk->length == XREFS_CHUNK_SIZE) {
+		const size_t half = XREFS_CHUNK_SIZE / 2;
+		XRefsChunk *right = RZ_NEW(XRefsChunk);
+		if (!right || !rz_pvector_insert(&idx->chunks, p.chunk + 1, right)) {
+			free(right);
+			return false;
+		}
+		right->length = XREFS_CHUNK_SIZE - half;
+		memcpy(right->key, chunk->key + half, right->length * sizeof(ut64));
+		memcpy(right->other, chunk->other + half, right->length * sizeof(ut64));
+		memcpy(right->type, chunk->type + half, right->length);
+		chunk->length = half;
+		if (p.pos > half) {
+			chunk = right;
+			p.pos -= half;
+		}
+	}
+
+	size_t tail = chunk->length - p.pos;
+	memmove(chunk->key + p.pos + 1, chunk->key + p.pos, tail * sizeof(ut64));
+	memmove(chunk->other + p.pos + 1, chunk->other + p.pos, tail * sizeof(ut64));
+	memmove(chunk->type + p.pos + 1, chunk->type + p.pos, tail);
+	chunk->key[p.pos] = key;
+	chunk->other[p.pos] = other;
+	chunk->type[p.pos] = type;
+	chunk->length++;
+	idx->count++;
 	return true;
 }
 
-static int ref_cmp(const RzAnalysisXRef *a, const RzAnalysisXRef *b, void *user) {
-	if (a->from < b->from) {
-		return -1;
+static bool xrefs_index_has(XRefsIndex *idx, ut64 key, ut64 other) {
+	XRefsPos p = xrefs_index_lower_bound(idx, key, other);
+	if (p.chunk == rz_pvector_len(&idx->chunks)) {
+		return false;
 	}
-	if (a->from > b->from) {
-		return 1;
+	XRefsChunk *chunk = rz_pvector_at(&idx->chunks, p.chunk);
+	return chunk->key[p.pos] == key && chunk->other[p.pos] == other;
+}
+
+static bool xrefs_index_del(XRefsIndex *idx, ut64 key, ut64 other) {
+	XRefsPos p = xrefs_index_lower_bound(idx, key, other);
+	if (p.chunk == rz_pvector_len(&idx->chunks)) {
+		return false;
 	}
-	if (a->to < b->to) {
-		return -1;
+	XRefsChunk *chunk = rz_pvector_at(&idx->chunks, p.chunk);
+	if (chunk->key[p.pos] != key || chunk->other[p.pos] != other) {
+		return false;
 	}
-	if (a->to > b->to) {
-		return 1;
+	size_t tail = chunk->length - p.pos - 1;
+	memmove(chunk->key + p.pos, chunk->key + p.pos + 1, tail * sizeof(ut64));
+	memmove(chunk->other + p.pos, chunk->other + p.pos + 1, tail * sizeof(ut64));
+	memmove(chunk->type + p.pos, chunk->type + p.pos + 1, tail);
+	chunk->length--;
+	idx->count--;
+	if (!chunk->length) {
+		free(rz_pvector_remove_at(&idx->chunks, p.chunk));
 	}
-	return 0;
+	return true;
 }
 
-static void sortxrefs(RzList /*<RzAnalysisXRef *>*/ *list) {
-	rz_list_sort(list, (RzListComparator)ref_cmp, NULL);
+static int pending_from_cmp(const XRefsPending *a, const XRefsPending *b, void *user) {
+	int ret = pair_cmp(a->xref.from, a->xref.to, b->xref.from, b->xref.to);
+	return ret ? ret : pair_cmp(a->seq, 0, b->seq, 0);
 }
 
-static void listxrefs(HtUP *m, ut64 addr, RzList /*<RzAnalysisXRef *>*/ *list) {
-	if (addr == UT64_MAX) {
-		ht_up_foreach(m, mylistrefs_cb, list);
-	} else {
-		HtUP *d = ht_up_find(m, addr, NULL);
-		if (d) {
-			ht_up_foreach(d, appendRef, list);
+static int pending_to_cmp(const XRefsPending *a, const XRefsPending *b, void *user) {
+	int ret = pair_cmp(a->xref.to, a->xref.from, b->xref.to, b->xref.from);
+	return ret ? ret : pair_cmp(a->seq, 0, b->seq, 0);
+}
+
+static bool pending_same_pair(const XRefsPending *a, const XRefsPending *b) {
+	return a->xref.from == b->xref.from && a->xref.to == b->xref.to;
+}
+
+/**
+ * Sorts \p pending with \p cmp and keeps only the last set of every (from, to) pair
+ */
+static void pending_sort_unique(RzVector /*<XRefsPending>*/ *pending, RzVectorComparator cmp) {
+	rz_vector_sort(pending, cmp, false, NULL);
+	size_t len = rz_vector_len(pending);
+	size_t n = 0;
+	for (size_t i = 0; i < len; i++) {
+		XRefsPending *cur = rz_vector_index_ptr(pending, i);
+		if (i + 1 < len && pending_same_pair(cur, rz_vector_index_ptr(pending, i + 1))) {
+			continue;
 		}
+		if (n != i) {
+			rz_vector_assign_at(pending, n, cur);
+		}
+		n++;
 	}
+	rz_vector_remove_range(pending, n, len - n, NULL);
 }
 
-static bool set_xref(HtUP *m, RzAnalysisXRef *xref, bool from2to) {
-	ut64 key1 = from2to ? xref->from : xref->to;
-	HtUP *ht = ht_up_find(m, key1, NULL);
-	if (!ht) {
-		// RzAnalysis::ht_xrefs_to is responsible for releasing of pointers.
-		HtUPFreeValue cb = from2to ? NULL : (HtUPFreeValue)rz_analysis_xref_free;
-		ht = ht_up_new(NULL, cb);
-		if (!ht) {
-			return false;
+static void pending_reset(RzAnalysisXRefs *xrefs) {
+	rz_vector_clear(&xrefs->pending);
+	xrefs->pending_min[0] = xrefs->pending_min[1] = UT64_MAX;
+	xrefs->pending_max[0] = xrefs->pending_max[1] = 0;
+}
+
+/**
+ * Moves the pending xrefs into the indexes. They are sorted first,
+ * so that consecutive insertions hit the same chunks.
+ * Only called by the functions changing the xrefs, the readers merge
+ * the pending xrefs instead.
+ */
+static bool xrefs_flush(RzAnalysisXRefs *xrefs) {
+	if (rz_vector_empty(&xrefs->pending)) {
+		return true;
+	}
+	bool res = true;
+	XRefsPending *it;
+	pending_sort_unique(&xrefs->pending, (RzVectorComparator)pending_from_cmp);
+	rz_vector_foreach (&xrefs->pending, it) {
+		if (!xrefs_index_set(&xrefs->from, it->xref.from, it->xref.to, it->xref.type, &it->prev_type)) {
+			it->failed = true;
+			res = false;
 		}
-		if (!ht_up_insert(m, key1, ht)) {
-			return false;
+	}
+	rz_vector_sort(&xrefs->pending, (RzVectorComparator)pending_to_cmp, false, NULL);
+	rz_vector_foreach (&xrefs->pending, it) {
+		if (it->failed || xrefs_index_set(&xrefs->to, it->xref.to, it->xref.from, it->xref.type, NULL)) {
+			continue;
+		}
+		// undo the forward insertion, keeping the xref that was there before
+		if (it->prev_type < 0) {
+			xrefs_index_del(&xrefs->from, it->xref.from, it->xref.to);
+		} else {
+			xrefs_index_set(&xrefs->from, it->xref.from, it->xref.to, it->prev_type, NULL);
+		}
+		res = false;
+	}
+	pending_reset(xrefs);
+	return res;
+}
+
+static inline ut64 xref_key(const RzAnalysisXRef *xref, bool by_from) {
+	return by_from ? xref->from : xref->to;
+}
+
+static inline ut64 xref_other(const RzAnalysisXRef *xref, bool by_from) {
+	return by_from ? xref->to : xref->from;
+}
+
+/**
+ * Appends to \p out the pending xrefs with (key, other) >= (\p key, \p other)
+ * and key <= \p last, sorted like the index and with only the last set of every pair.
+ */
+static void pending_collect(RzAnalysisXRefs *xrefs, bool by_from, ut64 key, ut64 other, ut64 last, RzVector /*<XRefsPending>*/ *out) {
+	if (rz_vector_empty(&xrefs->pending) || key > xrefs->pending_max[!by_from] || last < xrefs->pending_min[!by_from]) {
+		return;
+	}
+	XRefsPending *it;
+	rz_vector_foreach (&xrefs->pending, it) {
+		ut64 k = xref_key(&it->xref, by_from);
+		if (k > last || pair_cmp(k, xref_other(&it->xref, by_from), key, other) < 0) {
+			continue;
 		}
+		rz_vector_push(out, it);
 	}
-	ut64 key2 = from2to ? xref->to : xref->from;
-	return ht_up_update(ht, key2, xref);
+	pending_sort_unique(out, (RzVectorComparator)(by_from ? pending_from_cmp : pending_to_cmp));
+}
+
+/**
+ * Calls \p cb on the xrefs with key in [begin, last], merging the
+ * entries of the index with the pending ones.
+ * The callback may change the xrefs: the iteration then continues
+ * after the last visited entry.
+ */
+static bool xrefs_index_foreach(RzAnalysisXRefs *xrefs, bool by_from, ut64 begin, ut64 last, RzAnalysisXRefCb cb, void *user) {
+	XRefsIndex *idx = by_from ? &xrefs->from : &xrefs->to;
+	RzVector pending;
+	rz_vector_init(&pending, sizeof(XRefsPending), NULL, NULL);
+	ut64 key = begin;
+	ut64 other = 0;
+	bool ret = true;
+	bool restart = true;
+	while (restart) {
+		restart = false;
+		ut64 version = xrefs->version;
+		rz_vector_clear(&pending);
+		pending_collect(xrefs, by_from, key, other, last, &pending);
+		size_t next_pending = 0;
+		XRefsPos p = xrefs_index_lower_bound(idx, key, other);
+		while (true) {
+			XRefsChunk *chunk = NULL;
+			while (p.chunk < rz_pvector_len(&idx->chunks)) {
+				chunk = rz_pvector_at(&idx->chunks, p.chunk);
+				if (p.pos < chunk->length) {
+					break;
+				}
+				chunk = NULL;
+				p.chunk++;
+				p.pos = 0;
+			}
+			if (chunk && chunk->key[p.pos] > last) {
+				chunk = NULL;
+			}
+			XRefsPending *pe = next_pending < rz_vector_len(&pending) ? rz_vector_index_ptr(&pending, next_pending) : NULL;
+			if (!chunk && !pe) {
+				break;
+			}
+			int cmp = !chunk ? 1 : !pe ? -1 : pair_cmp(chunk->key[p.pos], chunk->other[p.pos], xref_key(&pe->xref, by_from), xref_other(&pe->xref, by_from));
+			RzAnalysisXRef xref;
+			if (cmp < 0) {
+				xref.from = by_from ? chunk->key[p.pos] : chunk->other[p.pos];
+				xref.to = by_from ? chunk->other[p.pos] : chunk->key[p.pos];
+				xref.type = chunk->type[p.pos];
+				p.pos++;
+			} else {
+				// the pending xref replaces the one of the index
+				xref = pe->xref;
+				next_pending++;
+				if (!cmp) {
+					p.pos++;
+				}
+			}
+			key = xref_key(&xref, by_from);
+			other = xref_other(&xref, by_from);
+			if (!cb(&xref, user)) {
+				ret = false;
+				break;
+			}
+			if (xrefs->version == version) {
+				continue;
+			}
+			if (other == UT64_MAX) {
+				if (key == last) {
+					break;
+				}
+				key++;
+			}
+			other++;
+			restart = true;
+			break;
+		}
+	}
+	rz_vector_fini(&pending);
+	return ret;
+}
+
+static RzAnalysisXRef *rz_analysis_xref_new(ut64 from, ut64 to, ut64 type) {
+	RzAnalysisXRef *xref = RZ_NEW(RzAnalysisXRef);
+	if (xref) {
+		xref->from = from;
+		xref->to = to;
+		xref->type = (type == -1) ? RZ_ANALYSIS_XREF_TYPE_CODE : type;
+	}
+	return xref;
+}
+
+RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_xref_list_new() {
+	return rz_list_newf((RzListFree)free);
+}
+
+static bool append_xref_cb(const RzAnalysisXRef *xref, void *user) {
+	RzList *list = (RzList *)user;
+	RzAnalysisXRef *cloned = rz_analysis_xref_new(xref->from, xref->to, xref->type);
+	if (!cloned || !rz_list_append(list, cloned)) {
+		free(cloned);
+		return false;
+	}
+	return true;
+}
+
+static int ref_cmp(const RzAnalysisXRef *a, const RzAnalysisXRef *b, void *user) {
+	return pair_cmp(a->from, a->to, b->from, b->to);
+}
+
+static void sortxrefs(RzList /*<RzAnalysisXRef *>*/ *list) {
+	rz_list_sort(list, (RzListComparator)ref_cmp, NULL);
 }
 
 // Set a cross reference from FROM to TO.
@@ -117,21 +440,25 @@ RZ_API bool rz_analysis_xrefs_set(RzAnalysis *analysis, ut64 from, ut64 to, RzAn
 			return false;
 		}
 	}
-	RzAnalysisXRef *xref = rz_analysis_xref_new(from, to, type);
-	if (!xref) {
+	RzAnalysisXRefs *xrefs = analysis->xrefs;
+	XRefsPending pending = {
+		.xref = {
+			.from = from,
+			.to = to,
+			.type = (type == -1) ? RZ_ANALYSIS_XREF_TYPE_CODE : type,
+		},
+		.seq = rz_vector_len(&xrefs->pending),
+	};
+	if (!rz_vector_push(&xrefs->pending, &pending)) {
 		return false;
 	}
-	if (!set_xref(analysis->ht_xrefs_from, xref, true)) {
-		// Pointer isn't added to <ht_xrefs_from> so we have to release it
-		rz_analysis_xref_free(xref);
-		return false;
-	}
-	if (!set_xref(analysis->ht_xrefs_to, xref, false)) {
-		// Delete the entry in <ht_xrefs_from>
-		rz_analysis_xrefs_deln(analysis, from, to, type);
-		// Pointer isn't added to <ht_xrefs_to> so we have to release it
-		rz_analysis_xref_free(xref);
-		return false;
+	xrefs->pending_min[0] = RZ_MIN(xrefs->pending_min[0], from);
+	xrefs->pending_max[0] = RZ_MAX(xrefs->pending_max[0], from);
+	xrefs->pending_min[1] = RZ_MIN(xrefs->pending_min[1], to);
+	xrefs->pending_max[1] = RZ_MAX(xrefs->pending_max[1], to);
+	xrefs->version++;
+	if (rz_vector_len(&xrefs->pending) >= XREFS_PENDING_SIZE) {
+		return xrefs_flush(xrefs);
 	}
 	return true;
 }
@@ -140,48 +467,73 @@ RZ_API bool rz_analysis_xrefs_deln(RzAnalysis *analysis, ut64 from, ut64 to, RzA
 	if (!analysis) {
 		return false;
 	}
-	HtUP *ht1 = ht_up_find(analysis->ht_xrefs_from, from, NULL);
-	if (ht1) {
-		ht_up_delete(ht1, to);
-	}
-	HtUP *ht2 = ht_up_find(analysis->ht_xrefs_to, to, NULL);
-	if (ht2) {
-		ht_up_delete(ht2, from);
-	}
+	RzAnalysisXRefs *xrefs = analysis->xrefs;
+	xrefs_flush(xrefs);
+	xrefs_index_del(&xrefs->from, from, to);
+	xrefs_index_del(&xrefs->to, to, from);
+	xrefs->version++;
 	return true;
 }
 
 RZ_API bool rz_analysis_xref_del(RzAnalysis *analysis, ut64 from, ut64 to) {
-	bool res = false;
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_NULL);
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_CODE);
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_CALL);
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_DATA);
-	res |= rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_STRING);
-	return res;
+	return rz_analysis_xrefs_deln(analysis, from, to, RZ_ANALYSIS_XREF_TYPE_NULL);
 }
 
-RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_xrefs_get_to(RzAnalysis *analysis, ut64 addr) {
-	RzList *list = rz_analysis_xref_list_new();
-	if (!list) {
-		return NULL;
+/**
+ * \brief Calls \p cb on all the xrefs, sorted by source and then destination address.
+ *
+ * No object is allocated for the visited xrefs; the pointer given to the
+ * callback is valid only during the call. The callback may add or remove xrefs.
+ *
+ * \param analysis RzAnalysis instance
+ * \param cb Callback, the iteration stops when it returns false
+ * \param user User pointer passed to \p cb
+ * \return false when the iteration was stopped by the callback, otherwise true
+ */
+RZ_API bool rz_analysis_xrefs_foreach(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisXRefCb cb, RZ_NULLABLE void *user) {
+	rz_return_val_if_fail(analysis && cb, false);
+	return xrefs_index_foreach(analysis->xrefs, true, 0, UT64_MAX, cb, user);
+}
+
+/**
+ * \brief Calls \p cb on the xrefs whose source address is in [begin, end),
+ * sorted by source and then destination address.
+ *
+ * \see rz_analysis_xrefs_foreach
+ */
+RZ_API bool rz_analysis_xrefs_foreach_from(RZ_NONNULL RzAnalysis *analysis, ut64 begin, ut64 end, RZ_NONNULL RzAnalysisXRefCb cb, RZ_NULLABLE void *user) {
+	rz_return_val_if_fail(analysis && cb, false);
+	if (begin >= end) {
+		return true;
 	}
-	listxrefs(analysis->ht_xrefs_to, addr, list);
-	sortxrefs(list);
-	if (rz_list_empty(list)) {
-		rz_list_free(list);
-		list = NULL;
+	return xrefs_index_foreach(analysis->xrefs, true, begin, end - 1, cb, user);
+}
+
+/**
+ * \brief Calls \p cb on the xrefs whose destination address is in [begin, end),
+ * sorted by destination and then source address.
+ *
+ * \see rz_analysis_xrefs_foreach
+ */
+RZ_API bool rz_analysis_xrefs_foreach_to(RZ_NONNULL RzAnalysis *analysis, ut64 begin, ut64 end, RZ_NONNULL RzAnalysisXRefCb cb, RZ_NULLABLE void *user) {
+	rz_return_val_if_fail(analysis && cb, false);
+	if (begin >= end) {
+		return true;
 	}
-	return list;
+	return xrefs_index_foreach(analysis->xrefs, false, begin, end - 1, cb, user);
 }
 
-RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_xrefs_get_from(RzAnalysis *analysis, ut64 addr) {
+static RzList /*<RzAnalysisXRef *>*/ *listxrefs(RzAnalysis *analysis, ut64 addr, bool by_from) {
 	RzList *list = rz_analysis_xref_list_new();
 	if (!list) {
 		return NULL;
 	}
-	listxrefs(analysis->ht_xrefs_from, addr, list);
-	sortxrefs(list);
+	RzAnalysisXRefs *xrefs = analysis->xrefs;
+	if (addr == UT64_MAX) {
+		xrefs_index_foreach(xrefs, true, 0, UT64_MAX, append_xref_cb, list);
+	} else {
+		xrefs_index_foreach(xrefs, by_from, addr, addr, append_xref_cb, list);
+	}
 	if (rz_list_empty(list)) {
 		rz_list_free(list);
 		list = NULL;
@@ -189,6 +541,14 @@ RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_xrefs_get_from(RzAnalys
 	return list;
 }
 
+RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_xrefs_get_to(RzAnalysis *analysis, ut64 addr) {
+	return listxrefs(analysis, addr, false);
+}
+
+RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_xrefs_get_from(RzAnalysis *analysis, ut64 addr) {
+	return listxrefs(analysis, addr, true);
+}
+
 /**
  * \brief Get list of all xrefs.
  * \param analysis RzAnalysis instance
@@ -198,8 +558,7 @@ RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_xrefs_list(RzAnalysis *
 	rz_return_val_if_fail(analysis, NULL);
 	RzList *list = rz_analysis_xref_list_new();
 	if (list) {
-		listxrefs(analysis->ht_xrefs_from, UT64_MAX, list);
-		sortxrefs(list);
+		rz_analysis_xrefs_foreach(analysis, append_xref_cb, list);
 	}
 	return list;
 }
@@ -233,42 +592,52 @@ RZ_API RzAnalysisXRefType rz_analysis_xrefs_type(char ch) {
 	}
 }
 
-RZ_API bool rz_analysis_xrefs_init(RzAnalysis *analysis) {
-	ht_up_free(analysis->ht_xrefs_from);
-	analysis->ht_xrefs_from = NULL;
-	ht_up_free(analysis->ht_xrefs_to);
-	analysis->ht_xrefs_to = NULL;
-
-	HtUP *tmp = ht_up_new(NULL, (HtUPFreeValue)ht_up_free);
-	if (!tmp) {
-		return false;
+RZ_IPI void rz_analysis_xrefs_free(RZ_NULLABLE RzAnalysisXRefs *xrefs) {
+	if (!xrefs) {
+		return;
 	}
-	analysis->ht_xrefs_from = tmp;
+	xrefs_index_fini(&xrefs->from);
+	xrefs_index_fini(&xrefs->to);
+	rz_vector_fini(&xrefs->pending);
+	free(xrefs);
+}
 
-	tmp = ht_up_new(NULL, (HtUPFreeValue)ht_up_free);
-	if (!tmp) {
-		ht_up_free(analysis->ht_xrefs_from);
-		analysis->ht_xrefs_from = NULL;
+RZ_API bool rz_analysis_xrefs_init(RzAnalysis *analysis) {
+	rz_analysis_xrefs_free(analysis->xrefs);
+	analysis->xrefs = NULL;
+
+	RzAnalysisXRefs *xrefs = RZ_NEW0(RzAnalysisXRefs);
+	if (!xrefs) {
 		return false;
 	}
-	analysis->ht_xrefs_to = tmp;
-	return true;
-}
-
-static bool count_cb(void *user, const ut64 k, const void *v) {
-	(*(ut64 *)user) += ((HtUP *)v)->count;
+	xrefs_index_init(&xrefs->from);
+	xrefs_index_init(&xrefs->to);
+	rz_vector_init(&xrefs->pending, sizeof(XRefsPending), NULL, NULL);
+	pending_reset(xrefs);
+	analysis->xrefs = xrefs;
 	return true;
 }
 
 RZ_API ut64 rz_analysis_xrefs_count(RzAnalysis *analysis) {
-	ut64 ret = 0;
-	ht_up_foreach(analysis->ht_xrefs_to, count_cb, &ret);
-	return ret;
+	RzAnalysisXRefs *xrefs = analysis->xrefs;
+	ut64 count = xrefs->from.count;
+	RzVector pending;
+	rz_vector_init(&pending, sizeof(XRefsPending), NULL, NULL);
+	pending_collect(xrefs, true, 0, 0, UT64_MAX, &pending);
+	XRefsPending *it;
+	rz_vector_foreach (&pending, it) {
+		if (!xrefs_index_has(&xrefs->from, it->xref.from, it->xref.to)) {
+			count++;
+		}
+	}
+	rz_vector_fini(&pending);
+	return count;
 }
 
-static RZ_OWN RzList /*<RzAnalysisXRef *>*/ *fcn_get_refs(const RzAnalysisFunction *fcn, HtUP *ht) {
+static RZ_OWN RzList /*<RzAnalysisXRef *>*/ *fcn_get_refs(const RzAnalysisFunction *fcn, bool by_from) {
 	void **it;
 	RzAnalysisBlock *bb;
+	RzAnalysisXRefs *xrefs = fcn->analysis->xrefs;
 	RzList *list = rz_analysis_xref_list_new();
 	if (!list) {
 		return NULL;
@@ -277,7 +646,7 @@ static RZ_OWN RzList /*<RzAnalysisXRef *>*/ *fcn_get_refs(const RzAnalysisFuncti
 		bb = (RzAnalysisBlock *)*it;
 		for (size_t i = 0; i < bb->ninstr; i++) {
 			ut64 at = bb->addr + rz_analysis_block_get_op_offset(bb, i);
-			listxrefs(ht, at, list);
+			xrefs_index_foreach(xrefs, by_from, at, at, append_xref_cb, list);
 		}
 	}
 	sortxrefs(list);
@@ -286,12 +655,12 @@ static RZ_OWN RzList /*<RzAnalysisXRef *>*/ *fcn_get_refs(const RzAnalysisFuncti
 
 RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_function_get_xrefs_from(const RzAnalysisFunction *fcn) {
 	rz_return_val_if_fail(fcn, NULL);
-	return fcn_get_refs(fcn, fcn->analysis->ht_xrefs_from);
+	return fcn_get_refs(fcn, true);
 }
 
 RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_function_get_xrefs_to(const RzAnalysisFunction *fcn) {
 	rz_return_val_if_fail(fcn, NULL);
-	return fcn_get_refs(fcn, fcn->analysis->ht_xrefs_to);
+	return fcn_get_refs(fcn, false);
 }
 
 RZ_API const char *rz_analysis_ref_type_tostring(RzAnalysisXRefType t) {
@@ -702,6 +702,7 @@ RZ_API RZ_BORROW RzBinSymbol *rz_bin_object_get_symbol_at(RZ_NONNULL RzBinObject
 	RzBinSymbol *sym;
 	void **iter;
 
+	rz_bin_object_process_pending(o);
 	if (va) {
 		rz_pvector_foreach (o->symbols, iter) {
 			sym = *iter;
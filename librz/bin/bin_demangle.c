@@ -32,7 +32,19 @@ static const char *get_mangled_name(const char *mangled) {
 #undef skip_prefix_s
 #undef skip_prefix_n
 
-RZ_IPI bool rz_bin_demangle_symbol(RzBinSymbol *bsym, const RzDemanglerPlugin *plugin, RzDemanglerFlag flags, bool force) {
+static char *demangle_name(const char *mangled, const RzDemanglerPlugin *plugin, RzDemanglerFlag flags, HtSP *cache) {
+	bool found = false;
+	const char *demangled = cache ? ht_sp_find(cache, mangled, &found) : NULL;
+	if (found) {
+		return rz_str_dup(demangled);
+	}
+	return plugin->demangle(mangled, flags);
+}
+
+/**
+ * \brief Demangles the symbol name; when not NULL, \p cache is looked up before calling \p plugin.
+ */
+RZ_IPI bool rz_bin_demangle_symbol(RzBinSymbol *bsym, const RzDemanglerPlugin *plugin, RzDemanglerFlag flags, HtSP *cache, bool force) {
 	if (!plugin || (bsym->dname && !force)) {
 		return false;
 	}
@@ -43,11 +55,14 @@ RZ_IPI bool rz_bin_demangle_symbol(RzBinSymbol *bsym, const RzDemanglerPlugin *p
 	}
 
 	free(bsym->dname);
-	bsym->dname = plugin->demangle(mangled, flags);
+	bsym->dname = demangle_name(mangled, plugin, flags, cache);
 	return bsym->dname != NULL;
 }
 
-RZ_IPI bool rz_bin_demangle_import(RzBinImport *import, const RzDemanglerPlugin *plugin, RzDemanglerFlag flags, bool force) {
+/**
+ * \brief Demangles the import name; when not NULL, \p cache is looked up before calling \p plugin.
+ */
+RZ_IPI bool rz_bin_demangle_import(RzBinImport *import, const RzDemanglerPlugin *plugin, RzDemanglerFlag flags, HtSP *cache, bool force) {
 	if (!plugin || (import->dname && !force)) {
 		return false;
 	}
@@ -57,7 +72,7 @@ RZ_IPI bool rz_bin_demangle_import(RzBinImport *import, const RzDemanglerPlugin
 		return false;
 	}
 
-	char *demangled = plugin->demangle(mangled, flags);
+	char *demangled = demangle_name(mangled, plugin, flags, cache);
 	if (!demangled) {
 		return false;
 	}
@@ -67,6 +82,61 @@ RZ_IPI bool rz_bin_demangle_import(RzBinImport *import, const RzDemanglerPlugin
 	return true;
 }
 
+static void batch_push_name(RzPVector *names, const char *name, const char *dname, bool force) {
+	const char *mangled = get_mangled_name(name);
+	if (mangled && (!dname || force)) {
+		rz_pvector_push(names, (void *)mangled);
+	}
+}
+
+/**
+ * \brief Demangles at once all the names of the object which rz_bin_demangle_symbol() and rz_bin_demangle_import() would demangle.
+ *
+ * The symbols, imports and relocations of an object share many names (each import
+ * is usually referenced by a relocation too), so the names are collected first and
+ * every distinct one is demangled only once, in parallel.
+ *
+ * \return On success returns the table to pass as cache to rz_bin_demangle_symbol()
+ *         and rz_bin_demangle_import(), otherwise NULL.
+ */
+RZ_IPI HtSP *rz_bin_demangle_batch(RzBinObject *o, const RzDemanglerPlugin *plugin, RzDemanglerFlag flags, bool force) {
+	if (!plugin) {
+		return NULL;
+	}
+
+	RzPVector names;
+	rz_pvector_init(&names, NULL);
+
+	void **it;
+	RzPVector *symbols = o->symbols;
+	if (symbols) {
+		rz_pvector_foreach (symbols, it) {
+			RzBinSymbol *symbol = *it;
+			batch_push_name(&names, symbol->name, symbol->dname, force);
+		}
+	}
+	RzPVector *imports = o->imports;
+	if (imports) {
+		rz_pvector_foreach (imports, it) {
+			RzBinImport *import = *it;
+			batch_push_name(&names, import->name, import->dname, force);
+		}
+	}
+	for (size_t i = 0; o->relocs && i < o->relocs->relocs_count; ++i) {
+		RzBinReloc *reloc = o->relocs->relocs[i];
+		if (reloc->import) {
+			batch_push_name(&names, reloc->import->name, reloc->import->dname, force);
+		}
+		if (reloc->symbol) {
+			batch_push_name(&names, reloc->symbol->name, reloc->symbol->dname, force);
+		}
+	}
+
+	HtSP *cache = rz_demangler_plugin_demangle_batch(plugin, &names, flags, RZ_THREAD_N_CORES_ALL_AVAILABLE);
+	rz_pvector_fini(&names);
+	return cache;
+}
+
 /**
  * \brief Demangles a symbol based on the language or by iterating all demanglers.
  *
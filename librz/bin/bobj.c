@@ -223,6 +223,7 @@ RZ_IPI void rz_bin_object_free(RzBinObject *o) {
  */
 RZ_API RZ_BORROW RzBinClass *rz_bin_object_find_class(RZ_NONNULL RzBinObject *o, RZ_NONNULL const char *name) {
 	rz_return_val_if_fail(o && name, NULL);
+	rz_bin_object_process_pending(o);
 	return ht_sp_find(o->name_to_class_object, name, NULL);
 }
 
@@ -335,6 +336,7 @@ RZ_API RZ_BORROW RzBinClass *rz_bin_object_add_class(RZ_NONNULL RzBinObject *o,
  */
 RZ_API RzBinSymbol *rz_bin_object_find_method(RZ_NONNULL RzBinObject *o, RZ_NONNULL const char *klass, RZ_NONNULL const char *method) {
 	rz_return_val_if_fail(o && klass && method, NULL);
+	rz_bin_object_process_pending(o);
 	char *key = rz_str_newf(RZ_BIN_FMT_CLASS_HT_GLUE, klass, method);
 	if (!key) {
 		return NULL;
@@ -354,6 +356,7 @@ RZ_API RzBinSymbol *rz_bin_object_find_method(RZ_NONNULL RzBinObject *o, RZ_NONN
  */
 RZ_API RzBinSymbol *rz_bin_object_find_method_by_vaddr(RZ_NONNULL RzBinObject *o, ut64 vaddr) {
 	rz_return_val_if_fail(o, NULL);
+	rz_bin_object_process_pending(o);
 	return (RzBinSymbol *)ht_up_find(o->vaddr_to_class_method, vaddr, NULL);
 }
 
@@ -427,6 +430,7 @@ RZ_API RZ_BORROW RzBinSymbol *rz_bin_object_add_method(RZ_NONNULL RzBinObject *o
  */
 RZ_API RzBinClassField *rz_bin_object_find_field(RZ_NONNULL RzBinObject *o, RZ_NONNULL const char *klass, RZ_NONNULL const char *field) {
 	rz_return_val_if_fail(o && klass && field, NULL);
+	rz_bin_object_process_pending(o);
 	char *key = rz_str_newf(RZ_BIN_FMT_CLASS_HT_GLUE, klass, field);
 	if (!key) {
 		return NULL;
@@ -546,6 +550,7 @@ RZ_IPI RzBinObject *rz_bin_object_new(RzBinFile *bf, RzBinPlugin *plugin, RzBinO
 
 RZ_API RzBinRelocStorage *rz_bin_object_patch_relocs(RzBinFile *bf, RzBinObject *o) {
 	rz_return_val_if_fail(bf && o, NULL);
+	rz_bin_object_process_pending(o);
 
 	// rz_bin_object_set_items set o->relocs but there we don't have access
 	// to io so we need to be run from bin_relocs, free the previous reloc and get
@@ -569,6 +574,7 @@ RZ_API RzBinRelocStorage *rz_bin_object_patch_relocs(RzBinFile *bf, RzBinObject
  */
 RZ_API RzBinSymbol *rz_bin_object_get_symbol_of_import(RzBinObject *o, RzBinImport *imp) {
 	rz_return_val_if_fail(o && imp && imp->name, NULL);
+	rz_bin_object_process_pending(o);
 	if (!o->import_name_symbols) {
 		return NULL;
 	}
@@ -680,6 +686,7 @@ RZ_API const RzPVector /*<RzBinField *>*/ *rz_bin_object_get_fields(RZ_NONNULL R
  */
 RZ_API const RzPVector /*<RzBinImport *>*/ *rz_bin_object_get_imports(RZ_NONNULL RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_process_pending(obj);
 	return obj->imports;
 }
 
@@ -753,6 +760,7 @@ RZ_API RZ_OWN RzPVector /*<RzBinMap *>*/ *rz_bin_object_get_maps(RZ_NONNULL RzBi
  */
 RZ_API const RzPVector /*<RzBinClass *>*/ *rz_bin_object_get_classes(RZ_NONNULL RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_process_pending(obj);
 	return obj->classes;
 }
 
@@ -780,6 +788,7 @@ RZ_API RZ_BORROW const RzPVector /*<RzBinMem *>*/ *rz_bin_object_get_mem(RZ_NONN
  */
 RZ_API const RzPVector /*<RzBinSymbol *>*/ *rz_bin_object_get_symbols(RZ_NONNULL RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	rz_bin_object_process_pending(obj);
 	return obj->symbols;
 }
 
@@ -147,6 +147,7 @@ RZ_API bool rz_bin_object_process_plugin_data(RZ_NONNULL RzBinFile *bf, RZ_NONNU
 	rz_return_val_if_fail(bf && bf->rbin && o && o->plugin, false);
 	const RzDemanglerPlugin *demangler = NULL;
 
+	o->demangle_pending = false;
 	rz_bin_set_and_process_file(bf, o);
 	rz_bin_set_and_process_entries(bf, o);
 	rz_bin_set_and_process_maps(bf, o);
@@ -182,17 +183,48 @@ RZ_API bool rz_bin_object_process_plugin_data(RZ_NONNULL RzBinFile *bf, RZ_NONNU
 	}
 
 	// now we can process the data.
-	RzDemanglerFlag flags = rz_demangler_get_flags(bf->rbin->demangler);
+	rz_bin_process_symbols(bf, o);
+	rz_bin_set_and_process_relocs(bf, o);
+
+	// the demangling is deferred until the first access to the data which needs it.
 	if (bf->rbin->demangle) {
 		demangler = rz_bin_process_get_demangler_plugin_from_lang(bf->rbin, o->lang);
 	}
-	rz_bin_process_symbols(bf, o, demangler, flags);
-	rz_bin_process_imports(bf, o, demangler, flags);
-	rz_bin_set_and_process_relocs(bf, o, demangler, flags);
+	o->demangler = demangler;
+	o->demangler_flags = rz_demangler_get_flags(bf->rbin->demangler);
+	o->demangle_pending = demangler != NULL;
 
 	return true;
 }
 
+/**
+ * \brief Demangles the symbols, imports and relocations of the object and processes their language.
+ *
+ * This step is deferred at load time, since demangling can take most of the
+ * loading time of big binaries and many requests (e.g. the sections or the
+ * binary info) never need it. The accessors of RzBinObject call this function
+ * before returning any data which depends on it; users reading the object
+ * fields directly must call it first.
+ *
+ * \param      o     The RzBinObject to process
+ */
+RZ_API void rz_bin_object_process_pending(RZ_NONNULL RzBinObject *o) {
+	rz_return_if_fail(o);
+	if (!o->demangle_pending) {
+		return;
+	}
+	// cleared first, since the language processing uses the accessors too.
+	o->demangle_pending = false;
+
+	// the names are demangled in parallel, while the language processing
+	// modifies the object and runs on the demangled names in order.
+	HtSP *cache = rz_bin_demangle_batch(o, o->demangler, o->demangler_flags, false);
+	rz_bin_demangle_and_process_symbols(o, o->demangler, o->demangler_flags, cache);
+	rz_bin_demangle_and_process_imports(o, o->demangler, o->demangler_flags, cache);
+	rz_bin_demangle_and_process_relocs(o, o->demangler, o->demangler_flags, cache);
+	ht_sp_free(cache);
+}
+
 /**
  * \brief Remove all previously identified strings in the binary object and scan it again for strings.
  */
@@ -229,9 +261,12 @@ RZ_API void rz_bin_demangle_with_flags(RZ_NONNULL RzBin *bin, RzDemanglerFlag fl
 			continue;
 		}
 		RzBinObject *o = bf->o;
+		rz_bin_object_process_pending(o);
 		const RzDemanglerPlugin *demangler = rz_bin_process_get_demangler_plugin_from_lang(bin, o->lang);
-		rz_bin_demangle_relocs_with_flags(o, demangler, flags);
-		rz_bin_demangle_imports_with_flags(o, demangler, flags);
-		rz_bin_demangle_symbols_with_flags(o, demangler, flags);
+		HtSP *cache = rz_bin_demangle_batch(o, demangler, flags, true);
+		rz_bin_demangle_relocs_with_flags(o, demangler, flags, cache);
+		rz_bin_demangle_imports_with_flags(o, demangler, flags, cache);
+		rz_bin_demangle_symbols_with_flags(o, demangler, flags, cache);
+		ht_sp_free(cache);
 	}
 }
@@ -38,7 +38,7 @@ RZ_IPI void rz_bin_set_imports_from_plugin(RzBinFile *bf, RzBinObject *o) {
 	}
 }
 
-RZ_IPI void rz_bin_process_imports(RzBinFile *bf, RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags) {
+RZ_IPI void rz_bin_demangle_and_process_imports(RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags, HtSP *cache) {
 	if (!demangler || rz_pvector_len(o->imports) < 1) {
 		return;
 	}
@@ -54,7 +54,7 @@ RZ_IPI void rz_bin_process_imports(RzBinFile *bf, RzBinObject *o, const RzDemang
 		}
 
 		// demangle the import
-		if (!rz_bin_demangle_import(element, demangler, flags, false) ||
+		if (!rz_bin_demangle_import(element, demangler, flags, cache, false) ||
 			!language_cb) {
 			continue;
 		}
@@ -66,7 +66,7 @@ RZ_IPI void rz_bin_process_imports(RzBinFile *bf, RzBinObject *o, const RzDemang
 	}
 }
 
-RZ_IPI void rz_bin_demangle_imports_with_flags(RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags) {
+RZ_IPI void rz_bin_demangle_imports_with_flags(RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags, HtSP *cache) {
 	void **it;
 	RzBinImport *element;
 	rz_pvector_foreach (o->imports, it) {
@@ -75,6 +75,6 @@ RZ_IPI void rz_bin_demangle_imports_with_flags(RzBinObject *o, const RzDemangler
 			continue;
 		}
 
-		rz_bin_demangle_import(element, demangler, flags, true);
+		rz_bin_demangle_import(element, demangler, flags, cache, true);
 	}
 }
@@ -8,25 +8,19 @@ static void process_handle_reloc(RzBinReloc *reloc,
 	RzBinObject *o,
 	const RzDemanglerPlugin *demangler,
 	RzDemanglerFlag flags,
+	HtSP *cache,
 	RzBinProcessLanguage imp_cb,
 	RzBinProcessLanguage sym_cb) {
-	// rebase physical address
-	reloc->paddr += o->opts.loadaddr;
-
-	if (!demangler) {
-		return;
-	}
-
-	if (reloc->import && rz_bin_demangle_import(reloc->import, demangler, flags, false) && imp_cb) {
+	if (reloc->import && rz_bin_demangle_import(reloc->import, demangler, flags, cache, false) && imp_cb) {
 		imp_cb(o, reloc->import);
 	}
 
-	if (reloc->symbol && rz_bin_demangle_symbol(reloc->symbol, demangler, flags, false) && sym_cb) {
+	if (reloc->symbol && rz_bin_demangle_symbol(reloc->symbol, demangler, flags, cache, false) && sym_cb) {
 		sym_cb(o, reloc->symbol);
 	}
 }
 
-RZ_IPI void rz_bin_set_and_process_relocs(RzBinFile *bf, RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags) {
+RZ_IPI void rz_bin_set_and_process_relocs(RzBinFile *bf, RzBinObject *o) {
 	RzBin *bin = bf->rbin;
 	RzBinPlugin *plugin = o->plugin;
 	RzPVector *relocs = NULL;
@@ -37,27 +31,38 @@ RZ_IPI void rz_bin_set_and_process_relocs(RzBinFile *bf, RzBinObject *o, const R
 		relocs = rz_pvector_new((RzListFree)rz_bin_reloc_free);
 	}
 
-	RzBinProcessLanguage imp_cb = rz_bin_process_language_import(o);
-	RzBinProcessLanguage sym_cb = rz_bin_process_language_symbol(o);
-
 	void **it;
 	RzBinReloc *element;
 	rz_pvector_foreach (relocs, it) {
 		element = *it;
-		process_handle_reloc(element, o, demangler, flags, imp_cb, sym_cb);
+		// rebase physical address
+		element->paddr += o->opts.loadaddr;
 	}
 
 	o->relocs = rz_bin_reloc_storage_new(relocs);
 }
 
-RZ_IPI void rz_bin_demangle_relocs_with_flags(RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags) {
+RZ_IPI void rz_bin_demangle_and_process_relocs(RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags, HtSP *cache) {
+	if (!demangler || !o->relocs) {
+		return;
+	}
+
+	RzBinProcessLanguage imp_cb = rz_bin_process_language_import(o);
+	RzBinProcessLanguage sym_cb = rz_bin_process_language_symbol(o);
+
+	for (size_t i = 0; i < o->relocs->relocs_count; ++i) {
+		process_handle_reloc(o->relocs->relocs[i], o, demangler, flags, cache, imp_cb, sym_cb);
+	}
+}
+
+RZ_IPI void rz_bin_demangle_relocs_with_flags(RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags, HtSP *cache) {
 	for (size_t i = 0; i < o->relocs->relocs_count; ++i) {
 		RzBinReloc *reloc = o->relocs->relocs[i];
 		if (reloc->import) {
-			rz_bin_demangle_import(reloc->import, demangler, flags, true);
+			rz_bin_demangle_import(reloc->import, demangler, flags, cache, true);
 		}
 		if (reloc->symbol) {
-			rz_bin_demangle_symbol(reloc->symbol, demangler, flags, true);
+			rz_bin_demangle_symbol(reloc->symbol, demangler, flags, cache, true);
 		}
 	}
 }
@@ -62,7 +62,7 @@ RZ_IPI RzBinProcessLanguage rz_bin_process_language_symbol(RzBinObject *o) {
 	}
 }
 
-static void process_handle_symbol(RzBinSymbol *symbol, RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags, RzBinProcessLanguage language_cb) {
+static void process_handle_symbol(RzBinSymbol *symbol, RzBinObject *o) {
 	// rebase physical address
 	symbol->paddr += o->opts.loadaddr;
 
@@ -76,20 +76,9 @@ static void process_handle_symbol(RzBinSymbol *symbol, RzBinObject *o, const RzD
 			ht_sp_insert(o->import_name_symbols, symbol->name, symbol);
 		}
 	}
-
-	// demangle the symbol
-	if (!rz_bin_demangle_symbol(symbol, demangler, flags, false) ||
-		!language_cb) {
-		return;
-	}
-
-	// handle the demangled string at language
-	// level; this can allow to add also classes
-	// methods and fields.
-	language_cb(o, symbol);
 }
 
-RZ_IPI void rz_bin_process_symbols(RzBinFile *bf, RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags) {
+RZ_IPI void rz_bin_process_symbols(RzBinFile *bf, RzBinObject *o) {
 	if (rz_pvector_len(o->symbols) < 1) {
 		return;
 	}
@@ -97,13 +86,36 @@ RZ_IPI void rz_bin_process_symbols(RzBinFile *bf, RzBinObject *o, const RzDemang
 	ht_sp_free(o->import_name_symbols);
 	o->import_name_symbols = ht_sp_new(HT_STR_DUP, NULL, NULL);
 
+	void **it;
+	RzBinSymbol *element;
+	rz_pvector_foreach (o->symbols, it) {
+		element = *it;
+		process_handle_symbol(element, o);
+	}
+}
+
+RZ_IPI void rz_bin_demangle_and_process_symbols(RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags, HtSP *cache) {
+	if (!demangler || rz_pvector_len(o->symbols) < 1) {
+		return;
+	}
+
 	RzBinProcessLanguage language_cb = rz_bin_process_language_symbol(o);
 
 	void **it;
 	RzBinSymbol *element;
 	rz_pvector_foreach (o->symbols, it) {
 		element = *it;
-		process_handle_symbol(element, o, demangler, flags, language_cb);
+		// demangle the symbol
+		if (!element->name ||
+			!rz_bin_demangle_symbol(element, demangler, flags, cache, false) ||
+			!language_cb) {
+			continue;
+		}
+
+		// handle the demangled string at language
+		// level; this can allow to add also classes
+		// methods and fields.
+		language_cb(o, element);
 	}
 }
 
@@ -116,11 +128,11 @@ RZ_IPI void rz_bin_set_symbols_from_plugin(RzBinFile *bf, RzBinObject *o) {
 	}
 }
 
-RZ_IPI void rz_bin_demangle_symbols_with_flags(RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags) {
+RZ_IPI void rz_bin_demangle_symbols_with_flags(RzBinObject *o, const RzDemanglerPlugin *demangler, RzDemanglerFlag flags, HtSP *cache) {
 	void **it;
 	RzBinSymbol *element;
 	rz_pvector_foreach (o->symbols, it) {
 		element = *it;
-		rz_bin_demangle_symbol(element, demangler, flags, true);
+		rz_bin_demangle_symbol(element, demangler, flags, cache, true);
 	}
 }
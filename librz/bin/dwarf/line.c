@@ -32,12 +32,29 @@ typedef struct {
 typedef struct {
 	RzBinDWARF *dw;
 	RzBinDwarfLine *line;
+	RzBinEndianReader *R;
 	RzBinDwarfLineUnitHdr *hdr;
 	SMRegisters *regs;
-	RzBinSourceLineInfoBuilder *source_line_info_builder;
+	RzVector /*<RzBinSourceLineSample>*/ *samples;
 	FilePathCache *file_path_cache;
 } DWLineContext;
 
+/**
+ * The line program of each unit is run on its own, possibly by another thread.
+ * The file names of the samples still point into the file path cache of the task
+ * and are moved into the string pool of the line info when the units are merged.
+ */
+typedef struct {
+	RzBinDWARF *dw;
+	RzBinDwarfLine *line;
+	RzBinDwarfLineUnit *unit;
+	RzBinEndianReader R; ///< Clone of the .debug_line reader
+	ut64 program_offset; ///< Offset of the first opcode of the unit
+	RzVector /*<RzBinSourceLineSample>*/ samples;
+	FilePathCache *file_path_cache;
+	bool done;
+} LineParseTask;
+
 static void LineHdr_init(RzBinDwarfLineUnitHdr *hdr) {
 	if (!hdr) {
 		return;
@@ -89,7 +106,7 @@ static bool FileEntryFormat_parse(
 }
 
 static const char *directory_parse_v5(DWLineContext *ctx, RzBinDwarfLineUnitHdr *hdr) {
-	RzBinEndianReader *R = ctx->line->R;
+	RzBinEndianReader *R = ctx->R;
 	const char *path_name = NULL;
 	RzBinDwarfFileEntryFormat *format = NULL;
 	rz_vector_foreach (&hdr->directory_entry_formats, format) {
@@ -107,7 +124,7 @@ static const char *directory_parse_v5(DWLineContext *ctx, RzBinDwarfLineUnitHdr
 }
 
 static bool FileEntry_parse_v5(DWLineContext *ctx, RzBinDwarfFileEntry *entry) {
-	RzBinEndianReader *R = ctx->line->R;
+	RzBinEndianReader *R = ctx->R;
 	RzBinDwarfLineUnitHdr *hdr = ctx->hdr;
 	RzBinDwarfFileEntryFormat *format = NULL;
 	rz_vector_foreach (&hdr->file_name_entry_formats, format) {
@@ -161,7 +178,7 @@ err:
  * 6.2.4 The Line Number Program Header: https://dwarfstd.org/doc/DWARF5.pdf#page=172
  */
 static bool LineHdr_parse_v5(DWLineContext *ctx) {
-	RzBinEndianReader *R = ctx->line->R;
+	RzBinEndianReader *R = ctx->R;
 	RzBinDwarfLineUnitHdr *hdr = ctx->hdr;
 	RET_FALSE_IF_FAIL(FileEntryFormat_parse(R, &hdr->directory_entry_formats, hdr));
 	ut64 count = 0;
@@ -187,7 +204,7 @@ static bool LineHdr_parse_v5(DWLineContext *ctx) {
 }
 
 static bool LineHdr_parse_v4(DWLineContext *ctx) {
-	RzBinEndianReader *R = ctx->line->R;
+	RzBinEndianReader *R = ctx->R;
 	while (true) {
 		const char *str = NULL;
 		OK_OR(R_read_cstring(R, &str) && RZ_STR_ISNOTEMPTY(str), break);
@@ -321,7 +338,7 @@ static bool LineHdr_parse(
 	DWLineContext *ctx,
 	RzBinDwarfEncoding encoding) {
 	rz_return_val_if_fail(ctx, false);
-	RzBinEndianReader *R = ctx->line->R;
+	RzBinEndianReader *R = ctx->R;
 	RzBinDwarfLineUnitHdr *hdr = ctx->hdr;
 	LineHdr_init(ctx->hdr);
 	hdr->offset = R_tell(R);
@@ -506,14 +523,24 @@ static void SMRegisters_reset(
 	regs->isa = 0;
 }
 
+static void push_line_sample(DWLineContext *ctx, ut32 line, ut32 column, const char *file) {
+	RzBinSourceLineSample *sample = rz_vector_push(ctx->samples, NULL);
+	if (!sample) {
+		return;
+	}
+	sample->address = ctx->regs->address;
+	sample->line = line;
+	sample->column = column;
+	sample->file = file;
+}
+
 static void store_line_sample(DWLineContext *ctx) {
 	const char *filepath = full_file_path_cached(ctx, ctx->regs->file);
-	rz_bin_source_line_info_builder_push_sample(
-		ctx->source_line_info_builder, ctx->regs->address, (ut32)ctx->regs->line, (ut32)ctx->regs->column, filepath);
+	push_line_sample(ctx, (ut32)ctx->regs->line, (ut32)ctx->regs->column, filepath);
 }
 
 /**
- * \brief Execute a single line op on regs and optionally store the resulting line info in source_line_info_builder
+ * \brief Execute a single line op on regs and optionally store the resulting line info in samples
  * \param line_file_cache if not null, filenames will be resolved to their full paths using this cache.
  */
 static bool LineOp_run(
@@ -568,8 +595,7 @@ static bool LineOp_run(
 		switch (op->ext_opcode) {
 		case DW_LNE_end_sequence:
 			ctx->regs->end_sequence = 1;
-			rz_bin_source_line_info_builder_push_sample(
-				ctx->source_line_info_builder, ctx->regs->address, 0, 0, NULL);
+			push_line_sample(ctx, 0, 0, NULL);
 			SMRegisters_reset(ctx->hdr, ctx->regs);
 			break;
 		case DW_LNE_set_address:
@@ -601,7 +627,7 @@ static bool LineOp_run(
 }
 
 static bool LineOp_at(DWLineContext *ctx, ut64 offset, RzBinDwarfLineOp *op) {
-	RzBinEndianReader *R = ctx->line->R;
+	RzBinEndianReader *R = ctx->R;
 	RET_FALSE_IF_FAIL(R_seek(R, offset, SEEK_SET));
 	op->offset = offset;
 	U8_OR_RET_FALSE(op->opcode);
@@ -618,7 +644,7 @@ static bool LineOp_at(DWLineContext *ctx, ut64 offset, RzBinDwarfLineOp *op) {
 static bool LineOp_all(
 	DWLineContext *ctx,
 	RzVector /*<RzBinDwarfLineOp>*/ *ops) {
-	RzBinEndianReader *R = ctx->line->R;
+	RzBinEndianReader *R = ctx->R;
 	while (true) {
 		ut64 offset = R_tell(R);
 		if (offset > ctx->hdr->offset + ctx->hdr->unit_length + 1) {
@@ -642,6 +668,44 @@ static void LineUnit_free(RzBinDwarfLineUnit *unit) {
 	free(unit);
 }
 
+static void LineParseTask_free(LineParseTask *task) {
+	if (!task) {
+		return;
+	}
+	rz_vector_fini(&task->samples);
+	rz_pvector_free(task->file_path_cache);
+	free(task);
+}
+
+static void LineParseTask_run(LineParseTask *task, void *user) {
+	RzBinDwarfLineUnit *unit = task->unit;
+	R_clone(task->line->R, &task->R);
+	R_seek(&task->R, (st64)task->program_offset, SEEK_SET);
+
+	SMRegisters regs;
+	DWLineContext ctx = {
+		.dw = task->dw,
+		.line = task->line,
+		.R = &task->R,
+		.hdr = &unit->hdr,
+		.regs = &regs,
+		.samples = &task->samples,
+	};
+	LineOp_all(&ctx, &unit->ops);
+
+	ctx.file_path_cache = task->file_path_cache = rz_pvector_new_with_len(
+		free, rz_vector_len(&unit->hdr.file_names));
+	SMRegisters_reset(&unit->hdr, &regs);
+
+	RzBinDwarfLineOp *op;
+	rz_vector_foreach (&unit->ops, op) {
+		if (!LineOp_run(op, &ctx)) {
+			break;
+		}
+	}
+	task->done = true;
+}
+
 static RzBinDwarfLine *Line_parse(
 	RzBinEndianReader *R,
 	RzBinDwarfEncoding *encoding,
@@ -659,10 +723,10 @@ static RzBinDwarfLine *Line_parse(
 		return NULL;
 	}
 
-	RzBinSourceLineInfoBuilder source_line_info_builder;
-	rz_bin_source_line_info_builder_init(&source_line_info_builder);
-	SMRegisters regs;
-	// each iteration we read one header AKA comp. unit
+	RzPVector tasks;
+	rz_pvector_init(&tasks, (RzPVectorFree)LineParseTask_free);
+	// each iteration we read one header AKA comp. unit,
+	// while the line programs are run afterwards.
 	while (true) {
 		RzBinDwarfLineUnit *unit = RZ_NEW0(RzBinDwarfLineUnit);
 		if (!unit) {
@@ -672,6 +736,7 @@ static RzBinDwarfLine *Line_parse(
 		DWLineContext ctx = {
 			.dw = dw,
 			.line = li,
+			.R = R,
 			.hdr = &unit->hdr,
 		};
 		if (!LineHdr_parse(&ctx, *encoding)) {
@@ -679,24 +744,44 @@ static RzBinDwarfLine *Line_parse(
 			break;
 		}
 		rz_vector_init(&unit->ops, sizeof(RzBinDwarfLineOp), NULL, NULL);
-		LineOp_all(&ctx, &unit->ops);
-
-		ctx.regs = &regs;
-		ctx.source_line_info_builder = &source_line_info_builder;
-		ctx.file_path_cache = rz_pvector_new_with_len(
-			free, rz_vector_len(&unit->hdr.file_names));
-		SMRegisters_reset(&unit->hdr, &regs);
-
-		RzBinDwarfLineOp *op;
-		rz_vector_foreach (&unit->ops, op) {
-			if (!LineOp_run(op, &ctx)) {
-				break;
-			}
+		LineParseTask *task = RZ_NEW0(LineParseTask);
+		if (!task || !rz_pvector_push(&tasks, task)) {
+			free(task);
+			LineUnit_free(unit);
+			break;
 		}
-
-		rz_pvector_free(ctx.file_path_cache);
+		task->dw = dw;
+		task->line = li;
+		task->unit = unit;
+		task->program_offset = R_tell(R);
+		rz_vector_init(&task->samples, sizeof(RzBinSourceLineSample), NULL, NULL);
 		rz_pvector_push(li->units, unit);
+
+		ut64 next = unit->hdr.offset + unit->hdr.unit_length + (unit->hdr.encoding.is_64bit ? 12 : 4);
+		R_seek(R, (st64)next, SEEK_SET);
+	}
+
+	RzThreadNCores max_threads = dw ? dw->max_threads : RZ_THREAD_N_CORES_ALL_AVAILABLE;
+	if (rz_pvector_len(&tasks) > 1 && rz_th_max_threads(max_threads) > 1 &&
+		!rz_th_iterate_pvector(&tasks, (RzThreadIterator)LineParseTask_run, max_threads, NULL)) {
+		RZ_LOG_WARN("DWARF: failed to run the line programs in parallel\n");
+	}
+
+	RzBinSourceLineInfoBuilder source_line_info_builder;
+	rz_bin_source_line_info_builder_init(&source_line_info_builder);
+	void **it;
+	rz_pvector_foreach (&tasks, it) {
+		LineParseTask *task = *it;
+		if (!task->done) {
+			LineParseTask_run(task, NULL);
+		}
+		RzBinSourceLineSample *sample;
+		rz_vector_foreach (&task->samples, sample) {
+			rz_bin_source_line_info_builder_push_sample(&source_line_info_builder,
+				sample->address, sample->line, sample->column, sample->file);
+		}
 	}
+	rz_pvector_fini(&tasks);
 	li->lines = rz_bin_source_line_info_builder_build_and_fini(&source_line_info_builder);
 	return li;
 }
@@ -598,7 +598,8 @@ static RzBinDwarfValueType ValueType_from_name(const char *name, ut8 byte_size)
 
 static RzBinDwarfValueType ValueType_from_die(
 	const RzBinDwarfEvaluation *eval, const RzBinDWARF *dw, UnitOffset offset) {
-	const RzBinDwarfDie *die = ht_up_find(dw->info->die_by_offset, eval->unit->offset + offset, NULL);
+	// only the lazily decoded DIEs of the unit are modified
+	const RzBinDwarfDie *die = rz_bin_dwarf_die_at((RzBinDWARF *)dw, eval->unit->offset + offset);
 	if (!die) {
 		return RzBinDwarfValueType_GENERIC;
 	}
@@ -690,6 +691,7 @@ RZ_API RZ_OWN RzBinDwarfEvaluation *rz_bin_dwarf_evaluation_new(
 	self->dw = dw;
 	self->unit = unit;
 	self->fn_die = fn_die;
+	self->fn_die_offset = fn_die ? fn_die->offset : UT64_MAX;
 	rz_vector_init(&self->stack, sizeof(RzBinDwarfValue), RzVector_Value_fini, NULL);
 	rz_vector_init(&self->expression_stack, sizeof(RzBinDwarfExprStackItem), NULL, NULL);
 	rz_vector_init(&self->result, sizeof(RzBinDwarfPiece), RzVector_RzBinDwarfPiece_fini, NULL);
@@ -964,6 +966,10 @@ static bool Evaluation_evaluate_one_operation(
 		break;
 	}
 	case OPERATION_KIND_FRAME_OFFSET: {
+		if (!self->fn_die && self->fn_die_offset != UT64_MAX && self->dw->info) {
+			// resumed after the DIEs of the unit were released, decode them again
+			self->fn_die = rz_bin_dwarf_die_at((RzBinDWARF *)self->dw, self->fn_die_offset);
+		}
 		if (!self->fn_die) {
 			out->kind = OperationEvaluationResult_WAITING;
 			out->waiting._1 = EvaluationStateWaiting_FbReg;
@@ -1369,6 +1375,9 @@ static bool RzBinDwarfEvaluationResult_to_loc(
 	}
 	if (eval->state.kind != EVALUATION_STATE_COMPLETE || eval_result->kind != EvaluationResult_COMPLETE) {
 		loc->kind = RzBinDwarfLocationKind_EVALUATION_WAITING;
+		// the DIEs of the unit may be released before the evaluation is resumed,
+		// the function DIE is looked up again by its offset when it is needed.
+		eval->fn_die = NULL;
 		loc->eval_waiting.eval = eval;
 		loc->eval_waiting.result = eval_result;
 		return true;
@@ -11,6 +11,29 @@ typedef struct {
 	RzBinDWARF *dw;
 } DebugInfoContext;
 
+/**
+ * The DIEs of each unit are parsed on their own, possibly by another thread,
+ * so the task keeps a private reader and defers the writes to the shared tables.
+ */
+typedef struct {
+	DebugInfoContext *ctx;
+	RzBinDwarfCompUnit *unit;
+	const RzBinDwarfAbbrevTable *tbl;
+	RzBinEndianReader R; ///< Clone of the .debug_info reader
+	RzVector /*<ut64>*/ locations; ///< Offsets of the DW_AT_location values, later mapped to the unit encoding
+	bool root_only; ///< Stop after the unit DIE
+	bool done;
+} CUParseTask;
+
+/**
+ * DIEs of a unit, private to this file: they are decoded on demand,
+ * so they are only accessed through rz_bin_dwarf_unit_dies().
+ */
+struct rz_bin_dwarf_unit_dies_t {
+	RzVector /*<RzBinDwarfDie>*/ vec;
+	bool loaded;
+};
+
 static void Die_fini(RzBinDwarfDie *die) {
 	if (!die) {
 		return;
@@ -78,10 +101,10 @@ static void apply_attr_opt(DebugInfoContext *ctx, RzBinDwarfCompUnit *cu, RzBinD
 }
 
 static bool CU_attrs_parse(
-	DebugInfoContext *ctx,
+	CUParseTask *task,
 	RzBinDwarfDie *die,
-	RzBinDwarfCompUnit *cu,
 	RzBinDwarfAbbrevDecl *abbrev_decl) {
+	RzBinDwarfCompUnit *cu = task->unit;
 
 	RZ_LOG_DEBUG("0x%" PFMT64x ":\t%s%s [%" PFMT64d "] %s\n",
 		die->offset, rz_str_indent(die->depth), rz_bin_dwarf_tag(die->tag),
@@ -90,14 +113,14 @@ static bool CU_attrs_parse(
 	rz_vector_foreach (&abbrev_decl->defs, spec) {
 		RzBinDwarfAttr attr = { 0 };
 		AttrOption opt = {
-			.dw = ctx->dw,
+			.dw = task->ctx->dw,
 			.implicit_const = spec->special,
 			.form = spec->form,
 			.at = spec->at,
 			.unit_offset = cu->offset,
 			.encoding = &cu->hdr.encoding,
 		};
-		if (!RzBinDwarfAttr_parse(ctx->info->R, &attr, &opt)) {
+		if (!RzBinDwarfAttr_parse(&task->R, &attr, &opt)) {
 			RZ_LOG_ERROR("DWARF: failed attr: 0x%" PFMT64x " %s [%s]\n",
 				die->offset, rz_bin_dwarf_attr(spec->at), rz_bin_dwarf_form(spec->form));
 			continue;
@@ -113,8 +136,7 @@ static bool CU_attrs_parse(
 				attr.value.kind == RzBinDwarfAttr_UConstant ||
 				attr.value.kind == RzBinDwarfAttr_SecOffset) {
 				ut64 offset = rz_bin_dwarf_attr_udata(&attr);
-				ht_up_insert(ctx->info->location_encoding,
-					offset, &cu->hdr.encoding);
+				rz_vector_push(&task->locations, &offset);
 			}
 		}
 		default:
@@ -123,21 +145,30 @@ static bool CU_attrs_parse(
 
 		rz_vector_push(&die->attrs, &attr);
 	}
+	return true;
+}
 
-	if (die->tag == DW_TAG_compile_unit ||
-		die->tag == DW_TAG_skeleton_unit) {
-		apply_attr_opt(ctx, cu, die, DW_AT_str_offsets_base);
-		apply_attr_opt(ctx, cu, die, DW_AT_addr_base);
-		apply_attr_opt(ctx, cu, die, DW_AT_GNU_addr_base);
-		apply_attr_opt(ctx, cu, die, DW_AT_GNU_ranges_base);
-		apply_attr_opt(ctx, cu, die, DW_AT_loclists_base);
-		apply_attr_opt(ctx, cu, die, DW_AT_rnglists_base);
-		RzBinDwarfAttr *attr;
-		rz_vector_foreach (&die->attrs, attr) {
-			CU_attr_apply(ctx, cu, attr);
-		}
+/**
+ * \brief Applies the attributes of a compile unit DIE to \p cu
+ *
+ * The strings are read through the shared readers of \p ctx->dw,
+ * thus this runs serially while the unit index is built.
+ */
+static void CU_die_apply(DebugInfoContext *ctx, RzBinDwarfCompUnit *cu, RzBinDwarfDie *die) {
+	if (die->tag != DW_TAG_compile_unit &&
+		die->tag != DW_TAG_skeleton_unit) {
+		return;
+	}
+	apply_attr_opt(ctx, cu, die, DW_AT_str_offsets_base);
+	apply_attr_opt(ctx, cu, die, DW_AT_addr_base);
+	apply_attr_opt(ctx, cu, die, DW_AT_GNU_addr_base);
+	apply_attr_opt(ctx, cu, die, DW_AT_GNU_ranges_base);
+	apply_attr_opt(ctx, cu, die, DW_AT_loclists_base);
+	apply_attr_opt(ctx, cu, die, DW_AT_rnglists_base);
+	RzBinDwarfAttr *attr;
+	rz_vector_foreach (&die->attrs, attr) {
+		CU_attr_apply(ctx, cu, attr);
 	}
-	return true;
 }
 
 /**
@@ -149,30 +180,38 @@ static int CU_init(RzBinDwarfCompUnit *unit) {
 	if (!unit) {
 		return -EINVAL;
 	}
-	rz_vector_init(&unit->dies, sizeof(RzBinDwarfDie), (RzVectorFree)Die_fini, NULL);
+	unit->dies = RZ_NEW0(RzBinDwarfUnitDies);
+	if (!unit->dies) {
+		return -ENOMEM;
+	}
+	rz_vector_init(&unit->dies->vec, sizeof(RzBinDwarfDie), (RzVectorFree)Die_fini, NULL);
 	return 0;
 }
 
 static void CU_fini(RzBinDwarfCompUnit *unit, void *user) {
-	if (!unit) {
+	if (!unit || !unit->dies) {
 		return;
 	}
-	rz_vector_fini(&unit->dies);
+	rz_vector_fini(&unit->dies->vec);
+	RZ_FREE(unit->dies);
 }
 
-static inline ut64 CU_next(RzBinDwarfCompUnit *unit) {
+static inline ut64 CU_next(const RzBinDwarfCompUnit *unit) {
 	return unit->offset + unit->hdr.length + (unit->hdr.encoding.is_64bit ? 12 : 4);
 }
 
+static inline ut64 CU_dies_offset(const RzBinDwarfCompUnit *unit) {
+	return unit->offset + unit->hdr.header_size + (unit->hdr.encoding.is_64bit ? 12 : 4);
+}
+
 /**
  * \brief Reads throught comp_unit buffer and parses all its DIEntries*
  */
-static bool CU_dies_parse(
-	DebugInfoContext *ctx,
-	RzBinDwarfCompUnit *unit,
-	const RzBinDwarfAbbrevTable *tbl) {
+static bool CU_dies_parse(CUParseTask *task) {
+	RzBinDwarfCompUnit *unit = task->unit;
+	const RzBinDwarfAbbrevTable *tbl = task->tbl;
 	st64 depth = 0;
-	RzBinEndianReader *R = ctx->info->R;
+	RzBinEndianReader *R = &task->R;
 	while (true) {
 		ut64 offset = R_tell(R);
 		if (offset >= CU_next(unit)) {
@@ -189,14 +228,14 @@ static bool CU_dies_parse(
 		RzBinDwarfDie die = {
 			.offset = offset,
 			.unit_offset = unit->offset,
-			.index = rz_vector_len(&unit->dies),
+			.index = rz_vector_len(&unit->dies->vec),
 			.depth = depth,
 			.abbrev_code = abbrev_code,
 		};
 		// there can be "null" entries that have abbr_code == 0
 		if (!abbrev_code) {
 			RZ_LOG_DEBUG("0x%" PFMT64x ":\t%sNULL\n", offset, rz_str_indent(die.depth));
-			rz_vector_push(&unit->dies, &die);
+			rz_vector_push(&unit->dies->vec, &die);
 			depth--;
 			if (depth <= 0) {
 				break;
@@ -221,9 +260,12 @@ static bool CU_dies_parse(
 			if (die.has_children) {
 				depth++;
 			}
-			GOTO_IF_FAIL(CU_attrs_parse(ctx, &die, unit, abbrev_decl), err);
+			GOTO_IF_FAIL(CU_attrs_parse(task, &die, abbrev_decl), err);
+		}
+		rz_vector_push(&unit->dies->vec, &die);
+		if (task->root_only) {
+			break;
 		}
-		rz_vector_push(&unit->dies, &die);
 	}
 	return true;
 err:
@@ -277,8 +319,109 @@ static bool CU_Hdr_parse(DebugInfoContext *ctx, RzBinDwarfCompUnit *cu) {
 	return true;
 }
 
+static CUParseTask *CU_parse_task_new(DebugInfoContext *ctx, RzBinDwarfCompUnit *unit) {
+	const RzBinDwarfAbbrevTable *tbl = ht_up_find(
+		ctx->dw->abbrev->by_offset, unit->hdr.abbrev_offset, NULL);
+	if (!tbl) {
+		return NULL;
+	}
+	CUParseTask *task = RZ_NEW0(CUParseTask);
+	if (!task) {
+		return NULL;
+	}
+	task->ctx = ctx;
+	task->unit = unit;
+	task->tbl = tbl;
+	rz_vector_init(&task->locations, sizeof(ut64), NULL, NULL);
+	return task;
+}
+
+static void CU_parse_task_free(CUParseTask *task) {
+	if (!task) {
+		return;
+	}
+	rz_vector_fini(&task->locations);
+	free(task);
+}
+
+static void CU_parse_task_run(CUParseTask *task, void *user) {
+	R_clone(task->ctx->info->R, &task->R);
+	R_seek(&task->R, (st64)CU_dies_offset(task->unit), SEEK_SET);
+	CU_dies_parse(task);
+	task->done = true;
+}
+
 /**
- * \brief Parses whole .debug_info section
+ * \brief Decodes the DIEs of \p units, in parallel when there are several of them
+ */
+static bool CU_dies_load(DebugInfoContext *ctx, RzPVector /*<RzBinDwarfCompUnit *>*/ *units) {
+	RzPVector tasks;
+	rz_pvector_init(&tasks, (RzPVectorFree)CU_parse_task_free);
+	if (!rz_pvector_empty(units) && !rz_pvector_reserve(&tasks, rz_pvector_len(units))) {
+		return false;
+	}
+	void **it;
+	rz_pvector_foreach (units, it) {
+		RzBinDwarfCompUnit *unit = *it;
+		CUParseTask *task = CU_parse_task_new(ctx, unit);
+		if (!task) {
+			// the abbreviations were checked by CU_parse_all(), so keep the unit empty
+			unit->dies->loaded = true;
+			continue;
+		}
+		rz_pvector_push(&tasks, task);
+	}
+
+	RzThreadNCores max_threads = ctx->dw->max_threads;
+	if (rz_pvector_len(&tasks) > 1 && rz_th_max_threads(max_threads) > 1 &&
+		!rz_th_iterate_pvector(&tasks, (RzThreadIterator)CU_parse_task_run, max_threads, NULL)) {
+		RZ_LOG_WARN("DWARF: failed to parse the compilation units in parallel\n");
+	}
+
+	// merge the units in order, so that the shared tables
+	// are filled as if the units were parsed one after the other.
+	rz_pvector_foreach (&tasks, it) {
+		CUParseTask *task = *it;
+		if (!task->done) {
+			CU_parse_task_run(task, NULL);
+		}
+		ut64 *offset = NULL;
+		rz_vector_foreach (&task->locations, offset) {
+			ht_up_insert(ctx->info->location_encoding, *offset, &task->unit->hdr.encoding);
+		}
+		task->unit->dies->loaded = true;
+		ctx->info->die_count += rz_vector_len(&task->unit->dies->vec);
+	}
+	rz_pvector_fini(&tasks);
+	return true;
+}
+
+/**
+ * \brief Applies the unit DIE of \p unit, without keeping any DIE in memory
+ */
+static bool CU_root_parse(DebugInfoContext *ctx, RzBinDwarfCompUnit *unit) {
+	CUParseTask *task = CU_parse_task_new(ctx, unit);
+	if (!task) {
+		return false;
+	}
+	task->root_only = true;
+	CU_parse_task_run(task, NULL);
+	RzBinDwarfDie *die = rz_vector_head(&unit->dies->vec);
+	if (die) {
+		CU_die_apply(ctx, unit, die);
+	} else if (unit->hdr.ut == DW_UT_skeleton) {
+		RZ_LOG_ERROR("Invalid DW_UT_skeleton [0x%" PFMT64x "]\n", unit->offset);
+	}
+	rz_vector_clear(&unit->dies->vec);
+	CU_parse_task_free(task);
+	return true;
+}
+
+/**
+ * \brief Builds the unit index of the .debug_info section
+ *
+ * Only the unit headers and the unit DIEs are read here, the other
+ * DIEs of a unit are decoded on demand by rz_bin_dwarf_unit_dies().
  */
 static bool CU_parse_all(DebugInfoContext *ctx) {
 	RzBinEndianReader *buffer = ctx->info->R;
@@ -293,31 +436,182 @@ static bool CU_parse_all(DebugInfoContext *ctx) {
 			.offset = offset,
 		};
 		if (CU_init(&unit) < 0) {
-			goto cleanup;
+			return false;
 		}
 		if (!CU_Hdr_parse(ctx, &unit)) {
+			CU_fini(&unit, NULL);
 			break;
 		}
-		if (unit.hdr.length > R_size(buffer)) {
-			goto cleanup;
-		}
-
-		RzBinDwarfAbbrevTable *tbl = ht_up_find(
-			ctx->dw->abbrev->by_offset, unit.hdr.abbrev_offset, NULL);
-		if (!tbl) {
-			goto cleanup;
+		if (unit.hdr.length > R_size(buffer) ||
+			!ht_up_find(ctx->dw->abbrev->by_offset, unit.hdr.abbrev_offset, NULL)) {
+			CU_fini(&unit, NULL);
+			return false;
 		}
 
 		RZ_LOG_DEBUG("0x%" PFMT64x ":\tcompile unit length = 0x%" PFMT64x ", abbr_offset: 0x%" PFMT64x "\n",
 			unit.offset, unit.hdr.length, unit.hdr.abbrev_offset);
-		CU_dies_parse(ctx, &unit, tbl);
-		ctx->info->die_count += rz_vector_len(&unit.dies);
 		unit.index = index++;
-		rz_vector_push(&ctx->info->units, &unit);
+		if (!rz_vector_push(&ctx->info->units, &unit)) {
+			CU_fini(&unit, NULL);
+			return false;
+		}
+		R_seek(buffer, (st64)CU_next(&unit), SEEK_SET);
+	}
+
+	RzBinDwarfCompUnit *unit = NULL;
+	rz_vector_foreach (&ctx->info->units, unit) {
+		if (!CU_root_parse(ctx, unit)) {
+			return false;
+		}
 	}
 	return true;
-cleanup:
-	return false;
+}
+
+/**
+ * \brief Returns the DIEs of \p unit, decoding them if they are not in memory yet
+ *
+ * The returned vector stays valid until the DIEs are released by
+ * rz_bin_dwarf_unit_dies_release() or rz_bin_dwarf_info_dies_release().
+ * \param dw RzBinDWARF instance whose info contains \p unit
+ * \param unit The unit to get the DIEs of
+ * \return RzVector<RzBinDwarfDie> of the unit, sorted by offset
+ */
+RZ_API RZ_BORROW RzVector /*<RzBinDwarfDie>*/ *rz_bin_dwarf_unit_dies(
+	RZ_BORROW RZ_NONNULL RzBinDWARF *dw,
+	RZ_BORROW RZ_NONNULL RzBinDwarfCompUnit *unit) {
+	rz_return_val_if_fail(dw && dw->info && unit, NULL);
+	if (!unit->dies->loaded) {
+		DebugInfoContext ctx = {
+			.info = dw->info,
+			.dw = dw,
+		};
+		RzPVector units;
+		rz_pvector_init(&units, NULL);
+		if (rz_pvector_push(&units, unit)) {
+			CU_dies_load(&ctx, &units);
+		}
+		rz_pvector_fini(&units);
+	}
+	return &unit->dies->vec;
+}
+
+/**
+ * \brief Tells whether the DIEs of \p unit are decoded and kept in memory
+ */
+RZ_API bool rz_bin_dwarf_unit_dies_loaded(RZ_BORROW RZ_NONNULL const RzBinDwarfCompUnit *unit) {
+	rz_return_val_if_fail(unit, false);
+	return unit->dies->loaded;
+}
+
+/**
+ * \brief Decodes the DIEs of all the \p units that are not in memory yet, in parallel
+ *
+ * The DIEs stay valid until they are released, like the ones of rz_bin_dwarf_unit_dies().
+ * \param dw RzBinDWARF instance whose info contains \p units
+ * \param units RzPVector<RzBinDwarfCompUnit *> of the units to decode
+ * \return true on success
+ */
+RZ_API bool rz_bin_dwarf_units_dies_load(
+	RZ_BORROW RZ_NONNULL RzBinDWARF *dw,
+	RZ_BORROW RZ_NONNULL RzPVector /*<RzBinDwarfCompUnit *>*/ *units) {
+	rz_return_val_if_fail(dw && dw->info && units, false);
+	RzPVector unloaded;
+	rz_pvector_init(&unloaded, NULL);
+	void **it;
+	rz_pvector_foreach (units, it) {
+		RzBinDwarfCompUnit *unit = *it;
+		if (!unit->dies->loaded && !rz_pvector_push(&unloaded, unit)) {
+			rz_pvector_fini(&unloaded);
+			return false;
+		}
+	}
+	DebugInfoContext ctx = {
+		.info = dw->info,
+		.dw = dw,
+	};
+	bool result = CU_dies_load(&ctx, &unloaded);
+	rz_pvector_fini(&unloaded);
+	return result;
+}
+
+/**
+ * \brief Frees the DIEs of \p unit, they are decoded again on the next access
+ */
+RZ_API void rz_bin_dwarf_unit_dies_release(
+	RZ_BORROW RZ_NONNULL RzBinDwarfInfo *info,
+	RZ_BORROW RZ_NONNULL RzBinDwarfCompUnit *unit) {
+	rz_return_if_fail(info && unit);
+	if (!unit->dies->loaded) {
+		return;
+	}
+	info->die_count -= rz_vector_len(&unit->dies->vec);
+	rz_vector_clear(&unit->dies->vec);
+	unit->dies->loaded = false;
+}
+
+/**
+ * \brief Frees the DIEs of all the units of \p info
+ */
+RZ_API void rz_bin_dwarf_info_dies_release(RZ_BORROW RZ_NONNULL RzBinDwarfInfo *info) {
+	rz_return_if_fail(info);
+	RzBinDwarfCompUnit *unit = NULL;
+	rz_vector_foreach (&info->units, unit) {
+		rz_bin_dwarf_unit_dies_release(info, unit);
+	}
+}
+
+/**
+ * \brief Finds the unit whose contribution to .debug_info contains \p offset
+ */
+RZ_API RZ_BORROW RzBinDwarfCompUnit *rz_bin_dwarf_unit_at(
+	RZ_BORROW RZ_NONNULL RzBinDwarfInfo *info, ut64 offset) {
+	rz_return_val_if_fail(info, NULL);
+	size_t lo = 0;
+	size_t hi = rz_vector_len(&info->units);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		RzBinDwarfCompUnit *unit = rz_vector_index_ptr(&info->units, mid);
+		if (offset < unit->offset) {
+			hi = mid;
+		} else if (offset >= CU_next(unit)) {
+			lo = mid + 1;
+		} else {
+			return unit;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * \brief Finds the DIE at \p offset in .debug_info, decoding its unit if needed
+ *
+ * The returned DIE has the same lifetime as the vector of rz_bin_dwarf_unit_dies().
+ */
+RZ_API RZ_BORROW RzBinDwarfDie *rz_bin_dwarf_die_at(
+	RZ_BORROW RZ_NONNULL RzBinDWARF *dw, ut64 offset) {
+	rz_return_val_if_fail(dw && dw->info, NULL);
+	RzBinDwarfCompUnit *unit = rz_bin_dwarf_unit_at(dw->info, offset);
+	if (!unit) {
+		return NULL;
+	}
+	RzVector *dies = rz_bin_dwarf_unit_dies(dw, unit);
+	if (!dies) {
+		return NULL;
+	}
+	size_t lo = 0;
+	size_t hi = rz_vector_len(dies);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		RzBinDwarfDie *die = rz_vector_index_ptr(dies, mid);
+		if (offset < die->offset) {
+			hi = mid;
+		} else if (offset > die->offset) {
+			lo = mid + 1;
+		} else {
+			return die;
+		}
+	}
+	return NULL;
 }
 
 RZ_API RZ_BORROW RzBinDwarfAttr *rz_bin_dwarf_die_get_attr(
@@ -352,7 +646,6 @@ static inline void info_free(RzBinDwarfInfo *info) {
 	R_free(info->R);
 	rz_vector_fini(&info->units);
 	ht_up_free(info->comp_dir_by_offset);
-	ht_up_free(info->die_by_offset);
 	ht_up_free(info->unit_by_offset);
 	ht_up_free(info->location_encoding);
 	free(info);
@@ -381,38 +674,11 @@ RZ_API RZ_OWN RzBinDwarfInfo *rz_bin_dwarf_info_from_buf(
 	};
 	ERR_IF_FAIL(CU_parse_all(&ctx));
 
-	info->die_by_offset = ht_up_new_size(info->die_count, NULL, NULL);
-	ERR_IF_FAIL(info->die_by_offset);
 	info->unit_by_offset = ht_up_new_size(rz_vector_len(&info->units), NULL, NULL);
 	ERR_IF_FAIL(info->unit_by_offset);
-
-	// build hashtable after whole parsing because of possible relocations
 	RzBinDwarfCompUnit *unit = NULL;
 	rz_vector_foreach (&info->units, unit) {
 		ht_up_insert(info->unit_by_offset, unit->offset, unit);
-		switch (unit->hdr.ut) {
-		case DW_UT_skeleton: {
-			RzBinDwarfDie *die = rz_vector_head(&unit->dies);
-			if (!die) {
-				RZ_LOG_ERROR("Invalid DW_UT_skeleton [0x%" PFMT64x "]\n", unit->offset);
-				break;
-			}
-			break;
-		}
-		case DW_UT_compile:
-		case DW_UT_type:
-		case DW_UT_partial:
-		case DW_UT_split_compile:
-		case DW_UT_split_type:
-		case DW_UT_lo_user:
-		case DW_UT_hi_user:
-		default: break;
-		}
-
-		RzBinDwarfDie *die = NULL;
-		rz_vector_foreach (&unit->dies, die) {
-			ht_up_insert(info->die_by_offset, die->offset, die); // optimization for further processing
-		}
 	}
 	return info;
 err:
@@ -440,11 +706,27 @@ RZ_API void rz_bin_dwarf_debug_info_dump(
 	RZ_NONNULL RZ_BORROW const RzBinDwarfInfo *info,
 	RZ_NONNULL RZ_BORROW const RzBinDWARF *dw,
 	RZ_NONNULL RZ_BORROW RzStrBuf *sb) {
-	rz_return_if_fail(info && sb);
+	rz_return_if_fail(info && dw && sb);
 	if (!rz_vector_empty(&info->units)) {
 		rz_strbuf_append(sb, "\n.debug_info content:\n");
 	}
+	// every DIE is printed, so decode the missing units at once and release them afterwards.
+	// The decoded DIEs are a cache, the parsed content of info and dw is left as it was.
+	RzBinDwarfInfo *cache = (RzBinDwarfInfo *)info;
+	RzPVector unloaded;
+	rz_pvector_init(&unloaded, NULL);
 	RzBinDwarfCompUnit *unit = NULL;
+	rz_vector_foreach (&cache->units, unit) {
+		if (!unit->dies->loaded) {
+			rz_pvector_push(&unloaded, unit);
+		}
+	}
+	DebugInfoContext ctx = {
+		.info = cache,
+		.dw = (RzBinDWARF *)dw,
+	};
+	CU_dies_load(&ctx, &unloaded);
+
 	rz_vector_foreach (&info->units, unit) {
 		const char *ut = rz_bin_dwarf_unit_type(unit->hdr.ut ? unit->hdr.ut : DW_UT_compile);
 		rz_strbuf_appendf(sb, "0x%08" PFMT64x ":\t%s\n", unit->offset, ut);
@@ -455,7 +737,7 @@ RZ_API void rz_bin_dwarf_debug_info_dump(
 		rz_strbuf_append(sb, "\n");
 
 		RzBinDwarfDie *die = NULL;
-		rz_vector_foreach (&unit->dies, die) {
+		rz_vector_foreach (&unit->dies->vec, die) {
 			rz_strbuf_appendf(sb, "%#08" PFMT64x ": %s [%" PFMT64u "]\n",
 				die->offset, rz_bin_dwarf_tag(die->tag), die->abbrev_code);
 			if (die->abbrev_code) {
@@ -464,11 +746,17 @@ RZ_API void rz_bin_dwarf_debug_info_dump(
 					if (!attr->at) {
 						continue;
 					}
-					rz_bin_dwarf_attr_dump(attr, (RzBinDWARF *)dw, unit->str_offsets_base, sb);
+					rz_bin_dwarf_attr_dump(attr, ctx.dw, unit->str_offsets_base, sb);
 					rz_strbuf_append(sb, "\n");
 				}
 			}
 			rz_strbuf_append(sb, "\n");
 		}
 	}
+
+	void **it;
+	rz_pvector_foreach (&unloaded, it) {
+		rz_bin_dwarf_unit_dies_release(cache, *it);
+	}
+	rz_pvector_fini(&unloaded);
 }
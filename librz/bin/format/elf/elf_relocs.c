@@ -5,7 +5,8 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include "elf.h"
-#include <rz_util/ht_uu.h>
+
+#define ELF_RELOCS_BATCH 0x400 ///< Maximum number of relocations read from the buffer at once
 
 struct relocs_segment {
 	ut64 offset;
@@ -58,76 +59,165 @@ static ut64 get_size_rel_mode(ut64 mode) {
 	return mode == DT_REL ? sizeof(Elf_(Rel)) : sizeof(Elf_(Rela));
 }
 
-static bool read_reloc_entry_aux(ELFOBJ *bin, Elf_(Rela) * reloc, ut64 offset, ut64 mode) {
-	if (!Elf_(rz_bin_elf_read_addr)(bin, &offset, &reloc->rz_offset) ||
-		!Elf_(rz_bin_elf_read_word_xword)(bin, &offset, &reloc->rz_info)) {
-		return false;
+static inline void decode_reloc_entry(const ut8 *buf, bool big_endian, ut64 mode, Elf_(Rela) * reloc) {
+#if RZ_BIN_ELF64
+	reloc->rz_offset = rz_read_ble64(buf, big_endian);
+	reloc->rz_info = rz_read_ble64(buf + 8, big_endian);
+	reloc->rz_addend = mode == DT_REL ? 0 : convert_to_two_complement_64(rz_read_ble64(buf + 16, big_endian));
+#else
+	reloc->rz_offset = rz_read_ble32(buf, big_endian);
+	reloc->rz_info = rz_read_ble32(buf + 4, big_endian);
+	reloc->rz_addend = mode == DT_REL ? 0 : convert_to_two_complement_32(rz_read_ble32(buf + 8, big_endian));
+#endif
+}
+
+/**
+ * Reads \p count relocations of \p segment starting from the entry at
+ * \p offset with a single read of the buffer and returns the number of
+ * entries decoded.
+ */
+static size_t get_reloc_entries(ELFOBJ *bin, struct relocs_segment *segment, ut64 offset, size_t count, ut8 *buf, Elf_(Rela) * result) {
+	ut64 read_size = get_size_rel_mode(segment->mode);
+	ut64 span = (count - 1) * segment->entry_size + read_size;
+	st64 read = rz_buf_read_at(bin->b, offset, buf, span);
+	if (read < (st64)read_size) {
+		return 0;
 	}
 
-	if (mode == DT_REL) {
-		reloc->rz_addend = 0;
-		return true;
+	count = RZ_MIN(count, ((ut64)read - read_size) / segment->entry_size + 1);
+
+	// the endianness and the mode are constants in each loop, so each one gets its own decoder
+	if (bin->big_endian) {
+		if (segment->mode == DT_REL) {
+			for (size_t i = 0; i < count; i++) {
+				decode_reloc_entry(buf + i * segment->entry_size, true, DT_REL, &result[i]);
+			}
+		} else {
+			for (size_t i = 0; i < count; i++) {
+				decode_reloc_entry(buf + i * segment->entry_size, true, DT_RELA, &result[i]);
+			}
+		}
+	} else {
+		if (segment->mode == DT_REL) {
+			for (size_t i = 0; i < count; i++) {
+				decode_reloc_entry(buf + i * segment->entry_size, false, DT_REL, &result[i]);
+			}
+		} else {
+			for (size_t i = 0; i < count; i++) {
+				decode_reloc_entry(buf + i * segment->entry_size, false, DT_RELA, &result[i]);
+			}
+		}
 	}
 
-	return Elf_(rz_bin_elf_read_sword_sxword)(bin, &offset, &reloc->rz_addend);
+	return count;
 }
 
-static bool read_reloc_entry(ELFOBJ *bin, Elf_(Rela) * reloc, ut64 offset, ut64 mode) {
-	if (!read_reloc_entry_aux(bin, reloc, offset, mode)) {
-		RZ_LOG_WARN("Failed to read reloc at 0x%" PFMT64x ".\n", offset);
-		return false;
-	}
+static void convert_reloc_entry(RzBinElfReloc *reloc, Elf_(Rela) * entry, ut64 mode) {
+	reloc->mode = mode;
+	reloc->offset = entry->rz_offset;
+	reloc->sym = ELF_R_SYM(entry->rz_info);
+	reloc->type = ELF_R_TYPE(entry->rz_info);
+	reloc->addend = entry->rz_addend;
+}
 
-	return true;
+static bool segments_overlap(struct relocs_segment *a, struct relocs_segment *b) {
+	if (a->offset >= b->offset) {
+		return a->offset - b->offset < b->size;
+	}
+	return b->offset - a->offset < a->size;
 }
 
-static bool get_reloc_entry(ELFOBJ *bin, RzBinElfReloc *reloc, ut64 offset, ut64 mode) {
-	Elf_(Rela) tmp;
-	if (!read_reloc_entry(bin, &tmp, offset, mode)) {
+static bool segment_has_entry(struct relocs_segment *segment, ut64 offset) {
+	if (offset < segment->offset) {
 		return false;
 	}
-
-	reloc->mode = mode;
-	reloc->offset = tmp.rz_offset;
-	reloc->sym = ELF_R_SYM(tmp.rz_info);
-	reloc->type = ELF_R_TYPE(tmp.rz_info);
-	reloc->addend = tmp.rz_addend;
-
-	return true;
+	ut64 delta = offset - segment->offset;
+	return delta < segment->size && !(delta % segment->entry_size);
 }
 
-static bool has_already_been_processed(ELFOBJ *bin, ut64 offset, HtUU *set) {
-	bool found;
-	ht_uu_find(set, offset, &found);
+static bool has_already_been_processed(RzPVector /*<struct relocs_segment *>*/ *overlapping, ut64 offset) {
+	void **it;
+	rz_pvector_foreach (overlapping, it) {
+		if (segment_has_entry(*it, offset)) {
+			return true;
+		}
+	}
 
-	return found;
+	return false;
 }
 
-static bool get_relocs_entry(ELFOBJ *bin, RzBinElfSection *section, RzVector /*<RzBinElfReloc>*/ *relocs, struct relocs_segment *segment, HtUU *set) {
-	for (ut64 entry_offset = 0; entry_offset < segment->size; entry_offset += segment->entry_size) {
-		if (has_already_been_processed(bin, segment->offset + entry_offset, set)) {
-			continue;
-		}
+static bool get_relocs_entry(ELFOBJ *bin, RzBinElfSection *section, RzVector /*<RzBinElfReloc>*/ *relocs, struct relocs_segment *segment, RzVector /*<struct relocs_segment>*/ *processed) {
+	if (!segment->size) {
+		return true;
+	}
+	if (!segment->entry_size) {
+		RZ_LOG_WARN("Invalid relocation entry size at 0x%" PFMT64x ".\n", segment->offset);
+		return true;
+	}
 
-		if (!ht_uu_insert(set, segment->offset + entry_offset, segment->offset + entry_offset)) {
+	// only the entries of the segments overlapping this one may have been processed already
+	RzPVector overlapping;
+	rz_pvector_init(&overlapping, NULL);
+	struct relocs_segment *other;
+	rz_vector_foreach (processed, other) {
+		if (segments_overlap(segment, other) && !rz_pvector_push(&overlapping, other)) {
+			rz_pvector_fini(&overlapping);
 			return false;
 		}
+	}
 
-		RzBinElfReloc tmp = { 0 };
-		if (!get_reloc_entry(bin, &tmp, segment->offset + entry_offset, segment->mode)) {
-			return false;
+	size_t batch = ELF_RELOCS_BATCH;
+	if (segment->entry_size > sizeof(Elf_(Rela))) {
+		// the entries read at once must fit in buf
+		batch = RZ_MIN(batch, (ELF_RELOCS_BATCH - 1) * sizeof(Elf_(Rela)) / segment->entry_size + 1);
+	}
+
+	ut8 *buf = RZ_NEWS(ut8, ELF_RELOCS_BATCH * sizeof(Elf_(Rela)));
+	Elf_(Rela) *entries = RZ_NEWS(Elf_(Rela), ELF_RELOCS_BATCH);
+	if (!buf || !entries) {
+		goto fail;
+	}
+
+	ut64 number = (segment->size - 1) / segment->entry_size + 1;
+	for (ut64 i = 0; i < number;) {
+		ut64 offset = segment->offset + i * segment->entry_size;
+		size_t count = RZ_MIN(batch, number - i);
+		size_t decoded = get_reloc_entries(bin, segment, offset, count, buf, entries);
+
+		for (size_t j = 0; j < decoded; j++, i++) {
+			ut64 entry_offset = segment->offset + i * segment->entry_size;
+			if (!rz_pvector_empty(&overlapping) && has_already_been_processed(&overlapping, entry_offset)) {
+				continue;
+			}
+
+			RzBinElfReloc tmp = { 0 };
+			convert_reloc_entry(&tmp, &entries[j], segment->mode);
+			fix_rva_and_offset(bin, &tmp, section);
+
+			if (!rz_vector_push(relocs, &tmp)) {
+				goto fail;
+			}
 		}
-		fix_rva_and_offset(bin, &tmp, section);
 
-		if (!rz_vector_push(relocs, &tmp)) {
-			return false;
+		if (decoded < count) {
+			RZ_LOG_WARN("Failed to read reloc at 0x%" PFMT64x ".\n", offset + decoded * segment->entry_size);
+			goto fail;
 		}
 	}
 
-	return true;
+	free(entries);
+	free(buf);
+	rz_pvector_fini(&overlapping);
+	return rz_vector_push(processed, segment);
+
+fail:
+	free(entries);
+	free(buf);
+	rz_pvector_fini(&overlapping);
+	return false;
 }
 
-static bool get_relocs_entry_from_dt_dynamic_aux(ELFOBJ *bin, RzVector /*<RzBinElfReloc>*/ *relocs, ut64 dt_addr, ut64 dt_size, ut64 entry_size, ut64 mode, HtUU *set) {
+static bool get_relocs_entry_from_dt_dynamic_aux(ELFOBJ *bin, RzVector /*<RzBinElfReloc>*/ *relocs, ut64 dt_addr, ut64 dt_size, ut64 entry_size, ut64 mode, RzVector /*<struct relocs_segment>*/ *processed) {
 	ut64 addr;
 	ut64 size;
 
@@ -142,10 +232,10 @@ static bool get_relocs_entry_from_dt_dynamic_aux(ELFOBJ *bin, RzVector /*<RzBinE
 
 	struct relocs_segment segment = relocs_segment_init(offset, size, entry_size, mode);
 
-	return get_relocs_entry(bin, NULL, relocs, &segment, set);
+	return get_relocs_entry(bin, NULL, relocs, &segment, processed);
 }
 
-static bool get_relocs_entry_from_dt_dynamic(ELFOBJ *bin, RzVector /*<RzBinElfReloc>*/ *relocs, HtUU *set) {
+static bool get_relocs_entry_from_dt_dynamic(ELFOBJ *bin, RzVector /*<RzBinElfReloc>*/ *relocs, RzVector /*<struct relocs_segment>*/ *processed) {
 	ut64 entry_size;
 
 	if (!Elf_(rz_bin_elf_has_dt_dynamic)(bin)) {
@@ -155,13 +245,13 @@ static bool get_relocs_entry_from_dt_dynamic(ELFOBJ *bin, RzVector /*<RzBinElfRe
 	ut64 dt_pltrel;
 	if (Elf_(rz_bin_elf_get_dt_info)(bin, DT_PLTREL, &dt_pltrel)) {
 		entry_size = get_size_rel_mode(dt_pltrel);
-		if (!get_relocs_entry_from_dt_dynamic_aux(bin, relocs, DT_JMPREL, DT_PLTRELSZ, entry_size, dt_pltrel, set)) {
+		if (!get_relocs_entry_from_dt_dynamic_aux(bin, relocs, DT_JMPREL, DT_PLTRELSZ, entry_size, dt_pltrel, processed)) {
 			return false;
 		}
 	}
 
 	if (Elf_(rz_bin_elf_get_dt_info)(bin, DT_RELENT, &entry_size)) {
-		if (!get_relocs_entry_from_dt_dynamic_aux(bin, relocs, DT_REL, DT_RELSZ, entry_size, DT_REL, set)) {
+		if (!get_relocs_entry_from_dt_dynamic_aux(bin, relocs, DT_REL, DT_RELSZ, entry_size, DT_REL, processed)) {
 			return false;
 		}
 	}
@@ -171,7 +261,7 @@ static bool get_relocs_entry_from_dt_dynamic(ELFOBJ *bin, RzVector /*<RzBinElfRe
 			return false;
 		}
 
-		if (!get_relocs_entry_from_dt_dynamic_aux(bin, relocs, DT_RELA, DT_RELASZ, entry_size, DT_RELA, set)) {
+		if (!get_relocs_entry_from_dt_dynamic_aux(bin, relocs, DT_RELA, DT_RELASZ, entry_size, DT_RELA, processed)) {
 			return false;
 		}
 	}
@@ -183,7 +273,7 @@ static ut64 get_section_relocation_mode(RzBinElfSection *section) {
 	return section->type == SHT_REL ? DT_REL : DT_RELA;
 }
 
-static bool get_relocs_entry_from_sections(ELFOBJ *bin, RzVector /*<RzBinElfReloc>*/ *relocs, HtUU *set) {
+static bool get_relocs_entry_from_sections(ELFOBJ *bin, RzVector /*<RzBinElfReloc>*/ *relocs, RzVector /*<struct relocs_segment>*/ *processed) {
 	RzBinElfSection *section;
 	rz_bin_elf_foreach_sections(bin, section) {
 		if (!section->is_valid || (section->type != SHT_REL && section->type != SHT_RELA)) {
@@ -195,7 +285,7 @@ static bool get_relocs_entry_from_sections(ELFOBJ *bin, RzVector /*<RzBinElfRelo
 
 		struct relocs_segment segment = relocs_segment_init(section->offset, section->size, entry_size, mode);
 
-		if (!get_relocs_entry(bin, section, relocs, &segment, set)) {
+		if (!get_relocs_entry(bin, section, relocs, &segment, processed)) {
 			return false;
 		}
 	}
@@ -206,36 +296,36 @@ static bool get_relocs_entry_from_sections(ELFOBJ *bin, RzVector /*<RzBinElfRelo
 RZ_OWN RzVector /*<RzBinElfReloc>*/ *Elf_(rz_bin_elf_relocs_new)(RZ_NONNULL ELFOBJ *bin) {
 	rz_return_val_if_fail(bin, NULL);
 
-	HtUU *set = ht_uu_new();
-	if (!set) {
+	RzVector *processed = rz_vector_new(sizeof(struct relocs_segment), NULL, NULL);
+	if (!processed) {
 		return NULL;
 	}
 
 	RzVector *result = rz_vector_new(sizeof(RzBinElfReloc), NULL, NULL);
 	if (!result) {
-		ht_uu_free(set);
+		rz_vector_free(processed);
 		return NULL;
 	}
 
-	if (!get_relocs_entry_from_dt_dynamic(bin, result, set)) {
+	if (!get_relocs_entry_from_dt_dynamic(bin, result, processed)) {
 		rz_vector_free(result);
-		ht_uu_free(set);
+		rz_vector_free(processed);
 		return NULL;
 	}
 
-	if (!get_relocs_entry_from_sections(bin, result, set)) {
+	if (!get_relocs_entry_from_sections(bin, result, processed)) {
 		rz_vector_free(result);
-		ht_uu_free(set);
+		rz_vector_free(processed);
 		return NULL;
 	}
 
 	if (!rz_vector_len(result)) {
 		rz_vector_free(result);
-		ht_uu_free(set);
+		rz_vector_free(processed);
 		return NULL;
 	}
 
-	ht_uu_free(set);
+	rz_vector_free(processed);
 
 	return result;
 }
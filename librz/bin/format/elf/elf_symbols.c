@@ -8,6 +8,7 @@
 #include <rz_util/ht_uu.h>
 
 #define HASH_NCHAIN_OFFSET(x) ((x) + 4)
+#define ELF_SYMBOLS_BATCH     0x400 ///< Maximum number of symbols read from the buffer at once
 
 struct symbols_segment {
 	ut64 offset;
@@ -150,31 +151,50 @@ static const char *symbol_bind_to_str(Elf_(Sym) * sym) {
 	return RZ_BIN_BIND_UNKNOWN_STR;
 }
 
-static bool get_symbol_entry_aux(ELFOBJ *bin, ut64 offset, Elf_(Sym) * result) {
+static inline void decode_symbol_entry(const ut8 *buf, bool big_endian, Elf_(Sym) * result) {
 #if RZ_BIN_ELF64
-	return Elf_(rz_bin_elf_read_word)(bin, &offset, &result->st_name) &&
-		Elf_(rz_bin_elf_read_char)(bin, &offset, &result->st_info) &&
-		Elf_(rz_bin_elf_read_char)(bin, &offset, &result->st_other) &&
-		Elf_(rz_bin_elf_read_section)(bin, &offset, &result->st_shndx) &&
-		Elf_(rz_bin_elf_read_addr)(bin, &offset, &result->st_value) &&
-		Elf_(rz_bin_elf_read_xword)(bin, &offset, &result->st_size);
+	result->st_name = rz_read_ble32(buf, big_endian);
+	result->st_info = buf[4];
+	result->st_other = buf[5];
+	result->st_shndx = rz_read_ble16(buf + 6, big_endian);
+	result->st_value = rz_read_ble64(buf + 8, big_endian);
+	result->st_size = rz_read_ble64(buf + 16, big_endian);
 #else
-	return Elf_(rz_bin_elf_read_word)(bin, &offset, &result->st_name) &&
-		Elf_(rz_bin_elf_read_addr)(bin, &offset, &result->st_value) &&
-		Elf_(rz_bin_elf_read_word)(bin, &offset, &result->st_size) &&
-		Elf_(rz_bin_elf_read_char)(bin, &offset, &result->st_info) &&
-		Elf_(rz_bin_elf_read_char)(bin, &offset, &result->st_other) &&
-		Elf_(rz_bin_elf_read_section)(bin, &offset, &result->st_shndx);
+	result->st_name = rz_read_ble32(buf, big_endian);
+	result->st_value = rz_read_ble32(buf + 4, big_endian);
+	result->st_size = rz_read_ble32(buf + 8, big_endian);
+	result->st_info = buf[12];
+	result->st_other = buf[13];
+	result->st_shndx = rz_read_ble16(buf + 14, big_endian);
 #endif
 }
 
-static bool get_symbol_entry(ELFOBJ *bin, ut64 offset, Elf_(Sym) * result) {
-	if (!get_symbol_entry_aux(bin, offset, result)) {
-		RZ_LOG_WARN("Failed to read symbol entry at 0x%" PFMT64x ".\n", offset);
-		return false;
+/**
+ * Reads \p count symbols, each one \p entry_size bytes after the previous one,
+ * with a single read of the buffer and returns the number of entries decoded.
+ */
+static size_t get_symbol_entries(ELFOBJ *bin, ut64 offset, size_t count, ut64 entry_size, ut8 *buf, Elf_(Sym) * result) {
+	ut64 span = (count - 1) * entry_size + sizeof(Elf_(Sym));
+	st64 read = rz_buf_read_at(bin->b, offset, buf, span);
+	if (read < (st64)sizeof(Elf_(Sym))) {
+		return 0;
 	}
 
-	return true;
+	size_t available = entry_size ? ((ut64)read - sizeof(Elf_(Sym))) / entry_size + 1 : count;
+	count = RZ_MIN(count, available);
+
+	// the endianness is a constant in each loop, so each one gets its own decoder
+	if (bin->big_endian) {
+		for (size_t i = 0; i < count; i++) {
+			decode_symbol_entry(buf + i * entry_size, true, &result[i]);
+		}
+	} else {
+		for (size_t i = 0; i < count; i++) {
+			decode_symbol_entry(buf + i * entry_size, false, &result[i]);
+		}
+	}
+
+	return count;
 }
 
 static bool is_section_local_symbol(ELFOBJ *bin, Elf_(Sym) * symbol) {
@@ -261,34 +281,60 @@ static bool compute_symbols_from_segment(ELFOBJ *bin, RzVector /*<RzBinElfSymbol
 		return false;
 	}
 
-	ut64 offset = segment->offset + segment->entry_size;
+	if (segment->number < 2) {
+		return true;
+	}
 
-	for (size_t i = 1; i < segment->number; i++) {
-		Elf_(Sym) entry;
-		if (!get_symbol_entry(bin, offset, &entry)) {
-			return false;
-		}
+	ut64 entry_size = segment->entry_size;
+	size_t batch = ELF_SYMBOLS_BATCH;
+	if (entry_size > sizeof(Elf_(Sym))) {
+		// the entries read at once must fit in buf
+		batch = RZ_MIN(batch, (ELF_SYMBOLS_BATCH - 1) * sizeof(Elf_(Sym)) / entry_size + 1);
+	}
 
-		if (!filter(bin, &entry, segment->dynamic)) {
-			offset += segment->entry_size;
-			continue;
-		}
+	ut8 *buf = RZ_NEWS(ut8, ELF_SYMBOLS_BATCH * sizeof(Elf_(Sym)));
+	Elf_(Sym) *entries = RZ_NEWS(Elf_(Sym), ELF_SYMBOLS_BATCH);
+	if (!buf || !entries) {
+		goto fail;
+	}
 
-		RzBinElfSymbol symbol = { 0 };
+	for (ut64 i = 1; i < segment->number;) {
+		ut64 offset = segment->offset + i * entry_size;
+		size_t count = RZ_MIN(batch, segment->number - i);
+		size_t decoded = get_symbol_entries(bin, offset, count, entry_size, buf, entries);
 
-		if (!convert_elf_symbol_entry(bin, segment, &symbol, &entry, i)) {
-			return false;
-		}
+		for (size_t j = 0; j < decoded; j++, i++) {
+			Elf_(Sym) *entry = &entries[j];
+			if (!filter(bin, entry, segment->dynamic)) {
+				continue;
+			}
 
-		if (!rz_vector_push(result, &symbol)) {
-			elf_symbol_fini(&symbol, NULL);
-			return false;
+			RzBinElfSymbol symbol = { 0 };
+
+			if (!convert_elf_symbol_entry(bin, segment, &symbol, entry, i)) {
+				goto fail;
+			}
+
+			if (!rz_vector_push(result, &symbol)) {
+				elf_symbol_fini(&symbol, NULL);
+				goto fail;
+			}
 		}
 
-		offset += segment->entry_size;
+		if (decoded < count) {
+			RZ_LOG_WARN("Failed to read symbol entry at 0x%" PFMT64x ".\n", offset + decoded * entry_size);
+			goto fail;
+		}
 	}
 
+	free(entries);
+	free(buf);
 	return true;
+
+fail:
+	free(entries);
+	free(buf);
+	return false;
 }
 
 static bool get_dynamic_elf_symbols(ELFOBJ *bin, RzVector /*<RzBinElfSymbol>*/ *result, RzBinElfSymbolFilter filter, HtUU *set) {
@@ -0,0 +1,1348 @@
+// SPDX-FileCopyrightText: 2024 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file analysis_cache.c
+ * Persistent on-disk cache of the auto-analysis results.
+ *
+ * After `aa`/`aaa` the flags and the analysis (functions, blocks, xrefs,
+ * meta, types, ...) are stored on disk and loaded back the next time the
+ * same file is analyzed with the same configuration.
+ *
+ * The bulk of the results, i.e. the xrefs, blocks, functions and flags,
+ * is written as binary records which are read back directly, without going
+ * through the JSON of the project serializers. Their fixed-size fields are
+ * taken from the same field tables the project serializers use for their
+ * keys, so the record layout follows the structs. The rest
+ * (meta, hints, types, flag spaces, ...) is serialized with the regular
+ * project serializers, but instead of the sdb text format every namespace
+ * is written to its own cdb file, which sdb maps into memory as it is.
+ *
+ * Layout on disk:
+ *
+ * <analysis.cache.dir>/<sha256 of the file>/
+ *   root    => key=<digest of the analysis affecting config and analysis level>
+ *              version=<ANALYSIS_CACHE_VERSION>
+ *              ns.count=<n>
+ *              ns.<i>=<namespace path, e.g. analysis/meta>
+ *   ns.<i>  => the key-value pairs of the namespace <i>
+ *   records => <xrefs> <blocks> <functions> <flags>, each a ut64 count
+ *              followed by the records, see the *_records_save() functions
+ *
+ * The cache is only used when the key stored in `root` matches the one
+ * computed from the current configuration, so changing any relevant
+ * option invalidates it automatically.
+ */
+
+#include <rz_core.h>
+#include <rz_util/rz_serialize.h>
+
+#define ANALYSIS_CACHE_VERSION 3
+#define ANALYSIS_CACHE_ROOT    "root"
+#define ANALYSIS_CACHE_RECORDS "records"
+
+/* prefixes of the config options which affect the analysis results */
+static const char *const cache_key_config_prefix[] = {
+	"analysis.",
+	"bin.",
+	"emu.",
+	"esil.",
+	NULL
+};
+
+/* single config options which affect the analysis results */
+static const char *const cache_key_config[] = {
+	"asm.arch",
+	"asm.bits",
+	"asm.cpu",
+	"asm.features",
+	"asm.os",
+	"asm.platform",
+	"cfg.bigendian",
+	"io.va",
+	NULL
+};
+
+static bool config_affects_cache(const char *name) {
+	if (rz_str_startswith(name, "analysis.cache")) {
+		// the cache settings themselves don't change the results
+		return false;
+	}
+	for (size_t i = 0; cache_key_config_prefix[i]; i++) {
+		if (rz_str_startswith(name, cache_key_config_prefix[i])) {
+			return true;
+		}
+	}
+	for (size_t i = 0; cache_key_config[i]; i++) {
+		if (!strcmp(name, cache_key_config[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static ut64 buf_update_hash(const ut8 *buf, ut64 size, void *user) {
+	if (!rz_hash_cfg_update((RzHashCfg *)user, buf, size)) {
+		return 0;
+	}
+	return size;
+}
+
+static void fields_layout_append(RzStrBuf *sb, const char *name, const RzSerializeField *fields, size_t count) {
+	rz_strbuf_appendf(sb, "%s=", name);
+	for (size_t i = 0; i < count; i++) {
+		rz_strbuf_appendf(sb, "%s:%" PFMTSZu ",", fields[i].key, fields[i].size);
+	}
+	rz_strbuf_append(sb, "\n");
+}
+
+/**
+ * \brief Append the layout of the binary records, which depends on the sizes of the struct fields
+ */
+static void records_layout_append(RzStrBuf *sb) {
+	size_t count;
+	const RzSerializeField *fields = rz_serialize_analysis_xref_fields(&count);
+	fields_layout_append(sb, "xref", fields, count);
+	fields = rz_serialize_analysis_block_fields(&count);
+	fields_layout_append(sb, "block", fields, count);
+	fields = rz_serialize_analysis_switch_op_fields(&count);
+	fields_layout_append(sb, "switch_op", fields, count);
+	fields = rz_serialize_analysis_case_op_fields(&count);
+	fields_layout_append(sb, "case_op", fields, count);
+	fields = rz_serialize_analysis_function_fields(&count);
+	fields_layout_append(sb, "function", fields, count);
+	fields = rz_serialize_flag_item_fields(&count);
+	fields_layout_append(sb, "flag", fields, count);
+}
+
+static char *file_digest(RzCore *core) {
+	RzBinFile *bf = rz_bin_cur(core->bin);
+	if (!bf) {
+		return NULL;
+	}
+	RzBuffer *buf = rz_buf_new_with_io_fd(&core->bin->iob, bf->fd);
+	if (!buf) {
+		return NULL;
+	}
+	char *digest = NULL;
+	ut64 size = rz_buf_size(buf);
+	RzHashCfg *md = rz_hash_cfg_new_with_algo2(core->hash, "sha256");
+	if (!size || !md) {
+		goto beach;
+	}
+	if (rz_buf_fwd_scan(buf, 0, size, buf_update_hash, md) != size || !rz_hash_cfg_final(md)) {
+		goto beach;
+	}
+	digest = rz_hash_cfg_get_result_string(md, "sha256", NULL, false);
+beach:
+	rz_hash_cfg_free(md);
+	rz_buf_free(buf);
+	return digest;
+}
+
+/**
+ * \brief Compute the key which identifies the analysis results for the current configuration
+ *
+ * The key is a digest of all the analysis.*, bin.*, esil.* and emu.* options
+ * (except the cache settings), the asm.* and io.* options selecting the code
+ * that is analyzed, the requested analysis level and the layout of the
+ * binary records.
+ */
+RZ_API RZ_OWN char *rz_core_analysis_cache_key(RZ_NONNULL RzCore *core, RzCoreAnalysisType type) {
+	rz_return_val_if_fail(core && core->config, NULL);
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	rz_strbuf_appendf(&sb, "version=%d\nlevel=%d\n", ANALYSIS_CACHE_VERSION, (int)type);
+	records_layout_append(&sb);
+
+	RzListIter *it;
+	RzConfigNode *node;
+	rz_list_foreach (core->config->nodes, it, node) {
+		if (config_affects_cache(node->name)) {
+			rz_strbuf_appendf(&sb, "%s=%s\n", node->name, node->value);
+		}
+	}
+	char *key = rz_hash_cfg_calculate_small_block_string(core->hash, "sha256",
+		(const ut8 *)rz_strbuf_get(&sb), rz_strbuf_length(&sb), NULL, false);
+	rz_strbuf_fini(&sb);
+	return key;
+}
+
+/**
+ * \brief Get the directory where the analysis cache of the currently opened file is stored
+ *
+ * The whole file is hashed to find the directory, so callers doing
+ * several cache operations should compute it once and pass it along.
+ */
+RZ_API RZ_OWN char *rz_core_analysis_cache_path(RZ_NONNULL RzCore *core) {
+	rz_return_val_if_fail(core && core->config, NULL);
+	const char *dir = rz_config_get(core->config, "analysis.cache.dir");
+	if (RZ_STR_ISEMPTY(dir)) {
+		return NULL;
+	}
+	char *digest = file_digest(core);
+	if (!digest) {
+		return NULL;
+	}
+	char *expanded = rz_path_home_expand(dir);
+	char *path = expanded ? rz_file_path_join(expanded, digest) : NULL;
+	free(expanded);
+	free(digest);
+	return path;
+}
+
+/*
+ * Binary records
+ *
+ * All the integers are little endian. The fixed-size fields of the xrefs,
+ * blocks, functions and flags are described by the field tables of their
+ * project serializers (see rz_serialize_analysis_block_fields() etc.) and
+ * written with rz_serialize_fields_write(), so their sizes follow the structs.
+ * A string is a ut32 length followed by the bytes, with UT32_MAX standing
+ * for NULL.
+ *
+ * Every *_records_load() function only checks the records if it is given
+ * no analysis or flags to load them into. The cache is fully checked that
+ * way before anything is replaced.
+ */
+
+typedef struct {
+	RzBuffer *buf;
+	bool failed;
+} RecordWriter;
+
+static void write_u8(RecordWriter *w, ut8 v) {
+	w->failed |= !rz_buf_write8(w->buf, v);
+}
+
+static void write_u16(RecordWriter *w, ut16 v) {
+	w->failed |= !rz_buf_write_le16(w->buf, v);
+}
+
+static void write_u32(RecordWriter *w, ut32 v) {
+	w->failed |= !rz_buf_write_le32(w->buf, v);
+}
+
+static void write_u64(RecordWriter *w, ut64 v) {
+	w->failed |= !rz_buf_write_le64(w->buf, v);
+}
+
+static void write_str(RecordWriter *w, const char *s) {
+	if (!s) {
+		write_u32(w, UT32_MAX);
+		return;
+	}
+	size_t len = strlen(s);
+	write_u32(w, (ut32)len);
+	w->failed |= rz_buf_write(w->buf, (const ut8 *)s, len) != (st64)len;
+}
+
+static void write_fields(RecordWriter *w, const void *obj, const RzSerializeField *fields, size_t count) {
+	w->failed |= !rz_serialize_fields_write(w->buf, obj, fields, count);
+}
+
+/**
+ * \brief Write a placeholder for the number of records that follow, see count_end()
+ */
+static ut64 count_begin(RecordWriter *w) {
+	ut64 at = rz_buf_tell(w->buf);
+	write_u64(w, 0);
+	return at;
+}
+
+static void count_end(RecordWriter *w, ut64 at, ut64 count) {
+	w->failed |= !rz_buf_write_le64_at(w->buf, at, count);
+}
+
+typedef struct {
+	RzBuffer *buf;
+	ut64 size;
+	bool failed;
+} RecordReader;
+
+static ut8 read_u8(RecordReader *r) {
+	ut8 v = 0;
+	r->failed |= !rz_buf_read8(r->buf, &v);
+	return v;
+}
+
+static ut16 read_u16(RecordReader *r) {
+	ut16 v = 0;
+	r->failed |= !rz_buf_read_le16(r->buf, &v);
+	return v;
+}
+
+static ut32 read_u32(RecordReader *r) {
+	ut32 v = 0;
+	r->failed |= !rz_buf_read_le32(r->buf, &v);
+	return v;
+}
+
+static ut64 read_u64(RecordReader *r) {
+	ut64 v = 0;
+	r->failed |= !rz_buf_read_le64(r->buf, &v);
+	return v;
+}
+
+static void read_fields(RecordReader *r, void *obj, const RzSerializeField *fields, size_t count) {
+	r->failed |= !rz_serialize_fields_read(r->buf, obj, fields, count);
+}
+
+/**
+ * \brief Read the number of following records, each at least \p min_size bytes long
+ */
+static ut64 read_count(RecordReader *r, ut64 min_size) {
+	ut64 count = read_u64(r);
+	if (count > (r->size - rz_buf_tell(r->buf)) / RZ_MAX(min_size, 1)) {
+		r->failed = true;
+		return 0;
+	}
+	return count;
+}
+
+static RZ_OWN char *read_str(RecordReader *r) {
+	ut32 len = read_u32(r);
+	if (r->failed || len == UT32_MAX) {
+		return NULL;
+	}
+	if (len > r->size - rz_buf_tell(r->buf)) {
+		r->failed = true;
+		return NULL;
+	}
+	char *s = malloc((size_t)len + 1);
+	if (!s || rz_buf_read(r->buf, (ut8 *)s, len) != (st64)len) {
+		free(s);
+		r->failed = true;
+		return NULL;
+	}
+	s[len] = '\0';
+	return s;
+}
+
+typedef struct {
+	RecordWriter *w;
+	const RzSerializeField *fields;
+	size_t n_fields;
+	ut64 count;
+} RecordCountCtx;
+
+static bool xref_record_save_cb(const RzAnalysisXRef *xref, void *user) {
+	RecordCountCtx *ctx = user;
+	write_fields(ctx->w, xref, ctx->fields, ctx->n_fields);
+	ctx->count++;
+	return !ctx->w->failed;
+}
+
+/**
+ * xref: fields
+ */
+static void xrefs_records_save(RecordWriter *w, RzAnalysis *analysis) {
+	RecordCountCtx ctx = { .w = w };
+	ctx.fields = rz_serialize_analysis_xref_fields(&ctx.n_fields);
+	ut64 at = count_begin(w);
+	rz_analysis_xrefs_foreach(analysis, xref_record_save_cb, &ctx);
+	count_end(w, at, ctx.count);
+}
+
+static bool xrefs_records_load(RecordReader *r, RZ_NULLABLE RzAnalysis *analysis) {
+	size_t n_fields;
+	const RzSerializeField *fields = rz_serialize_analysis_xref_fields(&n_fields);
+	ut64 count = read_count(r, rz_serialize_fields_size(fields, n_fields));
+	for (ut64 i = 0; i < count && !r->failed; i++) {
+		RzAnalysisXRef xref = { 0 };
+		read_fields(r, &xref, fields, n_fields);
+		switch (xref.type) {
+		case RZ_ANALYSIS_XREF_TYPE_NULL:
+		case RZ_ANALYSIS_XREF_TYPE_CODE:
+		case RZ_ANALYSIS_XREF_TYPE_CALL:
+		case RZ_ANALYSIS_XREF_TYPE_DATA:
+		case RZ_ANALYSIS_XREF_TYPE_STRING:
+			break;
+		default:
+			return false;
+		}
+		if (!r->failed && analysis) {
+			rz_analysis_xrefs_set(analysis, xref.from, xref.to, xref.type);
+		}
+	}
+	return !r->failed;
+}
+
+/**
+ * block: addr:ut64 fields has_switch:ut8 [switch_op] n_op_pos:ut32 op_pos:ut16[]
+ *        n_sp_delta:ut32 sp_delta:ut16[] cmpreg:str
+ * switch_op: fields n_cases:ut32 (case fields)[]
+ */
+static void blocks_records_save(RecordWriter *w, RzAnalysis *analysis) {
+	size_t n_fields, n_sop_fields, n_cop_fields;
+	const RzSerializeField *fields = rz_serialize_analysis_block_fields(&n_fields);
+	const RzSerializeField *sop_fields = rz_serialize_analysis_switch_op_fields(&n_sop_fields);
+	const RzSerializeField *cop_fields = rz_serialize_analysis_case_op_fields(&n_cop_fields);
+	ut64 at = count_begin(w);
+	ut64 count = 0;
+	RBIter iter;
+	RzAnalysisBlock *block;
+	rz_rbtree_foreach (analysis->bb_tree, iter, block, RzAnalysisBlock, _rb) {
+		write_u64(w, block->addr);
+		write_fields(w, block, fields, n_fields);
+		RzAnalysisSwitchOp *sop = block->switch_op;
+		write_u8(w, sop ? 1 : 0);
+		if (sop) {
+			write_fields(w, sop, sop_fields, n_sop_fields);
+			write_u32(w, rz_list_length(sop->cases));
+			RzListIter *it;
+			RzAnalysisCaseOp *cop;
+			rz_list_foreach (sop->cases, it, cop) {
+				write_fields(w, cop, cop_fields, n_cop_fields);
+			}
+		}
+		ut32 n_op_pos = block->op_pos && block->ninstr > 1 ? (ut32)block->ninstr - 1 : 0;
+		write_u32(w, n_op_pos);
+		for (ut32 i = 0; i < n_op_pos; i++) {
+			write_u16(w, block->op_pos[i]);
+		}
+		write_u32(w, (ut32)rz_vector_len(&block->sp_delta));
+		st16 *delta;
+		rz_vector_foreach (&block->sp_delta, delta) {
+			write_u16(w, (ut16)*delta);
+		}
+		write_str(w, block->cmpreg);
+		count++;
+	}
+	count_end(w, at, count);
+}
+
+static RzAnalysisSwitchOp *switch_op_record_load(RecordReader *r) {
+	size_t n_sop_fields, n_cop_fields;
+	const RzSerializeField *sop_fields = rz_serialize_analysis_switch_op_fields(&n_sop_fields);
+	const RzSerializeField *cop_fields = rz_serialize_analysis_case_op_fields(&n_cop_fields);
+	RzAnalysisSwitchOp *sop = rz_analysis_switch_op_new(0, 0, 0, 0);
+	if (!sop) {
+		r->failed = true;
+		return NULL;
+	}
+	read_fields(r, sop, sop_fields, n_sop_fields);
+	ut32 n_cases = read_u32(r);
+	for (ut32 i = 0; i < n_cases && !r->failed; i++) {
+		RzAnalysisCaseOp cop = { 0 };
+		read_fields(r, &cop, cop_fields, n_cop_fields);
+		rz_analysis_switch_op_add_case(sop, cop.addr, cop.value, cop.jump);
+	}
+	return sop;
+}
+
+static bool blocks_records_load(RecordReader *r, RZ_NULLABLE RzAnalysis *analysis) {
+	size_t n_fields;
+	const RzSerializeField *fields = rz_serialize_analysis_block_fields(&n_fields);
+	// addr, has_switch, n_op_pos, n_sp_delta and the length of cmpreg
+	ut64 min_size = sizeof(ut64) + rz_serialize_fields_size(fields, n_fields) + sizeof(ut8) + 3 * sizeof(ut32);
+	ut64 count = read_count(r, min_size);
+	for (ut64 i = 0; i < count && !r->failed; i++) {
+		RzAnalysisBlock proto = { 0 };
+		ut64 addr = read_u64(r);
+		read_fields(r, &proto, fields, n_fields);
+		proto.switch_op = read_u8(r) ? switch_op_record_load(r) : NULL;
+		ut32 n_op_pos = read_u32(r);
+		bool ok = !n_op_pos || (int)n_op_pos == proto.ninstr - 1;
+		proto.op_pos = ok && n_op_pos ? RZ_NEWS(ut16, n_op_pos) : NULL;
+		ok &= !n_op_pos || proto.op_pos;
+		for (ut32 j = 0; j < n_op_pos && ok && !r->failed; j++) {
+			proto.op_pos[j] = read_u16(r);
+		}
+		ut32 n_sp_delta = read_u32(r);
+		rz_vector_init(&proto.sp_delta, sizeof(st16), NULL, NULL);
+		for (ut32 j = 0; j < n_sp_delta && ok && !r->failed; j++) {
+			st16 delta = (st16)read_u16(r);
+			ok = rz_vector_push(&proto.sp_delta, &delta);
+		}
+		char *cmpreg = ok ? read_str(r) : NULL;
+
+		RzAnalysisBlock *block = ok && !r->failed && analysis ? rz_analysis_create_block(analysis, addr, proto.size) : NULL;
+		if (!block) {
+			rz_analysis_switch_op_free(proto.switch_op);
+			rz_vector_fini(&proto.sp_delta);
+			free(cmpreg);
+			free(proto.op_pos);
+			if (!ok || analysis) {
+				return false;
+			}
+			continue;
+		}
+		block->jump = proto.jump;
+		block->fail = proto.fail;
+		block->traced = proto.traced;
+		block->colorize = proto.colorize;
+		block->switch_op = proto.switch_op;
+		block->ninstr = proto.ninstr;
+		if (proto.op_pos) {
+			free(block->op_pos);
+			block->op_pos = proto.op_pos;
+			block->op_pos_size = (int)n_op_pos;
+		}
+		block->sp_entry = proto.sp_entry;
+		rz_vector_fini(&block->sp_delta);
+		block->sp_delta = proto.sp_delta;
+		block->cmpval = proto.cmpval;
+		block->cmpreg = cmpreg ? rz_str_constpool_get(&analysis->constpool, cmpreg) : NULL;
+		free(cmpreg);
+	}
+	return !r->failed;
+}
+
+static const RzSerializeField var_storage_piece_fields[] = {
+	RZ_SERIALIZE_FIELD(RzAnalysisVarStoragePiece, offset_in_bits, "offset_in_bits"),
+	RZ_SERIALIZE_FIELD(RzAnalysisVarStoragePiece, size_in_bits, "size_in_bits"),
+};
+
+static const RzSerializeField var_access_fields[] = {
+	RZ_SERIALIZE_FIELD(RzAnalysisVarAccess, offset, "off"),
+	RZ_SERIALIZE_FIELD(RzAnalysisVarAccess, type, "type"),
+	RZ_SERIALIZE_FIELD(RzAnalysisVarAccess, reg_addend, "sp"),
+};
+
+static const RzSerializeField var_constraint_fields[] = {
+	RZ_SERIALIZE_FIELD(RzTypeConstraint, cond, "cond"),
+	RZ_SERIALIZE_FIELD(RzTypeConstraint, val, "val"),
+};
+
+/**
+ * storage: type:ut32, then stack_off:ut64 | reg:str | dw_var_off:ut64 |
+ *          n_pieces:ut32 (piece fields, storage)[]
+ */
+static void var_storage_record_save(RecordWriter *w, const RzAnalysisVarStorage *storage) {
+	write_u32(w, storage->type);
+	switch (storage->type) {
+	case RZ_ANALYSIS_VAR_STORAGE_STACK:
+		write_u64(w, (ut64)storage->stack_off);
+		break;
+	case RZ_ANALYSIS_VAR_STORAGE_REG:
+		write_str(w, storage->reg);
+		break;
+	case RZ_ANALYSIS_VAR_STORAGE_EVAL_PENDING:
+		write_u64(w, storage->dw_var_off);
+		break;
+	case RZ_ANALYSIS_VAR_STORAGE_COMPOSITE: {
+		write_u32(w, storage->composite ? (ut32)rz_vector_len(storage->composite) : 0);
+		if (!storage->composite) {
+			break;
+		}
+		RzAnalysisVarStoragePiece *piece;
+		rz_vector_foreach (storage->composite, piece) {
+			write_fields(w, piece, var_storage_piece_fields, RZ_ARRAY_SIZE(var_storage_piece_fields));
+			RzAnalysisVarStorage empty = { 0 };
+			var_storage_record_save(w, piece->storage ? piece->storage : &empty);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static bool var_storage_record_load(RecordReader *r, RZ_NULLABLE RzAnalysis *analysis, RzAnalysisVarStorage *storage) {
+	ut32 type = read_u32(r);
+	switch (type) {
+	case RZ_ANALYSIS_VAR_STORAGE_STACK:
+		storage->type = type;
+		storage->stack_off = (RzStackAddr)read_u64(r);
+		break;
+	case RZ_ANALYSIS_VAR_STORAGE_REG: {
+		char *reg = read_str(r);
+		if (!reg) {
+			return false;
+		}
+		if (analysis) {
+			rz_analysis_var_storage_init_reg(storage, rz_str_constpool_get(&analysis->constpool, reg));
+		}
+		free(reg);
+		break;
+	}
+	case RZ_ANALYSIS_VAR_STORAGE_EVAL_PENDING:
+		storage->type = type;
+		storage->dw_var_off = read_u64(r);
+		break;
+	case RZ_ANALYSIS_VAR_STORAGE_COMPOSITE: {
+		ut32 n_pieces = read_u32(r);
+		rz_analysis_var_storage_init_composite(storage);
+		if (!storage->composite) {
+			return false;
+		}
+		for (ut32 i = 0; i < n_pieces && !r->failed; i++) {
+			RzAnalysisVarStoragePiece piece = { 0 };
+			read_fields(r, &piece, var_storage_piece_fields, RZ_ARRAY_SIZE(var_storage_piece_fields));
+			piece.storage = RZ_NEW0(RzAnalysisVarStorage);
+			if (!piece.storage || !var_storage_record_load(r, analysis, piece.storage)) {
+				rz_analysis_var_storage_piece_fini(&piece);
+				return false;
+			}
+			rz_vector_push(storage->composite, &piece);
+		}
+		break;
+	}
+	default:
+		return false;
+	}
+	return !r->failed;
+}
+
+/**
+ * var: name:str type:str kind:ut32 storage origin:ut32 [dw_var:ut64] comment:str
+ *      n_accesses:ut32 (access fields, reg:str)[] n_constraints:ut32 (constraint fields)[]
+ */
+static void var_record_save(RecordWriter *w, RzAnalysisVar *var) {
+	char *vartype = rz_type_as_string(var->fcn->analysis->typedb, var->type);
+	write_str(w, var->name);
+	write_str(w, vartype);
+	free(vartype);
+	write_u32(w, var->kind);
+	var_storage_record_save(w, &var->storage);
+	write_u32(w, var->origin.kind);
+	if (var->origin.kind == RZ_ANALYSIS_VAR_ORIGIN_DWARF) {
+		write_u64(w, var->origin.dw_var ? var->origin.dw_var->offset : UT64_MAX);
+	}
+	write_str(w, var->comment);
+	write_u32(w, (ut32)rz_vector_len(&var->accesses));
+	RzAnalysisVarAccess *acc;
+	rz_vector_foreach (&var->accesses, acc) {
+		write_fields(w, acc, var_access_fields, RZ_ARRAY_SIZE(var_access_fields));
+		write_str(w, acc->reg);
+	}
+	write_u32(w, (ut32)rz_vector_len(&var->constraints));
+	RzTypeConstraint *constr;
+	rz_vector_foreach (&var->constraints, constr) {
+		write_fields(w, constr, var_constraint_fields, RZ_ARRAY_SIZE(var_constraint_fields));
+	}
+}
+
+typedef struct {
+	RzAnalysis *analysis; ///< NULL if the records are only checked
+	HtSP /*<char *, RzType *>*/ *types; ///< variable types parsed so far, by their C representation
+} FunctionsLoadCtx;
+
+static const RzType *var_type_get(FunctionsLoadCtx *ctx, const char *type) {
+	RzType *t = ht_sp_find(ctx->types, type, NULL);
+	if (t) {
+		return t;
+	}
+	char *error_msg = NULL;
+	t = rz_type_parse_string_single(ctx->analysis->typedb->parser, type, &error_msg);
+	if (!t || error_msg) {
+		free(error_msg);
+		rz_type_free(t);
+		return NULL;
+	}
+	ht_sp_insert(ctx->types, type, t);
+	return t;
+}
+
+typedef struct {
+	RzAnalysisVarAccess acc; ///< everything but the register
+	char *reg;
+} VarAccessRecord;
+
+static void var_access_record_fini(void *e, void *user) {
+	free(((VarAccessRecord *)e)->reg);
+}
+
+static bool var_record_load(RecordReader *r, FunctionsLoadCtx *ctx, RZ_NULLABLE RzAnalysisFunction *fcn) {
+	RzAnalysisVarStorage storage = { 0 };
+	RzVector accesses;
+	rz_vector_init(&accesses, sizeof(VarAccessRecord), var_access_record_fini, NULL);
+	RzVector constraints;
+	rz_vector_init(&constraints, sizeof(RzTypeConstraint), NULL, NULL);
+
+	// read the whole record first, so that the reader stays in sync if the variable is dropped
+	char *name = read_str(r);
+	char *type = read_str(r);
+	RzAnalysisVarKind kind = read_u32(r);
+	bool have_storage = var_storage_record_load(r, ctx->analysis, &storage);
+	RzAnalysisVarOriginKind origin_kind = read_u32(r);
+	ut64 dw_var = origin_kind == RZ_ANALYSIS_VAR_ORIGIN_DWARF ? read_u64(r) : UT64_MAX;
+	char *comment = read_str(r);
+	ut32 n_accesses = read_u32(r);
+	for (ut32 i = 0; i < n_accesses && !r->failed; i++) {
+		VarAccessRecord acc = { 0 };
+		read_fields(r, &acc.acc, var_access_fields, RZ_ARRAY_SIZE(var_access_fields));
+		acc.reg = read_str(r);
+		if (!rz_vector_push(&accesses, &acc)) {
+			free(acc.reg);
+			r->failed = true;
+		}
+	}
+	ut32 n_constraints = read_u32(r);
+	for (ut32 i = 0; i < n_constraints && !r->failed; i++) {
+		RzTypeConstraint constr = { 0 };
+		read_fields(r, &constr, var_constraint_fields, RZ_ARRAY_SIZE(var_constraint_fields));
+		if (constr.cond >= RZ_TYPE_COND_AL && constr.cond <= RZ_TYPE_COND_LS) {
+			rz_vector_push(&constraints, &constr);
+		}
+	}
+	if (r->failed || !name || !type || !have_storage) {
+		goto beach;
+	}
+	if (!fcn) {
+		goto beach;
+	}
+	const RzType *vartype = var_type_get(ctx, type);
+	if (!vartype) {
+		RZ_LOG_ERROR("Fail to parse the function variable (\"%s\") type: %s\n", name, type);
+		goto beach;
+	}
+
+	RzAnalysisVar *var = NULL;
+	if (origin_kind == RZ_ANALYSIS_VAR_ORIGIN_NONE) {
+		var = rz_analysis_function_set_var(fcn, &storage, vartype, 0, name);
+		if (var) {
+			// the storage is owned by the variable now
+			storage.type = RZ_ANALYSIS_VAR_STORAGE_STACK;
+		}
+	} else {
+		var = RZ_NEW0(RzAnalysisVar);
+		if (!var) {
+			goto beach;
+		}
+		var->name = rz_str_dup(name);
+		var->type = rz_type_clone(vartype);
+		var->fcn = fcn;
+		var->storage = storage;
+		storage.type = RZ_ANALYSIS_VAR_STORAGE_STACK;
+		var->origin.kind = origin_kind;
+		if (origin_kind == RZ_ANALYSIS_VAR_ORIGIN_DWARF) {
+			var->origin.dw_var = ht_up_find(ctx->analysis->debug_info->variable_by_offset, dw_var, NULL);
+		}
+		RzAnalysisVar *added = var->name && var->type ? rz_analysis_function_add_var(fcn, var) : NULL;
+		if (!added) {
+			rz_analysis_var_free(var);
+		}
+		var = added;
+	}
+	if (!var) {
+		goto beach;
+	}
+	var->kind = kind;
+	if (comment) {
+		free(var->comment);
+		var->comment = comment;
+		comment = NULL;
+	}
+	VarAccessRecord *acc;
+	rz_vector_foreach (&accesses, acc) {
+		if (acc->reg) {
+			rz_analysis_var_set_access(var, acc->reg, fcn->addr + acc->acc.offset, acc->acc.type, acc->acc.reg_addend);
+		}
+	}
+	RzTypeConstraint *constr;
+	rz_vector_foreach (&constraints, constr) {
+		rz_analysis_var_add_constraint(var, constr);
+	}
+beach:
+	rz_analysis_var_storage_fini(&storage);
+	rz_vector_fini(&constraints);
+	rz_vector_fini(&accesses);
+	free(comment);
+	free(type);
+	free(name);
+	return !r->failed;
+}
+
+static bool label_record_save_cb(void *user, const ut64 addr, const void *name) {
+	RecordWriter *w = user;
+	write_str(w, name);
+	write_u64(w, addr);
+	return true;
+}
+
+/**
+ * function: addr:ut64 name:str fields cc:str pure:ut8 bp_frame:ut8 noreturn:ut8
+ *           n_bbs:ut32 bbs:ut64[] n_imports:ut32 imports:str[]
+ *           n_labels:ut32 (name:str addr:ut64)[] n_vars:ut32 var[]
+ */
+static void functions_records_save(RecordWriter *w, RzAnalysis *analysis) {
+	size_t n_fields;
+	const RzSerializeField *fields = rz_serialize_analysis_function_fields(&n_fields);
+	write_u64(w, rz_list_length(analysis->fcns));
+	RzListIter *it;
+	RzAnalysisFunction *fcn;
+	rz_list_foreach (analysis->fcns, it, fcn) {
+		write_u64(w, fcn->addr);
+		write_str(w, fcn->name);
+		write_fields(w, fcn, fields, n_fields);
+		write_str(w, fcn->cc);
+		write_u8(w, fcn->is_pure ? 1 : 0);
+		write_u8(w, fcn->bp_frame ? 1 : 0);
+		write_u8(w, fcn->is_noreturn ? 1 : 0);
+		write_u32(w, (ut32)rz_pvector_len(fcn->bbs));
+		void **vit;
+		rz_pvector_foreach (fcn->bbs, vit) {
+			RzAnalysisBlock *block = *vit;
+			write_u64(w, block->addr);
+		}
+		write_u32(w, rz_list_length(fcn->imports));
+		RzListIter *iit;
+		const char *import;
+		rz_list_foreach (fcn->imports, iit, import) {
+			write_str(w, import);
+		}
+		write_u32(w, (ut32)fcn->labels->count);
+		ht_up_foreach(fcn->labels, label_record_save_cb, w);
+		write_u32(w, (ut32)rz_pvector_len(&fcn->vars));
+		rz_pvector_foreach (&fcn->vars, vit) {
+			var_record_save(w, *vit);
+		}
+	}
+}
+
+static bool function_record_load(RecordReader *r, FunctionsLoadCtx *ctx) {
+	size_t n_fields;
+	const RzSerializeField *fields = rz_serialize_analysis_function_fields(&n_fields);
+	RzAnalysis *analysis = ctx->analysis;
+	RzAnalysisFunction proto = { 0 };
+	RzAnalysisFunction *fcn = analysis ? rz_analysis_function_new(analysis) : &proto;
+	if (!fcn) {
+		return false;
+	}
+	fcn->addr = read_u64(r);
+	char *name = read_str(r);
+	read_fields(r, fcn, fields, n_fields);
+	char *cc = read_str(r);
+	fcn->is_pure = read_u8(r) != 0;
+	fcn->bp_frame = read_u8(r) != 0;
+	bool noreturn = read_u8(r) != 0;
+	if (analysis) {
+		free(fcn->name);
+		fcn->name = name;
+		fcn->cc = cc ? rz_str_constpool_get(&analysis->constpool, cc) : NULL;
+	} else {
+		r->failed |= !name;
+		free(name);
+	}
+	free(cc);
+	ut32 n_bbs = read_u32(r);
+	for (ut32 i = 0; i < n_bbs && !r->failed; i++) {
+		ut64 addr = read_u64(r);
+		RzAnalysisBlock *block = analysis ? rz_analysis_get_block_at(analysis, addr) : NULL;
+		if (block) {
+			rz_analysis_function_add_block(fcn, block);
+		}
+	}
+	ut32 n_imports = read_u32(r);
+	for (ut32 i = 0; i < n_imports && !r->failed; i++) {
+		char *import = read_str(r);
+		if (!import || !analysis) {
+			free(import);
+			continue;
+		}
+		if (!fcn->imports) {
+			fcn->imports = rz_list_newf((RzListFree)free);
+		}
+		if (!fcn->imports || !rz_list_push(fcn->imports, import)) {
+			free(import);
+			r->failed = true;
+		}
+	}
+	ut32 n_labels = read_u32(r);
+	for (ut32 i = 0; i < n_labels && !r->failed; i++) {
+		char *label = read_str(r);
+		ut64 addr = read_u64(r);
+		if (label && analysis) {
+			rz_analysis_function_set_label(fcn, label, addr);
+		}
+		free(label);
+	}
+	if (analysis) {
+		if (r->failed || !fcn->name || !rz_analysis_add_function(analysis, fcn)) {
+			rz_analysis_function_free(fcn);
+			return false;
+		}
+		fcn->is_noreturn = noreturn; // Can't set directly, rz_analysis_add_function() overwrites it
+	}
+
+	ut32 n_vars = read_u32(r);
+	for (ut32 i = 0; i < n_vars && !r->failed; i++) {
+		var_record_load(r, ctx, analysis ? fcn : NULL);
+	}
+	return !r->failed;
+}
+
+static bool functions_records_load(RecordReader *r, RZ_NULLABLE RzAnalysis *analysis) {
+	size_t n_fields;
+	const RzSerializeField *fields = rz_serialize_analysis_function_fields(&n_fields);
+	FunctionsLoadCtx ctx = {
+		.analysis = analysis,
+		.types = ht_sp_new(HT_STR_DUP, NULL, (HtSPFreeValue)rz_type_free),
+	};
+	if (!ctx.types) {
+		return false;
+	}
+	// addr, the length of name and cc, pure, bp_frame, noreturn, n_bbs, n_imports, n_labels and n_vars
+	ut64 min_size = sizeof(ut64) + rz_serialize_fields_size(fields, n_fields) + 2 * sizeof(ut32) + 3 * sizeof(ut8) + 4 * sizeof(ut32);
+	ut64 count = read_count(r, min_size);
+	bool ret = true;
+	for (ut64 i = 0; i < count && ret; i++) {
+		ret = function_record_load(r, &ctx);
+	}
+	ht_sp_free(ctx.types);
+	return ret && !r->failed;
+}
+
+static bool flag_record_save_cb(RzFlagItem *item, void *user) {
+	RecordCountCtx *ctx = user;
+	RecordWriter *w = ctx->w;
+	write_str(w, item->name);
+	write_fields(w, item, ctx->fields, ctx->n_fields);
+	write_str(w, item->realname);
+	write_str(w, item->space ? item->space->name : NULL);
+	write_str(w, item->color);
+	write_str(w, item->comment);
+	write_str(w, item->alias);
+	ctx->count++;
+	return !w->failed;
+}
+
+/**
+ * flag: name:str fields realname:str space:str color:str comment:str alias:str
+ */
+static void flags_records_save(RecordWriter *w, RzFlag *flag) {
+	RecordCountCtx ctx = { .w = w };
+	ctx.fields = rz_serialize_flag_item_fields(&ctx.n_fields);
+	ut64 at = count_begin(w);
+	rz_flag_foreach(flag, flag_record_save_cb, &ctx);
+	count_end(w, at, ctx.count);
+}
+
+static bool flags_records_load(RecordReader *r, RZ_NULLABLE RzFlag *flag) {
+	size_t n_fields;
+	const RzSerializeField *fields = rz_serialize_flag_item_fields(&n_fields);
+	// the length of the six strings
+	ut64 count = read_count(r, rz_serialize_fields_size(fields, n_fields) + 6 * sizeof(ut32));
+	for (ut64 i = 0; i < count && !r->failed; i++) {
+		RzFlagItem proto = { 0 };
+		char *name = read_str(r);
+		read_fields(r, &proto, fields, n_fields);
+		char *realname = read_str(r);
+		char *space = read_str(r);
+		char *color = read_str(r);
+		char *comment = read_str(r);
+		char *alias = read_str(r);
+		if (!name) {
+			r->failed = true;
+		}
+		RzFlagItem *item = !r->failed && flag ? rz_flag_set(flag, name, proto.offset, proto.size) : NULL;
+		if (item) {
+			if (realname) {
+				rz_flag_item_set_realname(item, realname);
+			}
+			item->demangled = proto.demangled;
+			item->space = space ? rz_flag_space_get(flag, space) : NULL;
+			if (color) {
+				rz_flag_item_set_color(item, color);
+			}
+			if (comment) {
+				rz_flag_item_set_comment(item, comment);
+			}
+			if (alias) {
+				rz_flag_item_set_alias(item, alias);
+			}
+		} else if (flag) {
+			r->failed = true;
+		}
+		free(alias);
+		free(comment);
+		free(color);
+		free(space);
+		free(realname);
+		free(name);
+	}
+	return !r->failed;
+}
+
+/*
+ * Whole state
+ */
+
+/**
+ * \brief Serialize the flags and analysis of \p core into \p db and \p records
+ */
+static bool state_save(RzCore *core, Sdb *db, RzBuffer *records) {
+	RzFlag *flag = core->flags;
+	Sdb *flags_db = sdb_ns(db, "flags", true);
+	rz_serialize_spaces_save(sdb_ns(flags_db, "spaces", true), &flag->spaces);
+	sdb_set(flags_db, "realnames", flag->realnames ? "1" : "0");
+	sdb_copy(flag->tags, sdb_ns(flags_db, "tags", true));
+	rz_serialize_flag_zones_save(sdb_ns(flags_db, "zones", true), flag->zones);
+
+	RzAnalysis *analysis = core->analysis;
+	Sdb *analysis_db = sdb_ns(db, "analysis", true);
+	rz_serialize_analysis_function_noreturn_save(sdb_ns(analysis_db, "noreturn", true), analysis);
+	rz_serialize_analysis_meta_save(sdb_ns(analysis_db, "meta", true), analysis);
+	rz_serialize_analysis_hints_save(sdb_ns(analysis_db, "hints", true), analysis);
+	rz_serialize_analysis_classes_save(sdb_ns(analysis_db, "classes", true), analysis);
+	rz_serialize_analysis_types_save(sdb_ns(analysis_db, "types", true), analysis);
+	rz_serialize_analysis_callables_save(sdb_ns(analysis_db, "callables", true), analysis);
+	rz_serialize_analysis_imports_save(sdb_ns(analysis_db, "imports", true), analysis);
+	rz_serialize_analysis_cc_save(sdb_ns(analysis_db, "cc", true), analysis);
+	rz_serialize_analysis_global_var_save(sdb_ns(analysis_db, "vars", true), analysis);
+
+	RecordWriter w = { .buf = records };
+	xrefs_records_save(&w, analysis);
+	blocks_records_save(&w, analysis);
+	functions_records_save(&w, analysis);
+	flags_records_save(&w, flag);
+	return !w.failed;
+}
+
+static const char *const analysis_namespaces[] = {
+	"classes", "types", "callables", "noreturn", "meta", "hints", "imports", "cc", "vars", NULL
+};
+
+static const char *const flags_namespaces[] = {
+	"spaces", "tags", "zones", NULL
+};
+
+static bool namespaces_check(Sdb *db, const char *const *names, RzSerializeResultInfo *res) {
+	for (size_t i = 0; names[i]; i++) {
+		if (!sdb_ns(db, names[i], false)) {
+			RZ_SERIALIZE_ERR(res, "missing %s namespace", names[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Check that \p db and \p records hold a complete state, without touching the current one
+ */
+static bool state_check(Sdb *db, RzBuffer *records, RzSerializeResultInfo *res) {
+	Sdb *analysis_db = NULL;
+	Sdb *flags_db = NULL;
+	RZ_SERIALIZE_SUB(db, analysis_db, res, "analysis", return false;);
+	RZ_SERIALIZE_SUB(db, flags_db, res, "flags", return false;);
+	if (!namespaces_check(analysis_db, analysis_namespaces, res) ||
+		!namespaces_check(flags_db, flags_namespaces, res)) {
+		return false;
+	}
+	RecordReader r = { .buf = records, .size = rz_buf_size(records) };
+	rz_buf_seek(records, 0, RZ_BUF_SET);
+	if (!xrefs_records_load(&r, NULL)) {
+		RZ_SERIALIZE_ERR(res, "xrefs records are corrupted");
+		return false;
+	}
+	if (!blocks_records_load(&r, NULL)) {
+		RZ_SERIALIZE_ERR(res, "basic blocks records are corrupted");
+		return false;
+	}
+	if (!functions_records_load(&r, NULL)) {
+		RZ_SERIALIZE_ERR(res, "functions records are corrupted");
+		return false;
+	}
+	if (!flags_records_load(&r, NULL)) {
+		RZ_SERIALIZE_ERR(res, "flags records are corrupted");
+		return false;
+	}
+	if (rz_buf_tell(records) != r.size) {
+		RZ_SERIALIZE_ERR(res, "trailing data after the records");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * \brief Replace the flags and analysis of \p core by the ones in \p db and \p records
+ *
+ * Mirrors the order of rz_serialize_analysis_load() and rz_serialize_flag_load().
+ * The input must have passed state_check() before.
+ */
+static bool state_load(RzCore *core, Sdb *db, RzBuffer *records, RzSerializeResultInfo *res) {
+	Sdb *subdb = NULL;
+	Sdb *analysis_db = NULL;
+	Sdb *flags_db = NULL;
+	RZ_SERIALIZE_SUB(db, analysis_db, res, "analysis", return false;);
+	RZ_SERIALIZE_SUB(db, flags_db, res, "flags", return false;);
+	RecordReader r = { .buf = records, .size = rz_buf_size(records) };
+	rz_buf_seek(records, 0, RZ_BUF_SET);
+
+	RzAnalysis *analysis = core->analysis;
+	rz_analysis_purge(analysis);
+	if (!xrefs_records_load(&r, analysis)) {
+		RZ_SERIALIZE_ERR(res, "xrefs records are corrupted");
+		return false;
+	}
+	if (!blocks_records_load(&r, analysis)) {
+		RZ_SERIALIZE_ERR(res, "basic blocks records are corrupted");
+		return false;
+	}
+#define SUB(ns, call) RZ_SERIALIZE_SUB_DO(analysis_db, subdb, res, ns, call, return false;)
+	SUB("classes", rz_serialize_analysis_classes_load(subdb, analysis, res));
+	SUB("types", rz_serialize_analysis_types_load(subdb, analysis, res));
+	SUB("callables", rz_serialize_analysis_callables_load(subdb, analysis, res));
+	// All bbs have ref=1 now
+	if (!functions_records_load(&r, analysis)) {
+		RZ_SERIALIZE_ERR(res, "functions records are corrupted");
+		return false;
+	}
+	SUB("noreturn", rz_serialize_analysis_function_noreturn_load(subdb, analysis, res));
+	// Drop the reference of the blocks loading, blocks outside of functions go away.
+	RzPVector orphaned_bbs;
+	rz_pvector_init(&orphaned_bbs, (RzPVectorFree)rz_analysis_block_unref);
+	RBIter iter;
+	RzAnalysisBlock *block;
+	rz_rbtree_foreach (analysis->bb_tree, iter, block, RzAnalysisBlock, _rb) {
+		if (block->ref <= 1) {
+			rz_pvector_push(&orphaned_bbs, block);
+			continue;
+		}
+		rz_analysis_block_unref(block);
+	}
+	rz_pvector_clear(&orphaned_bbs); // unrefs all
+	SUB("meta", rz_serialize_analysis_meta_load(subdb, analysis, res));
+	SUB("hints", rz_serialize_analysis_hints_load(subdb, analysis, res));
+	SUB("imports", rz_serialize_analysis_imports_load(subdb, analysis, res));
+	SUB("cc", rz_serialize_analysis_cc_load(subdb, analysis, res));
+	SUB("vars", rz_serialize_analysis_global_var_load(subdb, analysis, res));
+#undef SUB
+
+	RzFlag *flag = core->flags;
+	rz_flag_unset_all(flag);
+	flag->realnames = sdb_num_get(flags_db, "realnames") != 0;
+	RZ_SERIALIZE_SUB_DO(flags_db, subdb, res, "spaces", rz_serialize_spaces_load(subdb, &flag->spaces, false, res), return false;);
+	RZ_SERIALIZE_SUB(flags_db, subdb, res, "tags", return false;);
+	sdb_copy(subdb, flag->tags);
+	rz_flag_zone_reset(flag);
+	RZ_SERIALIZE_SUB_DO(flags_db, subdb, res, "zones", rz_serialize_flag_zones_load(subdb, flag->zones, res), return false;);
+	if (!flags_records_load(&r, flag)) {
+		RZ_SERIALIZE_ERR(res, "flags records are corrupted");
+		return false;
+	}
+	return true;
+}
+
+/*
+ * On-disk cache
+ */
+
+typedef struct {
+	Sdb *out;
+	bool ok;
+} CacheWriteCtx;
+
+static bool write_kv_cb(void *user, const SdbKv *kv) {
+	CacheWriteCtx *ctx = user;
+	if (!sdb_disk_insert(ctx->out, sdbkv_key(kv), sdbkv_value(kv))) {
+		// keys longer than CDB_MAX_KEY can't be stored
+		ctx->ok = false;
+		return false;
+	}
+	return true;
+}
+
+static bool write_cdb(const char *dir, const char *name, Sdb *db) {
+	Sdb *out = sdb_new(dir, name, 0);
+	if (!out) {
+		return false;
+	}
+	CacheWriteCtx ctx = { out, true };
+	if (!sdb_disk_create(out)) {
+		sdb_free(out);
+		return false;
+	}
+	if (db) {
+		sdb_foreach(db, write_kv_cb, &ctx);
+	}
+	bool ok = sdb_disk_finish(out) && ctx.ok;
+	sdb_free(out);
+	return ok;
+}
+
+static bool write_namespaces(const char *dir, Sdb *db, const char *path, Sdb *root, int *count) {
+	SdbNs *ns;
+	RzListIter *it;
+	rz_list_foreach (db->ns, it, ns) {
+		char *nspath = path ? rz_str_newf("%s/%s", path, ns->name) : rz_str_dup(ns->name);
+		char *name = rz_str_newf("ns.%d", *count);
+		bool ok = nspath && name && write_cdb(dir, name, ns->sdb);
+		if (ok) {
+			sdb_set(root, name, nspath);
+			(*count)++;
+			ok = write_namespaces(dir, ns->sdb, nspath, root, count);
+		}
+		free(name);
+		free(nspath);
+		if (!ok) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Store the current flags and analysis in the on-disk analysis cache
+ *
+ * \param dir cache directory of the current file, see rz_core_analysis_cache_path()
+ * \param type analysis level the current results correspond to
+ * \return true if the cache was written
+ */
+RZ_API bool rz_core_analysis_cache_save(RZ_NONNULL RzCore *core, RZ_NONNULL const char *dir, RzCoreAnalysisType type) {
+	rz_return_val_if_fail(core && dir, false);
+	char *key = rz_core_analysis_cache_key(core, type);
+	char *root_file = rz_file_path_join(dir, ANALYSIS_CACHE_ROOT);
+	char *records_file = rz_file_path_join(dir, ANALYSIS_CACHE_RECORDS);
+	bool ret = false;
+	Sdb *db = NULL;
+	Sdb *root = NULL;
+	RzBuffer *records = NULL;
+	if (!key || !root_file || !records_file || !rz_sys_mkdirp(dir)) {
+		goto beach;
+	}
+	// Drop the old root first so that a partially written cache is never picked up.
+	if (rz_file_exists(root_file)) {
+		rz_file_rm(root_file);
+	}
+
+	db = sdb_new0();
+	root = sdb_new0();
+	records = rz_buf_new_empty(0);
+	if (!db || !root || !records) {
+		goto beach;
+	}
+	if (!state_save(core, db, records)) {
+		RZ_LOG_WARN("core: analysis cache: cannot serialize the analysis\n");
+		goto beach;
+	}
+
+	int count = 0;
+	if (!write_namespaces(dir, db, NULL, root, &count) || !rz_buf_dump(records, records_file)) {
+		RZ_LOG_WARN("core: analysis cache: cannot write the cache to %s\n", dir);
+		goto beach;
+	}
+	sdb_set(root, "key", key);
+	sdb_num_set(root, "version", ANALYSIS_CACHE_VERSION);
+	sdb_num_set(root, "ns.count", count);
+	ret = write_cdb(dir, ANALYSIS_CACHE_ROOT, root);
+	if (!ret) {
+		rz_file_rm(root_file);
+	}
+beach:
+	rz_buf_free(records);
+	sdb_free(root);
+	sdb_free(db);
+	free(records_file);
+	free(root_file);
+	free(key);
+	return ret;
+}
+
+static Sdb *open_cdb(const char *dir, const char *name) {
+	Sdb *db = sdb_new(dir, name, 0);
+	if (db && db->fd == -1) {
+		sdb_free(db);
+		return NULL;
+	}
+	return db;
+}
+
+/**
+ * \brief Build the namespace tree of the cache in \p db, every node backed by its mapped cdb file
+ */
+static bool attach_namespaces(const char *dir, Sdb *root, Sdb *db) {
+	ut64 count = sdb_num_get(root, "ns.count");
+	for (ut64 i = 0; i < count; i++) {
+		char name[32];
+		rz_strf(name, "ns.%" PFMT64u, i);
+		const char *path = sdb_const_get(root, name);
+		if (!path) {
+			return false;
+		}
+		Sdb *parent = db;
+		const char *base = path;
+		const char *slash = strrchr(path, '/');
+		if (slash) {
+			char *parent_path = rz_str_ndup(path, slash - path);
+			parent = parent_path ? sdb_ns_path(db, parent_path, false) : NULL;
+			free(parent_path);
+			base = slash + 1;
+		}
+		Sdb *ns = open_cdb(dir, name);
+		if (!parent || !ns) {
+			sdb_free(ns);
+			return false;
+		}
+		sdb_ns_set(parent, base, ns);
+		// the namespace holds the reference now
+		sdb_free(ns);
+	}
+	return true;
+}
+
+static void log_result_info(RzSerializeResultInfo *res) {
+	RzListIter *it;
+	const char *msg;
+	rz_list_foreach (res, it, msg) {
+		RZ_LOG_WARN("core: analysis cache: %s\n", msg);
+	}
+}
+
+/**
+ * \brief Load the flags and analysis from the on-disk analysis cache
+ *
+ * Nothing is changed if the cache is missing, corrupted or was produced
+ * with a different configuration or analysis level: the whole cache is
+ * checked before the current flags and analysis are replaced.
+ *
+ * \param dir cache directory of the current file, see rz_core_analysis_cache_path()
+ * \param type analysis level to look up
+ * \return true if the cached results have been loaded
+ */
+RZ_API bool rz_core_analysis_cache_load(RZ_NONNULL RzCore *core, RZ_NONNULL const char *dir, RzCoreAnalysisType type) {
+	rz_return_val_if_fail(core && dir, false);
+	char *key = NULL;
+	char *records_file = NULL;
+	Sdb *root = NULL;
+	Sdb *db = NULL;
+	RzBuffer *records = NULL;
+	RzSerializeResultInfo *res = NULL;
+	bool ret = false;
+	root = open_cdb(dir, ANALYSIS_CACHE_ROOT);
+	if (!root) {
+		goto beach;
+	}
+	key = rz_core_analysis_cache_key(core, type);
+	const char *stored = sdb_const_get(root, "key");
+	if (!key || !stored || strcmp(key, stored) || sdb_num_get(root, "version") != ANALYSIS_CACHE_VERSION) {
+		RZ_LOG_VERBOSE("core: analysis cache: %s is stale\n", dir);
+		goto beach;
+	}
+	db = sdb_new0();
+	records_file = rz_file_path_join(dir, ANALYSIS_CACHE_RECORDS);
+	records = records_file ? rz_buf_new_slurp(records_file) : NULL;
+	if (!db || !records || !attach_namespaces(dir, root, db)) {
+		RZ_LOG_WARN("core: analysis cache: %s is corrupted\n", dir);
+		goto beach;
+	}
+
+	res = rz_serialize_result_info_new();
+	if (!res) {
+		goto beach;
+	}
+	if (!state_check(db, records, res)) {
+		log_result_info(res);
+		RZ_LOG_WARN("core: analysis cache: %s is corrupted\n", dir);
+		goto beach;
+	}
+	if (!state_load(core, db, records, res)) {
+		// the records have been checked, so only the project serializers can fail here
+		log_result_info(res);
+		RZ_LOG_ERROR("core: analysis cache: cannot load %s, the analysis has been reset\n", dir);
+		rz_analysis_purge(core->analysis);
+		rz_flag_unset_all(core->flags);
+		goto beach;
+	}
+	ret = true;
+beach:
+	rz_serialize_result_info_free(res);
+	rz_buf_free(records);
+	sdb_free(db);
+	sdb_free(root);
+	free(records_file);
+	free(key);
+	return ret;
+}
@@ -6,23 +6,36 @@
  * \file Calculates a list of possible base addresses candidates using the strings position
  * Original code from 2013 Michael Coppola
  * https://github.com/mncoppola/ws30/blob/master/basefind.py
+ *
+ * The score of a base is the number of pointers p for which p - base is the
+ * offset of a string. Instead of probing every pointer for every base, the
+ * pointers are sorted once by (p % alignment, p): for each string s, the
+ * pointers which hit one of the bases are then a contiguous run starting at
+ * the first p >= s + base with the residue of s + base, and each of them adds
+ * its hits to the base p - s.
  */
 
 #include <rz_basefind.h>
 #include <rz_th.h>
 
+#define BASEFIND_READ_SIZE   0x100000
+#define BASEFIND_WINDOW_SIZE 0x100000 ///< Number of bases scored at once by a thread
+
 typedef struct basefind_addresses_t {
 	ut64 *ptr;
 	ut32 size;
 } BaseFindArray;
 
-typedef struct basefind_data_t {
-	ut32 score;
-	ut64 start;
-	ut64 end;
-	BaseFindArray *array;
-	RzAtomicBool *loop;
-} BaseFindData;
+typedef struct basefind_pointer_t {
+	ut64 address;
+	ut32 hits; ///< Number of words in the file with this value
+} BaseFindPointer;
+
+typedef struct basefind_pointers_t {
+	BaseFindPointer *ptr; ///< Sorted by (address % alignment, address)
+	ut32 size;
+	ut64 alignment;
+} BaseFindPointers;
 
 typedef struct basefind_thread_data_t {
 	ut32 id;
@@ -34,7 +47,7 @@ typedef struct basefind_thread_data_t {
 	ut32 score_min;
 	RzThreadLock *lock;
 	RzList /*<RzBaseFindScore *>*/ *scores;
-	HtUU *pointers;
+	BaseFindPointers *pointers;
 	BaseFindArray *array;
 	RzAtomicBool *loop;
 } BaseFindThreadData;
@@ -97,14 +110,10 @@ static void basefind_array_free(BaseFindArray *array) {
 	free(array);
 }
 
-static bool basefind_array_has(const BaseFindArray *array, ut64 value) {
-	// half-interval search should be better here.
-	for (ut32 i = 0; i < array->size; ++i) {
-		if (array->ptr[i] == value) {
-			return true;
-		}
-	}
-	return false;
+static int basefind_address_compare(const void *a, const void *b) {
+	ut64 x = *(const ut64 *)a;
+	ut64 y = *(const ut64 *)b;
+	return x < y ? -1 : (x > y);
 }
 
 static BaseFindArray *basefind_create_array_of_addresses(RzCore *core, RzBinStringSearchOpt *opt) {
@@ -119,7 +128,6 @@ static BaseFindArray *basefind_create_array_of_addresses(RzCore *core, RzBinStri
 		}
 	}
 
-	// if this list is sorted we can improve speed via half-interval search
 	strings = rz_bin_file_strings(current, opt);
 	if (!strings || rz_pvector_empty(strings)) {
 		RZ_LOG_ERROR("basefind: cannot find strings in binary with a minimum size of %" PFMTSZu ".\n", opt->min_length);
@@ -152,6 +160,16 @@ static BaseFindArray *basefind_create_array_of_addresses(RzCore *core, RzBinStri
 	}
 	RZ_LOG_INFO("basefind: located %u strings\n", array->size);
 
+	// the same offset must be counted only once per pointer
+	qsort(array->ptr, array->size, sizeof(ut64), basefind_address_compare);
+	ut32 unique = 0;
+	for (ut32 i = 0; i < array->size; ++i) {
+		if (!unique || array->ptr[unique - 1] != array->ptr[i]) {
+			array->ptr[unique++] = array->ptr[i];
+		}
+	}
+	array->size = unique;
+
 error:
 	rz_pvector_free(strings);
 	if (alloc) {
@@ -162,43 +180,134 @@ error:
 	return array;
 }
 
-static HtUU *basefind_create_pointer_map(RzCore *core, ut32 pointer_size) {
-	rz_return_val_if_fail(pointer_size == sizeof(ut32) || pointer_size == sizeof(ut64), NULL);
+static int basefind_pointer_compare(const void *a, const void *b, void *user) {
+	const BaseFindPointer *x = (const BaseFindPointer *)a;
+	const BaseFindPointer *y = (const BaseFindPointer *)b;
+	ut64 alignment = *(ut64 *)user;
+	ut64 rx = x->address % alignment;
+	ut64 ry = y->address % alignment;
+	if (rx != ry) {
+		return rx < ry ? -1 : 1;
+	}
+	return x->address < y->address ? -1 : (x->address > y->address);
+}
 
-	HtUU *map = ht_uu_new();
-	if (!map) {
-		RZ_LOG_ERROR("basefind: cannot allocate hashmap for pointer.\n");
-		return NULL;
+static void basefind_pointers_free(BaseFindPointers *pointers) {
+	if (!pointers) {
+		return;
 	}
+	free(pointers->ptr);
+	free(pointers);
+}
+
+/**
+ * Sorts \p words and merges the equal ones, summing their hits
+ */
+static void basefind_words_unique(RzVector /*<BaseFindPointer>*/ *words, ut64 alignment) {
+	size_t len = rz_vector_len(words);
+	if (len > 1) {
+		rz_vector_sort(words, basefind_pointer_compare, false, &alignment);
+	}
+	size_t unique = 0;
+	BaseFindPointer *array = rz_vector_head(words);
+	for (size_t i = 0; i < len; ++i) {
+		if (unique && array[unique - 1].address == array[i].address) {
+			array[unique - 1].hits += array[i].hits;
+		} else {
+			array[unique++] = array[i];
+		}
+	}
+	rz_vector_remove_range(words, unique, len - unique, NULL);
+}
+
+static BaseFindPointers *basefind_create_pointers(RzCore *core, ut32 pointer_size, ut64 alignment) {
+	rz_return_val_if_fail(pointer_size == sizeof(ut32) || pointer_size == sizeof(ut64), NULL);
 
-	ut8 buffer[sizeof(ut64)];
 	ut64 io_size = rz_io_size(core->io);
-	ut64 address = 0;
+	ut64 n_words = (io_size + pointer_size - 1) / pointer_size;
 	bool big_endian = rz_config_get_b(core->config, "cfg.bigendian");
-
-	for (ut64 pos = 0; pos < io_size; pos += pointer_size) {
-		rz_io_pread_at(core->io, pos, buffer, pointer_size);
-		address = pointer_size == sizeof(ut64) ? rz_read_ble64(buffer, big_endian) : rz_read_ble32(buffer, big_endian);
-		ut64 value = ht_uu_find(map, address, NULL) + 1;
-		ht_uu_insert(map, address, value);
+	BaseFindPointers *pointers = RZ_NEW0(BaseFindPointers);
+	ut8 *block = malloc(BASEFIND_READ_SIZE);
+	RzVector words;
+	rz_vector_init(&words, sizeof(BaseFindPointer), NULL, NULL);
+	RzVector block_words;
+	rz_vector_init(&block_words, sizeof(BaseFindPointer), NULL, NULL);
+	if (!pointers || !block || n_words > UT32_MAX || !rz_vector_reserve(&block_words, BASEFIND_READ_SIZE / pointer_size)) {
+		RZ_LOG_ERROR("basefind: cannot allocate the array of pointers.\n");
+		goto fail;
+	}
+
+	// words holds the unique words read so far, with a sorted prefix of sorted_len words
+	// followed by the unique words of the blocks read since the last merge
+	size_t sorted_len = 0;
+	for (ut64 pos = 0; pos < io_size; pos += BASEFIND_READ_SIZE) {
+		ut64 size = RZ_MIN(BASEFIND_READ_SIZE, io_size - pos);
+		ut64 whole = size - (size % pointer_size);
+		if (whole) {
+			rz_io_pread_at(core->io, pos, block, whole);
+		}
+		if (whole < size) {
+			// the last word of the file is incomplete
+			rz_io_pread_at(core->io, pos + whole, block + whole, pointer_size);
+			whole += pointer_size;
+		}
+		rz_vector_clear(&block_words);
+		for (ut64 i = 0; i < whole; i += pointer_size) {
+			BaseFindPointer word = { 0 };
+			word.address = pointer_size == sizeof(ut64) ? rz_read_ble64(block + i, big_endian) : rz_read_ble32(block + i, big_endian);
+			word.hits = 1;
+			rz_vector_push(&block_words, &word);
+		}
+		// only the unique words of the block are kept
+		basefind_words_unique(&block_words, alignment);
+		if (!rz_vector_insert_range(&words, rz_vector_len(&words), rz_vector_head(&block_words), rz_vector_len(&block_words))) {
+			RZ_LOG_ERROR("basefind: cannot allocate the array of pointers.\n");
+			goto fail;
+		}
+		// merge once the unsorted words outnumber the sorted ones, so that
+		// the words are sorted O(log n) times and never grow much past the unique ones
+		if (rz_vector_len(&words) - sorted_len > sorted_len) {
+			basefind_words_unique(&words, alignment);
+			sorted_len = rz_vector_len(&words);
+		}
 	}
-	RZ_LOG_INFO("basefind: located %u pointers\n", map->count);
-
-	return map;
+	basefind_words_unique(&words, alignment);
+	rz_vector_fini(&block_words);
+	ut32 unique = rz_vector_len(&words);
+	RZ_LOG_INFO("basefind: located %u pointers\n", unique);
+	rz_vector_shrink(&words);
+
+	pointers->size = unique;
+	pointers->alignment = alignment;
+	pointers->ptr = rz_vector_flush(&words);
+	free(block);
+	return pointers;
+
+fail:
+	rz_vector_fini(&block_words);
+	rz_vector_fini(&words);
+	basefind_pointers_free(pointers);
+	free(block);
+	return NULL;
 }
 
-static bool basefind_pointer_map_iter(BaseFindData *bfd, const ut64 address, const ut64 hits) {
-	if (!rz_atomic_bool_get(bfd->loop)) {
-		return false;
-	}
-	if (address < bfd->start || address >= bfd->end) {
-		return true;
-	}
-	ut64 offset = address - bfd->start;
-	if (basefind_array_has(bfd->array, offset)) {
-		bfd->score += hits;
+/**
+ * Returns the index of the first pointer which is not lower than \p address
+ * in the (address % alignment, address) order.
+ */
+static ut32 basefind_pointers_lower_bound(const BaseFindPointers *pointers, ut64 address) {
+	BaseFindPointer key = { .address = address };
+	ut64 alignment = pointers->alignment;
+	ut32 lo = 0, hi = pointers->size;
+	while (lo < hi) {
+		ut32 mid = lo + (hi - lo) / 2;
+		if (basefind_pointer_compare(&pointers->ptr[mid], &key, &alignment) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
 	}
-	return true;
+	return lo;
 }
 
 static int basefind_score_compare(const RzBaseFindScore *a, const RzBaseFindScore *b, void *user) {
@@ -215,49 +324,101 @@ static int basefind_score_compare(const RzBaseFindScore *a, const RzBaseFindScor
 	return 1;
 }
 
-static void *basefind_thread_runner(BaseFindThreadData *bftd) {
-	RzAtomicBool *loop = bftd->loop;
-	RzBaseFindScore *pair = NULL;
-	BaseFindData bfd;
-	ut64 base;
-
-	bfd.array = bftd->array;
-	bfd.loop = loop;
-	for (base = bftd->base_start; base < bftd->base_end; base += bftd->alignment) {
-		if (!rz_atomic_bool_get(loop)) {
-			break;
-		}
-		bftd->current = base;
-		bfd.score = 0;
-		bfd.start = base;
-		bfd.end = base + bftd->io_size;
-		ht_uu_foreach(bftd->pointers, (HtUUForeachCallback)basefind_pointer_map_iter, &bfd);
+static bool basefind_add_score(BaseFindThreadData *bftd, ut64 base, ut32 score) {
+	RzBaseFindScore *pair = RZ_NEW0(RzBaseFindScore);
+	if (!pair) {
+		RZ_LOG_ERROR("basefind: cannot allocate RzBaseFindScore.\n");
+		return false;
+	}
+	pair->score = score;
+	pair->candidate = base;
 
-		if (bfd.score < bftd->score_min) {
-			// ignore any score below than score_min
+	rz_th_lock_enter(bftd->lock);
+	if (!rz_list_append(bftd->scores, pair)) {
+		rz_th_lock_leave(bftd->lock);
+		free(pair);
+		RZ_LOG_ERROR("basefind: cannot append new score to the scores list.\n");
+		return false;
+	}
+	RZ_LOG_DEBUG("basefind: possible candidate at 0x%016" PFMT64x " with score of %u\n", base, score);
+	rz_th_lock_leave(bftd->lock);
+	return true;
+}
+
+/**
+ * Adds to \p scores the hits of the pointers matching a string for each one
+ * of the \p n_bases bases starting from \p first.
+ */
+static bool basefind_score_window(BaseFindThreadData *bftd, ut64 first, ut64 n_bases, ut32 *scores) {
+	const BaseFindPointers *pointers = bftd->pointers;
+	const BaseFindArray *array = bftd->array;
+	ut64 alignment = bftd->alignment;
+	ut64 last = first + (n_bases - 1) * alignment;
+	ut64 step = (last - first) / RZ_MAX(array->size, 1);
+
+	for (ut32 i = 0; i < array->size; ++i) {
+		if (!rz_atomic_bool_get(bftd->loop)) {
+			return false;
+		}
+		bftd->current = first + step * i;
+		ut64 offset = array->ptr[i];
+		if (offset >= bftd->io_size || offset > UT64_MAX - first) {
+			// the pointers are always within [base, base + io_size)
 			continue;
 		}
+		ut64 low = offset + first;
+		ut64 high = offset > UT64_MAX - last ? UT64_MAX : offset + last;
+		ut64 residue = low % alignment;
+		for (ut32 j = basefind_pointers_lower_bound(pointers, low); j < pointers->size; ++j) {
+			const BaseFindPointer *pointer = &pointers->ptr[j];
+			if (pointer->address > high || pointer->address % alignment != residue) {
+				break;
+			}
+			scores[(pointer->address - low) / alignment] += pointer->hits;
+		}
+	}
+	return true;
+}
+
+static void *basefind_thread_runner(BaseFindThreadData *bftd) {
+	ut64 alignment = bftd->alignment;
+	ut64 base_end = bftd->base_end;
+	ut32 *scores = NULL;
+
+	// bases whose end wraps around can never have a score
+	if (bftd->io_size > 0 && base_end - 1 > UT64_MAX - bftd->io_size) {
+		base_end = UT64_MAX - bftd->io_size + 1;
+	}
+	if (bftd->base_start >= base_end) {
+		return NULL;
+	}
+
+	ut64 n_bases = (base_end - bftd->base_start - 1) / alignment + 1;
+	ut64 window = RZ_MIN(n_bases, BASEFIND_WINDOW_SIZE);
+	scores = RZ_NEWS(ut32, window);
+	if (!scores) {
+		RZ_LOG_ERROR("basefind: cannot allocate the scores window.\n");
+		return NULL;
+	}
 
-		pair = RZ_NEW0(RzBaseFindScore);
-		if (!pair) {
-			RZ_LOG_ERROR("basefind: cannot allocate RzBaseFindScore.\n");
-			break;
+	for (ut64 done = 0; done < n_bases; done += window) {
+		ut64 first = bftd->base_start + done * alignment;
+		ut64 count = RZ_MIN(window, n_bases - done);
+		memset(scores, 0, count * sizeof(ut32));
+		if (!basefind_score_window(bftd, first, count, scores)) {
+			goto end;
 		}
-		pair->score = bfd.score;
-		pair->candidate = base;
-
-		rz_th_lock_enter(bftd->lock);
-		if (!rz_list_append(bftd->scores, pair)) {
-			rz_th_lock_leave(bftd->lock);
-			free(pair);
-			RZ_LOG_ERROR("basefind: cannot append new score to the scores list.\n");
-			break;
+		for (ut64 i = 0; i < count; ++i) {
+			// ignore any score below than score_min
+			if (scores[i] >= bftd->score_min && !basefind_add_score(bftd, first + i * alignment, scores[i])) {
+				goto end;
+			}
 		}
-		RZ_LOG_DEBUG("basefind: possible candidate at 0x%016" PFMT64x " with score of %u\n", base, bfd.score);
-		rz_th_lock_leave(bftd->lock);
 	}
-	bftd->current = base;
+	bftd->current = bftd->base_end;
 
+end:
+	free(scores);
 	return NULL;
 }
 
@@ -339,7 +500,7 @@ RZ_API RZ_OWN RzList /*<RzBaseFindScore *>*/ *rz_basefind(RZ_NONNULL RzCore *cor
 	rz_return_val_if_fail(core && options, NULL);
 	RzList *scores = NULL;
 	BaseFindArray *array = NULL;
-	HtUU *pointers = NULL;
+	BaseFindPointers *pointers = NULL;
 	size_t pool_size = 1;
 	RzThreadPool *pool = NULL;
 	RzThreadLock *lock = NULL;
@@ -389,7 +550,7 @@ RZ_API RZ_OWN RzList /*<RzBaseFindScore *>*/ *rz_basefind(RZ_NONNULL RzCore *cor
 		goto rz_basefind_end;
 	}
 
-	pointers = basefind_create_pointer_map(core, options->pointer_size / 8);
+	pointers = basefind_create_pointers(core, options->pointer_size / 8, alignment);
 	if (!pointers) {
 		goto rz_basefind_end;
 	}
@@ -493,6 +654,6 @@ rz_basefind_end:
 	}
 	rz_th_lock_free(lock);
 	basefind_array_free(array);
-	ht_uu_free(pointers);
+	basefind_pointers_free(pointers);
 	return scores;
 }
@@ -2347,14 +2347,75 @@ static bool isSkippable(RzBinSymbol *s) {
 	return false;
 }
 
+static void entrypoints_push(RzVector /*<ut64>*/ *entries, RzSetU *visited, ut64 addr) {
+	if (rz_set_u_contains(visited, addr)) {
+		return;
+	}
+	rz_set_u_add(visited, addr);
+	rz_vector_push(entries, &addr);
+}
+
+/**
+ * \brief Collects the entry points used by rz_core_analysis_all.
+ *
+ * The addresses are returned in the order in which they have to be analyzed
+ * (symbols, main and then the binary entries), without duplicates, so that
+ * the analysis of the whole binary always discovers functions in the same order.
+ * \p phase_end receives the end index of the symbols, main and entries.
+ */
+static RzVector /*<ut64>*/ *core_analysis_collect_entrypoints(RzCore *core, RzBinObject *o, size_t phase_end[3]) {
+	RzVector *entries = rz_vector_new(sizeof(ut64), NULL, NULL);
+	RzSetU *visited = rz_set_u_new();
+	if (!entries || !visited) {
+		rz_vector_free(entries);
+		rz_set_u_free(visited);
+		return NULL;
+	}
+
+	const RzPVector *vector = NULL;
+	void **it;
+	/* Symbols (Imports are already analyzed by rz_bin on init) */
+	if (o && (vector = rz_bin_object_get_symbols(o))) {
+		rz_pvector_foreach (vector, it) {
+			RzBinSymbol *symbol = *it;
+			// Stop analyzing PE imports further
+			if (isSkippable(symbol) || !isValidSymbol(symbol)) {
+				continue;
+			}
+			entrypoints_push(entries, visited, rz_bin_object_get_vaddr(o, symbol->paddr, symbol->vaddr));
+		}
+	}
+	phase_end[0] = rz_vector_len(entries);
+
+	/* Main */
+	const RzBinAddr *binmain = o ? rz_bin_object_get_special_symbol(o, RZ_BIN_SPECIAL_SYMBOL_MAIN) : NULL;
+	if (binmain && binmain->paddr != UT64_MAX) {
+		entrypoints_push(entries, visited, rz_bin_object_get_vaddr(o, binmain->paddr, binmain->vaddr));
+	}
+	phase_end[1] = rz_vector_len(entries);
+
+	/* Entries */
+	RzBinObject *bin = rz_bin_cur_object(core->bin);
+	vector = bin ? rz_bin_object_get_entries(bin) : NULL;
+	if (vector) {
+		rz_pvector_foreach (vector, it) {
+			RzBinAddr *entry = *it;
+			if (entry->paddr == UT64_MAX) {
+				continue;
+			}
+			entrypoints_push(entries, visited, rz_bin_object_get_vaddr(o, entry->paddr, entry->vaddr));
+		}
+	}
+	phase_end[2] = rz_vector_len(entries);
+
+	rz_set_u_free(visited);
+	return entries;
+}
+
 RZ_API int rz_core_analysis_all(RzCore *core) {
-	RzPVector *vector;
 	RzListIter *iter;
 	RzFlagItem *item;
 	RzAnalysisFunction *fcni;
-	const RzBinAddr *binmain;
-	RzBinAddr *entry;
-	RzBinSymbol *symbol;
 	int depth = core->analysis->opt.depth;
 	bool analysis_vars = rz_config_get_i(core->config, "analysis.vars");
 
@@ -2374,46 +2435,23 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 
 	RzBinFile *bf = core->bin->cur;
 	RzBinObject *o = bf ? bf->o : NULL;
-	/* Symbols (Imports are already analyzed by rz_bin on init) */
-	void **it;
-	if (o && (vector = o->symbols) != NULL) {
-		rz_pvector_foreach (vector, it) {
-			symbol = *it;
-			if (rz_cons_is_breaked()) {
+	size_t phase_end[3] = { 0 };
+	RzVector *entries = core_analysis_collect_entrypoints(core, o, phase_end);
+	// the entry points are analyzed one at a time, yielding after each phase.
+	// A break only stops the symbols, main and the entries are always analyzed.
+	size_t i = 0;
+	for (size_t phase = 0; phase < RZ_ARRAY_SIZE(phase_end); phase++) {
+		for (; entries && i < phase_end[phase]; i++) {
+			if (phase == 0 && rz_cons_is_breaked()) {
+				i = phase_end[phase];
 				break;
 			}
-			// Stop analyzing PE imports further
-			if (isSkippable(symbol)) {
-				continue;
-			}
-			if (isValidSymbol(symbol)) {
-				ut64 addr = rz_bin_object_get_vaddr(o, symbol->paddr, symbol->vaddr);
-				rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
-			}
-		}
-	}
-	rz_core_task_yield(&core->tasks);
-	/* Main */
-	if (o && (binmain = rz_bin_object_get_special_symbol(o, RZ_BIN_SPECIAL_SYMBOL_MAIN))) {
-		if (binmain->paddr != UT64_MAX) {
-			ut64 addr = rz_bin_object_get_vaddr(o, binmain->paddr, binmain->vaddr);
-			rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
-		}
-	}
-	rz_core_task_yield(&core->tasks);
-	RzBinObject *bin = rz_bin_cur_object(core->bin);
-	vector = bin ? (RzPVector *)rz_bin_object_get_entries(bin) : NULL;
-	if (vector) {
-		rz_pvector_foreach (vector, it) {
-			entry = *it;
-			if (entry->paddr == UT64_MAX) {
-				continue;
-			}
-			ut64 addr = rz_bin_object_get_vaddr(o, entry->paddr, entry->vaddr);
-			rz_core_analysis_fcn(core, addr, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
+			ut64 *addr = rz_vector_index_ptr(entries, i);
+			rz_core_analysis_fcn(core, *addr, -1, RZ_ANALYSIS_XREF_TYPE_NULL, depth - 1);
 		}
+		rz_core_task_yield(&core->tasks);
 	}
-	rz_core_task_yield(&core->tasks);
+	rz_vector_free(entries);
 	if (analysis_vars) {
 		/* Set fcn type to RZ_ANALYSIS_FCN_TYPE_SYM for symbols */
 		rz_list_foreach_prev(core->analysis->fcns, iter, fcni) {
@@ -3607,15 +3645,14 @@ struct core_noretl {
 	RzSetU *todo;
 };
 
-static bool process_reference_noreturn_cb(void *u, const ut64 k, const void *v) {
+static bool process_reference_noreturn_cb(const RzAnalysisXRef *xref, void *u) {
 	RzCore *core = ((struct core_noretl *)u)->core;
 	RzList *noretl = ((struct core_noretl *)u)->noretl;
 	RzSetU *todo = ((struct core_noretl *)u)->todo;
-	RzAnalysisXRef *xref = (RzAnalysisXRef *)v;
 	if (xref->type == RZ_ANALYSIS_XREF_TYPE_CALL || xref->type == RZ_ANALYSIS_XREF_TYPE_CODE) {
 		// At first we check if there are any relocations that override the call address
 		// Note, that the relocation overrides only the part of the instruction
-		ut64 addr = k;
+		ut64 addr = xref->from;
 		ut8 buf[CALL_BUF_SIZE] = { 0 };
 		RzAnalysisOp op = { 0 };
 		if (core->analysis->iob.read_at(core->analysis->iob.io, addr, buf, CALL_BUF_SIZE)) {
@@ -3640,12 +3677,6 @@ static bool process_reference_noreturn_cb(void *u, const ut64 k, const void *v)
 	return true;
 }
 
-static bool process_refs_cb(void *u, const ut64 k, const void *v) {
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach(ht, process_reference_noreturn_cb, u);
-	return true;
-}
-
 static bool reanalyze_fcns_cb(void *u, const ut64 k, const void *v) {
 	RzCore *core = u;
 	RzAnalysisFunction *fcn = (RzAnalysisFunction *)(size_t)k;
@@ -3667,7 +3698,7 @@ RZ_API void rz_core_analysis_propagate_noreturn_relocs(RzCore *core, ut64 addr)
 	// List of the potentially noreturn functions
 	RzSetU *todo = rz_set_u_new();
 	struct core_noretl u = { core, noretl, todo };
-	ht_up_foreach(core->analysis->ht_xrefs_to, process_refs_cb, &u);
+	rz_analysis_xrefs_foreach(core->analysis, process_reference_noreturn_cb, &u);
 	rz_list_free(noretl);
 	core->analysis->bits = bits1;
 	core->rasm->bits = bits2;
@@ -5973,6 +6004,14 @@ RZ_API void rz_core_perform_auto_analysis(RZ_NONNULL RzCore *core, RzCoreAnalysi
 	rz_return_if_fail(core);
 
 	ut64 old_offset = core->offset;
+	// hashing the file is not free, so the cache directory is looked up once
+	char *cache_dir = rz_config_get_b(core->config, "analysis.cache") ? rz_core_analysis_cache_path(core) : NULL;
+	// only a freshly opened file may be replaced by the cached results
+	if (cache_dir && rz_list_empty(core->analysis->fcns) && rz_core_analysis_cache_load(core, cache_dir, type)) {
+		rz_core_notify_done(core, "Loaded the analysis from the cache");
+		free(cache_dir);
+		return;
+	}
 	const char *notify = "Analyze all flags starting with sym. and entry0 (aa)";
 	rz_core_notify_begin(core, "%s", notify);
 	rz_cons_break_push(NULL, NULL);
@@ -6001,8 +6040,12 @@ finish:
 	rz_core_seek(core, old_offset, true);
 	// XXX this shouldnt be called. flags muts be created wheen the function is registered
 	rz_core_analysis_flag_every_function(core);
+	if (cache_dir && !rz_cons_is_breaked()) {
+		rz_core_analysis_cache_save(core, cache_dir, type);
+	}
 	rz_cons_break_pop();
 	RZ_FREE(debugger);
+	free(cache_dir);
 }
 
 /**
@@ -1306,7 +1306,7 @@ RZ_API bool rz_core_bin_apply_imports(RzCore *core, RzBinFile *binfile, bool va)
 	}
 	void **iter;
 	RzBinImport *import;
-	RzPVector *imports = o->imports;
+	const RzPVector *imports = rz_bin_object_get_imports(o);
 	rz_pvector_foreach (imports, iter) {
 		import = *iter;
 		if (!import->libname || !strstr(import->libname, ".dll")) {
@@ -1597,7 +1597,7 @@ RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va)
 RZ_API bool rz_core_bin_apply_classes(RzCore *core, RzBinFile *binfile) {
 	rz_return_val_if_fail(core && binfile, false);
 	RzBinObject *o = binfile->o;
-	RzPVector *cs = o ? o->classes : NULL;
+	const RzPVector *cs = o ? rz_bin_object_get_classes(o) : NULL;
 	if (!cs) {
 		return false;
 	}
@@ -2070,11 +2070,16 @@ static bool cb_io_cache_mode(void *user, void *data) {
 static bool cb_io_cache_read(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
+	const int cached = core->io->cached;
 	if (node->i_value) {
 		core->io->cached |= RZ_PERM_R;
 	} else {
 		core->io->cached &= ~RZ_PERM_R;
 	}
+	if (cached != core->io->cached) {
+		// the cached writes appear or disappear
+		rz_core_io_bytes_reset(core);
+	}
 	return true;
 }
 
@@ -2119,6 +2124,7 @@ static bool cb_iova(void *user, void *data) {
 	RzConfigNode *node = (RzConfigNode *)data;
 	if (node->i_value != core->io->va) {
 		core->io->va = node->i_value;
+		rz_core_io_bytes_reset(core);
 		/* ugly fix for rizin -d ... "rizin is going to die soon ..." */
 		if (core->io->desc) {
 			rz_core_block_read(core);
@@ -2134,6 +2140,13 @@ static bool cb_ioff(void *user, void *data) {
 	return true;
 }
 
+static bool cb_io_pagecache(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_io_page_cache_set_size(core->io, node->i_value);
+	return true;
+}
+
 static bool cb_io_oxff(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -3030,6 +3043,14 @@ RZ_API int rz_core_config_init(RzCore *core) {
 
 	/* analysis */
 	SETBPREF("analysis.detectwrites", "false", "Automatically reanalyze function after a write");
+	SETBPREF("analysis.cache", "false", "Reuse the results of aa/aaa stored for the same file and analysis.* settings");
+	{
+		char *cache_dir = rz_path_home_cache();
+		char *analysis_cache_dir = cache_dir ? rz_file_path_join(cache_dir, "analysis") : NULL;
+		SETPREF("analysis.cache.dir", analysis_cache_dir ? analysis_cache_dir : "", "Directory where the analysis cache is stored");
+		free(analysis_cache_dir);
+		free(cache_dir);
+	}
 	SETPREF("analysis.fcnprefix", "fcn", "Prefix new function names with this");
 	const char *analysiscc = rz_analysis_cc_default(core->analysis);
 	SETCB("analysis.cc", analysiscc ? analysiscc : "", (RzConfigCallback)&cb_analysiscc, "Specify default calling convention");
@@ -3425,6 +3446,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETI("diff.from", 0, "Set source diffing address for px (uses cc command)");
 	SETI("diff.to", 0, "Set destination diffing address for px (uses cc command)");
 	SETBPREF("diff.bare", "false", "Never show function names in diff output");
+	SETI("diff.lsh", 0, "Rows per MinHash LSH band used to prune the function matching candidates (0: compare all, 1-32: fewer is slower and finds more matches)");
 
 	/* dir */
 	SETI("dir.depth", 10, "Maximum depth when searching recursively for files");
@@ -3765,6 +3787,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETBPREF("search.flags", "true", "All search results are flagged, otherwise only printed");
 	SETBPREF("search.overlap", "false", "Look for overlapped search hits");
 	SETI("search.maxhits", 0, "Maximum number of hits (0: no limit)");
+	SETI("search.max_threads", RZ_THREAD_N_CORES_ALL_AVAILABLE, "Maximum core number used by keyword searches (0 for all cores, 1 to disable threads)");
 	SETI("search.from", 0, "Search start address (inclusive)");
 	SETI("search.to", UT64_MAX, "Search end address (exclusive)");
 	n = NODECB("search.in", "io.maps", &cb_search_in);
@@ -3798,6 +3821,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB("io.pcache", "false", &cb_iopcache, "io.cache for p-level");
 	SETCB("io.pcache.write", "false", &cb_iopcachewrite, "Enable write-cache");
 	SETCB("io.pcache.read", "false", &cb_iopcacheread, "Enable read-cache");
+	SETICB("io.pagecache", 0, &cb_io_pagecache, "Number of 4KiB pages kept in the IO read cache (0 to disable)");
 	SETCB("io.ff", "true", &cb_ioff, "Fill invalid buffers with 0xff instead of returning error");
 	SETBPREF("io.exec", "true", "See !!rizin -h~-x");
 	SETICB("io.0xff", 0xff, &cb_io_oxff, "Use this value instead of 0xff to fill unallocated areas");
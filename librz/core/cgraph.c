@@ -163,7 +163,8 @@ RZ_API RZ_OWN RzGraph /*<RzGraphNodeInfo *>*/ *rz_core_graph_importxrefs(RZ_NONN
 	bool va = core->io->va || core->bin->is_debugger;
 	void **iter;
 	RzBinImport *imp;
-	rz_pvector_foreach (obj->imports, iter) {
+	const RzPVector *imports = rz_bin_object_get_imports(obj);
+	rz_pvector_foreach (imports, iter) {
 		imp = *iter;
 		RzBinSymbol *sym = rz_bin_object_get_symbol_of_import(obj, imp);
 		ut64 addr = sym ? (va ? rz_bin_object_get_vaddr(obj, sym->paddr, sym->vaddr) : sym->paddr) : UT64_MAX;
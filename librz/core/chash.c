@@ -56,3 +56,72 @@ RZ_API RzCmdStatus rz_core_hash_plugins_print(RZ_NONNULL RZ_BORROW RzHash *hash,
 	rz_cmd_state_output_array_end(state);
 	return RZ_CMD_STATUS_OK;
 }
+
+static bool core_hash_tree_read(void *user, ut64 offset, ut8 *buf, ut64 len) {
+	RzCore *core = (RzCore *)user;
+	// unmapped bytes are filled with io->Oxff, as in the core block
+	rz_io_read_at(core->io, core->hash_tree_addr + offset, buf, len);
+	return true;
+}
+
+/**
+ * \brief Marks the chunks of core->hash_tree overlapping [addr, addr + size) as modified.
+ */
+RZ_IPI void rz_core_hash_tree_invalidate(RzCore *core, ut64 addr, ut64 size) {
+	if (!core->hash_tree || !size) {
+		return;
+	}
+	ut64 from = core->hash_tree_addr;
+	ut64 end = addr + size < addr ? UT64_MAX : addr + size;
+	if (end <= from) {
+		return;
+	}
+	if (addr < from) {
+		rz_hash_tree_invalidate(core->hash_tree, 0, end - from);
+		return;
+	}
+	rz_hash_tree_invalidate(core->hash_tree, addr - from, end - addr);
+}
+
+/**
+ * \brief Returns the tree hash of [addr, addr + size) as an hexadecimal string.
+ *
+ * The chunk digests of the last hashed region are kept in core->hash_tree, so
+ * hashing the same region again reads only the chunks touched by the writes,
+ * dropped cached writes and map changes notified by the IO since the previous
+ * call. The memory of a debuggee changes on its own, so it is always read again.
+ *
+ * \param  core        The RzCore instance
+ * \param  algo        The message digest to use
+ * \param  addr        The address of the region
+ * \param  size        The size of the region
+ * \param  chunk_size  The size of the leaves of the tree
+ *
+ * \return On success returns the hexadecimal root digest, otherwise NULL
+ */
+RZ_API RZ_OWN char *rz_core_hash_tree(RZ_NONNULL RzCore *core, RZ_NONNULL const char *algo, ut64 addr, ut64 size, ut64 chunk_size) {
+	rz_return_val_if_fail(core && algo && chunk_size > 0, NULL);
+	RzHashTree *tree = core->hash_tree;
+	if (!tree || core->hash_tree_addr != addr || rz_hash_tree_size(tree) != size ||
+		rz_hash_tree_chunk_size(tree) != chunk_size || strcmp(rz_hash_tree_algorithm(tree), algo)) {
+		rz_hash_tree_free(tree);
+		core->hash_tree = tree = rz_hash_tree_new(core->hash, algo, size, chunk_size);
+		core->hash_tree_addr = addr;
+		if (!tree) {
+			return NULL;
+		}
+	}
+
+	if (rz_core_is_debug(core)) {
+		rz_hash_tree_invalidate(tree, 0, UT64_MAX);
+	}
+
+	RzHashSize digest_size = 0;
+	const ut8 *root = NULL;
+	if (!rz_hash_tree_update(tree, core_hash_tree_read, core) ||
+		!(root = rz_hash_tree_root(tree, &digest_size))) {
+		RZ_FREE_CUSTOM(core->hash_tree, rz_hash_tree_free);
+		return NULL;
+	}
+	return rz_hex_bin2strdup(root, digest_size);
+}
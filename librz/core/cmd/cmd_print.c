@@ -1579,6 +1579,22 @@ RZ_IPI RzCmdStatus rz_cmd_print_hash_cfg_handler(RzCore *core, int argc, const c
 	return RZ_CMD_STATUS_OK;
 }
 
+RZ_IPI RzCmdStatus rz_cmd_print_hash_tree_handler(RzCore *core, int argc, const char **argv) {
+	ut64 chunk_size = argc > 2 ? rz_num_math(core->num, argv[2]) : 0x1000;
+	if (!chunk_size) {
+		RZ_LOG_ERROR("core: invalid chunk size\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+
+	char *root = rz_core_hash_tree(core, argv[1], core->offset, core->blocksize, chunk_size);
+	if (!root) {
+		return RZ_CMD_STATUS_ERROR;
+	}
+	rz_cons_println(root);
+	free(root);
+	return RZ_CMD_STATUS_OK;
+}
+
 RZ_IPI RzCmdStatus rz_cmd_print_hash_cfg_algo_list_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
 	return rz_core_hash_plugins_print(core->hash, state);
 }
@@ -1263,6 +1263,199 @@ static void do_asm_search(RzCore *core, struct search_parameters *param, const c
 	rz_cons_break_pop();
 }
 
+#define SEARCH_CHUNK_SIZE 0x10000
+
+typedef struct {
+	ut8 *buf;
+	ut64 len;
+	RzVector /*<ut32>*/ *matches; ///< n_kws vectors for each block of the chunk
+	bool done;
+	bool ok;
+} SearchChunk;
+
+typedef struct {
+	RzCore *core;
+	ut64 from;
+	ut64 to;
+	ut64 chunk_size; ///< multiple of block_size
+	ut64 block_size;
+	size_t n_kws;
+	size_t n_chunks;
+	size_t next; ///< next chunk to scan
+	size_t replayed; ///< chunks whose hits were reported
+	size_t window; ///< number of chunk slots, chunk k uses chunks[k % window]
+	SearchChunk *chunks;
+	RzThreadLock *lock;
+	RzThreadCond *cond;
+	bool stop;
+} SearchThreadCtx;
+
+static void *search_chunk_worker(SearchThreadCtx *ctx) {
+	RzSearch *search = ctx->core->search;
+	rz_th_lock_enter(ctx->lock);
+	while (true) {
+		while (!ctx->stop && ctx->next < ctx->n_chunks && ctx->next >= ctx->replayed + ctx->window) {
+			rz_th_cond_wait(ctx->cond, ctx->lock);
+		}
+		if (ctx->stop || ctx->next >= ctx->n_chunks) {
+			break;
+		}
+		size_t k = ctx->next++;
+		SearchChunk *chunk = &ctx->chunks[k % ctx->window];
+		ut64 at = ctx->from + k * ctx->chunk_size;
+		chunk->len = RZ_MIN(ctx->chunk_size, ctx->to - at);
+		// RzIO is not thread safe, the reads are serialized with the hit callbacks
+		(void)rz_io_read_at(ctx->core->io, at, chunk->buf, chunk->len);
+		rz_th_lock_leave(ctx->lock);
+
+		bool ok = true;
+		for (ut64 off = 0, b = 0; ok && off < chunk->len; off += ctx->block_size, b++) {
+			int len = RZ_MIN(ctx->block_size, chunk->len - off);
+			ok = rz_search_kw_scan(search, chunk->buf + off, len, &chunk->matches[b * ctx->n_kws]);
+		}
+
+		rz_th_lock_enter(ctx->lock);
+		chunk->ok = ok;
+		chunk->done = true;
+		rz_th_cond_signal_all(ctx->cond);
+	}
+	rz_th_lock_leave(ctx->lock);
+	return NULL;
+}
+
+static void search_thread_ctx_fini(SearchThreadCtx *ctx) {
+	size_t n_blocks = ctx->chunk_size / ctx->block_size;
+	for (size_t i = 0; ctx->chunks && i < ctx->window; i++) {
+		SearchChunk *chunk = &ctx->chunks[i];
+		for (size_t j = 0; chunk->matches && j < n_blocks * ctx->n_kws; j++) {
+			rz_vector_fini(&chunk->matches[j]);
+		}
+		free(chunk->matches);
+		free(chunk->buf);
+	}
+	free(ctx->chunks);
+	rz_th_cond_free(ctx->cond);
+	rz_th_lock_free(ctx->lock);
+}
+
+static bool search_thread_ctx_init(SearchThreadCtx *ctx, size_t window) {
+	size_t n_blocks = ctx->chunk_size / ctx->block_size;
+	ctx->window = window;
+	ctx->lock = rz_th_lock_new(false);
+	ctx->cond = rz_th_cond_new();
+	ctx->chunks = RZ_NEWS0(SearchChunk, window);
+	if (!ctx->lock || !ctx->cond || !ctx->chunks) {
+		return false;
+	}
+	for (size_t i = 0; i < window; i++) {
+		SearchChunk *chunk = &ctx->chunks[i];
+		chunk->buf = malloc(ctx->chunk_size);
+		chunk->matches = RZ_NEWS(RzVector, n_blocks * ctx->n_kws);
+		if (!chunk->buf || !chunk->matches) {
+			return false;
+		}
+		for (size_t j = 0; j < n_blocks * ctx->n_kws; j++) {
+			rz_vector_init(&chunk->matches[j], sizeof(ut32), NULL, NULL);
+		}
+	}
+	return true;
+}
+
+typedef enum {
+	SEARCH_THREADED_UNSUPPORTED = 0,
+	SEARCH_THREADED_DONE,
+	SEARCH_THREADED_MAXHITS,
+} SearchThreadedStatus;
+
+/**
+ * \brief Keyword search of [from, to) with the blocks scanned by several threads
+ *
+ * The blocks are read and scanned ahead by the worker threads, while the hits
+ * are reported by this thread in the same order as the sequential search, so
+ * the output is the same. \p at is set to the address where the search stopped.
+ */
+static SearchThreadedStatus do_string_search_threaded(RzCore *core, struct search_parameters *param, ut64 from, ut64 to, ut64 *at) {
+	RzSearch *search = core->search;
+	RzThreadNCores max_threads = rz_th_max_threads(rz_config_get_i(core->config, "search.max_threads"));
+	const char *cmdhit = rz_config_get(core->config, "cmd.hit");
+	// cmd.hit could modify the bytes that the threads have already read
+	if (max_threads < 2 || RZ_STR_ISNOTEMPTY(cmdhit) || !core->blocksize ||
+		to - from <= SEARCH_CHUNK_SIZE || !rz_search_kw_prepare(search)) {
+		return SEARCH_THREADED_UNSUPPORTED;
+	}
+	SearchThreadCtx ctx = { 0 };
+	ctx.core = core;
+	ctx.from = from;
+	ctx.to = to;
+	ctx.block_size = core->blocksize;
+	ctx.chunk_size = RZ_MAX(SEARCH_CHUNK_SIZE / ctx.block_size, 1) * ctx.block_size;
+	ctx.n_kws = rz_list_length(search->kws);
+	ctx.n_chunks = (to - from + ctx.chunk_size - 1) / ctx.chunk_size;
+	if (ctx.n_chunks < 2) {
+		return SEARCH_THREADED_UNSUPPORTED;
+	}
+	RzThreadPool *pool = NULL;
+	if (!search_thread_ctx_init(&ctx, (size_t)max_threads * 2) || !(pool = rz_th_pool_new(max_threads))) {
+		search_thread_ctx_fini(&ctx);
+		return SEARCH_THREADED_UNSUPPORTED;
+	}
+	size_t n_threads = 0;
+	for (size_t i = 0; i < rz_th_pool_size(pool); i++) {
+		RzThread *th = rz_th_new((RzThreadFunction)search_chunk_worker, &ctx);
+		if (!th) {
+			break;
+		}
+		if (!rz_th_pool_add_thread(pool, th)) {
+			rz_th_free(th);
+			break;
+		}
+		n_threads++;
+	}
+	SearchThreadedStatus status = SEARCH_THREADED_DONE;
+	*at = from;
+	bool stop = !n_threads;
+	for (size_t k = 0; !stop && k < ctx.n_chunks; k++) {
+		SearchChunk *chunk = &ctx.chunks[k % ctx.window];
+		rz_th_lock_enter(ctx.lock);
+		while (!chunk->done) {
+			rz_th_cond_wait(ctx.cond, ctx.lock);
+		}
+		stop = !chunk->ok;
+		for (ut64 off = 0, b = 0; !stop && off < chunk->len; off += ctx.block_size, b++) {
+			print_search_progress(*at, to, search->nhits, param);
+			if (rz_cons_is_breaked()) {
+				eprintf("\n\n");
+				stop = true;
+				break;
+			}
+			if (!rz_io_is_valid_offset(core->io, *at, 0)) {
+				stop = true;
+				break;
+			}
+			int len = RZ_MIN(ctx.block_size, chunk->len - off);
+			rz_search_kw_update_scanned(search, *at, chunk->buf + off, len, &chunk->matches[b * ctx.n_kws]);
+			if (search->maxhits > 0 && search->nhits >= search->maxhits) {
+				status = SEARCH_THREADED_MAXHITS;
+				stop = true;
+				break;
+			}
+			*at += len;
+		}
+		chunk->done = false;
+		ctx.replayed = k + 1;
+		ctx.stop = stop;
+		rz_th_cond_signal_all(ctx.cond);
+		rz_th_lock_leave(ctx.lock);
+	}
+	if (!n_threads) {
+		status = SEARCH_THREADED_UNSUPPORTED;
+	}
+	rz_th_pool_wait(pool);
+	rz_th_pool_free(pool);
+	search_thread_ctx_fini(&ctx);
+	return status;
+}
+
 static void do_string_search(RzCore *core, RzInterval search_itv, struct search_parameters *param) {
 	ut64 at;
 	ut8 *buf = NULL;
@@ -1327,7 +1520,18 @@ static void do_string_search(RzCore *core, RzInterval search_itv, struct search_
 				   from1 = search->bckwrds ? to : from,
 				   to1 = search->bckwrds ? from : to;
 			ut64 len;
-			for (at = from1; at != to1; at = search->bckwrds ? at - len : at + len) {
+			at = from1;
+			if (!param->regex_search && !param->aes_search && !param->privkey_search && !search->bckwrds) {
+				SearchThreadedStatus status = do_string_search_threaded(core, param, from, to, &at);
+				if (status == SEARCH_THREADED_MAXHITS) {
+					goto done;
+				}
+				if (status == SEARCH_THREADED_DONE) {
+					// the remaining blocks are skipped, as after a break of the loop below
+					goto map_done;
+				}
+			}
+			for (; at != to1; at = search->bckwrds ? at - len : at + len) {
 				print_search_progress(at, to1, search->nhits, param);
 				if (rz_cons_is_breaked()) {
 					eprintf("\n\n");
@@ -1377,6 +1581,7 @@ static void do_string_search(RzCore *core, RzInterval search_itv, struct search_
 					goto done;
 				}
 			}
+		map_done:
 			print_search_progress(at, to1, search->nhits, param);
 			rz_cons_clear_line(1);
 			core->num->value = search->nhits;
@@ -66,6 +66,7 @@ static const RzCmdDescDetail cmd_info_query_details[2];
 static const RzCmdDescDetail query_sdb_get_set_details[2];
 static const RzCmdDescDetail cmd_print_byte_array_details[3];
 static const RzCmdDescDetail pf_details[3];
+static const RzCmdDescDetail cmd_print_hash_tree_details[2];
 static const RzCmdDescDetail print_rising_and_falling_entropy_details[2];
 static const RzCmdDescDetail interactive_visual_details[2];
 static const RzCmdDescDetail write_details[3];
@@ -648,6 +649,7 @@ static const RzCmdDescArg cmd_print_format_write_args[3];
 static const RzCmdDescArg cmd_print_gadget_add_args[6];
 static const RzCmdDescArg cmd_print_gadget_move_args[6];
 static const RzCmdDescArg cmd_print_hash_cfg_args[2];
+static const RzCmdDescArg cmd_print_hash_tree_args[3];
 static const RzCmdDescArg print_instr_args[2];
 static const RzCmdDescArg print_instr_opcodes_args[2];
 static const RzCmdDescArg print_instr_esil_args[2];
@@ -14309,6 +14311,36 @@ static const RzCmdDescHelp cmd_print_hash_cfg_help = {
 	.args = cmd_print_hash_cfg_args,
 };
 
+static const RzCmdDescDetailEntry cmd_print_hash_tree_Example_space_of_space_usages_detail_entries[] = {
+	{ .text = "pht sha256 @! 0x100000", .arg_str = NULL, .comment = "Tree hash of 1 MiB from the current offset, with chunks of 0x1000 bytes" },
+	{ .text = "pht md5 0x200 @! 0x10000", .arg_str = NULL, .comment = "Tree hash of 64 KiB from the current offset, with chunks of 0x200 bytes" },
+	{ .text = "ph md5 @! 0x10000", .arg_str = NULL, .comment = "Plain digest of the same bytes, always hashed entirely: the tree hash is a different value" },
+	{ 0 },
+};
+static const RzCmdDescDetail cmd_print_hash_tree_details[] = {
+	{ .name = "Example of usages", .entries = cmd_print_hash_tree_Example_space_of_space_usages_detail_entries },
+	{ 0 },
+};
+static const RzCmdDescArg cmd_print_hash_tree_args[] = {
+	{
+		.name = "algo",
+		.type = RZ_CMD_ARG_TYPE_STRING,
+
+	},
+	{
+		.name = "chunk_size",
+		.type = RZ_CMD_ARG_TYPE_NUM,
+		.optional = true,
+
+	},
+	{ 0 },
+};
+static const RzCmdDescHelp cmd_print_hash_tree_help = {
+	.summary = "Prints the tree hash of the block, hashing again only the chunks written since the last call",
+	.details = cmd_print_hash_tree_details,
+	.args = cmd_print_hash_tree_args,
+};
+
 static const RzCmdDescArg cmd_print_hash_cfg_algo_list_args[] = {
 	{ 0 },
 };
@@ -22588,6 +22620,9 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 
 	RzCmdDesc *cmd_print_default_cd = rz_cmd_desc_group_new(core->rcmd, cmd_print_cd, "ph", rz_cmd_print_hash_cfg_handler, &cmd_print_hash_cfg_help, &cmd_print_default_help);
 	rz_warn_if_fail(cmd_print_default_cd);
+	RzCmdDesc *cmd_print_hash_tree_cd = rz_cmd_desc_argv_new(core->rcmd, cmd_print_default_cd, "pht", rz_cmd_print_hash_tree_handler, &cmd_print_hash_tree_help);
+	rz_warn_if_fail(cmd_print_hash_tree_cd);
+
 	RzCmdDesc *cmd_print_hash_cfg_algo_list_cd = rz_cmd_desc_argv_state_new(core->rcmd, cmd_print_default_cd, "phl", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_RIZIN | RZ_OUTPUT_MODE_JSON | RZ_OUTPUT_MODE_QUIET, rz_cmd_print_hash_cfg_algo_list_handler, &cmd_print_hash_cfg_algo_list_help);
 	rz_warn_if_fail(cmd_print_hash_cfg_algo_list_cd);
 
@@ -1934,6 +1934,8 @@ RZ_IPI RzCmdStatus rz_cmd_print_gadget_remove_handler(RzCore *core, int argc, co
 RZ_IPI RzCmdStatus rz_cmd_print_gadget_move_handler(RzCore *core, int argc, const char **argv);
 // "ph"
 RZ_IPI RzCmdStatus rz_cmd_print_hash_cfg_handler(RzCore *core, int argc, const char **argv);
+// "pht"
+RZ_IPI RzCmdStatus rz_cmd_print_hash_tree_handler(RzCore *core, int argc, const char **argv);
 // "phl"
 RZ_IPI RzCmdStatus rz_cmd_print_hash_cfg_algo_list_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state);
 // "pi"
@@ -213,7 +213,11 @@ RZ_API RzBinReloc *rz_core_getreloc(RzCore *core, ut64 addr, int size) {
 		return NULL;
 	}
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->relocs) {
+	if (!bf || !bf->o) {
+		return NULL;
+	}
+	rz_bin_object_process_pending(bf->o);
+	if (!bf->o->relocs) {
 		return NULL;
 	}
 	return rz_bin_reloc_storage_get_reloc_in(bf->o->relocs, addr, size);
@@ -222,7 +226,11 @@ RZ_API RzBinReloc *rz_core_getreloc(RzCore *core, ut64 addr, int size) {
 RZ_API RzBinReloc *rz_core_get_reloc_to(RzCore *core, ut64 addr) {
 	rz_return_val_if_fail(core, NULL);
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->relocs) {
+	if (!bf || !bf->o) {
+		return NULL;
+	}
+	rz_bin_object_process_pending(bf->o);
+	if (!bf->o->relocs) {
 		return NULL;
 	}
 	return rz_bin_reloc_storage_get_reloc_to(bf->o->relocs, addr);
@@ -1443,9 +1451,52 @@ static int bp_bits_at(ut64 addr, void *user) {
 	return r ? r : core->analysis->bits;
 }
 
+RZ_IPI void rz_core_hash_tree_invalidate(RzCore *core, ut64 addr, ut64 size);
+
+/**
+ * Drops the results computed from the bytes at [addr, addr + size)
+ */
+static void core_io_bytes_changed(RzCore *core, ut64 addr, ut64 size) {
+	rz_analysis_il_cache_invalidate(core->analysis, addr, size);
+	rz_core_hash_tree_invalidate(core, addr, size);
+}
+
+/**
+ * \brief Drops the results computed from the bytes of any address
+ *
+ * To be called when every address may read differently, e.g. when the
+ * mapping of the addresses or io.cache is toggled.
+ */
+RZ_IPI void rz_core_io_bytes_reset(RzCore *core) {
+	rz_analysis_il_cache_clear(core->analysis);
+	RZ_FREE_CUSTOM(core->hash_tree, rz_hash_tree_free);
+}
+
 static void ev_iowrite_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzCore *core = user;
 	RzEventIOWrite *iow = data;
+	RzIO *io = core->io;
+	if (iow->fd < 0 || !io->va) {
+		// the io cache reports addresses, the descs physical offsets
+		core_io_bytes_changed(core, iow->addr, iow->len);
+	} else {
+		// the written bytes are visible through every map of the desc
+		const ut64 end = UT64_ADD_OVFCHK(iow->addr, iow->len) ? UT64_MAX : iow->addr + iow->len;
+		void **it;
+		rz_pvector_foreach (&io->maps, it) {
+			RzIOMap *map = *it;
+			const ut64 size = rz_itv_size(map->itv);
+			if (map->fd != iow->fd || !size) {
+				continue;
+			}
+			const ut64 map_end = UT64_ADD_OVFCHK(map->delta, size) ? UT64_MAX : map->delta + size;
+			const ut64 from = RZ_MAX(iow->addr, map->delta);
+			const ut64 to = RZ_MIN(end, map_end);
+			if (from < to) {
+				core_io_bytes_changed(core, map->itv.addr + (from - map->delta), to - from);
+			}
+		}
+	}
 	if (rz_config_get_i(core->config, "analysis.detectwrites")) {
 		rz_analysis_update_analysis_range(core->analysis, iow->addr, iow->len);
 		if (core->cons->event_resize && core->cons->event_data) {
@@ -1462,12 +1513,31 @@ RZ_IPI void rz_core_vfile_bin_file_deleted(RzCore *core, RzBinFile *bf);
 
 static void ev_iodescclose_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzEventIODescClose *ioc = data;
-	rz_core_file_io_desc_closed(user, ioc->desc);
+	RzCore *core = user;
+	// the memory behind any address may have changed
+	rz_core_io_bytes_reset(core);
+	rz_core_file_io_desc_closed(core, ioc->desc);
 }
 
 static void ev_iomapdel_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzEventIOMapDel *iod = data;
-	rz_core_file_io_map_deleted(user, iod->map);
+	RzCore *core = user;
+	rz_core_io_bytes_reset(core);
+	rz_core_file_io_map_deleted(core, iod->map);
+}
+
+static void ev_iomapsupdate_cb(RzEvent *ev, int type, void *user, void *data) {
+	RzEventIOMapsUpdate *iou = data;
+	RzCore *core = user;
+	if (!core->io->va) {
+		return;
+	}
+	if (iou->map) {
+		// the new map shadows the addresses below it
+		core_io_bytes_changed(core, rz_itv_begin(iou->map->itv), rz_itv_size(iou->map->itv));
+	} else {
+		rz_core_io_bytes_reset(core);
+	}
 }
 
 static void ev_binfiledel_cb(RzEvent *ev, int type, void *user, void *data) {
@@ -1605,6 +1675,7 @@ RZ_API bool rz_core_init(RzCore *core) {
 	rz_event_hook(core->io->event, RZ_EVENT_IO_WRITE, ev_iowrite_cb, core);
 	rz_event_hook(core->io->event, RZ_EVENT_IO_DESC_CLOSE, ev_iodescclose_cb, core);
 	rz_event_hook(core->io->event, RZ_EVENT_IO_MAP_DEL, ev_iomapdel_cb, core);
+	rz_event_hook(core->io->event, RZ_EVENT_IO_MAPS_UPDATE, ev_iomapsupdate_cb, core);
 	core->io->ff = 1;
 	core->search = rz_search_new(RZ_SEARCH_KEYWORD);
 	core->flags = rz_flag_new();
@@ -1731,6 +1802,7 @@ RZ_API void rz_core_fini(RzCore *c) {
 	rz_core_task_join(&c->tasks, NULL, -1);
 	rz_core_wait(c);
 	//  avoid double free
+	RZ_FREE_CUSTOM(c->hash_tree, rz_hash_tree_free);
 	RZ_FREE_CUSTOM(c->hash, rz_hash_free);
 	RZ_FREE_CUSTOM(c->ropchain, rz_list_free);
 	RZ_FREE_CUSTOM(c->ev, rz_event_free);
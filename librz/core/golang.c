@@ -157,6 +157,8 @@ static void add_new_func_symbol(RzCore *core, const char *name, ut64 vaddr) {
 	if (!bf || !bf->o || !bf->o->symbols) {
 		return;
 	}
+	// the new symbol is added after the demangling, as if it were done at load time
+	rz_bin_object_process_pending(bf->o);
 	ut64 paddr = rz_io_v2p(core->io, vaddr);
 	RzBinSymbol *symbol = rz_bin_symbol_new(name, paddr, vaddr);
 	if (!symbol) {
@@ -42,6 +42,7 @@ RZ_API void rz_serialize_core_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core,
 }
 
 static const char *const config_exclude[] = {
+	"analysis.cache.dir",
 	"dir.home",
 	"dir.libs",
 	"dir.magic",
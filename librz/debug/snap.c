@@ -47,6 +47,12 @@ RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr) {
 	return (snap->addr <= addr && addr >= snap->addr_end);
 }
 
+/**
+ * \brief Returns the sha256 digest of the data of \p snap.
+ *
+ * The data of a snapshot never changes once taken, so the digest is computed
+ * in one pass instead of through a RzHashTree.
+ */
 RZ_API ut8 *rz_debug_snap_get_hash(RzDebug *dbg, RzDebugSnap *snap, RzHashSize *size) {
 	ut8 *digest = rz_hash_cfg_calculate_small_block(dbg->hash, "sha256", snap->data, snap->size, size);
 	if (!digest) {
@@ -235,3 +235,86 @@ RZ_API bool rz_demangler_resolve(RZ_NONNULL RzDemangler *dem, RZ_NULLABLE const
 
 	return false;
 }
+
+/**
+ * Below this number of distinct names the batch is demangled on
+ * the calling thread, since spawning the workers costs more.
+ */
+#define DEMANGLER_BATCH_MIN_THREADED 0x200
+
+typedef struct {
+	const char *mangled; ///< Borrowed from the names given to the batch
+	char *demangled;
+	bool done;
+} DemanglerBatchEntry;
+
+typedef struct {
+	const RzDemanglerPlugin *plugin;
+	RzDemanglerFlag flags;
+} DemanglerBatchCtx;
+
+static void demangler_batch_entry(DemanglerBatchEntry *entry, const DemanglerBatchCtx *ctx) {
+	entry->demangled = ctx->plugin->demangle(entry->mangled, ctx->flags);
+	entry->done = true;
+}
+
+/**
+ * \brief Demangles all the \p names with \p plugin, splitting the work across threads.
+ *
+ * The names are first deduplicated, so each distinct mangled string is demangled
+ * only once; the demangler callback must thus be reentrant.
+ *
+ * \param  plugin       The demangler plugin to use
+ * \param  names        The mangled names; duplicates and empty strings are allowed
+ * \param  flags        The demangler flags
+ * \param  max_threads  The maximum number of threads to use
+ *
+ * \return On success returns a table which maps each mangled name to its demangled
+ *         string, or to NULL when the plugin could not demangle it; otherwise NULL.
+ */
+RZ_API RZ_OWN HtSP /*<char *, char *>*/ *rz_demangler_plugin_demangle_batch(RZ_NONNULL const RzDemanglerPlugin *plugin, RZ_NONNULL const RzPVector /*<const char *>*/ *names, RzDemanglerFlag flags, RzThreadNCores max_threads) {
+	rz_return_val_if_fail(plugin && plugin->demangle && names, NULL);
+
+	HtSP *table = ht_sp_new(HT_STR_DUP, NULL, free);
+	RzPVector *entries = rz_pvector_new(free);
+	if (!table || !entries || (!rz_pvector_empty(names) && !rz_pvector_reserve(entries, rz_pvector_len(names)))) {
+		goto fail;
+	}
+
+	void **it;
+	rz_pvector_foreach (names, it) {
+		const char *name = *it;
+		if (RZ_STR_ISEMPTY(name) || !ht_sp_insert(table, name, NULL)) {
+			// already queued
+			continue;
+		}
+		DemanglerBatchEntry *entry = RZ_NEW0(DemanglerBatchEntry);
+		if (!entry || !rz_pvector_push(entries, entry)) {
+			free(entry);
+			goto fail;
+		}
+		entry->mangled = name;
+	}
+
+	DemanglerBatchCtx ctx = { .plugin = plugin, .flags = flags };
+	if (rz_pvector_len(entries) >= DEMANGLER_BATCH_MIN_THREADED && rz_th_max_threads(max_threads) > 1 &&
+		!rz_th_iterate_pvector(entries, (RzThreadIterator)demangler_batch_entry, max_threads, &ctx)) {
+		RZ_LOG_WARN("rz_demangler: failed to demangle the names in parallel\n");
+	}
+
+	rz_pvector_foreach (entries, it) {
+		DemanglerBatchEntry *entry = *it;
+		if (!entry->done) {
+			demangler_batch_entry(entry, &ctx);
+		}
+		ht_sp_update(table, entry->mangled, entry->demangled);
+	}
+	rz_pvector_free(entries);
+	return table;
+
+fail:
+	RZ_LOG_ERROR("rz_demangler: failed to allocate the demangling batch\n");
+	rz_pvector_free(entries);
+	ht_sp_free(table);
+	return NULL;
+}
@@ -3,6 +3,84 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 #include <rz_diff.h>
 #include <rz_util/rz_assert.h>
+#include <rz_util/rz_bits.h>
+
+/** \file distance.c
+ *
+ * Both distances are computed with bit-parallel algorithms: the shorter
+ * buffer (the pattern) is split in blocks of 64 bytes and every column of
+ * the dynamic programming matrix is advanced a whole block at a time,
+ * using one bitmask per block and byte value to know where the pattern
+ * matches the current byte of the longer buffer (the text).
+ *
+ * - Levenshtein: Myers' bit-vector algorithm, in the blocked form given by
+ *   Hyyrö ("A bit-vector algorithm for computing Levenshtein and Damerau
+ *   edit distances", 2003).
+ * - Myers: the O(ND) algorithm is kept for very similar buffers, but when
+ *   it would take longer than the bit-parallel LCS (Allison-Dix, Hyyrö
+ *   2004) computation, the latter is used instead, since the insert/delete
+ *   distance is `size_a + size_b - 2 * LCS`.
+ */
+
+#define BITS_BLOCK 64
+
+/**
+ * \brief Builds the match masks of \p pattern
+ *
+ * peq[c * n_blocks + i] has bit j set when pattern[i * 64 + j] == c
+ */
+static ut64 *pattern_masks_new(const ut8 *pattern, ut32 size, ut32 n_blocks) {
+	if ((size_t)n_blocks > SIZE_MAX / (256 * sizeof(ut64))) {
+		return NULL;
+	}
+	ut64 *peq = calloc((size_t)n_blocks * 256, sizeof(ut64));
+	if (!peq) {
+		return NULL;
+	}
+	for (ut32 i = 0; i < size; i++) {
+		peq[(size_t)pattern[i] * n_blocks + i / BITS_BLOCK] |= 1ull << (i % BITS_BLOCK);
+	}
+	return peq;
+}
+
+/**
+ * \brief Length of the longest common subsequence of \p text and \p pattern
+ */
+static bool lcs_length(const ut8 *text, ut32 lt, const ut8 *pattern, ut32 lp, ut32 *length) {
+	if (!lt || !lp) {
+		*length = 0;
+		return true;
+	}
+	const ut32 n_blocks = (lp + BITS_BLOCK - 1) / BITS_BLOCK;
+	ut64 *peq = pattern_masks_new(pattern, lp, n_blocks);
+	ut64 *v = malloc(n_blocks * sizeof(ut64));
+	if (!peq || !v) {
+		free(peq);
+		free(v);
+		return false;
+	}
+	memset(v, 0xff, n_blocks * sizeof(ut64));
+	for (ut32 j = 0; j < lt; j++) {
+		const ut64 *eq = peq + (size_t)text[j] * n_blocks;
+		ut64 carry = 0;
+		for (ut32 i = 0; i < n_blocks; i++) {
+			ut64 u = v[i] & eq[i];
+			ut64 x = v[i] + u;
+			ut64 sum = x + carry;
+			carry = (x < v[i]) | (sum < x);
+			v[i] = sum | (v[i] - u);
+		}
+	}
+	ut32 zeros = 0;
+	for (ut32 i = 0; i < n_blocks; i++) {
+		ut64 used = i + 1 < n_blocks || !(lp % BITS_BLOCK) ? UT64_MAX : (1ull << (lp % BITS_BLOCK)) - 1;
+		zeros += rz_bits_count_ones_ut64(~v[i] & used);
+	}
+	free(v);
+	free(peq);
+	*length = zeros;
+	return true;
+}
 
 /**
  * \brief Calculates the distance between two buffers using the Myers algorithm
@@ -28,6 +106,9 @@ RZ_API bool rz_diff_myers_distance(RZ_NONNULL const ut8 *a, ut32 la, RZ_NONNULL
 	if (m + 2 > SIZE_MAX / sizeof(st64) || !(v0 = malloc((m + 2) * sizeof(ut32)))) {
 		return false;
 	}
+	// the O(ND) search is abandoned once it costs more than the bit-parallel one
+	const ut64 max_work = ((ut64)la * lb) / BITS_BLOCK + m;
+	ut64 work = 0;
 	v = v0 + lb;
 	v[1] = 0;
 	for (di = 0; di <= m; di++) {
@@ -36,15 +117,27 @@ RZ_API bool rz_diff_myers_distance(RZ_NONNULL const ut8 *a, ut32 la, RZ_NONNULL
 		for (i = low; i <= high; i += 2) {
 			x = i == -di || (i != di && v[i - 1] < v[i + 1]) ? v[i + 1] : v[i - 1] + 1;
 			y = x - i;
+			st64 snake = x;
 			while (x < la && y < lb && a[x] == b[y]) {
 				x++;
 				y++;
 			}
+			work += 1 + x - snake;
 			v[i] = x;
 			if (x == la && y == lb) {
 				goto out;
 			}
 		}
+		if (work > max_work) {
+			ut32 lcs = 0;
+			bool ok = la >= lb ? lcs_length(a, la, b, lb, &lcs) : lcs_length(b, lb, a, la, &lcs);
+			if (!ok) {
+				free(v0);
+				return false;
+			}
+			di = m - 2 * (st64)lcs;
+			break;
+		}
 	}
 
 out:
@@ -59,18 +152,82 @@ out:
 }
 
 /**
- * \brief Calculates the distance between two buffers using the Levenshtein algorithm
+ * \brief Levenshtein distance between \p text and \p pattern
  *
- * Calculates the distance between two buffers using the Levenshtein distance algorithm.
- * - distance:   is the minimum number of edits needed to transform A into B
- * - similarity: is a number that defines how similar/identical the 2 buffers are.
+ * Stops as soon as the distance is known to be above \p max_distance,
+ * in which case max_distance + 1 is returned.
+ */
+static bool levenshtein_bits(const ut8 *text, ut32 lt, const ut8 *pattern, ut32 lp, ut32 max_distance, ut32 *distance) {
+	const ut32 n_blocks = (lp + BITS_BLOCK - 1) / BITS_BLOCK;
+	ut64 *peq = pattern_masks_new(pattern, lp, n_blocks);
+	// vertical deltas of the current column: +1 where pv is set, -1 where mv is set
+	ut64 *pv = malloc(n_blocks * sizeof(ut64));
+	ut64 *mv = calloc(n_blocks, sizeof(ut64));
+	if (!peq || !pv || !mv) {
+		free(peq);
+		free(pv);
+		free(mv);
+		return false;
+	}
+	memset(pv, 0xff, n_blocks * sizeof(ut64));
+	const ut32 last_bit = (lp - 1) % BITS_BLOCK;
+	ut64 score = lp;
+	for (ut32 j = 0; j < lt; j++) {
+		const ut64 *eq = peq + (size_t)text[j] * n_blocks;
+		// the first row is D[0][j] = j, so it always grows by one
+		int hin = 1;
+		for (ut32 i = 0; i < n_blocks; i++) {
+			ut64 p = pv[i], m = mv[i], e = eq[i];
+			ut64 xv = e | m;
+			if (hin < 0) {
+				e |= 1;
+			}
+			ut64 xh = (((e & p) + p) ^ p) | e;
+			ut64 ph = m | ~(xh | p);
+			ut64 mh = p & xh;
+			if (i + 1 == n_blocks) {
+				score += ((ph >> last_bit) & 1) - ((mh >> last_bit) & 1);
+			}
+			int hout = (ph >> 63) ? 1 : ((mh >> 63) ? -1 : 0);
+			ph <<= 1;
+			mh <<= 1;
+			if (hin < 0) {
+				mh |= 1;
+			} else if (hin > 0) {
+				ph |= 1;
+			}
+			pv[i] = mh | ~(xv | ph);
+			mv[i] = ph & xv;
+			hin = hout;
+		}
+		// each of the remaining columns can lower the distance by one at most
+		if (score > (ut64)max_distance + (lt - j - 1)) {
+			score = (ut64)max_distance + 1;
+			break;
+		}
+	}
+	free(mv);
+	free(pv);
+	free(peq);
+	*distance = score;
+	return true;
+}
+
+/**
+ * \brief Calculates the distance between two buffers using the Levenshtein algorithm, with an upper bound
+ *
+ * Same as rz_diff_levenshtein_distance(), but the computation stops as soon as
+ * the distance is known to be greater than \p max_distance; in that case the
+ * reported distance is max_distance + 1 and the similarity is computed from it.
+ * This is useful to discard dissimilar buffers quickly when only those with
+ * a minimum similarity are of interest.
  * */
-RZ_API bool rz_diff_levenshtein_distance(RZ_NONNULL const ut8 *a, ut32 la, RZ_NONNULL const ut8 *b, ut32 lb, RZ_NULLABLE ut32 *distance, RZ_NULLABLE double *similarity) {
+RZ_API bool rz_diff_levenshtein_distance_max(RZ_NONNULL const ut8 *a, ut32 la, RZ_NONNULL const ut8 *b, ut32 lb, ut32 max_distance, RZ_NULLABLE ut32 *distance, RZ_NULLABLE double *similarity) {
 	rz_return_val_if_fail(a && b, false);
 
 	const ut32 length = RZ_MAX(la, lb);
 	const ut8 *ea = a + la, *eb = b + lb, *t;
-	ut32 *d, i, j;
+	ut32 d, i;
 
 	for (; a < ea && b < eb && *a == *b; a++, b++) {
 	}
@@ -87,28 +244,31 @@ RZ_API bool rz_diff_levenshtein_distance(RZ_NONNULL const ut8 *a, ut32 la, RZ_NO
 		b = t;
 	}
 
-	if (sizeof(ut32) > SIZE_MAX / (lb + 1) || !(d = malloc((lb + 1) * sizeof(ut32)))) {
+	if (la - lb > max_distance) {
+		// at least la - lb bytes have to be inserted
+		d = max_distance + 1;
+	} else if (!lb) {
+		d = la;
+	} else if (!levenshtein_bits(a, la, b, lb, max_distance, &d)) {
 		return false;
 	}
-	for (i = 0; i <= lb; i++) {
-		d[i] = i;
-	}
-	for (i = 0; i < la; i++) {
-		ut32 ul = d[0];
-		d[0] = i + 1;
-		for (j = 0; j < lb; j++) {
-			ut32 u = d[j + 1];
-			d[j + 1] = a[i] == b[j] ? ul : RZ_MIN(ul, RZ_MIN(d[j], u)) + 1;
-			ul = u;
-		}
-	}
 
 	if (distance) {
-		*distance = d[lb];
+		*distance = d;
 	}
 	if (similarity) {
-		*similarity = length ? 1.0 - (double)d[lb] / length : 1.0;
+		*similarity = length ? 1.0 - (double)d / length : 1.0;
 	}
-	free(d);
 	return true;
 }
+
+/**
+ * \brief Calculates the distance between two buffers using the Levenshtein algorithm
+ *
+ * Calculates the distance between two buffers using the Levenshtein distance algorithm.
+ * - distance:   is the minimum number of edits needed to transform A into B
+ * - similarity: is a number that defines how similar/identical the 2 buffers are.
+ * */
+RZ_API bool rz_diff_levenshtein_distance(RZ_NONNULL const ut8 *a, ut32 la, RZ_NONNULL const ut8 *b, ut32 lb, RZ_NULLABLE ut32 *distance, RZ_NULLABLE double *similarity) {
+	return rz_diff_levenshtein_distance_max(a, la, b, lb, UT32_MAX, distance, similarity);
+}
@@ -137,6 +137,28 @@ typedef enum {
 	FLAG_FIELD_ALIAS
 } FlagField;
 
+static const RzSerializeField flag_fields[] = {
+	[FLAG_FIELD_REALNAME] = RZ_SERIALIZE_FIELD_VARIABLE("realname"),
+	[FLAG_FIELD_DEMANGLED] = RZ_SERIALIZE_FIELD_BOOL(RzFlagItem, demangled, "demangled"),
+	[FLAG_FIELD_OFFSET] = RZ_SERIALIZE_FIELD(RzFlagItem, offset, "offset"),
+	[FLAG_FIELD_SIZE] = RZ_SERIALIZE_FIELD(RzFlagItem, size, "size"),
+	[FLAG_FIELD_SPACE] = RZ_SERIALIZE_FIELD_VARIABLE("space"),
+	[FLAG_FIELD_COLOR] = RZ_SERIALIZE_FIELD_VARIABLE("color"),
+	[FLAG_FIELD_COMMENT] = RZ_SERIALIZE_FIELD_VARIABLE("comment"),
+	[FLAG_FIELD_ALIAS] = RZ_SERIALIZE_FIELD_VARIABLE("alias"),
+};
+
+/**
+ * \brief Get the fields of an RzFlagItem, in the order of their keys in the json
+ *
+ * The name is not part of the fields, it is the key of the flag in the sdb.
+ */
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_flag_item_fields(RZ_NONNULL size_t *count) {
+	rz_return_val_if_fail(count, NULL);
+	*count = RZ_ARRAY_SIZE(flag_fields);
+	return flag_fields;
+}
+
 typedef struct {
 	RzFlag *flag;
 	RzKeyParser *parser;
@@ -247,14 +269,7 @@ static bool load_flags(RZ_NONNULL Sdb *flags_db, RZ_NONNULL RzFlag *flag) {
 	if (!ctx.parser) {
 		return false;
 	}
-	rz_key_parser_add(ctx.parser, "realname", FLAG_FIELD_REALNAME);
-	rz_key_parser_add(ctx.parser, "demangled", FLAG_FIELD_DEMANGLED);
-	rz_key_parser_add(ctx.parser, "offset", FLAG_FIELD_OFFSET);
-	rz_key_parser_add(ctx.parser, "size", FLAG_FIELD_SIZE);
-	rz_key_parser_add(ctx.parser, "space", FLAG_FIELD_SPACE);
-	rz_key_parser_add(ctx.parser, "color", FLAG_FIELD_COLOR);
-	rz_key_parser_add(ctx.parser, "comment", FLAG_FIELD_COMMENT);
-	rz_key_parser_add(ctx.parser, "alias", FLAG_FIELD_ALIAS);
+	rz_serialize_fields_key_parser_add(ctx.parser, flag_fields, RZ_ARRAY_SIZE(flag_fields));
 	bool r = sdb_foreach(flags_db, flag_load_cb, &ctx);
 	rz_key_parser_free(ctx.parser);
 	return r;
@@ -52,6 +52,9 @@ bool rz_fletcher16_update(RzFletcher16 *ctx, const ut8 *data, size_t len) {
 		ctx->low += *data++;
 		ctx->high += ctx->low;
 	}
+	// reduce the tail too, otherwise consecutive small updates overflow
+	ctx->low %= 0xff;
+	ctx->high %= 0xff;
 	return true;
 }
 
@@ -95,6 +98,8 @@ bool rz_fletcher32_update(RzFletcher32 *ctx, const ut8 *data, size_t len) {
 		ctx->high += ctx->low;
 		data += 2;
 	}
+	ctx->low %= UT16_MAX;
+	ctx->high %= UT16_MAX;
 	return true;
 }
 
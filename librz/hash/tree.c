@@ -0,0 +1,281 @@
+// SPDX-FileCopyrightText: 2026 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/** \file tree.c
+ * RzHashTree computes a tree hash (Merkle tree) of a region with any of the
+ * message digests of RzHash.
+ *
+ * The region is split in chunks whose digests are the leaves of a binary tree;
+ * each inner node is the digest of its two children and the root identifies
+ * the whole region. The digests are kept between the updates, so after a write
+ * only the touched chunks and their ancestors are hashed again.
+ *
+ * Leaves are computed as H(0x00 || chunk) and inner nodes as
+ * H(0x01 || left || right), while a node without a sibling is moved up as it
+ * is; the prefixes keep a leaf from being confused with an inner node.
+ *
+ * The root is not the plain digest of the region: the digests of RzHash cannot
+ * be merged from the digests of the chunks, so the commands printing a plain
+ * digest (ph) still read the whole region and only pht is backed by the tree.
+ */
+
+#include <rz_hash.h>
+#include <rz_util.h>
+
+#define HASH_TREE_LEAF 0x00
+#define HASH_TREE_NODE 0x01
+
+typedef struct {
+	ut8 *digests; ///< count * digest_size bytes
+	ut64 *dirty; ///< One bit for each node which must be computed again
+	ut64 count; ///< Number of nodes of the level
+} HashTreeLevel;
+
+struct rz_hash_tree_t {
+	RzHashCfg *md;
+	char *name; ///< Name of the message digest
+	RzHashSize digest_size;
+	ut64 size; ///< Size of the hashed region
+	ut64 chunk_size; ///< Size of each leaf, except the last one
+	HashTreeLevel *levels; ///< From the leaves to the root
+	ut32 n_levels;
+	ut64 n_dirty; ///< Number of dirty leaves
+	ut8 *chunk; ///< Buffer used to read one chunk
+};
+
+#define dirty_words(n)         (((n) + 63) / 64)
+#define dirty_get(bits, i)     ((bits)[(i) / 64] & (1ULL << ((i) % 64)))
+#define dirty_set(bits, i)     ((bits)[(i) / 64] |= (1ULL << ((i) % 64)))
+#define dirty_lowest(word)     rz_bits_count_ones_ut64(((word) & -(word)) - 1)
+#define level_digest(tree, l, i) ((l)->digests + (i) * (tree)->digest_size)
+
+/**
+ * \brief Creates a tree hash of a region of \p size bytes split in chunks of \p chunk_size bytes.
+ *
+ * All the chunks are dirty, so the first rz_hash_tree_update() reads the whole region.
+ *
+ * \param  rh          The RzHash providing the message digest
+ * \param  name        The name of the message digest (entropy and ssdeep are not supported)
+ * \param  size        The size of the region
+ * \param  chunk_size  The size of the leaves of the tree
+ *
+ * \return On success returns a valid pointer, otherwise NULL
+ */
+RZ_API RZ_OWN RzHashTree *rz_hash_tree_new(RZ_NONNULL RzHash *rh, RZ_NONNULL const char *name, ut64 size, ut64 chunk_size) {
+	rz_return_val_if_fail(rh && name && chunk_size > 0, NULL);
+	if (!strncmp(name, "entropy", strlen("entropy")) || !strcmp(name, "ssdeep")) {
+		RZ_LOG_ERROR("msg digest: %s cannot be used to build a tree hash.\n", name);
+		return NULL;
+	}
+
+	RzHashTree *tree = RZ_NEW0(RzHashTree);
+	if (!tree) {
+		return NULL;
+	}
+	tree->size = size;
+	tree->chunk_size = chunk_size;
+	tree->name = rz_str_dup(name);
+	tree->md = rz_hash_cfg_new(rh);
+	tree->chunk = malloc(chunk_size);
+	if (!tree->name || !tree->md || !tree->chunk || !rz_hash_cfg_configure(tree->md, name)) {
+		goto fail;
+	}
+	tree->digest_size = rz_hash_cfg_size(tree->md, name);
+	if (!tree->digest_size) {
+		goto fail;
+	}
+
+	ut64 count = size ? (size + chunk_size - 1) / chunk_size : 1;
+	tree->n_levels = 1;
+	for (ut64 n = count; n > 1; n = (n + 1) / 2) {
+		tree->n_levels++;
+	}
+	tree->levels = RZ_NEWS0(HashTreeLevel, tree->n_levels);
+	if (!tree->levels) {
+		goto fail;
+	}
+	for (ut32 i = 0; i < tree->n_levels; i++, count = (count + 1) / 2) {
+		HashTreeLevel *level = &tree->levels[i];
+		level->count = count;
+		level->digests = RZ_NEWS0(ut8, count * tree->digest_size);
+		level->dirty = RZ_NEWS0(ut64, dirty_words(count));
+		if (!level->digests || !level->dirty) {
+			goto fail;
+		}
+	}
+
+	rz_hash_tree_invalidate(tree, 0, UT64_MAX);
+	return tree;
+
+fail:
+	rz_hash_tree_free(tree);
+	return NULL;
+}
+
+RZ_API void rz_hash_tree_free(RZ_NULLABLE RzHashTree *tree) {
+	if (!tree) {
+		return;
+	}
+	for (ut32 i = 0; tree->levels && i < tree->n_levels; i++) {
+		free(tree->levels[i].digests);
+		free(tree->levels[i].dirty);
+	}
+	free(tree->levels);
+	if (tree->md) {
+		rz_hash_cfg_free(tree->md);
+	}
+	free(tree->chunk);
+	free(tree->name);
+	free(tree);
+}
+
+RZ_API RZ_BORROW const char *rz_hash_tree_algorithm(RZ_NONNULL RzHashTree *tree) {
+	rz_return_val_if_fail(tree, NULL);
+	return tree->name;
+}
+
+RZ_API ut64 rz_hash_tree_size(RZ_NONNULL RzHashTree *tree) {
+	rz_return_val_if_fail(tree, 0);
+	return tree->size;
+}
+
+RZ_API ut64 rz_hash_tree_chunk_size(RZ_NONNULL RzHashTree *tree) {
+	rz_return_val_if_fail(tree, 0);
+	return tree->chunk_size;
+}
+
+/**
+ * \brief Returns the number of chunks which the next rz_hash_tree_update() will hash.
+ */
+RZ_API ut64 rz_hash_tree_dirty_chunks(RZ_NONNULL RzHashTree *tree) {
+	rz_return_val_if_fail(tree, 0);
+	return tree->n_dirty;
+}
+
+/**
+ * \brief Marks the chunks overlapping [offset, offset + size) as modified.
+ *
+ * Ranges outside of the region are ignored.
+ */
+RZ_API void rz_hash_tree_invalidate(RZ_NONNULL RzHashTree *tree, ut64 offset, ut64 size) {
+	rz_return_if_fail(tree);
+	HashTreeLevel *leaves = &tree->levels[0];
+	if (!size || (offset >= tree->size && tree->size)) {
+		return;
+	}
+	ut64 last = size > UT64_MAX - offset ? UT64_MAX : offset + size - 1;
+	ut64 first = offset / tree->chunk_size;
+	last = RZ_MIN(last / tree->chunk_size, leaves->count - 1);
+	for (ut64 i = first; i <= last; i++) {
+		if (!dirty_get(leaves->dirty, i)) {
+			dirty_set(leaves->dirty, i);
+			tree->n_dirty++;
+		}
+	}
+}
+
+static bool hash_tree_digest(RzHashTree *tree, ut8 prefix, const ut8 *a, ut64 a_size, const ut8 *b, ut64 b_size, ut8 *out) {
+	RzHashSize size = 0;
+	if (!rz_hash_cfg_init(tree->md) ||
+		!rz_hash_cfg_update(tree->md, &prefix, 1) ||
+		(a_size && !rz_hash_cfg_update(tree->md, a, a_size)) ||
+		(b_size && !rz_hash_cfg_update(tree->md, b, b_size)) ||
+		!rz_hash_cfg_final(tree->md)) {
+		return false;
+	}
+	const ut8 *digest = rz_hash_cfg_get_result(tree->md, tree->name, &size);
+	if (!digest || size != tree->digest_size) {
+		return false;
+	}
+	memcpy(out, digest, size);
+	return true;
+}
+
+static bool hash_tree_update_leaves(RzHashTree *tree, RzHashTreeRead read, void *user, const ut8 *data) {
+	HashTreeLevel *leaves = &tree->levels[0];
+	HashTreeLevel *parents = tree->n_levels > 1 ? &tree->levels[1] : NULL;
+	for (ut64 w = 0; w < dirty_words(leaves->count); w++) {
+		while (leaves->dirty[w]) {
+			ut64 i = w * 64 + dirty_lowest(leaves->dirty[w]);
+			ut64 offset = i * tree->chunk_size;
+			ut64 size = offset < tree->size ? RZ_MIN(tree->chunk_size, tree->size - offset) : 0;
+			const ut8 *chunk = data ? data + offset : tree->chunk;
+			if (!data && size && !read(user, offset, tree->chunk, size)) {
+				return false;
+			}
+			if (!hash_tree_digest(tree, HASH_TREE_LEAF, chunk, size, NULL, 0, level_digest(tree, leaves, i))) {
+				return false;
+			}
+			leaves->dirty[w] &= leaves->dirty[w] - 1;
+			tree->n_dirty--;
+			if (parents) {
+				dirty_set(parents->dirty, i / 2);
+			}
+		}
+	}
+	return true;
+}
+
+static bool hash_tree_update_nodes(RzHashTree *tree) {
+	for (ut32 l = 1; l < tree->n_levels; l++) {
+		HashTreeLevel *children = &tree->levels[l - 1];
+		HashTreeLevel *level = &tree->levels[l];
+		HashTreeLevel *parents = l + 1 < tree->n_levels ? &tree->levels[l + 1] : NULL;
+		for (ut64 w = 0; w < dirty_words(level->count); w++) {
+			while (level->dirty[w]) {
+				ut64 i = w * 64 + dirty_lowest(level->dirty[w]);
+				const ut8 *left = level_digest(tree, children, 2 * i);
+				ut8 *out = level_digest(tree, level, i);
+				if (2 * i + 1 < children->count) {
+					const ut8 *right = level_digest(tree, children, 2 * i + 1);
+					if (!hash_tree_digest(tree, HASH_TREE_NODE, left, tree->digest_size, right, tree->digest_size, out)) {
+						return false;
+					}
+				} else {
+					memcpy(out, left, tree->digest_size);
+				}
+				level->dirty[w] &= level->dirty[w] - 1;
+				if (parents) {
+					dirty_set(parents->dirty, i / 2);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Hashes again the dirty chunks, reading them with \p read, and updates the root.
+ *
+ * \param  tree  The RzHashTree to update
+ * \param  read  Callback which reads the bytes of the region at the given offset
+ * \param  user  User pointer passed to \p read
+ *
+ * \return Returns false when a read or the message digest fails, otherwise true
+ */
+RZ_API bool rz_hash_tree_update(RZ_NONNULL RzHashTree *tree, RZ_NONNULL RzHashTreeRead read, RZ_NULLABLE void *user) {
+	rz_return_val_if_fail(tree && read, false);
+	return hash_tree_update_leaves(tree, read, user, NULL) && hash_tree_update_nodes(tree);
+}
+
+/**
+ * \brief Hashes again the dirty chunks of \p data, which holds the whole region, and updates the root.
+ */
+RZ_API bool rz_hash_tree_update_buffer(RZ_NONNULL RzHashTree *tree, RZ_NONNULL const ut8 *data) {
+	rz_return_val_if_fail(tree && data, false);
+	return hash_tree_update_leaves(tree, NULL, NULL, data) && hash_tree_update_nodes(tree);
+}
+
+/**
+ * \brief Returns the root digest, or NULL when some chunk was modified after the last update.
+ */
+RZ_API RZ_BORROW const ut8 *rz_hash_tree_root(RZ_NONNULL RzHashTree *tree, RZ_NULLABLE RzHashSize *size) {
+	rz_return_val_if_fail(tree, NULL);
+	if (tree->n_dirty) {
+		return NULL;
+	}
+	if (size) {
+		*size = tree->digest_size;
+	}
+	return tree->levels[tree->n_levels - 1].digests;
+}
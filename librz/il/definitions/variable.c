@@ -4,6 +4,8 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <rz_il/definitions/variable.h>
+#include <rz_constructor.h>
+#include <rz_th.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -39,6 +41,68 @@ RZ_API void rz_il_variable_free(RZ_NULLABLE RzILVar *var) {
 
 // Variable Set
 
+/**
+ * Maximum number of name strings remembered in RzILVarSet.slot_of_ptr.
+ * Lifted code normally uses a small set of constant strings, but to not grow
+ * without bounds when names are generated, the map is simply dropped when full.
+ */
+#define VAR_SET_PTR_CACHE_MAX 0x1000
+
+/**
+ * Number of slots above which rz_il_var_set_reset() drops all the slots.
+ * Lifters may generate names of local variables, so the slots of names
+ * that are not used anymore would otherwise accumulate.
+ */
+#define VAR_SET_SLOTS_MAX 0x1000
+
+static RzThreadLock *var_set_id_lock = NULL;
+static ut32 var_set_last_id = 0;
+
+#ifdef RZ_DEFINE_CONSTRUCTOR_NEEDS_PRAGMA
+#pragma RZ_DEFINE_CONSTRUCTOR_PRAGMA_ARGS(init_var_set_id)
+#endif
+RZ_DEFINE_CONSTRUCTOR(init_var_set_id)
+static void init_var_set_id(void) {
+	var_set_id_lock = rz_th_lock_new(false);
+}
+
+#ifdef RZ_DEFINE_DESTRUCTOR_NEEDS_PRAGMA
+#pragma RZ_DEFINE_DESTRUCTOR_PRAGMA_ARGS(fini_var_set_id)
+#endif
+RZ_DEFINE_DESTRUCTOR(fini_var_set_id)
+static void fini_var_set_id(void) {
+	RZ_FREE_CUSTOM(var_set_id_lock, rz_th_lock_free);
+}
+
+/**
+ * Returns a new set id, never 0 so that RZ_IL_VAR_SLOT_CACHE_INIT never matches a set
+ */
+static ut32 var_set_new_id(void) {
+	if (var_set_id_lock) {
+		rz_th_lock_enter(var_set_id_lock);
+	}
+	if (!++var_set_last_id) {
+		var_set_last_id++;
+	}
+	ut32 id = var_set_last_id;
+	if (var_set_id_lock) {
+		rz_th_lock_leave(var_set_id_lock);
+	}
+	return id;
+}
+
+static void var_set_entry_fini(void *e, RZ_UNUSED void *user) {
+	RzILVarSetEntry *entry = e;
+	free(entry->name);
+	rz_il_variable_free(entry->var);
+	rz_il_value_free(entry->val);
+}
+
+static HtPU *slot_of_ptr_new(void) {
+	HtPUOptions opt = { 0 };
+	return ht_pu_new_opt(&opt);
+}
+
 /**
  * Initialize \p vs as an empty variable set
  *
@@ -50,27 +114,118 @@ RZ_API void rz_il_variable_free(RZ_NULLABLE RzILVar *var) {
 RZ_API bool rz_il_var_set_init(RzILVarSet *vs) {
 	rz_return_val_if_fail(vs, false);
 	memset(vs, 0, sizeof(*vs));
-	vs->vars = ht_sp_new(HT_STR_DUP, NULL, (HtSPFreeValue)rz_il_variable_free);
-	if (!vs->vars) {
+	vs->id = var_set_new_id();
+	rz_vector_init(&vs->entries, sizeof(RzILVarSetEntry), var_set_entry_fini, NULL);
+	vs->slot_of_name = ht_su_new(HT_STR_DUP);
+	if (!vs->slot_of_name) {
 		return false;
 	}
-	vs->contents = ht_sp_new(HT_STR_DUP, NULL, (HtSPFreeValue)rz_il_value_free);
-	if (!vs->contents) {
-		ht_sp_free(vs->vars);
-		vs->vars = NULL;
+	vs->slot_of_ptr = slot_of_ptr_new();
+	if (!vs->slot_of_ptr) {
+		ht_su_free(vs->slot_of_name);
+		vs->slot_of_name = NULL;
 		return false;
 	}
 	return true;
 }
 
 RZ_API void rz_il_var_set_fini(RzILVarSet *vs) {
-	ht_sp_free(vs->vars);
-	ht_sp_free(vs->contents);
+	rz_vector_fini(&vs->entries);
+	ht_su_free(vs->slot_of_name);
+	ht_pu_free(vs->slot_of_ptr);
+	vs->slot_of_name = NULL;
+	vs->slot_of_ptr = NULL;
 }
 
+/**
+ * Remove all variables and their contents from \p vs
+ *
+ * The slots of all names that have been resolved before stay valid,
+ * so resetting is cheap and does not require resolving names again.
+ * Only when the set holds more than VAR_SET_SLOTS_MAX names, all the slots
+ * are dropped and the set gets a new id, which invalidates the cached slots.
+ */
 RZ_API void rz_il_var_set_reset(RzILVarSet *vs) {
-	rz_il_var_set_fini(vs);
-	rz_il_var_set_init(vs);
+	rz_return_if_fail(vs);
+	if (rz_vector_len(&vs->entries) > VAR_SET_SLOTS_MAX) {
+		HtSU *slot_of_name = ht_su_new(HT_STR_DUP);
+		HtPU *slot_of_ptr = slot_of_ptr_new();
+		if (slot_of_name && slot_of_ptr) {
+			rz_vector_clear(&vs->entries);
+			ht_su_free(vs->slot_of_name);
+			ht_pu_free(vs->slot_of_ptr);
+			vs->slot_of_name = slot_of_name;
+			vs->slot_of_ptr = slot_of_ptr;
+			vs->id = var_set_new_id();
+			return;
+		}
+		ht_su_free(slot_of_name);
+		ht_pu_free(slot_of_ptr);
+	}
+	RzILVarSetEntry *entry;
+	rz_vector_foreach (&vs->entries, entry) {
+		rz_il_variable_free(entry->var);
+		entry->var = NULL;
+		rz_il_value_free(entry->val);
+		entry->val = NULL;
+	}
+}
+
+static RzILVarSetEntry *entry_at(RzILVarSet *vs, RzILVarSlot slot) {
+	if (slot >= rz_vector_len(&vs->entries)) {
+		return NULL;
+	}
+	return rz_vector_index_ptr(&vs->entries, slot);
+}
+
+/**
+ * Get the slot of the variable called \p name
+ *
+ * Slots are dense indices into the set, assigned once per name and valid until
+ * rz_il_var_set_reset() drops them (see RzILVarSet.id), independent of whether
+ * a variable of that name currently exists. They can be used with the `_at` functions to access
+ * variables without any name lookups.
+ *
+ * \param create if true, a new slot is assigned if \p name has never been seen before
+ * \return the slot or RZ_IL_VAR_SLOT_INVALID if \p name has no slot and \p create is false
+ */
+RZ_API RzILVarSlot rz_il_var_set_resolve(RzILVarSet *vs, const char *name, bool create) {
+	rz_return_val_if_fail(vs && name, RZ_IL_VAR_SLOT_INVALID);
+	// Names mostly come from the same op trees over and over again,
+	// so first check if this exact string has been resolved before.
+	bool found = false;
+	ut64 slot = vs->slot_of_ptr ? ht_pu_find(vs->slot_of_ptr, name, &found) : 0;
+	if (found) {
+		RzILVarSetEntry *entry = entry_at(vs, slot);
+		if (entry && !strcmp(entry->name, name)) {
+			return slot;
+		}
+	}
+	slot = ht_su_find(vs->slot_of_name, name, &found);
+	if (!found) {
+		if (!create || rz_vector_len(&vs->entries) >= RZ_IL_VAR_SLOT_INVALID) {
+			return RZ_IL_VAR_SLOT_INVALID;
+		}
+		RzILVarSetEntry entry = { 0 };
+		entry.name = rz_str_dup(name);
+		if (!entry.name) {
+			return RZ_IL_VAR_SLOT_INVALID;
+		}
+		slot = rz_vector_len(&vs->entries);
+		if (!rz_vector_push(&vs->entries, &entry)) {
+			free(entry.name);
+			return RZ_IL_VAR_SLOT_INVALID;
+		}
+		ht_su_insert(vs->slot_of_name, name, slot);
+	}
+	if (vs->slot_of_ptr && vs->slot_of_ptr->count >= VAR_SET_PTR_CACHE_MAX) {
+		ht_pu_free(vs->slot_of_ptr);
+		vs->slot_of_ptr = slot_of_ptr_new();
+	}
+	if (vs->slot_of_ptr) {
+		ht_pu_update(vs->slot_of_ptr, name, slot);
+	}
+	return (RzILVarSlot)slot;
 }
 
 /**
@@ -79,15 +234,21 @@ RZ_API void rz_il_var_set_reset(RzILVarSet *vs) {
  */
 RZ_API RZ_BORROW RzILVar *rz_il_var_set_create_var(RzILVarSet *vs, const char *name, RzILSortPure sort) {
 	rz_return_val_if_fail(vs && name, NULL);
-	if (ht_sp_find(vs->vars, name, NULL)) {
-		return NULL;
-	}
-	RzILVar *var = rz_il_variable_new(name, sort);
-	if (!var) {
+	return rz_il_var_set_create_var_at(vs, rz_il_var_set_resolve(vs, name, true), sort);
+}
+
+/**
+ * Create a new variable of the given sort in \p slot, named after the slot.
+ * If a variable already exists in \p slot, nothing happens.
+ */
+RZ_API RZ_BORROW RzILVar *rz_il_var_set_create_var_at(RzILVarSet *vs, RzILVarSlot slot, RzILSortPure sort) {
+	rz_return_val_if_fail(vs, NULL);
+	RzILVarSetEntry *entry = entry_at(vs, slot);
+	if (!entry || entry->var) {
 		return NULL;
 	}
-	ht_sp_insert(vs->vars, name, var);
-	return var;
+	entry->var = rz_il_variable_new(entry->name, sort);
+	return entry->var;
 }
 
 /**
@@ -96,52 +257,85 @@ RZ_API RZ_BORROW RzILVar *rz_il_var_set_create_var(RzILVarSet *vs, const char *n
  */
 RZ_API RZ_OWN RZ_NULLABLE RzILVal *rz_il_var_set_remove_var(RzILVarSet *vs, const char *name) {
 	rz_return_val_if_fail(vs && name, NULL);
-	ht_sp_delete(vs->vars, name);
-	HtSPKv *kv = ht_sp_find_kv(vs->contents, name, NULL);
-	if (!kv) {
+	return rz_il_var_set_remove_var_at(vs, rz_il_var_set_resolve(vs, name, false));
+}
+
+/**
+ * Remove the variable in \p slot, if it exists. The slot itself stays valid.
+ * \return the variable's variable, to be freed by the caller
+ */
+RZ_API RZ_OWN RZ_NULLABLE RzILVal *rz_il_var_set_remove_var_at(RzILVarSet *vs, RzILVarSlot slot) {
+	rz_return_val_if_fail(vs, NULL);
+	RzILVarSetEntry *entry = entry_at(vs, slot);
+	if (!entry) {
 		return NULL;
 	}
-	RzILVal *r = kv->value;
-	kv->value = NULL;
-	ht_sp_delete(vs->contents, name);
+	rz_il_variable_free(entry->var);
+	entry->var = NULL;
+	RzILVal *r = entry->val;
+	entry->val = NULL;
 	return r;
 }
 
 /**
- * Set the contents of the variable called \p name to \p val
+ * Set the contents of the variable in \p slot to \p val
  *
- * In order for this to succeed, a variable called \p name must already exist
+ * In order for this to succeed, a variable must exist in \p slot
  * and the sort of \p val must match the variable's sort. Checking this is done
  * inside this function, so calling it with invalid args in that sense is fine.
  *
  * \return whether the value was successfully bound
  */
-RZ_API bool rz_il_var_set_bind(RzILVarSet *vs, const char *name, RZ_OWN RzILVal *val) {
-	rz_return_val_if_fail(vs && name && val, false);
-	RzILVar *var = ht_sp_find(vs->vars, name, NULL);
+RZ_API bool rz_il_var_set_bind_at(RzILVarSet *vs, RzILVarSlot slot, RZ_OWN RzILVal *val) {
+	rz_return_val_if_fail(vs && val && slot < rz_vector_len(&vs->entries), false);
+	RzILVarSetEntry *entry = entry_at(vs, slot);
+	RzILVar *var = entry->var;
 	if (!var || !rz_il_sort_pure_eq(var->sort, rz_il_value_get_sort(val))) {
 		if (!var) {
-			RZ_LOG_ERROR("Attempted to bind value to non-existent variable \"%s\"\n", name);
+			RZ_LOG_ERROR("Attempted to bind value to non-existent variable \"%s\"\n", entry->name);
 		} else {
-			RZ_LOG_ERROR("Attempted to bind mis-sorted value to variable \"%s\"\n", name);
+			RZ_LOG_ERROR("Attempted to bind mis-sorted value to variable \"%s\"\n", var->name);
 		}
 		rz_il_value_free(val);
 		return false;
 	}
-	ht_sp_update(vs->contents, name, val);
+	rz_il_value_free(entry->val);
+	entry->val = val;
 	return true;
 }
 
 /**
- * Get the definition of the variable called \p name
+ * Set the contents of the variable called \p name to \p val
+ *
+ * \see rz_il_var_set_bind_at
+ * \return whether the value was successfully bound
  */
-RZ_API RZ_BORROW RzILVar *rz_il_var_set_get(RzILVarSet *vs, const char *name) {
-	return ht_sp_find(vs->vars, name, NULL);
+RZ_API bool rz_il_var_set_bind(RzILVarSet *vs, const char *name, RZ_OWN RzILVal *val) {
+	rz_return_val_if_fail(vs && name && val, false);
+	RzILVarSlot slot = rz_il_var_set_resolve(vs, name, false);
+	if (slot == RZ_IL_VAR_SLOT_INVALID) {
+		RZ_LOG_ERROR("Attempted to bind value to non-existent variable \"%s\"\n", name);
+		rz_il_value_free(val);
+		return false;
+	}
+	return rz_il_var_set_bind_at(vs, slot, val);
 }
 
-static bool vars_collect_cb(void *user, RZ_UNUSED const char *k, const void *v) {
-	rz_pvector_push(user, (void *)v);
-	return true;
+/**
+ * Get the definition of the variable in \p slot
+ */
+RZ_API RZ_BORROW RzILVar *rz_il_var_set_get_at(RzILVarSet *vs, RzILVarSlot slot) {
+	rz_return_val_if_fail(vs, NULL);
+	RzILVarSetEntry *entry = entry_at(vs, slot);
+	return entry ? entry->var : NULL;
+}
+
+/**
+ * Get the definition of the variable called \p name
+ */
+RZ_API RZ_BORROW RzILVar *rz_il_var_set_get(RzILVarSet *vs, const char *name) {
+	rz_return_val_if_fail(vs && name, NULL);
+	return rz_il_var_set_get_at(vs, rz_il_var_set_resolve(vs, name, false));
 }
 
 /**
@@ -153,16 +347,30 @@ RZ_API RZ_OWN RzPVector /*<RzILVar *>*/ *rz_il_var_set_get_all(RzILVarSet *vs) {
 	if (!r) {
 		return NULL;
 	}
-	ht_sp_foreach(vs->vars, vars_collect_cb, r);
+	RzILVarSetEntry *entry;
+	rz_vector_foreach (&vs->entries, entry) {
+		if (entry->var) {
+			rz_pvector_push(r, entry->var);
+		}
+	}
 	return r;
 }
 
+/**
+ * Get the current value of the variable in \p slot
+ */
+RZ_API RZ_BORROW RzILVal *rz_il_var_set_get_value_at(RzILVarSet *vs, RzILVarSlot slot) {
+	rz_return_val_if_fail(vs, NULL);
+	RzILVarSetEntry *entry = entry_at(vs, slot);
+	return entry ? entry->val : NULL;
+}
+
 /**
  * Get the current value of the variable called \p name
  */
 RZ_API RZ_BORROW RzILVal *rz_il_var_set_get_value(RzILVarSet *vs, const char *name) {
 	rz_return_val_if_fail(vs && name, NULL);
-	return ht_sp_find(vs->contents, name, NULL);
+	return rz_il_var_set_get_value_at(vs, rz_il_var_set_resolve(vs, name, false));
 }
 
 /**
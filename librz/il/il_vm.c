@@ -22,6 +22,9 @@ extern RZ_IPI RzILOpEffectHandler rz_il_op_handler_effect_table_default[RZ_IL_OP
 RZ_API bool rz_il_vm_init(RzILVM *vm, ut64 start_addr, ut32 addr_size, bool big_endian) {
 	rz_return_val_if_fail(vm, false);
 
+	rz_pvector_init(&vm->pool.bvs, (RzPVectorFree)rz_bv_free);
+	rz_pvector_init(&vm->pool.bools, (RzPVectorFree)rz_il_bool_free);
+	vm->pool.allocs = 0;
 	if (!rz_il_var_set_init(&vm->global_vars)) {
 		rz_il_vm_fini(vm);
 		return false;
@@ -94,6 +97,9 @@ RZ_API void rz_il_vm_fini(RzILVM *vm) {
 
 	rz_pvector_free(vm->events);
 	vm->events = NULL;
+
+	rz_pvector_fini(&vm->pool.bvs);
+	rz_pvector_fini(&vm->pool.bools);
 }
 
 /**
@@ -166,7 +172,7 @@ RZ_API RZ_BORROW RzILVar *rz_il_vm_create_global_var(RZ_NONNULL RzILVM *vm, RZ_N
 	if (!val) {
 		return NULL;
 	}
-	rz_il_var_set_bind(&vm->global_vars, name, val);
+	rz_il_var_set_bind_at(&vm->global_vars, rz_il_var_set_resolve(&vm->global_vars, name, false), val);
 	return var;
 }
 
@@ -185,8 +191,19 @@ RZ_API void rz_il_vm_set_global_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char
  */
 RZ_API void rz_il_vm_set_local_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char *name, RZ_OWN RzILVal *val) {
 	rz_return_if_fail(vm && name && val);
-	rz_il_var_set_create_var(&vm->local_vars, name, rz_il_value_get_sort(val));
-	rz_il_var_set_bind(&vm->local_vars, name, val);
+	rz_il_vm_set_local_var_at(vm, rz_il_var_set_resolve(&vm->local_vars, name, true), val);
+}
+
+/**
+ * Same as rz_il_vm_set_local_var(), but for the local variable in \p slot of `vm->local_vars`
+ */
+RZ_API void rz_il_vm_set_local_var_at(RZ_NONNULL RzILVM *vm, RzILVarSlot slot, RZ_OWN RzILVal *val) {
+	rz_return_if_fail(vm && val);
+	RzILVarSet *vs = &vm->local_vars;
+	if (!rz_il_var_set_get_at(vs, slot)) {
+		rz_il_var_set_create_var_at(vs, slot, rz_il_value_get_sort(val));
+	}
+	rz_il_var_set_bind_at(vs, slot, val);
 }
 
 /**
@@ -198,9 +215,18 @@ RZ_API void rz_il_vm_set_local_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char
  */
 RZ_API RzILLocalPurePrev rz_il_vm_push_local_pure_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char *name, RzILVal *val) {
 	rz_return_val_if_fail(vm && name && val, NULL);
-	RzILVal *r = rz_il_var_set_remove_var(&vm->local_pure_vars, name);
-	rz_il_var_set_create_var(&vm->local_pure_vars, name, rz_il_value_get_sort(val));
-	rz_il_var_set_bind(&vm->local_pure_vars, name, val);
+	return rz_il_vm_push_local_pure_var_at(vm, rz_il_var_set_resolve(&vm->local_pure_vars, name, true), val);
+}
+
+/**
+ * Same as rz_il_vm_push_local_pure_var(), but for the let binding in \p slot of `vm->local_pure_vars`
+ */
+RZ_API RzILLocalPurePrev rz_il_vm_push_local_pure_var_at(RZ_NONNULL RzILVM *vm, RzILVarSlot slot, RzILVal *val) {
+	rz_return_val_if_fail(vm && val, NULL);
+	RzILVarSet *vs = &vm->local_pure_vars;
+	RzILVal *r = rz_il_var_set_remove_var_at(vs, slot);
+	rz_il_var_set_create_var_at(vs, slot, rz_il_value_get_sort(val));
+	rz_il_var_set_bind_at(vs, slot, val);
 	return r;
 }
 
@@ -210,12 +236,22 @@ RZ_API RzILLocalPurePrev rz_il_vm_push_local_pure_var(RZ_NONNULL RzILVM *vm, RZ_
  */
 RZ_API void rz_il_vm_pop_local_pure_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char *name, RzILLocalPurePrev prev) {
 	rz_return_if_fail(vm && name);
-	RzILVal *r = rz_il_var_set_remove_var(&vm->local_pure_vars, name);
+	rz_il_vm_pop_local_pure_var_at(vm, rz_il_var_set_resolve(&vm->local_pure_vars, name, false), prev);
+}
+
+/**
+ * Same as rz_il_vm_pop_local_pure_var(), but for the let binding in \p slot of `vm->local_pure_vars`
+ * \param prev pass here the return value of rz_il_vm_push_local_pure_var_at()
+ */
+RZ_API void rz_il_vm_pop_local_pure_var_at(RZ_NONNULL RzILVM *vm, RzILVarSlot slot, RzILLocalPurePrev prev) {
+	rz_return_if_fail(vm);
+	RzILVarSet *vs = &vm->local_pure_vars;
+	RzILVal *r = rz_il_var_set_remove_var_at(vs, slot);
 	rz_warn_if_fail(r); // the var should always be bound when calling this function
 	rz_il_value_free(r);
 	if (prev) {
-		rz_il_var_set_create_var(&vm->local_pure_vars, name, rz_il_value_get_sort(prev));
-		rz_il_var_set_bind(&vm->local_pure_vars, name, prev);
+		rz_il_var_set_create_var_at(vs, slot, rz_il_value_get_sort(prev));
+		rz_il_var_set_bind_at(vs, slot, prev);
 	}
 }
 
@@ -232,6 +268,14 @@ static RzILVarSet *var_set_of_kind(RzILVM *vm, RzILVarKind kind) {
 	return NULL;
 }
 
+/**
+ * Get the set holding the variables of the given \p kind, e.g. to access them by their slots
+ */
+RZ_API RZ_BORROW RzILVarSet *rz_il_vm_get_var_set(RZ_NONNULL RzILVM *vm, RzILVarKind kind) {
+	rz_return_val_if_fail(vm, NULL);
+	return var_set_of_kind(vm, kind);
+}
+
 RZ_API RZ_BORROW RzILVar *rz_il_vm_get_var(RZ_NONNULL RzILVM *vm, RzILVarKind kind, const char *name) {
 	rz_return_val_if_fail(vm && name, NULL);
 	return rz_il_var_set_get(var_set_of_kind(vm, kind), name);
@@ -326,3 +370,78 @@ RZ_API RZ_BORROW RzILEffectLabel *rz_il_vm_update_label(RZ_NONNULL RzILVM *vm, R
 	lbl->addr = rz_bv_dup(addr);
 	return lbl;
 }
+
+/**
+ * Maximum number of unused temporaries of each kind kept in the pool of a VM
+ */
+#define IL_VM_POOL_MAX 0x100
+
+/**
+ * Create a new zero-initialized bitvector for a temporary value during evaluation.
+ * Bitvectors of at most 64 bits are taken from the pool of \p vm if possible.
+ * The result may be freed with both rz_il_vm_bv_free() and rz_bv_free().
+ */
+RZ_API RZ_OWN RzBitVector *rz_il_vm_bv_new(RZ_NONNULL RzILVM *vm, ut32 length) {
+	rz_return_val_if_fail(vm && length, NULL);
+	if (length > 64 || rz_pvector_empty(&vm->pool.bvs)) {
+		vm->pool.allocs++;
+		return rz_bv_new(length);
+	}
+	RzBitVector *bv = rz_pvector_pop(&vm->pool.bvs);
+	rz_bv_init(bv, length);
+	return bv;
+}
+
+/**
+ * Duplicate \p bv into a temporary value, see rz_il_vm_bv_new()
+ */
+RZ_API RZ_OWN RzBitVector *rz_il_vm_bv_dup(RZ_NONNULL RzILVM *vm, RZ_NONNULL const RzBitVector *bv) {
+	rz_return_val_if_fail(vm && bv, NULL);
+	RzBitVector *r = rz_il_vm_bv_new(vm, bv->len);
+	if (r) {
+		rz_bv_copy(bv, r);
+	}
+	return r;
+}
+
+/**
+ * Free a bitvector that is no longer needed, keeping it in the pool of \p vm for reuse.
+ * \p bv does not need to come from rz_il_vm_bv_new().
+ */
+RZ_API void rz_il_vm_bv_free(RZ_NONNULL RzILVM *vm, RZ_NULLABLE RZ_OWN RzBitVector *bv) {
+	rz_return_if_fail(vm);
+	if (!bv) {
+		return;
+	}
+	if (bv->len > 64 || rz_pvector_len(&vm->pool.bvs) >= IL_VM_POOL_MAX || !rz_pvector_push(&vm->pool.bvs, bv)) {
+		rz_bv_free(bv);
+	}
+}
+
+/**
+ * Create a new bool for a temporary value during evaluation, taken from the pool of \p vm if possible.
+ * The result may be freed with both rz_il_vm_bool_free() and rz_il_bool_free().
+ */
+RZ_API RZ_OWN RzILBool *rz_il_vm_bool_new(RZ_NONNULL RzILVM *vm, bool b) {
+	rz_return_val_if_fail(vm, NULL);
+	if (rz_pvector_empty(&vm->pool.bools)) {
+		vm->pool.allocs++;
+		return rz_il_bool_new(b);
+	}
+	RzILBool *r = rz_pvector_pop(&vm->pool.bools);
+	r->b = b;
+	return r;
+}
+
+/**
+ * Free a bool that is no longer needed, keeping it in the pool of \p vm for reuse.
+ */
+RZ_API void rz_il_vm_bool_free(RZ_NONNULL RzILVM *vm, RZ_NULLABLE RZ_OWN RzILBool *b) {
+	rz_return_if_fail(vm);
+	if (!b) {
+		return;
+	}
+	if (rz_pvector_len(&vm->pool.bools) >= IL_VM_POOL_MAX || !rz_pvector_push(&vm->pool.bools, b)) {
+		rz_il_bool_free(b);
+	}
+}
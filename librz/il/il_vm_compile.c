@@ -0,0 +1,1256 @@
+// SPDX-FileCopyrightText: 2024 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/**
+ * \file
+ * RzIL Virtual Machine Evaluation of pre-compiled effects
+ *
+ * rz_il_compile_effect() flattens an effect tree into an array of instructions
+ * in evaluation order. Every instruction carries the function that executes it
+ * and the indices of its operands in a register file of ut64 values, so running
+ * it requires neither the recursive walk through the tree, nor the allocation
+ * of any intermediate bitvectors.
+ *
+ * Only bitvectors of up to 64 bits and bools are held in registers. Effects
+ * which can not be expressed this way (wider bitvectors, floats, goto, ...)
+ * are kept as they are and handed to the regular evaluator when reached, so
+ * the result of evaluating a compiled effect, including the events it emits,
+ * is always the same as evaluating the original effect.
+ */
+
+#include <rz_il/rz_il_vm.h>
+
+extern RZ_IPI RzILOpPureHandler rz_il_op_handler_pure_table_default[RZ_IL_OP_PURE_MAX];
+extern RZ_IPI RzILOpEffectHandler rz_il_op_handler_effect_table_default[RZ_IL_OP_EFFECT_MAX];
+
+/**
+ * Number of registers that are allocated on the stack during evaluation,
+ * only effects using more than that need a heap-allocated register file.
+ */
+#define COMPILED_STACK_REGS 64
+
+typedef struct compiled_insn_t CompiledInsn;
+typedef struct compiled_exec_t CompiledExec;
+
+/**
+ * \brief Execution callback for a single compiled instruction
+ * \return false if an error occured and the execution should be aborted
+ */
+typedef bool (*CompiledInsnHandler)(CompiledExec *ex, CompiledInsn *insn);
+
+struct compiled_insn_t {
+	CompiledInsnHandler handler;
+	ut32 dst; ///< register receiving the result
+	ut32 src[3]; ///< operand registers
+	ut32 width; ///< bit width of the result, or of the operands for comparisons and effects
+	ut64 mask; ///< all ones in the lowest `width` bits
+	union {
+		ut64 imm; ///< constant value, or the width of the second operand for cast and append
+		ut32 target; ///< index of the instruction to continue at for jumps
+		struct {
+			const char *name; ///< name of the variable, borrowed from the op
+			RzILSortPure sort; ///< sort of the variable at compile time
+			RzILVarSlotCache slot; ///< slot of the variable in the set it was last resolved in
+		} var;
+		struct {
+			RzILMemIndex index;
+			ut32 key_width;
+		} mem;
+		const char *label; ///< borrowed from the op
+		RzILOpEffect *effect; ///< effect to evaluate with the regular evaluator, borrowed
+	} u;
+};
+
+struct compiled_exec_t {
+	RzILVM *vm;
+	ut64 *regs;
+	ut32 ip; ///< index of the next instruction to execute
+};
+
+/**
+ * \brief An effect in compiled form, see rz_il_compile_effect()
+ */
+struct rz_il_compiled_effect_t {
+	CompiledInsn *insns;
+	ut32 insns_count;
+	ut32 regs_count;
+	RzILOpEffect *op; ///< the effect that was compiled, borrowed
+	ut8 pure_codes[RZ_IL_OP_PURE_MAX]; ///< codes of the pure ops turned into instructions
+	ut8 pure_codes_count;
+	ut8 effect_codes[RZ_IL_OP_EFFECT_MAX]; ///< codes of the effect ops turned into instructions
+	ut8 effect_codes_count;
+};
+
+static inline ut64 width_mask(ut32 width) {
+	return width >= 64 ? UT64_MAX : (1ULL << width) - 1;
+}
+
+static inline ut32 sort_width(RzILSortPure sort) {
+	return sort.type == RZ_IL_TYPE_PURE_BOOL ? 1 : sort.props.bv.length;
+}
+
+static inline bool msb(ut64 v, ut32 width) {
+	return (v >> (width - 1)) & 1;
+}
+
+/////////////////////////////////////////////////////////
+// Instructions
+
+/**
+ * Get the slot of the variable referenced by \p insn, updating the cached one if necessary.
+ * Compiled effects may be evaluated in other vms than the one they were compiled for.
+ */
+static RzILVarSlot var_slot(RzILVarSet *vs, CompiledInsn *insn, bool create) {
+	return rz_il_var_set_resolve_cached(vs, insn->u.var.name, &insn->u.var.slot, create);
+}
+
+/**
+ * Initialize \p val as a non-owning value backed by \p bv and \p b to pass the contents of a register to events
+ */
+static void stack_value_init(RzILVal *val, RzBitVector *bv, RzILBool *b, const CompiledInsn *insn, ut64 v) {
+	val->type = insn->u.var.sort.type;
+	if (val->type == RZ_IL_TYPE_PURE_BOOL) {
+		b->b = v;
+		val->data.b = b;
+	} else {
+		rz_bv_init(bv, insn->width);
+		rz_bv_set_from_ut64(bv, v);
+		val->data.bv = bv;
+	}
+}
+
+static RzILVal *value_new(const CompiledInsn *insn, ut64 v) {
+	if (insn->u.var.sort.type == RZ_IL_TYPE_PURE_BOOL) {
+		RzILBool *b = rz_il_bool_new(v);
+		return b ? rz_il_value_new_bool(b) : NULL;
+	}
+	RzBitVector *bv = rz_bv_new_from_ut64(insn->width, v);
+	return bv ? rz_il_value_new_bitv(bv) : NULL;
+}
+
+static void value_assign(RzILVal *val, ut64 v) {
+	if (val->type == RZ_IL_TYPE_PURE_BOOL) {
+		val->data.b->b = v;
+	} else {
+		rz_bv_set_from_ut64(val->data.bv, v);
+	}
+}
+
+static bool var_read(CompiledExec *ex, CompiledInsn *insn, RzILVarKind kind) {
+	RzILVarSet *vs = kind == RZ_IL_VAR_KIND_GLOBAL ? &ex->vm->global_vars : &ex->vm->local_vars;
+	RzILVal *val = rz_il_var_set_get_value_at(vs, var_slot(vs, insn, false));
+	if (!val) {
+		RZ_LOG_ERROR("RzIL: reading value of variable \"%s\" of kind %s failed.\n",
+			insn->u.var.name, rz_il_var_kind_name(kind));
+		return false;
+	}
+	if (kind == RZ_IL_VAR_KIND_GLOBAL) {
+		rz_il_vm_event_add(ex->vm, rz_il_event_var_read_new(insn->u.var.name, val));
+	}
+	if (!rz_il_sort_pure_eq(rz_il_value_get_sort(val), insn->u.var.sort)) {
+		RZ_LOG_ERROR("RzIL: variable \"%s\" of kind %s changed its sort since compilation.\n",
+			insn->u.var.name, rz_il_var_kind_name(kind));
+		return false;
+	}
+	ex->regs[insn->dst] = val->type == RZ_IL_TYPE_PURE_BOOL ? val->data.b->b : rz_bv_to_ut64(val->data.bv);
+	return true;
+}
+
+static bool insn_var_global(CompiledExec *ex, CompiledInsn *insn) {
+	return var_read(ex, insn, RZ_IL_VAR_KIND_GLOBAL);
+}
+
+static bool insn_var_local(CompiledExec *ex, CompiledInsn *insn) {
+	return var_read(ex, insn, RZ_IL_VAR_KIND_LOCAL);
+}
+
+static bool insn_const(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = insn->u.imm;
+	return true;
+}
+
+static bool insn_mov(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = ex->regs[insn->src[0]];
+	return true;
+}
+
+static bool insn_jump(CompiledExec *ex, CompiledInsn *insn) {
+	ex->ip = insn->u.target;
+	return true;
+}
+
+static bool insn_branch_false(CompiledExec *ex, CompiledInsn *insn) {
+	if (!ex->regs[insn->src[0]]) {
+		ex->ip = insn->u.target;
+	}
+	return true;
+}
+
+static bool insn_bool_inv(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = !ex->regs[insn->src[0]];
+	return true;
+}
+
+static bool insn_and(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = ex->regs[insn->src[0]] & ex->regs[insn->src[1]];
+	return true;
+}
+
+static bool insn_or(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = ex->regs[insn->src[0]] | ex->regs[insn->src[1]];
+	return true;
+}
+
+static bool insn_xor(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = ex->regs[insn->src[0]] ^ ex->regs[insn->src[1]];
+	return true;
+}
+
+static bool insn_msb(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = msb(ex->regs[insn->src[0]], insn->width);
+	return true;
+}
+
+static bool insn_lsb(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = ex->regs[insn->src[0]] & 1;
+	return true;
+}
+
+static bool insn_is_zero(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = !ex->regs[insn->src[0]];
+	return true;
+}
+
+static bool insn_neg(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = (0 - ex->regs[insn->src[0]]) & insn->mask;
+	return true;
+}
+
+static bool insn_lognot(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = ~ex->regs[insn->src[0]] & insn->mask;
+	return true;
+}
+
+static bool insn_add(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = (ex->regs[insn->src[0]] + ex->regs[insn->src[1]]) & insn->mask;
+	return true;
+}
+
+static bool insn_sub(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = (ex->regs[insn->src[0]] - ex->regs[insn->src[1]]) & insn->mask;
+	return true;
+}
+
+static bool insn_mul(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = (ex->regs[insn->src[0]] * ex->regs[insn->src[1]]) & insn->mask;
+	return true;
+}
+
+/* unsigned division and modulo with the semantics of rz_bv_div() and rz_bv_mod() for a zero divisor */
+static inline ut64 udiv(ut64 x, ut64 y, ut64 mask) {
+	return y ? x / y : mask;
+}
+
+static inline ut64 umod(ut64 x, ut64 y) {
+	return y ? x % y : x;
+}
+
+static bool insn_div(CompiledExec *ex, CompiledInsn *insn) {
+	ut64 y = ex->regs[insn->src[1]];
+	ex->regs[insn->dst] = udiv(ex->regs[insn->src[0]], y, insn->mask);
+	if (!y) {
+		rz_il_vm_event_add(ex->vm, rz_il_event_exception_new("division by zero"));
+	}
+	return true;
+}
+
+static bool insn_mod(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = umod(ex->regs[insn->src[0]], ex->regs[insn->src[1]]);
+	return true;
+}
+
+static bool insn_sdiv(CompiledExec *ex, CompiledInsn *insn) {
+	ut64 x = ex->regs[insn->src[0]];
+	ut64 y = ex->regs[insn->src[1]];
+	ut64 mask = insn->mask;
+	bool mx = msb(x, insn->width);
+	bool my = msb(y, insn->width);
+	ut64 r;
+	if (!mx && !my) {
+		r = udiv(x, y, mask);
+	} else if (mx && !my) {
+		r = 0 - udiv((0 - x) & mask, y, mask);
+	} else if (!mx && my) {
+		r = 0 - udiv(x, (0 - y) & mask, mask);
+	} else {
+		r = udiv((0 - x) & mask, (0 - y) & mask, mask);
+	}
+	ex->regs[insn->dst] = r & mask;
+	return true;
+}
+
+static bool insn_smod(CompiledExec *ex, CompiledInsn *insn) {
+	ut64 x = ex->regs[insn->src[0]];
+	ut64 y = ex->regs[insn->src[1]];
+	ut64 mask = insn->mask;
+	bool mx = msb(x, insn->width);
+	bool my = msb(y, insn->width);
+	ut64 r;
+	if (!mx && !my) {
+		r = umod(x, y);
+	} else if (mx && !my) {
+		r = 0 - umod((0 - x) & mask, y);
+	} else if (!mx && my) {
+		r = 0 - umod(x, (0 - y) & mask);
+	} else {
+		r = 0 - umod((0 - x) & mask, (0 - y) & mask);
+	}
+	ex->regs[insn->dst] = r & mask;
+	return true;
+}
+
+static bool insn_shiftl(CompiledExec *ex, CompiledInsn *insn) {
+	ut64 x = ex->regs[insn->src[0]];
+	ut32 shift = ex->regs[insn->src[1]] & UT32_MAX;
+	bool fill = ex->regs[insn->src[2]];
+	if (shift >= insn->width) {
+		x = fill ? insn->mask : 0;
+	} else if (shift) {
+		x = ((x << shift) | (fill ? width_mask(shift) : 0)) & insn->mask;
+	}
+	ex->regs[insn->dst] = x;
+	return true;
+}
+
+static bool insn_shiftr(CompiledExec *ex, CompiledInsn *insn) {
+	ut64 x = ex->regs[insn->src[0]];
+	ut32 shift = ex->regs[insn->src[1]] & UT32_MAX;
+	bool fill = ex->regs[insn->src[2]];
+	if (shift >= insn->width) {
+		x = fill ? insn->mask : 0;
+	} else if (shift) {
+		x = (x >> shift) | (fill ? insn->mask & ~(insn->mask >> shift) : 0);
+	}
+	ex->regs[insn->dst] = x;
+	return true;
+}
+
+static bool insn_eq(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = ex->regs[insn->src[0]] == ex->regs[insn->src[1]];
+	return true;
+}
+
+static bool insn_ule(CompiledExec *ex, CompiledInsn *insn) {
+	ex->regs[insn->dst] = ex->regs[insn->src[0]] <= ex->regs[insn->src[1]];
+	return true;
+}
+
+static bool insn_sle(CompiledExec *ex, CompiledInsn *insn) {
+	ut64 x = ex->regs[insn->src[0]];
+	ut64 y = ex->regs[insn->src[1]];
+	bool mx = msb(x, insn->width);
+	bool my = msb(y, insn->width);
+	ex->regs[insn->dst] = mx == my ? x <= y : mx;
+	return true;
+}
+
+static bool insn_cast(CompiledExec *ex, CompiledInsn *insn) {
+	bool fill = ex->regs[insn->src[0]];
+	ut64 copied = width_mask(RZ_MIN(insn->width, (ut32)insn->u.imm));
+	ex->regs[insn->dst] = (ex->regs[insn->src[1]] & copied) | (fill ? insn->mask & ~copied : 0);
+	return true;
+}
+
+static bool insn_append(CompiledExec *ex, CompiledInsn *insn) {
+	// the high part is non-empty, so the low part is always narrower than 64 bits here
+	ex->regs[insn->dst] = (ex->regs[insn->src[0]] << insn->u.imm) | ex->regs[insn->src[1]];
+	return true;
+}
+
+static bool bv_init_from_reg(RzBitVector *bv, ut32 width, ut64 v) {
+	return rz_bv_init(bv, width) && rz_bv_set_from_ut64(bv, v);
+}
+
+static bool load_result(CompiledExec *ex, CompiledInsn *insn, RZ_OWN RzBitVector *val) {
+	if (!val) {
+		return false;
+	}
+	bool ret = rz_bv_len(val) == insn->width;
+	if (ret) {
+		ex->regs[insn->dst] = rz_bv_to_ut64(val);
+	} else {
+		RZ_LOG_ERROR("RzIL: mem %u changed its value size since compilation.\n", (unsigned int)insn->u.mem.index);
+	}
+	rz_bv_free(val);
+	return ret;
+}
+
+static bool insn_load(CompiledExec *ex, CompiledInsn *insn) {
+	RzBitVector key;
+	if (!bv_init_from_reg(&key, insn->u.mem.key_width, ex->regs[insn->src[0]])) {
+		return false;
+	}
+	return load_result(ex, insn, rz_il_vm_mem_load(ex->vm, insn->u.mem.index, &key));
+}
+
+static bool insn_loadw(CompiledExec *ex, CompiledInsn *insn) {
+	RzBitVector key;
+	if (!bv_init_from_reg(&key, insn->u.mem.key_width, ex->regs[insn->src[0]])) {
+		return false;
+	}
+	return load_result(ex, insn, rz_il_vm_mem_loadw(ex->vm, insn->u.mem.index, &key, insn->width));
+}
+
+static bool insn_store(CompiledExec *ex, CompiledInsn *insn) {
+	RzBitVector key, value;
+	if (!bv_init_from_reg(&key, insn->u.mem.key_width, ex->regs[insn->src[0]]) ||
+		!bv_init_from_reg(&value, insn->width, ex->regs[insn->src[1]])) {
+		return false;
+	}
+	rz_il_vm_mem_store(ex->vm, insn->u.mem.index, &key, &value);
+	return true;
+}
+
+static bool insn_storew(CompiledExec *ex, CompiledInsn *insn) {
+	RzBitVector key, value;
+	if (!bv_init_from_reg(&key, insn->u.mem.key_width, ex->regs[insn->src[0]]) ||
+		!bv_init_from_reg(&value, insn->width, ex->regs[insn->src[1]])) {
+		return false;
+	}
+	rz_il_vm_mem_storew(ex->vm, insn->u.mem.index, &key, &value);
+	return true;
+}
+
+static bool insn_set_global(CompiledExec *ex, CompiledInsn *insn) {
+	RzILVM *vm = ex->vm;
+	RzILVarSet *vs = &vm->global_vars;
+	RzILVarSlot slot = var_slot(vs, insn, false);
+	RzILVar *var = rz_il_var_set_get_at(vs, slot);
+	RzILVal *old_val = rz_il_var_set_get_value_at(vs, slot);
+	ut64 v = ex->regs[insn->src[0]];
+	if (var && old_val && rz_il_sort_pure_eq(rz_il_value_get_sort(old_val), insn->u.var.sort)) {
+		// overwrite the old value in-place, the event holds copies of both values
+		RzBitVector bv;
+		RzILBool b;
+		RzILVal val;
+		stack_value_init(&val, &bv, &b, insn, v);
+		rz_il_vm_event_add(vm, rz_il_event_var_write_new(var->name, old_val, &val));
+		value_assign(old_val, v);
+		return true;
+	}
+	RzILVal *val = value_new(insn, v);
+	if (!val) {
+		return false;
+	}
+	if (!var) {
+		// reports the error
+		rz_il_vm_set_global_var(vm, insn->u.var.name, val);
+		return true;
+	}
+	if (old_val) {
+		rz_il_vm_event_add(vm, rz_il_event_var_write_new(var->name, old_val, val));
+	}
+	rz_il_var_set_bind_at(vs, slot, val);
+	return true;
+}
+
+static bool insn_set_local(CompiledExec *ex, CompiledInsn *insn) {
+	RzILVarSet *vs = &ex->vm->local_vars;
+	RzILVarSlot slot = var_slot(vs, insn, true);
+	RzILVal *old_val = rz_il_var_set_get_value_at(vs, slot);
+	ut64 v = ex->regs[insn->src[0]];
+	if (old_val && rz_il_sort_pure_eq(rz_il_value_get_sort(old_val), insn->u.var.sort)) {
+		value_assign(old_val, v);
+		return true;
+	}
+	RzILVal *val = value_new(insn, v);
+	if (!val) {
+		return false;
+	}
+	rz_il_vm_set_local_var(ex->vm, insn->u.var.name, val);
+	return true;
+}
+
+static bool insn_jmp(CompiledExec *ex, CompiledInsn *insn) {
+	RzILVM *vm = ex->vm;
+	ut64 v = ex->regs[insn->src[0]];
+	if (rz_bv_len(vm->pc) == insn->width) {
+		RzBitVector dst;
+		bv_init_from_reg(&dst, insn->width, v);
+		rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, &dst));
+		rz_bv_set_from_ut64(vm->pc, v);
+		return true;
+	}
+	RzBitVector *dst = rz_bv_new_from_ut64(insn->width, v);
+	if (!dst) {
+		return false;
+	}
+	rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, dst));
+	rz_bv_free(vm->pc);
+	vm->pc = dst;
+	return true;
+}
+
+static bool insn_label(CompiledExec *ex, CompiledInsn *insn) {
+	rz_il_vm_create_label(ex->vm, insn->u.label, ex->vm->pc);
+	return true;
+}
+
+static bool insn_effect(CompiledExec *ex, CompiledInsn *insn) {
+	return rz_il_evaluate_effect(ex->vm, insn->u.effect);
+}
+
+/////////////////////////////////////////////////////////
+// Compilation
+
+typedef struct {
+	const char *name;
+	ut32 reg;
+	RzILSortPure sort;
+} LetBinding;
+
+typedef struct {
+	RzILVM *vm;
+	RzVector /*<CompiledInsn>*/ insns;
+	ut32 regs_count;
+	RzVector /*<LetBinding>*/ lets; ///< let bindings in scope, innermost last
+	HtSU /*<char *, ut64>*/ *local_sorts; ///< known sorts of local vars, 0 for bool, else the bitvector length
+	bool pure_compiled[RZ_IL_OP_PURE_MAX]; ///< pure ops that instructions were emitted for, by code
+	bool effect_compiled[RZ_IL_OP_EFFECT_MAX]; ///< effect ops that instructions were emitted for, by code
+	bool oom;
+} Compiler;
+
+static CompiledInsn *emit(Compiler *c, CompiledInsnHandler handler) {
+	CompiledInsn *insn = rz_vector_push(&c->insns, NULL);
+	if (!insn) {
+		c->oom = true;
+		return NULL;
+	}
+	memset(insn, 0, sizeof(*insn));
+	insn->handler = handler;
+	return insn;
+}
+
+/**
+ * Emit an instruction producing a value of \p width bits into a new register
+ */
+static CompiledInsn *emit_value(Compiler *c, CompiledInsnHandler handler, ut32 width, ut32 *reg) {
+	CompiledInsn *insn = emit(c, handler);
+	if (!insn) {
+		return NULL;
+	}
+	insn->dst = *reg = c->regs_count++;
+	insn->width = width;
+	insn->mask = width_mask(width);
+	return insn;
+}
+
+static CompiledInsn *insn_at(Compiler *c, size_t index) {
+	return rz_vector_index_ptr(&c->insns, index);
+}
+
+static bool width_supported(ut32 width) {
+	return width && width <= 64;
+}
+
+static bool sort_supported(RzILSortPure sort) {
+	return sort.type == RZ_IL_TYPE_PURE_BOOL ||
+		(sort.type == RZ_IL_TYPE_PURE_BITVECTOR && width_supported(sort.props.bv.length));
+}
+
+static ut64 local_sort_encode(RzILSortPure sort) {
+	return sort.type == RZ_IL_TYPE_PURE_BOOL ? 0 : sort.props.bv.length;
+}
+
+static RzILSortPure local_sort_decode(ut64 v) {
+	return v ? rz_il_sort_pure_bv(v) : rz_il_sort_pure_bool();
+}
+
+static bool compile_pure(Compiler *c, RzILOpPure *op, ut32 *reg, RzILSortPure *sort);
+
+static bool compile_bv(Compiler *c, RzILOpPure *op, ut32 *reg, ut32 *width) {
+	RzILSortPure sort;
+	if (!compile_pure(c, op, reg, &sort) || sort.type != RZ_IL_TYPE_PURE_BITVECTOR) {
+		return false;
+	}
+	*width = sort.props.bv.length;
+	return true;
+}
+
+static bool compile_bool(Compiler *c, RzILOpPure *op, ut32 *reg) {
+	RzILSortPure sort;
+	return compile_pure(c, op, reg, &sort) && sort.type == RZ_IL_TYPE_PURE_BOOL;
+}
+
+static bool compile_var(Compiler *c, RzILOpArgsVar *args, ut32 *reg, RzILSortPure *sort) {
+	switch (args->kind) {
+	case RZ_IL_VAR_KIND_LOCAL_PURE: {
+		// let-bound vars are only registers, resolved statically
+		for (size_t i = rz_vector_len(&c->lets); i; i--) {
+			LetBinding *b = rz_vector_index_ptr(&c->lets, i - 1);
+			if (!strcmp(b->name, args->v)) {
+				*reg = b->reg;
+				*sort = b->sort;
+				return true;
+			}
+		}
+		return false;
+	}
+	case RZ_IL_VAR_KIND_GLOBAL: {
+		RzILVarSlot slot = rz_il_var_set_resolve(&c->vm->global_vars, args->v, false);
+		RzILVar *var = rz_il_var_set_get_at(&c->vm->global_vars, slot);
+		if (!var || !sort_supported(var->sort)) {
+			return false;
+		}
+		*sort = var->sort;
+		CompiledInsn *insn = emit_value(c, insn_var_global, sort_width(*sort), reg);
+		if (!insn) {
+			return false;
+		}
+		insn->u.var.name = args->v;
+		insn->u.var.sort = *sort;
+		insn->u.var.slot = RZ_IL_VAR_SLOT_CACHE_INIT;
+		return true;
+	}
+	case RZ_IL_VAR_KIND_LOCAL: {
+		// the sort of a local var is only known from a previous set in the same effect
+		bool found = false;
+		ut64 v = ht_su_find(c->local_sorts, args->v, &found);
+		if (!found) {
+			return false;
+		}
+		*sort = local_sort_decode(v);
+		CompiledInsn *insn = emit_value(c, insn_var_local, sort_width(*sort), reg);
+		if (!insn) {
+			return false;
+		}
+		insn->u.var.name = args->v;
+		insn->u.var.sort = *sort;
+		insn->u.var.slot = RZ_IL_VAR_SLOT_CACHE_INIT;
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+static bool compile_ite(Compiler *c, RzILOpArgsIte *args, ut32 *reg, RzILSortPure *sort) {
+	ut32 cond;
+	if (!compile_bool(c, args->condition, &cond)) {
+		return false;
+	}
+	size_t branch = rz_vector_len(&c->insns);
+	CompiledInsn *insn = emit(c, insn_branch_false);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = cond;
+	ut32 x, y;
+	RzILSortPure sort_x, sort_y;
+	if (!compile_pure(c, args->x, &x, &sort_x)) {
+		return false;
+	}
+	ut32 dst = c->regs_count++;
+	insn = emit(c, insn_mov);
+	if (!insn) {
+		return false;
+	}
+	insn->dst = dst;
+	insn->src[0] = x;
+	size_t jump = rz_vector_len(&c->insns);
+	if (!emit(c, insn_jump)) {
+		return false;
+	}
+	insn_at(c, branch)->u.target = rz_vector_len(&c->insns);
+	if (!compile_pure(c, args->y, &y, &sort_y) || !rz_il_sort_pure_eq(sort_x, sort_y)) {
+		return false;
+	}
+	insn = emit(c, insn_mov);
+	if (!insn) {
+		return false;
+	}
+	insn->dst = dst;
+	insn->src[0] = y;
+	insn_at(c, jump)->u.target = rz_vector_len(&c->insns);
+	*reg = dst;
+	*sort = sort_x;
+	return true;
+}
+
+static bool compile_let(Compiler *c, RzILOpArgsLet *args, ut32 *reg, RzILSortPure *sort) {
+	LetBinding b = { .name = args->name };
+	if (!compile_pure(c, args->exp, &b.reg, &b.sort)) {
+		return false;
+	}
+	if (!rz_vector_push(&c->lets, &b)) {
+		c->oom = true;
+		return false;
+	}
+	bool ret = compile_pure(c, args->body, reg, sort);
+	rz_vector_pop(&c->lets, NULL);
+	return ret;
+}
+
+static bool compile_bool_op(Compiler *c, RzILOpPure *x, RzILOpPure *y, CompiledInsnHandler handler, ut32 *reg, RzILSortPure *sort) {
+	ut32 rx, ry;
+	if (!compile_bool(c, x, &rx) || !compile_bool(c, y, &ry)) {
+		return false;
+	}
+	CompiledInsn *insn = emit_value(c, handler, 1, reg);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rx;
+	insn->src[1] = ry;
+	*sort = rz_il_sort_pure_bool();
+	return true;
+}
+
+/**
+ * Compile an op taking one bitvector, producing either a bitvector of the same width or a bool
+ */
+static bool compile_bv_unop(Compiler *c, RzILOpPure *x, CompiledInsnHandler handler, bool to_bool, ut32 *reg, RzILSortPure *sort) {
+	ut32 rx, width;
+	if (!compile_bv(c, x, &rx, &width)) {
+		return false;
+	}
+	CompiledInsn *insn = emit_value(c, handler, width, reg);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rx;
+	*sort = to_bool ? rz_il_sort_pure_bool() : rz_il_sort_pure_bv(width);
+	return true;
+}
+
+/**
+ * Compile an op taking two bitvectors of the same width, producing either a bitvector of that width or a bool
+ */
+static bool compile_bv_binop(Compiler *c, RzILOpPure *x, RzILOpPure *y, CompiledInsnHandler handler, bool to_bool, ut32 *reg, RzILSortPure *sort) {
+	ut32 rx, ry, wx, wy;
+	if (!compile_bv(c, x, &rx, &wx) || !compile_bv(c, y, &ry, &wy) || wx != wy) {
+		return false;
+	}
+	CompiledInsn *insn = emit_value(c, handler, wx, reg);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rx;
+	insn->src[1] = ry;
+	*sort = to_bool ? rz_il_sort_pure_bool() : rz_il_sort_pure_bv(wx);
+	return true;
+}
+
+static bool compile_shift(Compiler *c, struct rz_il_op_args_shift_t *args, CompiledInsnHandler handler, ut32 *reg, RzILSortPure *sort) {
+	ut32 rx, ry, rfill, wx, wy;
+	if (!compile_bv(c, args->x, &rx, &wx) || !compile_bv(c, args->y, &ry, &wy) || !compile_bool(c, args->fill_bit, &rfill)) {
+		return false;
+	}
+	CompiledInsn *insn = emit_value(c, handler, wx, reg);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rx;
+	insn->src[1] = ry;
+	insn->src[2] = rfill;
+	*sort = rz_il_sort_pure_bv(wx);
+	return true;
+}
+
+static bool compile_cast(Compiler *c, RzILOpArgsCast *args, ut32 *reg, RzILSortPure *sort) {
+	ut32 rfill, rval, width;
+	if (!width_supported(args->length) || !compile_bool(c, args->fill, &rfill) || !compile_bv(c, args->val, &rval, &width)) {
+		return false;
+	}
+	CompiledInsn *insn = emit_value(c, insn_cast, args->length, reg);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rfill;
+	insn->src[1] = rval;
+	insn->u.imm = width;
+	*sort = rz_il_sort_pure_bv(args->length);
+	return true;
+}
+
+static bool compile_append(Compiler *c, RzILOpArgsAppend *args, ut32 *reg, RzILSortPure *sort) {
+	ut32 rhigh, rlow, whigh, wlow;
+	if (!compile_bv(c, args->high, &rhigh, &whigh) || !compile_bv(c, args->low, &rlow, &wlow) || !width_supported(whigh + wlow)) {
+		return false;
+	}
+	CompiledInsn *insn = emit_value(c, insn_append, whigh + wlow, reg);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rhigh;
+	insn->src[1] = rlow;
+	insn->u.imm = wlow;
+	*sort = rz_il_sort_pure_bv(whigh + wlow);
+	return true;
+}
+
+/**
+ * Check that \p index is a memory of \p vm that can be accessed with keys of \p key_width bits.
+ * Any mismatch is left to the regular evaluator to report.
+ */
+static bool mem_supported(RzILVM *vm, RzILMemIndex index, ut32 key_width) {
+	RzILMem *mem = rz_il_vm_get_mem(vm, index);
+	return mem && rz_il_mem_key_len(mem) == key_width;
+}
+
+static bool compile_load(Compiler *c, RzILMemIndex index, RzILOpPure *key, ut32 n_bits, bool word, ut32 *reg, RzILSortPure *sort) {
+	ut32 rkey, wkey;
+	if (!compile_bv(c, key, &rkey, &wkey) || !mem_supported(c->vm, index, wkey)) {
+		return false;
+	}
+	if (!word) {
+		n_bits = rz_il_mem_value_len(rz_il_vm_get_mem(c->vm, index));
+	}
+	if (!width_supported(n_bits)) {
+		return false;
+	}
+	CompiledInsn *insn = emit_value(c, word ? insn_loadw : insn_load, n_bits, reg);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rkey;
+	insn->u.mem.index = index;
+	insn->u.mem.key_width = wkey;
+	*sort = rz_il_sort_pure_bv(n_bits);
+	return true;
+}
+
+/**
+ * Emit the instructions evaluating \p op into a register
+ * \return false if \p op can not be compiled, in which case the instructions emitted so far must be discarded
+ */
+static bool compile_pure(Compiler *c, RzILOpPure *op, ut32 *reg, RzILSortPure *sort) {
+	if (c->vm->op_handler_pure_table[op->code] != rz_il_op_handler_pure_table_default[op->code]) {
+		// custom semantics
+		return false;
+	}
+	c->pure_compiled[op->code] = true;
+	CompiledInsn *insn;
+	switch (op->code) {
+	case RZ_IL_OP_VAR:
+		return compile_var(c, &op->op.var, reg, sort);
+	case RZ_IL_OP_ITE:
+		return compile_ite(c, &op->op.ite, reg, sort);
+	case RZ_IL_OP_LET:
+		return compile_let(c, &op->op.let, reg, sort);
+	case RZ_IL_OP_B0:
+	case RZ_IL_OP_B1:
+		insn = emit_value(c, insn_const, 1, reg);
+		if (!insn) {
+			return false;
+		}
+		insn->u.imm = op->code == RZ_IL_OP_B1;
+		*sort = rz_il_sort_pure_bool();
+		return true;
+	case RZ_IL_OP_INV: {
+		ut32 rx;
+		if (!compile_bool(c, op->op.boolinv.x, &rx)) {
+			return false;
+		}
+		insn = emit_value(c, insn_bool_inv, 1, reg);
+		if (!insn) {
+			return false;
+		}
+		insn->src[0] = rx;
+		*sort = rz_il_sort_pure_bool();
+		return true;
+	}
+	case RZ_IL_OP_AND:
+		return compile_bool_op(c, op->op.booland.x, op->op.booland.y, insn_and, reg, sort);
+	case RZ_IL_OP_OR:
+		return compile_bool_op(c, op->op.boolor.x, op->op.boolor.y, insn_or, reg, sort);
+	case RZ_IL_OP_XOR:
+		return compile_bool_op(c, op->op.boolxor.x, op->op.boolxor.y, insn_xor, reg, sort);
+	case RZ_IL_OP_BITV: {
+		RzBitVector *value = op->op.bitv.value;
+		if (!width_supported(rz_bv_len(value))) {
+			return false;
+		}
+		insn = emit_value(c, insn_const, rz_bv_len(value), reg);
+		if (!insn) {
+			return false;
+		}
+		insn->u.imm = rz_bv_to_ut64(value);
+		*sort = rz_il_sort_pure_bv(rz_bv_len(value));
+		return true;
+	}
+	case RZ_IL_OP_MSB:
+		return compile_bv_unop(c, op->op.msb.bv, insn_msb, true, reg, sort);
+	case RZ_IL_OP_LSB:
+		return compile_bv_unop(c, op->op.lsb.bv, insn_lsb, true, reg, sort);
+	case RZ_IL_OP_IS_ZERO:
+		return compile_bv_unop(c, op->op.is_zero.bv, insn_is_zero, true, reg, sort);
+	case RZ_IL_OP_NEG:
+		return compile_bv_unop(c, op->op.neg.bv, insn_neg, false, reg, sort);
+	case RZ_IL_OP_LOGNOT:
+		return compile_bv_unop(c, op->op.lognot.bv, insn_lognot, false, reg, sort);
+	case RZ_IL_OP_ADD:
+		return compile_bv_binop(c, op->op.add.x, op->op.add.y, insn_add, false, reg, sort);
+	case RZ_IL_OP_SUB:
+		return compile_bv_binop(c, op->op.sub.x, op->op.sub.y, insn_sub, false, reg, sort);
+	case RZ_IL_OP_MUL:
+		return compile_bv_binop(c, op->op.mul.x, op->op.mul.y, insn_mul, false, reg, sort);
+	case RZ_IL_OP_DIV:
+		return compile_bv_binop(c, op->op.div.x, op->op.div.y, insn_div, false, reg, sort);
+	case RZ_IL_OP_SDIV:
+		return compile_bv_binop(c, op->op.sdiv.x, op->op.sdiv.y, insn_sdiv, false, reg, sort);
+	case RZ_IL_OP_MOD:
+		return compile_bv_binop(c, op->op.mod.x, op->op.mod.y, insn_mod, false, reg, sort);
+	case RZ_IL_OP_SMOD:
+		return compile_bv_binop(c, op->op.smod.x, op->op.smod.y, insn_smod, false, reg, sort);
+	case RZ_IL_OP_LOGAND:
+		return compile_bv_binop(c, op->op.logand.x, op->op.logand.y, insn_and, false, reg, sort);
+	case RZ_IL_OP_LOGOR:
+		return compile_bv_binop(c, op->op.logor.x, op->op.logor.y, insn_or, false, reg, sort);
+	case RZ_IL_OP_LOGXOR:
+		return compile_bv_binop(c, op->op.logxor.x, op->op.logxor.y, insn_xor, false, reg, sort);
+	case RZ_IL_OP_SHIFTR:
+		return compile_shift(c, &op->op.shiftr, insn_shiftr, reg, sort);
+	case RZ_IL_OP_SHIFTL:
+		return compile_shift(c, &op->op.shiftl, insn_shiftl, reg, sort);
+	case RZ_IL_OP_EQ:
+		return compile_bv_binop(c, op->op.eq.x, op->op.eq.y, insn_eq, true, reg, sort);
+	case RZ_IL_OP_SLE:
+		return compile_bv_binop(c, op->op.sle.x, op->op.sle.y, insn_sle, true, reg, sort);
+	case RZ_IL_OP_ULE:
+		return compile_bv_binop(c, op->op.ule.x, op->op.ule.y, insn_ule, true, reg, sort);
+	case RZ_IL_OP_CAST:
+		return compile_cast(c, &op->op.cast, reg, sort);
+	case RZ_IL_OP_APPEND:
+		return compile_append(c, &op->op.append, reg, sort);
+	case RZ_IL_OP_LOAD:
+		return compile_load(c, op->op.load.mem, op->op.load.key, 0, false, reg, sort);
+	case RZ_IL_OP_LOADW:
+		return compile_load(c, op->op.loadw.mem, op->op.loadw.key, op->op.loadw.n_bits, true, reg, sort);
+	default:
+		// floats
+		return false;
+	}
+}
+
+static bool compile_effect(Compiler *c, RzILOpEffect *op);
+
+static bool compile_set(Compiler *c, RzILOpArgsSet *args) {
+	ut32 rx;
+	RzILSortPure sort;
+	if (!compile_pure(c, args->x, &rx, &sort)) {
+		return false;
+	}
+	if (args->is_local) {
+		bool found = false;
+		ut64 v = ht_su_find(c->local_sorts, args->v, &found);
+		if (found && v != local_sort_encode(sort)) {
+			// mis-sorted, leave the error to the regular evaluator
+			return false;
+		}
+		ht_su_update(c->local_sorts, args->v, local_sort_encode(sort));
+	} else {
+		RzILVarSlot slot = rz_il_var_set_resolve(&c->vm->global_vars, args->v, false);
+		RzILVar *var = rz_il_var_set_get_at(&c->vm->global_vars, slot);
+		if (!var || !rz_il_sort_pure_eq(var->sort, sort)) {
+			return false;
+		}
+	}
+	CompiledInsn *insn = emit(c, args->is_local ? insn_set_local : insn_set_global);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rx;
+	insn->width = sort_width(sort);
+	insn->u.var.name = args->v;
+	insn->u.var.sort = sort;
+	insn->u.var.slot = RZ_IL_VAR_SLOT_CACHE_INIT;
+	return true;
+}
+
+static bool compile_jmp(Compiler *c, RzILOpArgsJmp *args) {
+	ut32 rdst, width;
+	if (!compile_bv(c, args->dst, &rdst, &width)) {
+		return false;
+	}
+	CompiledInsn *insn = emit(c, insn_jmp);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rdst;
+	insn->width = width;
+	return true;
+}
+
+static bool compile_store(Compiler *c, RzILMemIndex index, RzILOpPure *key, RzILOpPure *value, bool word) {
+	ut32 rkey, rvalue, wkey, wvalue;
+	if (!compile_bv(c, key, &rkey, &wkey) || !compile_bv(c, value, &rvalue, &wvalue) || !mem_supported(c->vm, index, wkey)) {
+		return false;
+	}
+	if (!word && wvalue != rz_il_mem_value_len(rz_il_vm_get_mem(c->vm, index))) {
+		return false;
+	}
+	CompiledInsn *insn = emit(c, word ? insn_storew : insn_store);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = rkey;
+	insn->src[1] = rvalue;
+	insn->width = wvalue;
+	insn->u.mem.index = index;
+	insn->u.mem.key_width = wkey;
+	return true;
+}
+
+static bool compile_branch(Compiler *c, RzILOpArgsBranch *args) {
+	ut32 cond;
+	if (!compile_bool(c, args->condition, &cond)) {
+		return false;
+	}
+	size_t branch = rz_vector_len(&c->insns);
+	CompiledInsn *insn = emit(c, insn_branch_false);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = cond;
+	if (!compile_effect(c, args->true_eff)) {
+		return false;
+	}
+	size_t jump = rz_vector_len(&c->insns);
+	if (!emit(c, insn_jump)) {
+		return false;
+	}
+	insn_at(c, branch)->u.target = rz_vector_len(&c->insns);
+	if (!compile_effect(c, args->false_eff)) {
+		return false;
+	}
+	insn_at(c, jump)->u.target = rz_vector_len(&c->insns);
+	return true;
+}
+
+static bool compile_repeat(Compiler *c, RzILOpArgsRepeat *args) {
+	size_t loop = rz_vector_len(&c->insns);
+	ut32 cond;
+	if (!compile_bool(c, args->condition, &cond)) {
+		return false;
+	}
+	size_t branch = rz_vector_len(&c->insns);
+	CompiledInsn *insn = emit(c, insn_branch_false);
+	if (!insn) {
+		return false;
+	}
+	insn->src[0] = cond;
+	if (!compile_effect(c, args->data_eff)) {
+		return false;
+	}
+	insn = emit(c, insn_jump);
+	if (!insn) {
+		return false;
+	}
+	insn->u.target = loop;
+	insn_at(c, branch)->u.target = rz_vector_len(&c->insns);
+	return true;
+}
+
+/**
+ * Emit the instructions performing \p op
+ * \return false if \p op can not be compiled, in which case the instructions emitted so far must be discarded
+ */
+static bool compile_effect_code(Compiler *c, RzILOpEffect *op) {
+	if (c->vm->op_handler_effect_table[op->code] != rz_il_op_handler_effect_table_default[op->code]) {
+		// custom semantics
+		return false;
+	}
+	c->effect_compiled[op->code] = true;
+	switch (op->code) {
+	case RZ_IL_OP_NOP:
+		return true;
+	case RZ_IL_OP_SET:
+		return compile_set(c, &op->op.set);
+	case RZ_IL_OP_JMP:
+		return compile_jmp(c, &op->op.jmp);
+	case RZ_IL_OP_SEQ:
+		return compile_effect(c, op->op.seq.x) && compile_effect(c, op->op.seq.y);
+	case RZ_IL_OP_BLK:
+		if (op->op.blk.label) {
+			CompiledInsn *insn = emit(c, insn_label);
+			if (!insn) {
+				return false;
+			}
+			insn->u.label = op->op.blk.label;
+		}
+		return compile_effect(c, op->op.blk.data_eff) && compile_effect(c, op->op.blk.ctrl_eff);
+	case RZ_IL_OP_REPEAT:
+		return compile_repeat(c, &op->op.repeat);
+	case RZ_IL_OP_BRANCH:
+		return compile_branch(c, &op->op.branch);
+	case RZ_IL_OP_STORE:
+		return compile_store(c, op->op.store.mem, op->op.store.key, op->op.store.value, false);
+	case RZ_IL_OP_STOREW:
+		return compile_store(c, op->op.storew.mem, op->op.storew.key, op->op.storew.value, true);
+	default:
+		// empty, goto
+		return false;
+	}
+}
+
+/**
+ * Local vars set inside \p op by the regular evaluator may have any sort afterwards
+ */
+static void forget_local_sorts(Compiler *c, RzILOpEffect *op) {
+	switch (op->code) {
+	case RZ_IL_OP_SET:
+		if (op->op.set.is_local) {
+			ht_su_delete(c->local_sorts, op->op.set.v);
+		}
+		break;
+	case RZ_IL_OP_SEQ:
+		forget_local_sorts(c, op->op.seq.x);
+		forget_local_sorts(c, op->op.seq.y);
+		break;
+	case RZ_IL_OP_BLK:
+		forget_local_sorts(c, op->op.blk.data_eff);
+		forget_local_sorts(c, op->op.blk.ctrl_eff);
+		break;
+	case RZ_IL_OP_REPEAT:
+		forget_local_sorts(c, op->op.repeat.data_eff);
+		break;
+	case RZ_IL_OP_BRANCH:
+		forget_local_sorts(c, op->op.branch.true_eff);
+		forget_local_sorts(c, op->op.branch.false_eff);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Emit the instructions performing \p op, or a single one handing it to the regular evaluator
+ * \return false only if an allocation failed
+ */
+static bool compile_effect(Compiler *c, RzILOpEffect *op) {
+	size_t mark = rz_vector_len(&c->insns);
+	if (compile_effect_code(c, op)) {
+		return true;
+	}
+	if (c->oom) {
+		return false;
+	}
+	rz_vector_remove_range(&c->insns, mark, rz_vector_len(&c->insns) - mark, NULL);
+	forget_local_sorts(c, op);
+	CompiledInsn *insn = emit(c, insn_effect);
+	if (!insn) {
+		return false;
+	}
+	insn->u.effect = op;
+	return true;
+}
+
+/**
+ * \brief Compile \p op into a flat form that can be evaluated faster than the op itself
+ *
+ * The sorts of the variables and the layout of the memories are taken from \p vm,
+ * but the result may be evaluated in any vm set up in the same way.
+ * Parts of \p op that can not be compiled are evaluated with the regular evaluator,
+ * so the result is always equivalent to evaluating \p op directly.
+ * Ops with custom handlers in \p vm are not compiled, and a vm replacing the handler
+ * of any compiled op evaluates the whole of \p op with the regular evaluator instead.
+ *
+ * \param op the effect to compile, which must outlive the result
+ * \return the compiled effect, to be evaluated with rz_il_evaluate_compiled_effect()
+ */
+RZ_API RZ_OWN RzILCompiledEffect *rz_il_compile_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL RZ_BORROW RzILOpEffect *op) {
+	rz_return_val_if_fail(vm && op, NULL);
+	RzILCompiledEffect *ce = RZ_NEW0(RzILCompiledEffect);
+	if (!ce) {
+		return NULL;
+	}
+	Compiler c = { .vm = vm };
+	rz_vector_init(&c.insns, sizeof(CompiledInsn), NULL, NULL);
+	rz_vector_init(&c.lets, sizeof(LetBinding), NULL, NULL);
+	c.local_sorts = ht_su_new(HT_STR_DUP);
+	if (!c.local_sorts || !compile_effect(&c, op) || rz_vector_len(&c.insns) > UT32_MAX) {
+		RZ_FREE(ce);
+		goto beach;
+	}
+	ce->insns_count = rz_vector_len(&c.insns);
+	ce->insns = rz_vector_flush(&c.insns);
+	ce->regs_count = c.regs_count;
+	ce->op = op;
+	for (ut32 i = 0; i < RZ_IL_OP_PURE_MAX; i++) {
+		if (c.pure_compiled[i]) {
+			ce->pure_codes[ce->pure_codes_count++] = i;
+		}
+	}
+	for (ut32 i = 0; i < RZ_IL_OP_EFFECT_MAX; i++) {
+		if (c.effect_compiled[i]) {
+			ce->effect_codes[ce->effect_codes_count++] = i;
+		}
+	}
+beach:
+	ht_su_free(c.local_sorts);
+	rz_vector_fini(&c.lets);
+	rz_vector_fini(&c.insns);
+	return ce;
+}
+
+RZ_API void rz_il_compiled_effect_free(RZ_NULLABLE RzILCompiledEffect *ce) {
+	if (!ce) {
+		return;
+	}
+	free(ce->insns);
+	free(ce);
+}
+
+/**
+ * Check that \p vm has the default handlers for all ops that were turned into instructions of \p ce
+ */
+static bool compiled_handlers_match(RzILVM *vm, RzILCompiledEffect *ce) {
+	for (ut32 i = 0; i < ce->pure_codes_count; i++) {
+		ut8 code = ce->pure_codes[i];
+		if (vm->op_handler_pure_table[code] != rz_il_op_handler_pure_table_default[code]) {
+			return false;
+		}
+	}
+	for (ut32 i = 0; i < ce->effect_codes_count; i++) {
+		ut8 code = ce->effect_codes[i];
+		if (vm->op_handler_effect_table[code] != rz_il_op_handler_effect_table_default[code]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Evaluate (execute) the given compiled effect
+ *
+ * The instructions cache the slots of the variables they access,
+ * so the same compiled effect must not be evaluated by multiple threads at once.
+ *
+ * \return false if an error occured and the execution should be aborted
+ */
+RZ_API bool rz_il_evaluate_compiled_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILCompiledEffect *ce) {
+	rz_return_val_if_fail(vm && ce, false);
+	if (!compiled_handlers_match(vm, ce)) {
+		// custom semantics in this vm, which the instructions would bypass
+		return rz_il_evaluate_effect(vm, ce->op);
+	}
+	ut64 stack_regs[COMPILED_STACK_REGS];
+	ut64 *regs = ce->regs_count <= COMPILED_STACK_REGS ? stack_regs : RZ_NEWS(ut64, ce->regs_count);
+	if (!regs) {
+		return false;
+	}
+	CompiledExec ex = { .vm = vm, .regs = regs, .ip = 0 };
+	bool succ = true;
+	while (ex.ip < ce->insns_count) {
+		CompiledInsn *insn = &ce->insns[ex.ip++];
+		if (!insn->handler(&ex, insn)) {
+			succ = false;
+			break;
+		}
+	}
+	if (regs != stack_regs) {
+		free(regs);
+	}
+	return succ;
+}
@@ -293,15 +293,7 @@ RZ_API void rz_il_vm_clear_events(RzILVM *vm) {
 	rz_pvector_clear(vm->events);
 }
 
-/**
- * Execute the opcodes uplifted from raw instructions.A list may contain multiple opcode trees
- * \param vm pointer to VM
- * \param op_list, a list of op roots.
- * \param fallthrough_addr initial address to set PC to. Thus also the address to "step to" if no explicit jump occurs.
- */
-RZ_API bool rz_il_vm_step(RzILVM *vm, RzILOpEffect *op, ut64 fallthrough_addr) {
-	rz_return_val_if_fail(vm && op, false);
-
+static void step_begin(RzILVM *vm, ut64 fallthrough_addr) {
 	rz_il_vm_clear_events(vm);
 
 	// Set the successor pc **before** evaluating. Any jmp/goto may then overwrite it again.
@@ -309,11 +301,36 @@ RZ_API bool rz_il_vm_step(RzILVM *vm, RzILOpEffect *op, ut64 fallthrough_addr) {
 	rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, next_pc));
 	rz_bv_free(vm->pc);
 	vm->pc = next_pc;
+}
 
-	bool succ = rz_il_evaluate_effect(vm, op);
-
+static void step_end(RzILVM *vm) {
 	// remove any local defined variable (local pure vars are unbound automatically)
 	rz_il_var_set_reset(&vm->local_vars);
+}
+
+/**
+ * Execute the opcodes uplifted from raw instructions.A list may contain multiple opcode trees
+ * \param vm pointer to VM
+ * \param op_list, a list of op roots.
+ * \param fallthrough_addr initial address to set PC to. Thus also the address to "step to" if no explicit jump occurs.
+ */
+RZ_API bool rz_il_vm_step(RzILVM *vm, RzILOpEffect *op, ut64 fallthrough_addr) {
+	rz_return_val_if_fail(vm && op, false);
+	step_begin(vm, fallthrough_addr);
+	bool succ = rz_il_evaluate_effect(vm, op);
+	step_end(vm);
+	return succ;
+}
+
+/**
+ * Same as rz_il_vm_step(), but execute an effect compiled with rz_il_compile_effect()
+ * \param fallthrough_addr initial address to set PC to. Thus also the address to "step to" if no explicit jump occurs.
+ */
+RZ_API bool rz_il_vm_step_compiled(RzILVM *vm, RzILCompiledEffect *ce, ut64 fallthrough_addr) {
+	rz_return_val_if_fail(vm && ce, false);
+	step_begin(vm, fallthrough_addr);
+	bool succ = rz_il_evaluate_compiled_effect(vm, ce);
+	step_end(vm);
 	return succ;
 }
 
@@ -5,24 +5,23 @@
 #include <rz_il/rz_il_opcodes.h>
 #include <rz_il/rz_il_vm.h>
 
-static RzILEvent *il_event_new_write_from_var(RzILVM *vm, RzILVar *var, RzILVal *new_val) {
-	rz_return_val_if_fail(vm && var && new_val, NULL);
-	RzILVal *old_val = rz_il_vm_get_var_value(vm, RZ_IL_VAR_KIND_GLOBAL, var->name);
-	if (!old_val) {
-		return NULL;
-	}
-	return rz_il_event_var_write_new(var->name, old_val, new_val);
-}
-
-static void rz_il_set(RzILVM *vm, const char *var_name, bool is_local, RZ_OWN RzILVal *val) {
+static void rz_il_set(RzILVM *vm, const char *var_name, bool is_local, RzILVarSlot slot, RZ_OWN RzILVal *val) {
 	if (is_local) {
-		rz_il_vm_set_local_var(vm, var_name, val);
-	} else {
-		RzILVar *var = rz_il_vm_get_var(vm, RZ_IL_VAR_KIND_GLOBAL, var_name);
-		RzILEvent *evt = il_event_new_write_from_var(vm, var, val);
-		rz_il_vm_event_add(vm, evt);
+		rz_il_vm_set_local_var_at(vm, slot, val);
+		return;
+	}
+	RzILVarSet *vs = &vm->global_vars;
+	RzILVar *var = rz_il_var_set_get_at(vs, slot);
+	if (!var) {
+		// reports the error
 		rz_il_vm_set_global_var(vm, var_name, val);
+		return;
+	}
+	RzILVal *old_val = rz_il_var_set_get_value_at(vs, slot);
+	if (old_val) {
+		rz_il_vm_event_add(vm, rz_il_event_var_write_new(var->name, old_val, val));
 	}
+	rz_il_var_set_bind_at(vs, slot, val);
 }
 
 bool rz_il_handler_empty(RzILVM *vm, RzILOpEffect *op) {
@@ -38,19 +37,89 @@ bool rz_il_handler_nop(RzILVM *vm, RzILOpEffect *op) {
 	return true;
 }
 
+/**
+ * Overwrite the current value of a variable with the temporary \p v if both have the same sort,
+ * so the temporary can go back to the pool instead of being bound to the variable.
+ * \return whether \p v has been consumed
+ */
+static bool set_in_place(RzILVM *vm, bool is_local, RzILVarSlot slot, RzILTypePure type, void *v) {
+	RzILVarSet *vs = is_local ? &vm->local_vars : &vm->global_vars;
+	RzILVar *var = rz_il_var_set_get_at(vs, slot);
+	RzILVal *old_val = rz_il_var_set_get_value_at(vs, slot);
+	if (!var || !old_val || old_val->type != type) {
+		return false;
+	}
+	RzILVal val = { .type = type };
+	switch (type) {
+	case RZ_IL_TYPE_PURE_BOOL:
+		val.data.b = v;
+		break;
+	case RZ_IL_TYPE_PURE_BITVECTOR:
+		if (rz_bv_len(old_val->data.bv) != rz_bv_len(v)) {
+			return false;
+		}
+		val.data.bv = v;
+		break;
+	default:
+		return false;
+	}
+	if (!is_local) {
+		rz_il_vm_event_add(vm, rz_il_event_var_write_new(var->name, old_val, &val));
+	}
+	if (type == RZ_IL_TYPE_PURE_BOOL) {
+		old_val->data.b->b = val.data.b->b;
+		rz_il_vm_bool_free(vm, v);
+	} else {
+		rz_bv_copy(val.data.bv, old_val->data.bv);
+		rz_il_vm_bv_free(vm, v);
+	}
+	return true;
+}
+
 bool rz_il_handler_set(RzILVM *vm, RzILOpEffect *op) {
 	rz_return_val_if_fail(vm && op, false);
 	RzILOpArgsSet *set_op = &op->op.set;
-	RzILVal *val = rz_il_evaluate_val(vm, set_op->x);
+	RzILTypePure type;
+	void *v = rz_il_evaluate_pure(vm, set_op->x, &type);
+	if (!v) {
+		return false;
+	}
+	// local variables are created on the first set, globals must exist already
+	RzILVarSet *vs = set_op->is_local ? &vm->local_vars : &vm->global_vars;
+	RzILVarSlot slot = rz_il_var_set_resolve_cached(vs, set_op->v, &set_op->slot, set_op->is_local);
+	if (set_in_place(vm, set_op->is_local, slot, type, v)) {
+		return true;
+	}
+	RzILVal *val;
+	switch (type) {
+	case RZ_IL_TYPE_PURE_BOOL:
+		val = rz_il_value_new_bool(v);
+		break;
+	case RZ_IL_TYPE_PURE_BITVECTOR:
+		val = rz_il_value_new_bitv(v);
+		break;
+	case RZ_IL_TYPE_PURE_FLOAT:
+		val = rz_il_value_new_float(v);
+		break;
+	default:
+		val = NULL;
+		break;
+	}
 	if (!val) {
 		return false;
 	}
-	rz_il_set(vm, set_op->v, set_op->is_local, val);
+	rz_il_set(vm, set_op->v, set_op->is_local, slot, val);
 	return true;
 }
 
 static void perform_jump(RzILVM *vm, RZ_OWN RzBitVector *dst) {
 	rz_il_vm_event_add(vm, rz_il_event_pc_write_new(vm->pc, dst));
+	if (rz_bv_len(vm->pc) == rz_bv_len(dst)) {
+		// keep the pc and let the temporary go back to the pool
+		rz_bv_copy(dst, vm->pc);
+		rz_il_vm_bv_free(vm, dst);
+		return;
+	}
 	rz_bv_free(vm->pc);
 	vm->pc = dst;
 }
@@ -113,9 +182,9 @@ bool rz_il_handler_repeat(RzILVM *vm, RzILOpEffect *op) {
 			res = false;
 			break;
 		}
-		rz_il_bool_free(condition);
+		rz_il_vm_bool_free(vm, condition);
 	}
-	rz_il_bool_free(condition);
+	rz_il_vm_bool_free(vm, condition);
 
 	return res;
 }
@@ -135,7 +204,7 @@ bool rz_il_handler_branch(RzILVM *vm, RzILOpEffect *op) {
 	} else {
 		ret = rz_il_evaluate_effect(vm, op_branch->false_eff);
 	}
-	rz_il_bool_free(condition);
+	rz_il_vm_bool_free(vm, condition);
 
 	return ret;
 }
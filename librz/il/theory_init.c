@@ -19,7 +19,7 @@ void *rz_il_handler_ite(RzILVM *vm, RzILOpPure *op, RzILTypePure *type) {
 	} else {
 		ret = rz_il_evaluate_pure(vm, op_ite->y, type); // false branch
 	}
-	rz_il_bool_free(condition);
+	rz_il_vm_bool_free(vm, condition);
 	return ret;
 }
 
@@ -27,7 +27,8 @@ void *rz_il_handler_var(RzILVM *vm, RzILOpPure *op, RzILTypePure *type) {
 	rz_return_val_if_fail(vm && op && type, NULL);
 
 	RzILOpArgsVar *var_op = &op->op.var;
-	RzILVal *val = rz_il_vm_get_var_value(vm, var_op->kind, var_op->v);
+	RzILVarSet *vs = rz_il_vm_get_var_set(vm, var_op->kind);
+	RzILVal *val = vs ? rz_il_var_set_get_value_at(vs, rz_il_var_set_resolve_cached(vs, var_op->v, &var_op->slot, false)) : NULL;
 	if (!val) {
 		RZ_LOG_ERROR("RzIL: reading value of variable \"%s\" of kind %s failed.\n",
 			var_op->v, rz_il_var_kind_name(var_op->kind));
@@ -42,11 +43,11 @@ void *rz_il_handler_var(RzILVM *vm, RzILOpPure *op, RzILTypePure *type) {
 	switch (val->type) {
 	case RZ_IL_TYPE_PURE_BOOL:
 		*type = RZ_IL_TYPE_PURE_BOOL;
-		ret = rz_il_bool_new(val->data.b->b);
+		ret = rz_il_vm_bool_new(vm, val->data.b->b);
 		break;
 	case RZ_IL_TYPE_PURE_BITVECTOR:
 		*type = RZ_IL_TYPE_PURE_BITVECTOR;
-		ret = rz_bv_dup(val->data.bv);
+		ret = rz_il_vm_bv_dup(vm, val->data.bv);
 		break;
 	case RZ_IL_TYPE_PURE_FLOAT:
 		*type = RZ_IL_TYPE_PURE_FLOAT;
@@ -65,9 +66,10 @@ void *rz_il_handler_let(RzILVM *vm, RzILOpPure *op, RzILTypePure *type) {
 	if (!v) {
 		return NULL;
 	}
-	RzILLocalPurePrev prev = rz_il_vm_push_local_pure_var(vm, args->name, v);
+	RzILVarSlot slot = rz_il_var_set_resolve_cached(&vm->local_pure_vars, args->name, &args->slot, true);
+	RzILLocalPurePrev prev = rz_il_vm_push_local_pure_var_at(vm, slot, v);
 	void *r = rz_il_evaluate_pure(vm, args->body, type);
-	rz_il_vm_pop_local_pure_var(vm, args->name, prev);
+	rz_il_vm_pop_local_pure_var_at(vm, slot, prev);
 	return r;
 }
 
@@ -447,6 +447,8 @@ typedef struct rz_analysis_hint_cb_t {
 } RHintCb;
 
 typedef struct rz_analysis_il_vm_t RzAnalysisILVM;
+typedef struct rz_analysis_xrefs_t RzAnalysisXRefs;
+typedef struct rz_analysis_il_cache_t RzAnalysisILCache;
 
 typedef struct {
 	HtUP /*<ut64, RzAnalysisDwarfFunction *>*/ *function_by_offset; ///< Store all functions parsed from DWARF by DIE offset
@@ -495,13 +497,13 @@ typedef struct rz_analysis_t {
 	struct rz_analysis_esil_t *esil;
 	struct rz_analysis_esil_inter_state_t *esilinterstate;
 	RzAnalysisILVM *il_vm; ///< user-faced VM, NEVER use this for any analysis passes!
+	RzAnalysisILCache *il_cache; ///< IL ops lifted while stepping IL vms, by address
 	struct rz_analysis_plugin_t *cur;
 	RzAnalysisRange *limit; // analysis.from, analysis.to
 	HtSP /*<RzAnalysisPlugin *>*/ *plugins;
 	Sdb *sdb_noret;
 	Sdb *sdb_fmts;
-	HtUP *ht_xrefs_from;
-	HtUP *ht_xrefs_to;
+	RzAnalysisXRefs *xrefs; ///< All the cross references, see xrefs.c
 	bool recursive_noreturn; // analysis.rnr
 	// moved from RzAnalysisFcn
 	Sdb *sdb; // root
@@ -1150,6 +1152,7 @@ typedef struct rz_analysis_esil_callbacks_t {
 typedef struct rz_analysis_esil_t {
 	RzAnalysis *analysis;
 	char **stack;
+	const void **stack_words; ///< compiled word that pushed each entry of the stack, kept for the entries pushed by the program rz_analysis_esil_parse() is running
 	ut64 addrmask;
 	int stacksize;
 	int stackptr;
@@ -1177,6 +1180,8 @@ typedef struct rz_analysis_esil_t {
 	ut8 lastsz; // in bits //used for signature-flag
 	/* native ops and custom ops */
 	HtSP *ops;
+	HtSP *compiled; ///< expressions already compiled by rz_analysis_esil_parse(), by their string
+	int compiled_running; ///< number of nested executions of compiled expressions
 	RzStrBuf current_opstr;
 	RzIDStorage *sources;
 	HtUP *interrupts;
@@ -1741,6 +1746,8 @@ RZ_API RzAnalysisILStepResult rz_analysis_il_vm_step_while_with_events(
 	RZ_NONNULL RzAnalysisILVMCondCallback cond, RZ_NULLABLE void *user);
 RZ_API bool rz_analysis_il_vm_setup(RzAnalysis *analysis);
 RZ_API void rz_analysis_il_vm_cleanup(RzAnalysis *analysis);
+RZ_API void rz_analysis_il_cache_clear(RZ_NONNULL RzAnalysis *analysis);
+RZ_API void rz_analysis_il_cache_invalidate(RZ_NONNULL RzAnalysis *analysis, ut64 addr, ut64 size);
 
 /* trace */
 RZ_API RzAnalysisRzilTrace *rz_analysis_rzil_trace_new(RzAnalysis *analysis, RZ_NONNULL RzAnalysisILVM *rzil);
@@ -1788,6 +1795,7 @@ RZ_API int rz_analysis_function_resize(RzAnalysisFunction *fcn, int newsize);
 RZ_API bool rz_analysis_function_purity(RzAnalysisFunction *fcn);
 
 typedef bool (*RzAnalysisRefCmp)(RzAnalysisXRef *ref, void *data);
+typedef bool (*RzAnalysisXRefCb)(const RzAnalysisXRef *xref, void *user);
 RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_xref_list_new(void);
 RZ_API ut64 rz_analysis_xrefs_count(RzAnalysis *analysis);
 RZ_API const char *rz_analysis_xrefs_type_tostring(RzAnalysisXRefType type);
@@ -1800,6 +1808,9 @@ RZ_API RZ_OWN RzList /*<RzAnalysisXRef *>*/ *rz_analysis_function_get_xrefs_to(c
 RZ_API bool rz_analysis_xrefs_set(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisXRefType type);
 RZ_API bool rz_analysis_xrefs_deln(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisXRefType type);
 RZ_API bool rz_analysis_xref_del(RzAnalysis *analysis, ut64 from, ut64 to);
+RZ_API bool rz_analysis_xrefs_foreach(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzAnalysisXRefCb cb, RZ_NULLABLE void *user);
+RZ_API bool rz_analysis_xrefs_foreach_from(RZ_NONNULL RzAnalysis *analysis, ut64 begin, ut64 end, RZ_NONNULL RzAnalysisXRefCb cb, RZ_NULLABLE void *user);
+RZ_API bool rz_analysis_xrefs_foreach_to(RZ_NONNULL RzAnalysis *analysis, ut64 begin, ut64 end, RZ_NONNULL RzAnalysisXRefCb cb, RZ_NULLABLE void *user);
 
 /* var.c */
 RZ_API RZ_BORROW RzAnalysisVar *rz_analysis_function_set_var(
@@ -1958,6 +1969,7 @@ typedef struct rz_analysis_match_options_t {
 	RZ_NONNULL RzAnalysis *analysis_b; ///< Analysis context for the second input (can be the same as analysis_a)
 	RzAnalysisMatchThreadInfoCb callback; ///< When set allows to get the thread information
 	void *user; ///< User pointer to pass to the callback function for the thread info
+	ut32 lsh_rows; ///< When not 0, functions are only compared with the candidates sharing a band of lsh_rows MinHash values (1-32, fewer is slower but finds more matches)
 } RzAnalysisMatchOpt;
 
 typedef struct rz_analysis_match_pair_t {
@@ -1970,6 +1982,7 @@ typedef struct rz_analysis_match_result_t {
 	RzList /*<RzAnalysisMatchPair *>*/ *matches; ///< List of matched pairs between input A and B
 	RzList /*<void *>*/ *unmatch_a; ///< List of unmatched elements from input A (the pointers are either RzAnalysisBlock or RzAnalysisFunction)
 	RzList /*<void *>*/ *unmatch_b; ///< List of unmatched elements from input B (the pointers are either RzAnalysisBlock or RzAnalysisFunction)
+	ut64 n_compared; ///< Number of pairs whose similarity has been computed
 } RzAnalysisMatchResult;
 
 #define RZ_ANALYSIS_SIMILARITY_THRESHOLD (0.5)
@@ -2386,6 +2399,12 @@ typedef struct {
 	RzKeyParser *piece_parser;
 } RzSerializeAnalysisFunctionLoadCtx;
 
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_case_op_fields(RZ_NONNULL size_t *count);
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_switch_op_fields(RZ_NONNULL size_t *count);
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_block_fields(RZ_NONNULL size_t *count);
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_function_fields(RZ_NONNULL size_t *count);
+RZ_API RZ_BORROW const RzSerializeField *rz_serialize_analysis_xref_fields(RZ_NONNULL size_t *count);
+
 RZ_API void rz_serialize_analysis_case_op_save(RZ_NONNULL PJ *j, RZ_NONNULL RzAnalysisCaseOp *op);
 RZ_API void rz_serialize_analysis_switch_op_save(RZ_NONNULL PJ *j, RZ_NONNULL RzAnalysisSwitchOp *op);
 RZ_API RzAnalysisSwitchOp *rz_serialize_analysis_switch_op_load(RZ_NONNULL const RzJson *json);
@@ -2446,6 +2465,8 @@ RZ_API void rz_serialize_analysis_classes_save(RZ_NONNULL Sdb *db, RZ_NONNULL Rz
 RZ_API bool rz_serialize_analysis_classes_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
 RZ_API void rz_serialize_analysis_types_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
 RZ_API bool rz_serialize_analysis_types_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
+RZ_API void rz_serialize_analysis_callables_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
+RZ_API bool rz_serialize_analysis_callables_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
 RZ_API void rz_serialize_analysis_sign_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
 RZ_API bool rz_serialize_analysis_sign_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
 RZ_API void rz_serialize_analysis_imports_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
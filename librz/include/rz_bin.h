@@ -321,6 +321,9 @@ typedef struct rz_bin_object_t {
 	RzBinAddr *binsym[RZ_BIN_SPECIAL_SYMBOL_LAST];
 	struct rz_bin_plugin_t *plugin;
 	RzBinLanguage lang;
+	const RzDemanglerPlugin *demangler; ///< Demangler of the language of the object, NULL when demangling is disabled
+	RzDemanglerFlag demangler_flags; ///< Flags used to demangle the object
+	bool demangle_pending; ///< True until rz_bin_object_process_pending() demangles the object
 	RZ_DEPRECATE RZ_BORROW Sdb *kv; ///< deprecated, put info in C structures instead of this (holds a copy of another pointer.)
 	void *bin_obj; // internal pointer used by formats
 } RzBinObject;
@@ -967,6 +970,7 @@ static inline bool rz_bin_file_rclass_is(RzBinFile *bf, const char *x) {
 
 // binobject functions
 RZ_API bool rz_bin_object_process_plugin_data(RZ_NONNULL RzBinFile *bf, RZ_NONNULL RzBinObject *o);
+RZ_API void rz_bin_object_process_pending(RZ_NONNULL RzBinObject *o);
 RZ_API ut64 rz_bin_object_addr_with_base(RzBinObject *o, ut64 addr);
 RZ_API ut64 rz_bin_object_get_vaddr(RzBinObject *o, ut64 paddr, ut64 vaddr);
 RZ_API const RzBinAddr *rz_bin_object_get_special_symbol(RzBinObject *o, RzBinSpecialSymbol sym);
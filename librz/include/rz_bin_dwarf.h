@@ -1074,11 +1074,21 @@ typedef struct {
 	ut64 sibling;
 } RzBinDwarfDie;
 
+/// Private storage of the DIEs of a unit
+typedef struct rz_bin_dwarf_unit_dies_t RzBinDwarfUnitDies;
+
+/**
+ * \brief A compilation unit of .debug_info
+ *
+ * Only the header and the unit DIE are read when the section is loaded.
+ * The other DIEs are decoded on demand: get them with rz_bin_dwarf_unit_dies()
+ * and look one up by offset with rz_bin_dwarf_die_at().
+ */
 typedef struct rz_bin_dwarf_comp_unit_t {
 	ut64 offset;
 	ut64 index;
 	RzBinDwarfCompUnitHdr hdr;
-	RzVector /*<RzBinDwarfDie>*/ dies;
+	RzBinDwarfUnitDies *dies; ///< Private, see rz_bin_dwarf_unit_dies()
 	const char *name;
 	const char *comp_dir;
 	const char *producer;
@@ -1093,12 +1103,17 @@ typedef struct rz_bin_dwarf_comp_unit_t {
 	ut64 rnglists_base;
 } RzBinDwarfCompUnit;
 
+/**
+ * \brief Content of .debug_info
+ *
+ * There is no table of all the DIEs: they are decoded per unit on demand,
+ * see rz_bin_dwarf_unit_dies() and rz_bin_dwarf_die_at().
+ */
 typedef struct {
 	RzBinEndianReader *R;
 	RzVector /*<RzBinDwarfCompUnit>*/ units;
-	HtUP /*<ut64, DwarfDie *>*/ *die_by_offset;
 	HtUP /*<ut64, RzBinDwarfCompUnit *>*/ *unit_by_offset;
-	size_t die_count;
+	size_t die_count; // number of DIEs currently decoded
 	/**
 	 * Cache mapping from an offset in the debug_line section to a string
 	 * representing the DW_AT_comp_dir attribute of the compilation unit
@@ -1441,6 +1456,7 @@ typedef struct rz_core_bin_dwarf_t {
 	RzBinDwarfStr *str;
 	RzBinDwarfStrOffsets *str_offsets;
 	RzBinDwarfLineStr *line_str;
+	RzThreadNCores max_threads; ///< Threads decoding the units and the line programs (RZ_THREAD_N_CORES_ALL_AVAILABLE by default).
 } RzBinDWARF;
 
 #define DWARF_FIELD_IMPL(T, F) \
@@ -1522,6 +1538,21 @@ RZ_API RZ_OWN RzBinDwarfInfo *rz_bin_dwarf_info_from_file(
 RZ_API void rz_bin_dwarf_info_free(RZ_OWN RZ_NULLABLE RzBinDwarfInfo *info);
 RZ_API RZ_BORROW RzBinDwarfAttr *rz_bin_dwarf_die_get_attr(
 	RZ_BORROW RZ_NONNULL const RzBinDwarfDie *die, DW_AT name);
+RZ_API RZ_BORROW RzVector /*<RzBinDwarfDie>*/ *rz_bin_dwarf_unit_dies(
+	RZ_BORROW RZ_NONNULL RzBinDWARF *dw,
+	RZ_BORROW RZ_NONNULL RzBinDwarfCompUnit *unit);
+RZ_API bool rz_bin_dwarf_units_dies_load(
+	RZ_BORROW RZ_NONNULL RzBinDWARF *dw,
+	RZ_BORROW RZ_NONNULL RzPVector /*<RzBinDwarfCompUnit *>*/ *units);
+RZ_API bool rz_bin_dwarf_unit_dies_loaded(RZ_BORROW RZ_NONNULL const RzBinDwarfCompUnit *unit);
+RZ_API void rz_bin_dwarf_unit_dies_release(
+	RZ_BORROW RZ_NONNULL RzBinDwarfInfo *info,
+	RZ_BORROW RZ_NONNULL RzBinDwarfCompUnit *unit);
+RZ_API void rz_bin_dwarf_info_dies_release(RZ_BORROW RZ_NONNULL RzBinDwarfInfo *info);
+RZ_API RZ_BORROW RzBinDwarfCompUnit *rz_bin_dwarf_unit_at(
+	RZ_BORROW RZ_NONNULL RzBinDwarfInfo *info, ut64 offset);
+RZ_API RZ_BORROW RzBinDwarfDie *rz_bin_dwarf_die_at(
+	RZ_BORROW RZ_NONNULL RzBinDWARF *dw, ut64 offset);
 RZ_API void rz_bin_dwarf_debug_info_dump(
 	RZ_NONNULL RZ_BORROW const RzBinDwarfInfo *info,
 	RZ_NONNULL RZ_BORROW const RzBinDWARF *dw,
@@ -1642,7 +1673,8 @@ typedef struct {
 typedef struct {
 	const RzBinDWARF *dw;
 	const RzBinDwarfCompUnit *unit;
-	const RzBinDwarfDie *fn_die;
+	const RzBinDwarfDie *fn_die; // cleared when the evaluation is left waiting
+	ut64 fn_die_offset; // offset of fn_die, to find it again on resume, UT64_MAX if none
 	RzBinEndianReader bytecode;
 	const RzBinDwarfEncoding *encoding;
 	ut64 *object_address;
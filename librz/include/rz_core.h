@@ -338,6 +338,8 @@ struct rz_core_t {
 	RzList /*<char *>*/ *ropchain;
 	RzCoreSeekHistory seek_history;
 	RzHash *hash;
+	RzHashTree *hash_tree; ///< Chunk digests of the last region hashed by pht
+	ut64 hash_tree_addr; ///< Address of the region of hash_tree
 
 	bool marks_init;
 	ut64 marks[UT8_MAX + 1];
@@ -595,6 +597,7 @@ RZ_API void rz_core_debug_map_print(RzCore *core, ut64 addr, RzCmdStateOutput *s
 
 /* chash.c */
 RZ_API RzCmdStatus rz_core_hash_plugins_print(RZ_NONNULL RZ_BORROW RzHash *hash, RZ_OUT RzCmdStateOutput *state);
+RZ_API RZ_OWN char *rz_core_hash_tree(RZ_NONNULL RzCore *core, RZ_NONNULL const char *algo, ut64 addr, ut64 size, ut64 chunk_size);
 
 /* ccrypto.c */
 RZ_API RzCmdStatus rz_core_crypto_plugins_print(RzCrypto *cry, RzCmdStateOutput *state);
@@ -745,6 +748,12 @@ RZ_API bool rz_core_analysis_continue_until_call(RZ_NONNULL RzCore *core);
 RZ_API bool rz_core_is_debugging(RZ_NONNULL RzCore *core);
 RZ_API void rz_core_perform_auto_analysis(RZ_NONNULL RzCore *core, RzCoreAnalysisType type);
 
+/* analysis_cache.c */
+RZ_API RZ_OWN char *rz_core_analysis_cache_key(RZ_NONNULL RzCore *core, RzCoreAnalysisType type);
+RZ_API RZ_OWN char *rz_core_analysis_cache_path(RZ_NONNULL RzCore *core);
+RZ_API bool rz_core_analysis_cache_save(RZ_NONNULL RzCore *core, RZ_NONNULL const char *dir, RzCoreAnalysisType type);
+RZ_API bool rz_core_analysis_cache_load(RZ_NONNULL RzCore *core, RZ_NONNULL const char *dir, RzCoreAnalysisType type);
+
 RZ_API st64 rz_core_analysis_coverage_count(RZ_NONNULL RzCore *core);
 RZ_API st64 rz_core_analysis_code_count(RZ_NONNULL RzCore *core);
 RZ_API st64 rz_core_analysis_calls_count(RZ_NONNULL RzCore *core);
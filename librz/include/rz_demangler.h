@@ -6,6 +6,9 @@
 #define RZ_DEMANGLER_H
 #include <rz_types.h>
 #include <rz_list.h>
+#include <rz_vector.h>
+#include <rz_th.h>
+#include <rz_util/ht_sp.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,6 +56,7 @@ RZ_API bool rz_demangler_plugin_add(RZ_NONNULL RzDemangler *demangler, RZ_NONNUL
 RZ_API bool rz_demangler_plugin_del(RZ_NONNULL RzDemangler *demangler, RZ_NONNULL RzDemanglerPlugin *plugin);
 RZ_API RZ_BORROW const RzDemanglerPlugin *rz_demangler_plugin_get(RZ_NONNULL RzDemangler *demangler, RZ_NONNULL const char *language);
 RZ_API bool rz_demangler_resolve(RZ_NONNULL RzDemangler *demangler, RZ_NULLABLE const char *symbol, RZ_NONNULL const char *language, RZ_NONNULL RZ_OWN char **output);
+RZ_API RZ_OWN HtSP /*<char *, char *>*/ *rz_demangler_plugin_demangle_batch(RZ_NONNULL const RzDemanglerPlugin *plugin, RZ_NONNULL const RzPVector /*<const char *>*/ *names, RzDemanglerFlag flags, RzThreadNCores max_threads);
 
 #ifdef __cplusplus
 }
@@ -50,6 +50,13 @@ typedef struct rz_hash_cfg_t {
 	RzHash *hash;
 } RzHashCfg;
 
+typedef struct rz_hash_tree_t RzHashTree;
+
+/**
+ * \brief Reads \p len bytes at \p offset of the region hashed by a RzHashTree
+ */
+typedef bool (*RzHashTreeRead)(void *user, ut64 offset, ut8 *buf, ut64 len);
+
 /**
  * \brief Compare plugins by name (via strcmp).
  */
@@ -90,6 +97,17 @@ RZ_API RZ_OWN ut8 *rz_hash_cfg_calculate_small_block(RZ_NONNULL RzHash *rh, RZ_N
 RZ_API RZ_OWN char *rz_hash_cfg_calculate_small_block_string(RZ_NONNULL RzHash *rh, RZ_NONNULL const char *name, RZ_NONNULL const ut8 *buffer, ut64 bsize, RZ_NULLABLE ut32 *size, bool invert);
 RZ_API RZ_OWN char *rz_hash_cfg_randomart(RZ_NONNULL const ut8 *buffer, ut32 length, ut64 address);
 
+RZ_API RZ_OWN RzHashTree *rz_hash_tree_new(RZ_NONNULL RzHash *rh, RZ_NONNULL const char *name, ut64 size, ut64 chunk_size);
+RZ_API void rz_hash_tree_free(RZ_NULLABLE RzHashTree *tree);
+RZ_API RZ_BORROW const char *rz_hash_tree_algorithm(RZ_NONNULL RzHashTree *tree);
+RZ_API ut64 rz_hash_tree_size(RZ_NONNULL RzHashTree *tree);
+RZ_API ut64 rz_hash_tree_chunk_size(RZ_NONNULL RzHashTree *tree);
+RZ_API ut64 rz_hash_tree_dirty_chunks(RZ_NONNULL RzHashTree *tree);
+RZ_API void rz_hash_tree_invalidate(RZ_NONNULL RzHashTree *tree, ut64 offset, ut64 size);
+RZ_API bool rz_hash_tree_update(RZ_NONNULL RzHashTree *tree, RZ_NONNULL RzHashTreeRead read, RZ_NULLABLE void *user);
+RZ_API bool rz_hash_tree_update_buffer(RZ_NONNULL RzHashTree *tree, RZ_NONNULL const ut8 *data);
+RZ_API RZ_BORROW const ut8 *rz_hash_tree_root(RZ_NONNULL RzHashTree *tree, RZ_NULLABLE RzHashSize *size);
+
 RZ_API double rz_hash_ssdeep_compare(RZ_NONNULL const char *hash1, RZ_NONNULL const char *hash2);
 RZ_API RZ_OWN char *rz_hash_ssdeep(RZ_NONNULL const ut8 *input, size_t size);
 RZ_API ut32 rz_hash_xxhash(RZ_NONNULL const ut8 *input, size_t size);
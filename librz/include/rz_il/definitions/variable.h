@@ -7,7 +7,9 @@
 #define RZ_IL_VARIABLE_H
 
 #include <rz_util/rz_bitvector.h>
-#include <rz_util/ht_sp.h>
+#include <rz_util/ht_su.h>
+#include <rz_util/ht_pu.h>
+#include <rz_vector.h>
 #include <rz_il/definitions/value.h>
 
 #ifdef __cplusplus
@@ -25,24 +27,82 @@ typedef struct rz_il_var_t {
 RZ_API RZ_OWN RzILVar *rz_il_variable_new(RZ_NONNULL const char *name, RzILSortPure sort);
 RZ_API void rz_il_variable_free(RZ_NULLABLE RzILVar *var);
 
+/**
+ * \brief Index of a variable inside a RzILVarSet, see rz_il_var_set_resolve()
+ */
+typedef ut32 RzILVarSlot;
+
+#define RZ_IL_VAR_SLOT_INVALID UT32_MAX
+
+/**
+ * \brief Slot of a variable remembered by its user, e.g. an op, see rz_il_var_set_resolve_cached()
+ *
+ * Holds the id of the set the slot was resolved in and the slot itself, so
+ * it can be checked and read at once.
+ */
+typedef ut64 RzILVarSlotCache;
+
+#define RZ_IL_VAR_SLOT_CACHE_INIT 0 ///< no slot resolved yet, no set has id 0
+
+/**
+ * \brief A variable definition together with its contents inside a RzILVarSet
+ */
+typedef struct rz_il_var_set_entry_t {
+	char *name; ///< name the slot belongs to, kept even while no variable of this name exists
+	RzILVar *var; ///< definition or NULL if the variable does not currently exist
+	RzILVal *val; ///< contents or NULL if nothing is bound
+} RzILVarSetEntry;
+
 /**
  * \brief Holds a set of variable definitions and their current contents
  * This is meant only as a low-level container to be used in RzILVM.
+ *
+ * Every name used in the set gets a dense integer slot, which stays valid
+ * until rz_il_var_set_reset() drops the slots of a set holding too many names.
+ * The set then gets a new id, so slots cached with rz_il_var_set_resolve_cached()
+ * are resolved again. Resolving a name to a slot once and accessing the
+ * variable by slot afterwards avoids hashing the name on every access.
  */
 typedef struct rz_il_var_set_t {
-	HtSP /*<char *, RzILVar *>*/ *vars;
-	HtSP /*<char *, RzILVal *>*/ *contents;
+	RzVector /*<RzILVarSetEntry>*/ entries; ///< all variables and their contents, indexed by slot
+	HtSU /*<char *, RzILVarSlot>*/ *slot_of_name; ///< name -> slot
+	HtPU /*<const char *, RzILVarSlot>*/ *slot_of_ptr; ///< name strings resolved before -> slot, verified on lookup
+	ut32 id; ///< unique among all the sets, changed when the slots are dropped
 } RzILVarSet;
 
 RZ_API bool rz_il_var_set_init(RzILVarSet *vs);
 RZ_API void rz_il_var_set_fini(RzILVarSet *vs);
 RZ_API void rz_il_var_set_reset(RzILVarSet *vs);
+RZ_API RzILVarSlot rz_il_var_set_resolve(RzILVarSet *vs, const char *name, bool create);
 RZ_API RZ_BORROW RzILVar *rz_il_var_set_create_var(RzILVarSet *vs, const char *name, RzILSortPure sort);
+RZ_API RZ_BORROW RzILVar *rz_il_var_set_create_var_at(RzILVarSet *vs, RzILVarSlot slot, RzILSortPure sort);
 RZ_API RZ_OWN RZ_NULLABLE RzILVal *rz_il_var_set_remove_var(RzILVarSet *vs, const char *name);
+RZ_API RZ_OWN RZ_NULLABLE RzILVal *rz_il_var_set_remove_var_at(RzILVarSet *vs, RzILVarSlot slot);
 RZ_API bool rz_il_var_set_bind(RzILVarSet *vs, const char *name, RZ_OWN RzILVal *val);
+RZ_API bool rz_il_var_set_bind_at(RzILVarSet *vs, RzILVarSlot slot, RZ_OWN RzILVal *val);
 RZ_API RZ_BORROW RzILVar *rz_il_var_set_get(RzILVarSet *vs, const char *name);
+RZ_API RZ_BORROW RzILVar *rz_il_var_set_get_at(RzILVarSet *vs, RzILVarSlot slot);
 RZ_API RZ_OWN RzPVector /*<RzILVar *>*/ *rz_il_var_set_get_all(RzILVarSet *vs);
 RZ_API RZ_BORROW RzILVal *rz_il_var_set_get_value(RzILVarSet *vs, const char *name);
+RZ_API RZ_BORROW RzILVal *rz_il_var_set_get_value_at(RzILVarSet *vs, RzILVarSlot slot);
+
+/**
+ * \brief Get the slot of \p name, using the one in \p cache if it was resolved in \p vs
+ *
+ * \p cache must always be used with the same name, it is updated on every new resolution.
+ * \see rz_il_var_set_resolve
+ */
+static inline RzILVarSlot rz_il_var_set_resolve_cached(RzILVarSet *vs, const char *name, RzILVarSlotCache *cache, bool create) {
+	RzILVarSlotCache c = *cache;
+	if ((ut32)(c >> 32) == vs->id) {
+		return (RzILVarSlot)c;
+	}
+	RzILVarSlot slot = rz_il_var_set_resolve(vs, name, create);
+	if (slot != RZ_IL_VAR_SLOT_INVALID) {
+		*cache = ((ut64)vs->id << 32) | slot;
+	}
+	return slot;
+}
 
 typedef enum {
 	RZ_IL_VAR_KIND_GLOBAL, ///< global var, usually bound to a physical representation like a register.
@@ -169,6 +169,7 @@ typedef struct rz_il_op_args_set_t {
 	const char *v; ///< name of variable, const one
 	bool is_local; ///< whether a global variable should be set or a local optionally created and set
 	RzILOpPure *x; ///< value to set the variable to
+	RzILVarSlotCache slot; ///< slot of v, filled in on evaluation
 } RzILOpArgsSet;
 
 /**
@@ -180,6 +181,7 @@ typedef struct rz_il_op_args_let_t {
 	const char *name; ///< name of variable
 	RzILOpPure *exp; ///< value/expression to bind the variable to
 	RzILOpPure *body; ///< body in which the variable will be bound and that produces the result
+	RzILVarSlotCache slot; ///< slot of name, filled in on evaluation
 } RzILOpArgsLet;
 
 /**
@@ -261,6 +263,7 @@ typedef struct rz_il_op_args_ite_t {
 typedef struct rz_il_op_args_var_t {
 	const char *v; ///< name of variable, const one
 	RzILVarKind kind; ///< set of variables to pick from
+	RzILVarSlotCache slot; ///< slot of v, filled in on evaluation
 } RzILOpArgsVar;
 
 /**
@@ -32,6 +32,24 @@ typedef bool (*RzILOpEffectHandler)(RzILVM *vm, RzILOpEffect *op);
 
 typedef void (*RzILVmHook)(RzILVM *vm, RzILOpEffect *op);
 
+/**
+ * \brief An effect flattened into a form that can be evaluated faster, see rz_il_compile_effect()
+ */
+typedef struct rz_il_compiled_effect_t RzILCompiledEffect;
+
+/**
+ * \brief Free lists of temporary values created during evaluation
+ *
+ * Bitvectors of at most 64 bits and bools that are no longer needed are
+ * kept here instead of being freed, so evaluating an op can reuse them
+ * instead of going through malloc/free for every intermediate value.
+ */
+typedef struct rz_il_vm_pool_t {
+	RzPVector /*<RzBitVector *>*/ bvs; ///< unused bitvectors, their contents are undefined
+	RzPVector /*<RzILBool *>*/ bools; ///< unused bools
+	ut64 allocs; ///< number of temporaries that had to be allocated because the pool was empty
+} RzILVMPool;
+
 /**
  * \brief Low-level VM to execute raw IL code
  */
@@ -49,6 +67,7 @@ struct rz_il_vm_t {
 	RzILOpEffectHandler *op_handler_effect_table; ///< Array of Handler, handler can be indexed by opcode
 	RzPVector /*<RzILEvent *>*/ *events; ///< List of events that has happened in the last step
 	bool big_endian; ///< Sets the endianness of the memory reads/writes operations
+	RzILVMPool pool; ///< Recycled temporaries, see rz_il_vm_bv_new() and rz_il_vm_bool_new()
 };
 
 // VM high level operations
@@ -59,6 +78,13 @@ RZ_API void rz_il_vm_fini(RzILVM *vm);
 
 RZ_API ut32 rz_il_vm_get_pc_len(RzILVM *vm);
 
+// Temporaries
+RZ_API RZ_OWN RzBitVector *rz_il_vm_bv_new(RZ_NONNULL RzILVM *vm, ut32 length);
+RZ_API RZ_OWN RzBitVector *rz_il_vm_bv_dup(RZ_NONNULL RzILVM *vm, RZ_NONNULL const RzBitVector *bv);
+RZ_API void rz_il_vm_bv_free(RZ_NONNULL RzILVM *vm, RZ_NULLABLE RZ_OWN RzBitVector *bv);
+RZ_API RZ_OWN RzILBool *rz_il_vm_bool_new(RZ_NONNULL RzILVM *vm, bool b);
+RZ_API void rz_il_vm_bool_free(RZ_NONNULL RzILVM *vm, RZ_NULLABLE RZ_OWN RzILBool *b);
+
 // VM Event operations
 RZ_API void rz_il_vm_event_add(RzILVM *vm, RzILEvent *evt);
 RZ_API void rz_il_vm_clear_events(RzILVM *vm);
@@ -84,9 +110,13 @@ RZ_API RZ_BORROW RzILEffectLabel *rz_il_vm_update_label(RZ_NONNULL RzILVM *vm, R
 RZ_API RZ_BORROW RzILVar *rz_il_vm_create_global_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char *name, RzILSortPure sort);
 RZ_API void rz_il_vm_set_global_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char *name, RZ_OWN RzILVal *val);
 RZ_API void rz_il_vm_set_local_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char *name, RZ_OWN RzILVal *val);
+RZ_API void rz_il_vm_set_local_var_at(RZ_NONNULL RzILVM *vm, RzILVarSlot slot, RZ_OWN RzILVal *val);
 typedef RZ_NULLABLE RzILVal *RzILLocalPurePrev;
 RZ_API RzILLocalPurePrev rz_il_vm_push_local_pure_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char *name, RzILVal *val);
+RZ_API RzILLocalPurePrev rz_il_vm_push_local_pure_var_at(RZ_NONNULL RzILVM *vm, RzILVarSlot slot, RzILVal *val);
 RZ_API void rz_il_vm_pop_local_pure_var(RZ_NONNULL RzILVM *vm, RZ_NONNULL const char *name, RzILLocalPurePrev prev);
+RZ_API void rz_il_vm_pop_local_pure_var_at(RZ_NONNULL RzILVM *vm, RzILVarSlot slot, RzILLocalPurePrev prev);
+RZ_API RZ_BORROW RzILVarSet *rz_il_vm_get_var_set(RZ_NONNULL RzILVM *vm, RzILVarKind kind);
 RZ_API RZ_BORROW RzILVar *rz_il_vm_get_var(RZ_NONNULL RzILVM *vm, RzILVarKind kind, const char *name);
 RZ_API RZ_OWN RzPVector /*<RzILVar *>*/ *rz_il_vm_get_all_vars(RZ_NONNULL RzILVM *vm, RzILVarKind kind);
 RZ_API RZ_BORROW RzILVal *rz_il_vm_get_var_value(RZ_NONNULL RzILVM *vm, RzILVarKind kind, const char *name);
@@ -101,6 +131,12 @@ RZ_API bool rz_il_evaluate_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILOpEffect
 
 RZ_API bool rz_il_vm_step(RzILVM *vm, RzILOpEffect *op, ut64 fallthrough_addr);
 
+// Compiled evaluation
+RZ_API RZ_OWN RzILCompiledEffect *rz_il_compile_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL RZ_BORROW RzILOpEffect *op);
+RZ_API void rz_il_compiled_effect_free(RZ_NULLABLE RzILCompiledEffect *ce);
+RZ_API bool rz_il_evaluate_compiled_effect(RZ_NONNULL RzILVM *vm, RZ_NONNULL RzILCompiledEffect *ce);
+RZ_API bool rz_il_vm_step_compiled(RzILVM *vm, RzILCompiledEffect *ce, ut64 fallthrough_addr);
+
 #ifdef __cplusplus
 }
 #endif
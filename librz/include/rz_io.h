@@ -56,6 +56,28 @@ extern "C" {
 
 RZ_LIB_VERSION_HEADER(rz_io);
 
+#define RZ_IO_PAGE_CACHE_PAGE_SIZE 0x1000
+
+typedef struct rz_io_page_t RzIOPage;
+
+/**
+ * \brief Size-bounded read cache of desc pages, keyed by (fd, page)
+ *
+ * Sits below the map resolution, so every virtual address mapped to the
+ * same desc page shares the same cached bytes. Disabled when max_pages is 0.
+ */
+typedef struct rz_io_page_cache_t {
+	HtUP /*<int, HtUP<ut64, RzIOPage *> *>*/ *descs; ///< fd -> (page index -> page)
+	HtUP /*<int, RzIODesc *>*/ *static_descs; ///< fd -> the desc if its content only changes through RzIO, NULL otherwise
+	RzThreadLock *lock; ///< taken by every page cache function
+	RzIOPage *lru_head; ///< most recently used page
+	RzIOPage *lru_tail; ///< least recently used page, evicted first
+	size_t n_pages; ///< number of pages currently cached
+	size_t max_pages; ///< maximum number of cached pages (0 means disabled)
+	ut64 hits; ///< page lookups served from the cache
+	ut64 misses; ///< pages that had to be read from the desc
+} RzIOPageCache;
+
 typedef struct rz_io_t {
 	struct rz_io_desc_t *desc; // XXX deprecate... we should use only the fd integer, not hold a weak pointer
 	ut64 off;
@@ -73,8 +95,13 @@ typedef struct rz_io_t {
 	RzPVector /*<RzIOMap *>*/ maps; // from tail backwards maps with higher priority are found
 	RzSkyline map_skyline; // map parts that are not covered by others
 	RzIDStorage *files;
-	RzPVector /*<RzIOCache *>*/ cache;
-	RzSkyline cache_skyline;
+	RzPVector /*<RzIOCache *>*/ cache; ///< cached writes, oldest first
+	RzIntervalTree /*<RzIOCache *>*/ cache_index; ///< cached writes by range
+	RBTree /*<RzIOCachePage>*/ cache_pages; ///< bytes visible through the cached writes, sorted by address
+	size_t cache_pages_count; ///< number of pages in cache_pages
+	ut64 cache_seq; ///< seq of the next cached write
+	RzVector /*<ut64>*/ cache_stack; ///< cache_seq saved by each rz_io_cache_push()
+	RzIOPageCache page_cache;
 	ut8 *write_mask;
 	int write_mask_len;
 	HtSP /*<RzIOPlugin *>*/ *plugins;
@@ -140,6 +167,7 @@ typedef struct rz_io_plugin_t {
 	int (*create)(RzIO *io, const char *file, int mode, int type);
 	bool (*check)(RzIO *io, const char *, bool many);
 	ut8 *(*get_buf)(RzIODesc *desc, ut64 *size);
+	const ut8 *(*borrow)(RzIODesc *desc, ut64 paddr, size_t len); ///< Pointer to the bytes at paddr, without copying them
 } RzIOPlugin;
 
 typedef struct rz_io_map_t {
@@ -163,7 +191,9 @@ typedef struct rz_io_cache_t {
 	RzInterval itv;
 	ut8 *data;
 	ut8 *odata;
+	ut8 *udata; ///< bytes of the IO overwritten when data was committed
 	int written;
+	ut64 seq; ///< order of the write, newer writes have higher values
 } RzIOCache;
 
 #define RZ_IO_DESC_CACHE_SIZE (sizeof(ut64) * 8)
@@ -173,9 +203,10 @@ typedef struct rz_io_desc_cache_t {
 } RzIODescCache;
 
 typedef struct rz_event_io_write_t {
-	ut64 addr;
-	const ut8 *buf;
+	ut64 addr; ///< offset in the desc fd, or address of the io cache when fd is -1
+	const ut8 *buf; ///< written bytes, NULL when cached writes were dropped
 	size_t len;
+	int fd;
 } RzEventIOWrite;
 
 typedef struct rz_event_io_desc_close_t {
@@ -186,6 +217,10 @@ typedef struct rz_event_io_map_del_t {
 	RzIOMap *map;
 } RzEventIOMapDel;
 
+typedef struct rz_event_io_maps_update_t {
+	RzIOMap *map; ///< the added or raised map, NULL if any address may resolve differently
+} RzEventIOMapsUpdate;
+
 struct rz_io_bind_t;
 
 typedef int (*RzIOGetCurrentFd)(RzIO *io);
@@ -341,6 +376,7 @@ RZ_API bool rz_io_vread_at_mapped(RzIO *io, ut64 vaddr, ut8 *buf, size_t len);
 RZ_API bool rz_io_read_at(RzIO *io, ut64 addr, ut8 *buf, size_t len);
 RZ_API bool rz_io_read_at_mapped(RzIO *io, ut64 addr, ut8 *buf, size_t len);
 RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, size_t len);
+RZ_API RZ_BORROW const ut8 *rz_io_borrow_at(RZ_NONNULL RzIO *io, ut64 addr, size_t len);
 RZ_API bool rz_io_write_at(RzIO *io, ut64 addr, const ut8 *buf, size_t len);
 RZ_API bool rz_io_read(RzIO *io, ut8 *buf, size_t len);
 RZ_API bool rz_io_write(RzIO *io, const ut8 *buf, size_t len);
@@ -382,6 +418,7 @@ RZ_API ut64 rz_io_desc_seek(RzIODesc *desc, ut64 offset, int whence);
 RZ_API bool rz_io_desc_resize(RzIODesc *desc, ut64 newsize);
 RZ_API ut64 rz_io_desc_size(RzIODesc *desc);
 RZ_API ut8 *rz_io_desc_get_buf(RzIODesc *desc, RZ_OUT RZ_NONNULL ut64 *size);
+RZ_API RZ_BORROW const ut8 *rz_io_desc_borrow_at(RZ_NONNULL RzIODesc *desc, ut64 paddr, size_t len);
 RZ_API bool rz_io_desc_is_blockdevice(RzIODesc *desc);
 RZ_API bool rz_io_desc_is_chardevice(RzIODesc *desc);
 RZ_API bool rz_io_desc_exchange(RzIO *io, int fd, int fdx); // this should get 2 descs
@@ -396,7 +433,7 @@ RZ_API int rz_io_desc_write_at(RzIODesc *desc, ut64 addr, const ut8 *buf, size_t
 RZ_IPI bool rz_io_desc_init(RzIO *io);
 RZ_IPI bool rz_io_desc_fini(RzIO *io);
 
-/* io/cache.c */
+/* io/io_cache.c */
 RZ_API int rz_io_cache_invalidate(RzIO *io, ut64 from, ut64 to);
 RZ_API bool rz_io_cache_at(RzIO *io, ut64 addr);
 RZ_API void rz_io_cache_commit(RzIO *io, ut64 from, ut64 to);
@@ -405,6 +442,17 @@ RZ_API void rz_io_cache_fini(RzIO *io);
 RZ_API void rz_io_cache_reset(RzIO *io, int set);
 RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, size_t len);
 RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, size_t len);
+RZ_API bool rz_io_cache_push(RZ_NONNULL RzIO *io);
+RZ_API bool rz_io_cache_pop(RZ_NONNULL RzIO *io);
+
+/* io/io_page_cache.c */
+RZ_API void rz_io_page_cache_init(RZ_NONNULL RzIO *io);
+RZ_API void rz_io_page_cache_fini(RZ_NONNULL RzIO *io);
+RZ_API void rz_io_page_cache_set_size(RZ_NONNULL RzIO *io, size_t max_pages);
+RZ_API void rz_io_page_cache_reset(RZ_NONNULL RzIO *io);
+RZ_API void rz_io_page_cache_invalidate(RZ_NONNULL RzIO *io, int fd, ut64 paddr, ut64 len);
+RZ_API void rz_io_page_cache_invalidate_fd(RZ_NONNULL RzIO *io, int fd);
+RZ_API int rz_io_page_cache_read(RZ_NONNULL RzIODesc *desc, ut64 paddr, RZ_NONNULL RZ_OUT ut8 *buf, size_t len);
 
 /* io/p_cache.c */
 RZ_API bool rz_io_desc_cache_init(RzIODesc *desc);
@@ -157,6 +157,7 @@ typedef struct rz_reg_t {
 	int size;
 	bool is_thumb;
 	bool big_endian;
+	ut32 items_gen; ///< Changes whenever the items are freed or the role names change, so that kept RzRegItem pointers can be checked
 } RzReg;
 
 typedef struct rz_reg_flags_t {
@@ -51,6 +51,8 @@ typedef struct rz_search_hit_t {
 
 typedef int (*RzSearchCallback)(RzSearchKeyword *kw, void *user, ut64 where);
 
+typedef struct rz_search_matcher_t RzSearchMatcher;
+
 typedef struct rz_search_t {
 	int n_kws; // hit${n_kws}_${count}
 	int mode;
@@ -70,6 +72,7 @@ typedef struct rz_search_t {
 	int align;
 	int (*update)(struct rz_search_t *s, ut64 from, const ut8 *buf, int len);
 	RzList /*<RzSearchKeyword *>*/ *kws; // TODO: Use rz_search_kw_new ()
+	RzSearchMatcher *matcher; // multi-pattern prefilter of kws, built on first use
 	RzIOBind iob;
 	char bckwrds;
 } RzSearch;
@@ -99,6 +102,9 @@ RZ_API int rz_search_kw_add(RzSearch *s, RzSearchKeyword *kw);
 RZ_API void rz_search_reset(RzSearch *s, int mode);
 RZ_API void rz_search_kw_reset(RzSearch *s);
 RZ_API void rz_search_string_prepare_backward(RzSearch *s);
+RZ_API bool rz_search_kw_prepare(RZ_NONNULL RzSearch *s);
+RZ_API bool rz_search_kw_scan(RZ_NONNULL RzSearch *s, RZ_NONNULL const ut8 *buf, int len, RZ_NONNULL RZ_OUT RzVector /*<ut32>*/ *matches);
+RZ_API int rz_search_kw_update_scanned(RZ_NONNULL RzSearch *s, ut64 from, RZ_NONNULL const ut8 *buf, int len, RZ_NONNULL RzVector /*<ut32>*/ *matches);
 
 // TODO: is this an internal API?
 RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len);
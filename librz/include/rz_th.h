@@ -33,8 +33,11 @@ typedef struct rz_th_cond_t RzThreadCond;
 typedef struct rz_th_t RzThread;
 typedef struct rz_th_pool_t RzThreadPool;
 typedef struct rz_th_queue_t RzThreadQueue;
+typedef struct rz_th_scheduler_t RzThreadScheduler;
+typedef struct rz_th_task_group_t RzThreadTaskGroup;
 typedef void *(*RzThreadFunction)(void *user);
 typedef void (*RzThreadIterator)(void *element, void *user);
+typedef void (*RzThreadTask)(void *user);
 
 typedef struct rz_atomic_bool_t RzAtomicBool;
 
@@ -88,6 +91,16 @@ RZ_API bool rz_th_queue_is_empty(RZ_NONNULL RzThreadQueue *queue);
 RZ_API bool rz_th_queue_is_full(RZ_NONNULL RzThreadQueue *queue);
 RZ_API size_t rz_th_queue_size(RZ_NONNULL RzThreadQueue *queue);
 
+RZ_API RZ_OWN RzThreadScheduler *rz_th_scheduler_new(RzThreadNCores max_threads);
+RZ_API void rz_th_scheduler_free(RZ_NULLABLE RzThreadScheduler *sched);
+RZ_API size_t rz_th_scheduler_size(RZ_NONNULL RzThreadScheduler *sched);
+RZ_API RZ_OWN RzThreadTaskGroup *rz_th_task_group_new(RZ_NONNULL RzThreadScheduler *sched);
+RZ_API void rz_th_task_group_free(RZ_NULLABLE RzThreadTaskGroup *group);
+RZ_API bool rz_th_task_group_submit(RZ_NONNULL RzThreadTaskGroup *group, RZ_NONNULL RzThreadTask task, RZ_NULLABLE void *user);
+RZ_API bool rz_th_task_group_wait(RZ_NONNULL RzThreadTaskGroup *group);
+RZ_API void rz_th_task_group_cancel(RZ_NONNULL RzThreadTaskGroup *group);
+RZ_API bool rz_th_task_group_is_cancelled(RZ_NONNULL RzThreadTaskGroup *group);
+
 RZ_API RZ_OWN RzAtomicBool *rz_atomic_bool_new(bool value);
 RZ_API void rz_atomic_bool_free(RZ_NULLABLE RzAtomicBool *tbool);
 RZ_API bool rz_atomic_bool_get(RZ_NONNULL RzAtomicBool *tbool);
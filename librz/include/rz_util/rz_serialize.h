@@ -6,6 +6,7 @@
 
 #include <rz_util/rz_json.h>
 #include <rz_util/ht_sp.h>
+#include <rz_util/rz_buf.h>
 #include <rz_list.h>
 
 /**
@@ -135,4 +136,31 @@ static inline void rz_key_parser_add(RzKeyParser *parser, const char *key, int v
 		rip \
 	}
 
+/**
+ * \brief Description of one field of a serialized struct
+ *
+ * Tables of these describe the fields of a struct together with their
+ * keys in the json of the project serializers. Fields of a fixed size
+ * can additionally be written and read as binary records, with their
+ * offsets and sizes taken from the struct itself.
+ */
+typedef struct rz_serialize_field_t {
+	const char *key; ///< key of the field in the json
+	size_t offset; ///< offset of the field in the struct
+	size_t size; ///< size of the field in bytes, 0 if it has no fixed size and is (de)serialized separately
+	bool is_bool; ///< the field is a bool, which is read back as 0 or 1 only
+} RzSerializeField;
+
+#define RZ_SERIALIZE_FIELD(type, field, key) \
+	{ key, offsetof(type, field), sizeof(((type *)NULL)->field), false }
+#define RZ_SERIALIZE_FIELD_BOOL(type, field, key) \
+	{ key, offsetof(type, field), sizeof(((type *)NULL)->field), true }
+#define RZ_SERIALIZE_FIELD_VARIABLE(key) \
+	{ key, 0, 0, false }
+
+RZ_API void rz_serialize_fields_key_parser_add(RZ_NONNULL RzKeyParser *parser, RZ_NONNULL const RzSerializeField *fields, size_t count);
+RZ_API ut64 rz_serialize_fields_size(RZ_NONNULL const RzSerializeField *fields, size_t count);
+RZ_API bool rz_serialize_fields_write(RZ_NONNULL RzBuffer *b, RZ_NONNULL const void *obj, RZ_NONNULL const RzSerializeField *fields, size_t count);
+RZ_API bool rz_serialize_fields_read(RZ_NONNULL RzBuffer *b, RZ_NONNULL void *obj, RZ_NONNULL const RzSerializeField *fields, size_t count);
+
 #endif // RZ_SERIALIZE_H
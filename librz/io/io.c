@@ -115,6 +115,7 @@ RZ_API RzIO *rz_io_init(RzIO *io) {
 	rz_skyline_init(&io->map_skyline);
 	rz_io_map_init(io);
 	rz_io_cache_init(io);
+	rz_io_page_cache_init(io);
 	rz_io_plugin_init(io);
 	io->event = rz_event_new(io);
 	return io;
@@ -268,7 +269,10 @@ RZ_API int rz_io_pread_at(RzIO *io, ut64 paddr, ut8 *buf, size_t len) {
 	if (io->ff) {
 		memset(buf, io->Oxff, len);
 	}
-	return rz_io_desc_read_at(io->desc, paddr, buf, len);
+	if (!io->desc) {
+		return 0;
+	}
+	return rz_io_page_cache_read(io->desc, paddr, buf, len);
 }
 
 RZ_API int rz_io_pwrite_at(RzIO *io, ut64 paddr, const ut8 *buf, size_t len) {
@@ -352,6 +356,43 @@ RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, size_t len) {
 	return ret;
 }
 
+/**
+ * \brief Returns a pointer to the \p len bytes at \p addr, without copying them
+ *
+ * This is a fast path for callers that only need to look at the bytes (e.g.
+ * hashing or scanning large local files). It only succeeds if the whole range
+ * is backed by a single desc able to lend its memory (see
+ * rz_io_desc_borrow_at()) and no cached write overlays it. The pointer is valid
+ * until the next write, resize, map change or close.
+ *
+ * \return the bytes, or NULL if the caller has to fall back to rz_io_read_at()
+ */
+RZ_API RZ_BORROW const ut8 *rz_io_borrow_at(RZ_NONNULL RzIO *io, ut64 addr, size_t len) {
+	rz_return_val_if_fail(io, NULL);
+	if (!len || UT64_ADD_OVFCHK(addr, len - 1)) {
+		return NULL;
+	}
+	if ((io->cached & RZ_PERM_R) && io_cache_overlaps(io, addr, len)) {
+		return NULL;
+	}
+	if (!io->va) {
+		return io->desc ? rz_io_desc_borrow_at(io->desc, addr, len) : NULL;
+	}
+	const RzSkylineItem *part = rz_skyline_get_item(&io->map_skyline, addr);
+	if (!part || !rz_itv_contain(part->itv, addr + len - 1)) {
+		return NULL;
+	}
+	RzIOMap *map = part->user;
+	if (!(map->perm & RZ_PERM_R)) {
+		return NULL;
+	}
+	RzIODesc *desc = rz_io_desc_get(io, map->fd);
+	if (!desc) {
+		return NULL;
+	}
+	return rz_io_desc_borrow_at(desc, addr - map->itv.addr + map->delta, len);
+}
+
 /**
  * \brief Writes \p len bytes of data from \p buf to \p addr into the given \p io.
  *
@@ -733,6 +774,7 @@ RZ_API int rz_io_fini(RzIO *io) {
 	rz_io_desc_cache_fini_all(io);
 	rz_io_desc_fini(io);
 	rz_io_map_fini(io);
+	rz_io_page_cache_fini(io);
 	ht_sp_free(io->plugins);
 	rz_io_cache_fini(io);
 	if (io->runprofile) {
@@ -1,8 +1,28 @@
 // SPDX-FileCopyrightText: 2008-2020 pancake <pancake@nopcode.org>
 // SPDX-License-Identifier: LGPL-3.0-only
 
+/** \file io_cache.c
+ * Write cache used by io.cache.
+ *
+ * Every cached write is kept in io->cache, oldest first, together with the
+ * bytes it replaced, and indexed by its range in io->cache_index so that
+ * commits and invalidations only visit the writes of their range.
+ *
+ * The bytes left visible by the writes are kept in pages of
+ * RZ_IO_CACHE_PAGE_SIZE bytes sorted by address in io->cache_pages, so that
+ * reads are O(log n) in the number of dirty pages whatever the number of
+ * writes. Dropping a write replays the older writes it was hiding.
+ */
+
 #include <rz_io.h>
-#include <rz_skyline.h>
+#include "io_private.h"
+
+#define PAGE_MASK    ((ut64)RZ_IO_CACHE_PAGE_SIZE - 1)
+#define PAGE_ADDR(x) ((x) & ~PAGE_MASK)
+
+#define BIT_GET(bits, i) ((bits)[(i) >> 3] & (1 << ((i)&7)))
+#define BIT_SET(bits, i) ((bits)[(i) >> 3] |= (1 << ((i)&7)))
+#define BIT_CLR(bits, i) ((bits)[(i) >> 3] &= ~(1 << ((i)&7)))
 
 static void cache_item_free(RzIOCache *cache) {
 	if (!cache) {
@@ -10,127 +30,452 @@ static void cache_item_free(RzIOCache *cache) {
 	}
 	free(cache->data);
 	free(cache->odata);
+	free(cache->udata);
 	free(cache);
 }
 
+static int page_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	ut64 addr = *(const ut64 *)incoming;
+	const RzIOCachePage *page = container_of(in_tree, const RzIOCachePage, rb);
+	if (addr < page->addr) {
+		return -1;
+	}
+	return addr > page->addr ? 1 : 0;
+}
+
+static void page_free(RBNode *node, void *user) {
+	free(container_of(node, RzIOCachePage, rb));
+}
+
+static RzIOCachePage *page_find(RzIO *io, ut64 addr) {
+	ut64 key = PAGE_ADDR(addr);
+	RBNode *node = rz_rbtree_find(io->cache_pages, &key, page_cmp, NULL);
+	return node ? container_of(node, RzIOCachePage, rb) : NULL;
+}
+
+static RzIOCachePage *page_get(RzIO *io, ut64 addr) {
+	RzIOCachePage *page = page_find(io, addr);
+	if (page) {
+		return page;
+	}
+	page = RZ_NEW0(RzIOCachePage);
+	if (!page) {
+		return NULL;
+	}
+	page->addr = PAGE_ADDR(addr);
+	rz_rbtree_insert(&io->cache_pages, &page->addr, &page->rb, page_cmp, NULL);
+	io->cache_pages_count++;
+	return page;
+}
+
+static void pages_free(RzIO *io) {
+	rz_rbtree_free(io->cache_pages, page_free, NULL);
+	io->cache_pages = NULL;
+	io->cache_pages_count = 0;
+}
+
+/**
+ * Makes the \p len bytes of \p buf visible at \p addr
+ */
+static bool pages_set(RzIO *io, ut64 addr, const ut8 *buf, ut64 len) {
+	ut64 done = 0;
+	while (done < len) {
+		ut64 cur = addr + done;
+		RzIOCachePage *page = page_get(io, cur);
+		if (!page) {
+			return false;
+		}
+		size_t off = cur & PAGE_MASK;
+		size_t n = RZ_MIN(RZ_IO_CACHE_PAGE_SIZE - off, len - done);
+		memcpy(page->data + off, buf + done, n);
+		for (size_t i = off; i < off + n; i++) {
+			if (!BIT_GET(page->dirty, i)) {
+				BIT_SET(page->dirty, i);
+				page->dirty_count++;
+			}
+		}
+		done += n;
+	}
+	return true;
+}
+
+/**
+ * Hides the bytes of [addr, addr + len), dropping the pages left empty
+ */
+static void pages_clear(RzIO *io, ut64 addr, ut64 len) {
+	const ut64 last = addr + len - 1;
+	ut64 key = PAGE_ADDR(addr);
+	while (true) {
+		RBNode *node = rz_rbtree_lower_bound(io->cache_pages, &key, page_cmp, NULL);
+		if (!node) {
+			break;
+		}
+		RzIOCachePage *page = container_of(node, RzIOCachePage, rb);
+		if (page->addr > last) {
+			break;
+		}
+		size_t from = page->addr < addr ? addr - page->addr : 0;
+		size_t to = RZ_MIN(last - page->addr, PAGE_MASK);
+		for (size_t i = from; i <= to; i++) {
+			if (BIT_GET(page->dirty, i)) {
+				BIT_CLR(page->dirty, i);
+				page->dirty_count--;
+			}
+		}
+		ut64 next = page->addr + RZ_IO_CACHE_PAGE_SIZE;
+		if (!page->dirty_count) {
+			rz_rbtree_delete(&io->cache_pages, &page->addr, page_cmp, NULL, page_free, NULL);
+			io->cache_pages_count--;
+		}
+		if (!next || next > last) {
+			break;
+		}
+		key = next;
+	}
+}
+
+static int seq_cmp(const void *a, const void *b, void *user) {
+	const RzIOCache *ca = a;
+	const RzIOCache *cb = b;
+	if (ca->seq < cb->seq) {
+		return -1;
+	}
+	return ca->seq > cb->seq ? 1 : 0;
+}
+
+typedef struct {
+	RzInterval range;
+	RzPVector /*<RzIOCache *>*/ *out;
+} CollectCtx;
+
+static bool collect_cb(RzIntervalNode *node, void *user) {
+	CollectCtx *ctx = user;
+	RzIOCache *c = node->data;
+	if (rz_itv_overlap(c->itv, ctx->range)) {
+		rz_pvector_push(ctx->out, c);
+	}
+	return true;
+}
+
+/**
+ * Appends to \p out the cached writes overlapping the interval
+ * { from, to - from } as defined by rz_itv_overlap()
+ */
+static void cache_collect(RzIO *io, ut64 from, ut64 to, RzPVector /*<RzIOCache *>*/ *out) {
+	CollectCtx ctx = { { from, to - from }, out };
+	// when the interval wraps, only the writes containing from can overlap it
+	ut64 hi = from;
+	if (from < to) {
+		hi = to - 1;
+	} else if (!to) {
+		hi = UT64_MAX;
+	}
+	rz_interval_tree_all_intersect(&io->cache_index, from, hi, true, collect_cb, &ctx);
+}
+
+/**
+ * Returns the index of the first cached write of io->cache with a seq >= \p seq
+ */
+static size_t cache_lower_bound(RzIO *io, ut64 seq) {
+	size_t lo = 0;
+	size_t hi = rz_pvector_len(&io->cache);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		RzIOCache *c = rz_pvector_at(&io->cache, mid);
+		if (c->seq < seq) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+static int itv_cmp(const void *a, const void *b, void *user) {
+	const RzInterval *ia = a;
+	const RzInterval *ib = b;
+	if (ia->addr < ib->addr) {
+		return -1;
+	}
+	return ia->addr > ib->addr ? 1 : 0;
+}
+
+/**
+ * Makes the bytes of \p c inside the sorted, disjoint intervals of \p holes visible again
+ */
+static void cache_replay(RzIO *io, RzIOCache *c, RzVector /*<RzInterval>*/ *holes) {
+	const ut64 begin = rz_itv_begin(c->itv);
+	const ut64 end = rz_itv_end(c->itv);
+	size_t lo = 0;
+	size_t hi = rz_vector_len(holes);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		RzInterval *hole = rz_vector_index_ptr(holes, mid);
+		if (rz_itv_end(*hole) <= begin) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	for (size_t i = lo; i < rz_vector_len(holes); i++) {
+		RzInterval *hole = rz_vector_index_ptr(holes, i);
+		if (rz_itv_begin(*hole) >= end) {
+			break;
+		}
+		ut64 from = RZ_MAX(begin, rz_itv_begin(*hole));
+		ut64 to = RZ_MIN(end, rz_itv_end(*hole));
+		pages_set(io, from, c->data + (from - begin), to - from);
+	}
+}
+
+/**
+ * Removes the cached writes of \p items, sorted by seq, from the cache
+ *
+ * The bytes of the IO overwritten by the committed writes are written back,
+ * and the older writes that were hidden by the dropped ones become visible.
+ */
+static void cache_drop(RzIO *io, RzPVector /*<RzIOCache *>*/ *items) {
+	if (rz_pvector_empty(items)) {
+		return;
+	}
+	RzVector holes;
+	rz_vector_init(&holes, sizeof(RzInterval), NULL, NULL);
+	const int cached = io->cached;
+	io->cached = 0;
+	void **it;
+	// newest first, so that overlapping writes restore the oldest bytes
+	rz_pvector_foreach_prev(items, it) {
+		RzIOCache *c = *it;
+		if (c->written && c->udata) {
+			rz_io_write_at(io, rz_itv_begin(c->itv), c->udata, rz_itv_size(c->itv));
+			c->written = false;
+		}
+		RzIntervalNode *node = rz_interval_tree_node_at_data(&io->cache_index, rz_itv_begin(c->itv), c);
+		if (node) {
+			rz_interval_tree_delete(&io->cache_index, node, false);
+		}
+		pages_clear(io, rz_itv_begin(c->itv), rz_itv_size(c->itv));
+		rz_vector_push(&holes, &c->itv);
+	}
+	io->cached = cached;
+
+	// both io->cache and items are sorted by seq
+	size_t first = cache_lower_bound(io, ((RzIOCache *)rz_pvector_head(items))->seq);
+	size_t len = first;
+	size_t next = 0;
+	for (size_t i = first; i < rz_pvector_len(&io->cache); i++) {
+		RzIOCache *c = rz_pvector_at(&io->cache, i);
+		if (next < rz_pvector_len(items) && rz_pvector_at(items, next) == c) {
+			cache_item_free(c);
+			next++;
+			continue;
+		}
+		rz_pvector_set(&io->cache, len++, c);
+	}
+	rz_vector_remove_range(&io->cache.v, len, rz_pvector_len(&io->cache) - len, NULL);
+
+	// merge the holes left by the dropped writes
+	rz_vector_sort(&holes, itv_cmp, false, NULL);
+	size_t merged = 0;
+	RzInterval *hole;
+	rz_vector_foreach (&holes, hole) {
+		RzInterval *prev = merged ? rz_vector_index_ptr(&holes, merged - 1) : NULL;
+		if (prev && rz_itv_begin(*hole) <= rz_itv_end(*prev)) {
+			prev->size = RZ_MAX(rz_itv_end(*prev), rz_itv_end(*hole)) - prev->addr;
+			continue;
+		}
+		*(RzInterval *)rz_vector_index_ptr(&holes, merged++) = *hole;
+	}
+	rz_vector_remove_range(&holes, merged, rz_vector_len(&holes) - merged, NULL);
+
+	// replay the remaining writes that overlap the holes, oldest first
+	RzPVector replay;
+	rz_pvector_init(&replay, NULL);
+	rz_vector_foreach (&holes, hole) {
+		cache_collect(io, rz_itv_begin(*hole), rz_itv_end(*hole), &replay);
+	}
+	rz_pvector_sort(&replay, seq_cmp, NULL);
+	RzIOCache *last = NULL;
+	rz_pvector_foreach (&replay, it) {
+		RzIOCache *c = *it;
+		if (c != last) {
+			cache_replay(io, c, &holes);
+		}
+		last = c;
+	}
+	rz_pvector_fini(&replay);
+
+	rz_vector_foreach (&holes, hole) {
+		RzEventIOWrite iow = { rz_itv_begin(*hole), NULL, rz_itv_size(*hole), -1 };
+		rz_event_send(io->event, RZ_EVENT_IO_WRITE, &iow);
+	}
+	rz_vector_fini(&holes);
+}
+
 RZ_API bool rz_io_cache_at(RzIO *io, ut64 addr) {
 	rz_return_val_if_fail(io, false);
-	return rz_skyline_contains(&io->cache_skyline, addr);
+	RzIOCachePage *page = page_find(io, addr);
+	return page && BIT_GET(page->dirty, addr & PAGE_MASK);
 }
 
 RZ_API void rz_io_cache_init(RzIO *io) {
 	rz_return_if_fail(io);
 	rz_pvector_init(&io->cache, (RzPVectorFree)cache_item_free);
-	rz_skyline_init(&io->cache_skyline);
+	rz_interval_tree_init(&io->cache_index, NULL);
+	io->cache_pages = NULL;
+	io->cache_pages_count = 0;
+	io->cache_seq = 0;
+	rz_vector_init(&io->cache_stack, sizeof(ut64), NULL, NULL);
 	io->cached = 0;
 }
 
 RZ_API void rz_io_cache_fini(RzIO *io) {
 	rz_return_if_fail(io);
+	rz_interval_tree_fini(&io->cache_index);
 	rz_pvector_fini(&io->cache);
-	rz_skyline_fini(&io->cache_skyline);
+	pages_free(io);
+	rz_vector_fini(&io->cache_stack);
 	io->cached = 0;
 }
 
+/**
+ * \brief Writes the cached writes overlapping [from, to) to the IO, oldest first
+ *
+ * The writes stay in the cache, marked as written.
+ */
 RZ_API void rz_io_cache_commit(RzIO *io, ut64 from, ut64 to) {
-	void **iter;
-	RzIOCache *c;
-	RzInterval range = (RzInterval){ from, to - from };
 	rz_return_if_fail(io);
-	rz_pvector_foreach (&io->cache, iter) {
-		// if (from <= c->to - 1 && c->from <= to - 1) {
-		c = *iter;
-		if (rz_itv_overlap(c->itv, range)) {
-			int cached = io->cached;
-			io->cached = 0;
-			if (rz_io_write_at(io, rz_itv_begin(c->itv), c->data, rz_itv_size(c->itv))) {
-				c->written = true;
-			} else {
-				eprintf("Error writing change at 0x%08" PFMT64x "\n", rz_itv_begin(c->itv));
-			}
-			io->cached = cached;
-			// break; // XXX old behavior, revisit this
+	RzPVector items;
+	rz_pvector_init(&items, NULL);
+	cache_collect(io, from, to, &items);
+	rz_pvector_sort(&items, seq_cmp, NULL);
+	const int cached = io->cached;
+	const bool cm = io->cachemode;
+	io->cached = 0;
+	io->cachemode = false;
+	void **it;
+	rz_pvector_foreach (&items, it) {
+		RzIOCache *c = *it;
+		const ut64 size = rz_itv_size(c->itv);
+		if (!c->udata && (c->udata = malloc(size))) {
+			memset(c->udata, io->Oxff, size);
+			rz_io_read_at(io, rz_itv_begin(c->itv), c->udata, size);
+		}
+		if (rz_io_write_at(io, rz_itv_begin(c->itv), c->data, size)) {
+			c->written = true;
+		} else {
+			RZ_LOG_ERROR("Error writing change at 0x%08" PFMT64x "\n", rz_itv_begin(c->itv));
+		}
+	}
+	io->cached = cached;
+	io->cachemode = cm;
+	rz_pvector_fini(&items);
+}
+
+/**
+ * Notifies that the bytes of all the cached pages become the ones of the IO again
+ */
+static void pages_drop_notify(RzIO *io) {
+	RzEventIOWrite iow = { 0, NULL, 0, -1 };
+	RBIter it;
+	RzIOCachePage *page;
+	rz_rbtree_foreach (io->cache_pages, it, page, RzIOCachePage, rb) {
+		if (iow.len && iow.addr + iow.len == page->addr) {
+			iow.len += RZ_IO_CACHE_PAGE_SIZE;
+			continue;
+		}
+		if (iow.len) {
+			rz_event_send(io->event, RZ_EVENT_IO_WRITE, &iow);
 		}
+		iow.addr = page->addr;
+		iow.len = RZ_IO_CACHE_PAGE_SIZE;
+	}
+	if (iow.len) {
+		rz_event_send(io->event, RZ_EVENT_IO_WRITE, &iow);
 	}
 }
 
 RZ_API void rz_io_cache_reset(RzIO *io, int set) {
 	rz_return_if_fail(io);
+	pages_drop_notify(io);
 	io->cached = set;
+	rz_interval_tree_fini(&io->cache_index);
+	rz_interval_tree_init(&io->cache_index, NULL);
 	rz_pvector_clear(&io->cache);
-	rz_skyline_clear(&io->cache_skyline);
+	pages_free(io);
+	io->cache_seq = 0;
+	rz_vector_clear(&io->cache_stack);
 }
 
+/**
+ * \brief Drops the cached writes overlapping [from, to)
+ *
+ * The bytes of the IO overwritten by the dropped writes that were committed
+ * are written back. The older writes hidden by the dropped ones become visible
+ * again.
+ *
+ * \return the number of dropped writes
+ */
 RZ_API int rz_io_cache_invalidate(RzIO *io, ut64 from, ut64 to) {
 	rz_return_val_if_fail(io, 0);
-	int invalidated = 0;
-	void **iter;
-	RzIOCache *c;
-	RzInterval range = (RzInterval){ from, to - from };
-	rz_pvector_foreach_prev(&io->cache, iter) {
-		c = *iter;
-		if (rz_itv_overlap(c->itv, range)) {
-			int cached = io->cached;
-			io->cached = 0;
-			rz_io_write_at(io, rz_itv_begin(c->itv), c->odata, rz_itv_size(c->itv));
-			io->cached = cached;
-			c->written = false;
-			rz_pvector_remove_data(&io->cache, c);
-			free(c->data);
-			free(c->odata);
-			free(c);
-			invalidated++;
-		}
-	}
-	rz_skyline_clear(&io->cache_skyline);
-	rz_pvector_foreach (&io->cache, iter) {
-		c = *iter;
-		rz_skyline_add(&io->cache_skyline, c->itv, c);
-	}
+	RzPVector items;
+	rz_pvector_init(&items, NULL);
+	cache_collect(io, from, to, &items);
+	rz_pvector_sort(&items, seq_cmp, NULL);
+	int invalidated = rz_pvector_len(&items);
+	cache_drop(io, &items);
+	rz_pvector_fini(&items);
 	return invalidated;
 }
 
 RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, size_t len) {
 	rz_return_val_if_fail(io && buf, false);
-	RzIOCache *ch = RZ_NEW0(RzIOCache);
-	if (!ch) {
-		return false;
+	if (!len) {
+		return true;
 	}
 	if (UT64_ADD_OVFCHK(addr, len)) {
 		const ut64 first_len = UT64_MAX - addr;
 		rz_io_cache_write(io, 0, buf + first_len, len - first_len);
 		len = first_len;
 	}
-	ch->itv = (RzInterval){ addr, len };
-	ch->odata = (ut8 *)calloc(1, len + 1);
-	if (!ch->odata) {
-		free(ch);
+	RzIOCache *ch = RZ_NEW0(RzIOCache);
+	if (!ch) {
 		return false;
 	}
-	ch->data = (ut8 *)calloc(1, len + 1);
-	if (!ch->data) {
-		free(ch->odata);
-		free(ch);
+	ch->itv = (RzInterval){ addr, len };
+	ch->data = rz_mem_dup(buf, len);
+	ch->odata = malloc(len);
+	if (!ch->data || !ch->odata) {
+		cache_item_free(ch);
 		return false;
 	}
-	ch->written = false;
 	{
 		const bool cm = io->cachemode;
 		io->cachemode = false;
 		rz_io_read_at(io, addr, ch->odata, len);
 		io->cachemode = cm;
 	}
-	memcpy(ch->data, buf, len);
-	rz_pvector_push(&io->cache, ch);
-	rz_skyline_add(&io->cache_skyline, ch->itv, ch);
-	RzEventIOWrite iow = { addr, buf, len };
+	ch->seq = io->cache_seq++;
+	if (!rz_pvector_push(&io->cache, ch)) {
+		cache_item_free(ch);
+		return false;
+	}
+	if (!rz_interval_tree_insert(&io->cache_index, addr, addr + len - 1, ch) ||
+		!pages_set(io, addr, buf, len)) {
+		RzPVector items;
+		rz_pvector_init(&items, NULL);
+		rz_pvector_push(&items, ch);
+		cache_drop(io, &items);
+		rz_pvector_fini(&items);
+		return false;
+	}
+	RzEventIOWrite iow = { addr, buf, len, -1 };
 	rz_event_send(io->event, RZ_EVENT_IO_WRITE, &iow);
 	return true;
 }
 
 RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, size_t len) {
 	rz_return_val_if_fail(io && buf, false);
-	RzSkyline *skyline = &io->cache_skyline;
 	if (!len) {
 		return true;
 	}
@@ -139,31 +484,88 @@ RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, size_t len) {
 		rz_io_cache_read(io, 0, buf + first_len, len - first_len);
 		len = first_len;
 	}
-	const RzSkylineItem *iter = rz_skyline_get_item_intersect(skyline, addr, len);
-	if (!iter) {
+	if (!io->cache_pages) {
 		return false;
 	}
-	const RzSkylineItem *last = (RzSkylineItem *)skyline->v.a + skyline->v.len;
 	bool covered = false;
-	while (iter != last) {
-		const ut64 begin = rz_itv_begin(iter->itv);
-		const st64 addr_offset = begin - addr;
-		const ut64 buf_offset = addr_offset > 0 ? addr_offset : 0;
-		const ut64 cur_addr = addr + buf_offset;
-		const ut64 left = len - buf_offset;
-		if (begin > cur_addr + left) {
+	const ut64 end = addr + len;
+	ut64 key = PAGE_ADDR(addr);
+	RBIter it = rz_rbtree_lower_bound_forward(io->cache_pages, &key, page_cmp, NULL);
+	RzIOCachePage *page;
+	rz_rbtree_iter_while (it, page, RzIOCachePage, rb) {
+		if (page->addr >= end) {
 			break;
 		}
-		RzIOCache *cache = iter->user;
-		const ut64 cache_shift = addr_offset < 0 ? -addr_offset : 0;
-		const ut64 cache_offset = begin - rz_itv_begin(cache->itv) + cache_shift;
-		const ut64 read = RZ_MIN(left, rz_itv_size(iter->itv) - cache_shift);
-		memcpy(buf + buf_offset, cache->data + cache_offset, read);
-		covered = true;
-		if (left - read <= 0) {
-			break;
+		size_t from = page->addr < addr ? addr - page->addr : 0;
+		size_t to = RZ_MIN(end - page->addr, RZ_IO_CACHE_PAGE_SIZE);
+		ut8 *dst = buf + (page->addr + from - addr);
+		if (page->dirty_count == RZ_IO_CACHE_PAGE_SIZE) {
+			memcpy(dst, page->data + from, to - from);
+			covered = true;
+			continue;
+		}
+		for (size_t i = from; i < to; i++, dst++) {
+			if (BIT_GET(page->dirty, i)) {
+				*dst = page->data[i];
+				covered = true;
+			}
 		}
-		iter++;
 	}
 	return covered;
 }
+
+/**
+ * Returns true if any byte of [addr, addr + len) is overlaid by the cache
+ */
+bool io_cache_overlaps(RzIO *io, ut64 addr, size_t len) {
+	if (!len || !io->cache_pages) {
+		return false;
+	}
+	const ut64 last = UT64_ADD_OVFCHK(addr, len - 1) ? UT64_MAX : addr + len - 1;
+	ut64 key = PAGE_ADDR(addr);
+	RBIter it = rz_rbtree_lower_bound_forward(io->cache_pages, &key, page_cmp, NULL);
+	RzIOCachePage *page;
+	rz_rbtree_iter_while (it, page, RzIOCachePage, rb) {
+		if (page->addr > last) {
+			break;
+		}
+		size_t from = page->addr < addr ? addr - page->addr : 0;
+		size_t to = RZ_MIN(last - page->addr, PAGE_MASK);
+		for (size_t i = from; i <= to; i++) {
+			if (BIT_GET(page->dirty, i)) {
+				return true;
+			}
+		}
+	}
+	return addr + len < addr && io_cache_overlaps(io, 0, addr + len);
+}
+
+/**
+ * \brief Saves the current content of the cache
+ *
+ * The writes done until the matching rz_io_cache_pop() are dropped then.
+ */
+RZ_API bool rz_io_cache_push(RZ_NONNULL RzIO *io) {
+	rz_return_val_if_fail(io, false);
+	return rz_vector_push(&io->cache_stack, &io->cache_seq);
+}
+
+/**
+ * \brief Drops the cached writes done since the last rz_io_cache_push()
+ */
+RZ_API bool rz_io_cache_pop(RZ_NONNULL RzIO *io) {
+	rz_return_val_if_fail(io, false);
+	if (rz_vector_empty(&io->cache_stack)) {
+		return false;
+	}
+	ut64 seq;
+	rz_vector_pop(&io->cache_stack, &seq);
+	RzPVector items;
+	rz_pvector_init(&items, NULL);
+	for (size_t i = cache_lower_bound(io, seq); i < rz_pvector_len(&io->cache); i++) {
+		rz_pvector_push(&items, rz_pvector_at(&io->cache, i));
+	}
+	cache_drop(io, &items);
+	rz_pvector_fini(&items);
+	return true;
+}
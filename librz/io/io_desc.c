@@ -38,6 +38,9 @@ RZ_API void rz_io_desc_free(RzIODesc *desc) {
 		free(desc->referer);
 		free(desc->name);
 		rz_io_desc_cache_fini(desc);
+		if (desc->io) {
+			rz_io_page_cache_invalidate_fd(desc->io, desc->fd);
+		}
 		if (desc->io && desc->io->files) {
 			rz_id_storage_delete(desc->io->files, desc->fd);
 		}
@@ -247,9 +250,34 @@ RZ_API ut8 *rz_io_desc_get_buf(RzIODesc *desc, RZ_OUT RZ_NONNULL ut64 *size) {
 	return desc->plugin->get_buf(desc, size);
 }
 
+/**
+ * \brief Returns a pointer to \p len bytes at \p paddr of \p desc, without copying them
+ *
+ * Only plugins backed by memory that stays valid across reads (e.g. local
+ * files mapped read-only by the default plugin) can lend their bytes. The
+ * pointer is valid until the desc is written, resized or closed.
+ *
+ * \return the bytes, or NULL if the caller has to fall back to rz_io_desc_read_at()
+ */
+RZ_API RZ_BORROW const ut8 *rz_io_desc_borrow_at(RZ_NONNULL RzIODesc *desc, ut64 paddr, size_t len) {
+	rz_return_val_if_fail(desc, NULL);
+	if (!len || !(desc->perm & RZ_PERM_R) || !desc->plugin || !desc->plugin->borrow) {
+		return NULL;
+	}
+	RzIO *io = desc->io;
+	if (io && (io->cachemode || io->p_cache)) {
+		// these overlay the desc reads, the plugin bytes are not what a read returns
+		return NULL;
+	}
+	return desc->plugin->borrow(desc, paddr, len);
+}
+
 RZ_API bool rz_io_desc_resize(RzIODesc *desc, ut64 newsize) {
 	if (desc && desc->plugin && desc->plugin->resize) {
 		bool ret = desc->plugin->resize(desc->io, desc, newsize);
+		if (desc->io) {
+			rz_io_page_cache_invalidate_fd(desc->io, desc->fd);
+		}
 		if (desc->io && desc->io->p_cache) {
 			rz_io_desc_cache_cleanup(desc);
 		}
@@ -277,6 +305,8 @@ RZ_API bool rz_io_desc_exchange(RzIO *io, int fd, int fdx) {
 	if (!(desc = rz_io_desc_get(io, fd)) || !(descx = rz_io_desc_get(io, fdx))) {
 		return false;
 	}
+	rz_io_page_cache_invalidate_fd(io, fd);
+	rz_io_page_cache_invalidate_fd(io, fdx);
 	desc->fd = fdx;
 	descx->fd = fd;
 	rz_id_storage_set(io->files, desc, fdx);
@@ -73,7 +73,7 @@ RZ_API int rz_io_fd_read_at(RzIO *io, int fd, ut64 addr, ut8 *buf, size_t len) {
 	if (!io || !buf || (len < 1) || !(desc = rz_io_desc_get(io, fd))) {
 		return 0;
 	}
-	return rz_io_desc_read_at(desc, addr, buf, len);
+	return rz_io_page_cache_read(desc, addr, buf, len);
 }
 
 // returns length of written bytes
@@ -10,8 +10,14 @@
 
 #define END_OF_MAP_IDS UT32_MAX
 
+static void maps_update_notify(RzIO *io, RzIOMap *map) {
+	RzEventIOMapsUpdate ev = { map };
+	rz_event_send(io->event, RZ_EVENT_IO_MAPS_UPDATE, &ev);
+}
+
 // Store map parts that are not covered by others into io->map_skyline
 void io_map_calculate_skyline(RzIO *io) {
+	rz_io_page_cache_reset(io);
 	rz_skyline_clear(&io->map_skyline);
 	// Last map has highest priority (it shadows previous maps)
 	void **it;
@@ -19,6 +25,7 @@ void io_map_calculate_skyline(RzIO *io) {
 		RzIOMap *map = (RzIOMap *)*it;
 		rz_skyline_add(&io->map_skyline, map->itv, map);
 	}
+	maps_update_notify(io, NULL);
 }
 
 RzIOMap *io_map_new(RzIO *io, int fd, int perm, ut64 delta, ut64 addr, ut64 size) {
@@ -44,6 +51,7 @@ RzIOMap *io_map_new(RzIO *io, int fd, int perm, ut64 delta, ut64 addr, ut64 size
 	// new map lives on the top, being top the list's tail
 	rz_pvector_push(&io->maps, map);
 	rz_skyline_add(&io->map_skyline, map->itv, map);
+	maps_update_notify(io, map);
 	return map;
 }
 
@@ -239,6 +247,7 @@ RZ_API bool rz_io_map_priorize(RzIO *io, ut32 id) {
 			rz_pvector_remove_at(&io->maps, i);
 			rz_pvector_push(&io->maps, map);
 			rz_skyline_add(&io->map_skyline, map->itv, map);
+			maps_update_notify(io, map);
 			return true;
 		}
 	}
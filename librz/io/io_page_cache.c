@@ -0,0 +1,363 @@
+// SPDX-FileCopyrightText: 2024 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/** \file io_page_cache.c
+ * Page-granular read cache placed in front of the desc read path.
+ *
+ * Every read that reaches a desc (via the map skyline in virtual mode or
+ * directly in physical mode) is split into pages of RZ_IO_PAGE_CACHE_PAGE_SIZE
+ * bytes; pages are read once from the plugin and kept in a LRU list until
+ * they are evicted, the underlying desc is written, resized or closed, or the
+ * maps are modified.
+ *
+ * Only descs whose content changes through RzIO alone are cached: regular
+ * files opened by the default plugin and malloc:// buffers. Debuggers, devices,
+ * procfs/sysfs files and the other live backends (procpid, self, shm, ...)
+ * are always read from the plugin.
+ *
+ * All the entry points take RzIOPageCache.lock, so the cache can be shared by
+ * threads reading through the same RzIO.
+ */
+
+#include <rz_io.h>
+
+struct rz_io_page_t {
+	int fd;
+	ut64 index; ///< paddr / RZ_IO_PAGE_CACHE_PAGE_SIZE
+	size_t size; ///< number of valid bytes (less than a page at the end of the desc)
+	RzIOPage *prev;
+	RzIOPage *next;
+	ut8 data[RZ_IO_PAGE_CACHE_PAGE_SIZE];
+};
+
+static void lru_unlink(RzIOPageCache *cache, RzIOPage *page) {
+	if (page->prev) {
+		page->prev->next = page->next;
+	} else {
+		cache->lru_head = page->next;
+	}
+	if (page->next) {
+		page->next->prev = page->prev;
+	} else {
+		cache->lru_tail = page->prev;
+	}
+	page->prev = NULL;
+	page->next = NULL;
+}
+
+static void lru_push_front(RzIOPageCache *cache, RzIOPage *page) {
+	page->prev = NULL;
+	page->next = cache->lru_head;
+	if (cache->lru_head) {
+		cache->lru_head->prev = page;
+	}
+	cache->lru_head = page;
+	if (!cache->lru_tail) {
+		cache->lru_tail = page;
+	}
+}
+
+static void page_remove(RzIOPageCache *cache, RzIOPage *page) {
+	int fd = page->fd;
+	lru_unlink(cache, page);
+	HtUP *pages = ht_up_find(cache->descs, fd, NULL);
+	if (pages) {
+		// the page is owned by the table, which frees it
+		ht_up_delete(pages, page->index);
+		if (!ht_up_size(pages)) {
+			ht_up_delete(cache->descs, fd);
+		}
+	} else {
+		free(page);
+	}
+	cache->n_pages--;
+}
+
+static bool is_static_file(RzIODesc *desc) {
+	RzIOPlugin *plugin = desc->plugin;
+	if (!plugin || !plugin->name || plugin->isdbg || rz_io_desc_is_chardevice(desc)) {
+		return false;
+	}
+	if (!strcmp(plugin->name, "malloc")) {
+		return true;
+	}
+	if (strcmp(plugin->name, "default") || !desc->uri) {
+		return false;
+	}
+	if (plugin->is_blockdevice && plugin->is_blockdevice(desc)) {
+		return false;
+	}
+	const char *path = desc->uri;
+	if (rz_str_startswith(path, "file://")) {
+		path += strlen("file://");
+	} else if (rz_str_startswith(path, "nocache://")) {
+		path += strlen("nocache://");
+	}
+	if (rz_str_startswith(path, "/proc/") || rz_str_startswith(path, "/sys/") || rz_str_startswith(path, "/dev/")) {
+		return false;
+	}
+	return rz_file_is_regular(path);
+}
+
+static bool is_cacheable(RzIODesc *desc) {
+	RzIO *io = desc->io;
+	if (!io || !io->page_cache.max_pages) {
+		return false;
+	}
+	// io.cache.auto and io.pcache overlay the desc reads, keep them authoritative
+	if (io->cachemode || io->p_cache) {
+		return false;
+	}
+	// the check stats the file, so it is done once per desc
+	RzIOPageCache *cache = &io->page_cache;
+	bool found = false;
+	void *is_static = ht_up_find(cache->static_descs, desc->fd, &found);
+	if (!found) {
+		is_static = is_static_file(desc) ? desc : NULL;
+		ht_up_insert(cache->static_descs, desc->fd, is_static);
+	}
+	return is_static == desc;
+}
+
+static RzIOPage *page_get(RzIOPageCache *cache, RzIODesc *desc, ut64 index) {
+	HtUP *pages = ht_up_find(cache->descs, desc->fd, NULL);
+	RzIOPage *page = pages ? ht_up_find(pages, index, NULL) : NULL;
+	if (page) {
+		cache->hits++;
+		if (cache->lru_head != page) {
+			lru_unlink(cache, page);
+			lru_push_front(cache, page);
+		}
+		return page;
+	}
+
+	cache->misses++;
+	page = RZ_NEW0(RzIOPage);
+	if (!page) {
+		return NULL;
+	}
+	int ret = rz_io_desc_read_at(desc, index * RZ_IO_PAGE_CACHE_PAGE_SIZE, page->data, RZ_IO_PAGE_CACHE_PAGE_SIZE);
+	if (ret < 1) {
+		free(page);
+		return NULL;
+	}
+	page->fd = desc->fd;
+	page->index = index;
+	page->size = ret;
+
+	if (!pages) {
+		pages = ht_up_new(NULL, free);
+		if (!pages || !ht_up_insert(cache->descs, desc->fd, pages)) {
+			ht_up_free(pages);
+			free(page);
+			return NULL;
+		}
+	}
+	if (!ht_up_insert(pages, index, page)) {
+		free(page);
+		return NULL;
+	}
+	lru_push_front(cache, page);
+	cache->n_pages++;
+	while (cache->n_pages > cache->max_pages && cache->lru_tail != page) {
+		page_remove(cache, cache->lru_tail);
+	}
+	return page;
+}
+
+static void cache_disable(RzIOPageCache *cache) {
+	ht_up_free(cache->descs);
+	ht_up_free(cache->static_descs);
+	cache->descs = NULL;
+	cache->static_descs = NULL;
+	cache->lru_head = NULL;
+	cache->lru_tail = NULL;
+	cache->n_pages = 0;
+	cache->max_pages = 0;
+}
+
+RZ_API void rz_io_page_cache_init(RZ_NONNULL RzIO *io) {
+	rz_return_if_fail(io);
+	memset(&io->page_cache, 0, sizeof(io->page_cache));
+	io->page_cache.lock = rz_th_lock_new(false);
+}
+
+RZ_API void rz_io_page_cache_fini(RZ_NONNULL RzIO *io) {
+	rz_return_if_fail(io);
+	cache_disable(&io->page_cache);
+	rz_th_lock_free(io->page_cache.lock);
+	memset(&io->page_cache, 0, sizeof(io->page_cache));
+}
+
+/**
+ * \brief Drops all the cached pages, keeping the cache enabled and its counters.
+ */
+RZ_API void rz_io_page_cache_reset(RZ_NONNULL RzIO *io) {
+	rz_return_if_fail(io);
+	RzIOPageCache *cache = &io->page_cache;
+	if (!cache->lock) {
+		return;
+	}
+	rz_th_lock_enter(cache->lock);
+	if (cache->descs) {
+		ht_up_free(cache->descs);
+		cache->descs = ht_up_new(NULL, (HtUPFreeValue)ht_up_free);
+		cache->lru_head = NULL;
+		cache->lru_tail = NULL;
+		cache->n_pages = 0;
+		if (!cache->descs) {
+			cache_disable(cache);
+		}
+	}
+	rz_th_lock_leave(cache->lock);
+}
+
+/**
+ * \brief Sets the maximum number of pages kept by the IO page cache.
+ *
+ * \param io The RzIO to configure
+ * \param max_pages Number of RZ_IO_PAGE_CACHE_PAGE_SIZE pages to keep, 0 disables the cache
+ */
+RZ_API void rz_io_page_cache_set_size(RZ_NONNULL RzIO *io, size_t max_pages) {
+	rz_return_if_fail(io);
+	RzIOPageCache *cache = &io->page_cache;
+	if (!cache->lock) {
+		return;
+	}
+	rz_th_lock_enter(cache->lock);
+	if (!max_pages) {
+		cache_disable(cache);
+		goto beach;
+	}
+	if (!cache->descs) {
+		cache->descs = ht_up_new(NULL, (HtUPFreeValue)ht_up_free);
+		cache->static_descs = ht_up_new(NULL, NULL);
+		if (!cache->descs || !cache->static_descs) {
+			cache_disable(cache);
+			goto beach;
+		}
+	}
+	cache->max_pages = max_pages;
+	while (cache->n_pages > cache->max_pages) {
+		page_remove(cache, cache->lru_tail);
+	}
+beach:
+	rz_th_lock_leave(cache->lock);
+}
+
+/**
+ * \brief Drops the cached pages of \p fd overlapping [paddr, paddr + len)
+ */
+static void cache_invalidate(RzIOPageCache *cache, int fd, ut64 paddr, ut64 len) {
+	if (!cache->descs || !len) {
+		return;
+	}
+	HtUP *pages = ht_up_find(cache->descs, fd, NULL);
+	if (!pages) {
+		return;
+	}
+	ut64 first = paddr / RZ_IO_PAGE_CACHE_PAGE_SIZE;
+	ut64 last = (paddr + len - 1) / RZ_IO_PAGE_CACHE_PAGE_SIZE;
+	if (paddr + len - 1 < paddr || last - first >= ht_up_size(pages)) {
+		// wide (or wrapping) range, cheaper to walk the cached pages
+		for (RzIOPage *page = cache->lru_head, *next; page; page = next) {
+			next = page->next;
+			if (page->fd == fd && (paddr + len - 1 < paddr || (page->index >= first && page->index <= last))) {
+				page_remove(cache, page);
+			}
+		}
+		return;
+	}
+	for (ut64 index = first; index <= last; index++) {
+		RzIOPage *page = ht_up_find(pages, index, NULL);
+		if (page) {
+			bool last_page = ht_up_size(pages) == 1;
+			page_remove(cache, page);
+			if (last_page) {
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * \brief Drops the cached pages of \p fd overlapping [paddr, paddr + len)
+ */
+RZ_API void rz_io_page_cache_invalidate(RZ_NONNULL RzIO *io, int fd, ut64 paddr, ut64 len) {
+	rz_return_if_fail(io);
+	RzIOPageCache *cache = &io->page_cache;
+	if (!cache->lock) {
+		return;
+	}
+	rz_th_lock_enter(cache->lock);
+	cache_invalidate(cache, fd, paddr, len);
+	rz_th_lock_leave(cache->lock);
+}
+
+/**
+ * \brief Drops all the cached pages of \p fd
+ *
+ * Called when the desc is closed, exchanged or resized, so the
+ * fd may refer to another file on the next read.
+ */
+RZ_API void rz_io_page_cache_invalidate_fd(RZ_NONNULL RzIO *io, int fd) {
+	rz_return_if_fail(io);
+	RzIOPageCache *cache = &io->page_cache;
+	if (!cache->lock) {
+		return;
+	}
+	rz_th_lock_enter(cache->lock);
+	cache_invalidate(cache, fd, 0, UT64_MAX);
+	if (cache->static_descs) {
+		ht_up_delete(cache->static_descs, fd);
+	}
+	rz_th_lock_leave(cache->lock);
+}
+
+/**
+ * \brief Reads \p len bytes at \p paddr of \p desc through the IO page cache.
+ *
+ * Behaves as rz_io_desc_read_at() and falls back to it whenever the desc
+ * cannot be cached or a page cannot be read as a whole.
+ *
+ * \return the number of read bytes, or a value < 1 on error
+ */
+RZ_API int rz_io_page_cache_read(RZ_NONNULL RzIODesc *desc, ut64 paddr, RZ_NONNULL RZ_OUT ut8 *buf, size_t len) {
+	rz_return_val_if_fail(desc && buf, -1);
+	RzIOPageCache *cache = desc->io ? &desc->io->page_cache : NULL;
+	if (!cache || !cache->lock) {
+		return rz_io_desc_read_at(desc, paddr, buf, len);
+	}
+	rz_th_lock_enter(cache->lock);
+	if (!is_cacheable(desc)) {
+		rz_th_lock_leave(cache->lock);
+		return rz_io_desc_read_at(desc, paddr, buf, len);
+	}
+	size_t done = 0;
+	ut64 addr = paddr;
+	while (done < len) {
+		ut64 offset = addr % RZ_IO_PAGE_CACHE_PAGE_SIZE;
+		RzIOPage *page = page_get(cache, desc, addr / RZ_IO_PAGE_CACHE_PAGE_SIZE);
+		if (!page || page->size <= offset) {
+			break;
+		}
+		size_t n = RZ_MIN(page->size - offset, len - done);
+		memcpy(buf + done, page->data + offset, n);
+		done += n;
+		addr += n;
+		if (page->size < RZ_IO_PAGE_CACHE_PAGE_SIZE) {
+			// short page, end of the desc
+			rz_th_lock_leave(cache->lock);
+			return done;
+		}
+	}
+	rz_th_lock_leave(cache->lock);
+	if (done == len) {
+		return done;
+	}
+	int ret = rz_io_desc_read_at(desc, addr, buf + done, len - done);
+	if (ret < 1) {
+		return done ? done : ret;
+	}
+	return done + ret;
+}
@@ -110,7 +110,8 @@ RZ_API int rz_io_plugin_write(RzIODesc *desc, const ut8 *buf, size_t len) {
 	}
 	const ut64 cur_addr = rz_io_desc_seek(desc, 0LL, RZ_IO_SEEK_CUR);
 	int ret = desc->plugin->write(desc->io, desc, buf, len);
-	RzEventIOWrite iow = { cur_addr, buf, len };
+	rz_io_page_cache_invalidate(desc->io, desc->fd, cur_addr, len);
+	RzEventIOWrite iow = { cur_addr, buf, len, desc->fd };
 	rz_event_send(desc->io->event, RZ_EVENT_IO_WRITE, &iow);
 	return ret;
 }
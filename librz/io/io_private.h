@@ -4,8 +4,25 @@
 #ifndef _IO_PRIVATE_H_
 #define _IO_PRIVATE_H_
 
+#define RZ_IO_CACHE_PAGE_SIZE 0x100
+
+/**
+ * \brief Page of the bytes made visible by the io.cache writes
+ *
+ * Holds, for every byte of the page, the value of the newest cached write
+ * covering it. The page is dropped when no cached write covers it anymore.
+ */
+typedef struct rz_io_cache_page_t {
+	RBNode rb;
+	ut64 addr; ///< address of the first byte, aligned to RZ_IO_CACHE_PAGE_SIZE
+	size_t dirty_count; ///< number of bits set in dirty
+	ut8 dirty[RZ_IO_CACHE_PAGE_SIZE / 8]; ///< bitmap of the bytes covered by a cached write
+	ut8 data[RZ_IO_CACHE_PAGE_SIZE]; ///< cached bytes, meaningful where dirty
+} RzIOCachePage;
+
 RzIOMap *io_map_new(RzIO *io, int fd, int perm, ut64 delta, ut64 addr, ut64 size);
 RzIOMap *io_map_add(RzIO *io, int fd, int flags, ut64 delta, ut64 addr, ut64 size, bool do_skyline);
 void io_map_calculate_skyline(RzIO *io);
+bool io_cache_overlaps(RzIO *io, ut64 addr, size_t len);
 
 #endif
@@ -202,6 +202,21 @@ static ut8 *io_default_get_buf(RzIODesc *desc, ut64 *size) {
 	return rz_buf_data(mmo->buf, size);
 }
 
+static const ut8 *io_default_borrow(RzIODesc *desc, ut64 paddr, size_t len) {
+	rz_return_val_if_fail(desc && desc->data, NULL);
+	RzIOMMapFileObj *mmo = desc->data;
+	// writable mappings may be remapped on resize, only lend read-only ones
+	if (mmo->buf->type != RZ_BUFFER_MMAP || (mmo->perm & RZ_PERM_W)) {
+		return NULL;
+	}
+	ut64 size;
+	const ut8 *data = rz_buf_data(mmo->buf, &size);
+	if (!data || paddr >= size || len > size - paddr) {
+		return NULL;
+	}
+	return data + paddr;
+}
+
 RzIOPlugin rz_io_plugin_default = {
 	.name = "default",
 	.desc = "Open local files",
@@ -217,7 +232,8 @@ RzIOPlugin rz_io_plugin_default = {
 #if __UNIX__
 	.is_blockdevice = __is_blockdevice,
 #endif
-	.get_buf = io_default_get_buf
+	.get_buf = io_default_get_buf,
+	.borrow = io_default_borrow
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -130,7 +130,7 @@ RZ_API int rz_io_desc_cache_write(RzIODesc *desc, ut64 paddr, const ut8 *buf, si
 		caddr++;
 		cbaddr = 0;
 	}
-	RzEventIOWrite iow = { paddr, buf, len };
+	RzEventIOWrite iow = { paddr, buf, len, desc->fd };
 	rz_event_send(desc->io->event, RZ_EVENT_IO_WRITE, &iow);
 	return written;
 }
@@ -342,9 +342,20 @@ RZ_API void rz_io_desc_cache_cleanup(RzIODesc *desc) {
 	}
 }
 
+static bool __desc_cache_drop_cb(void *user, const ut64 k, const void *v) {
+	RzIODesc *desc = (RzIODesc *)user;
+	// the bytes under the cached ones become visible again
+	RzEventIOWrite iow = { RZ_IO_DESC_CACHE_SIZE * k, NULL, RZ_IO_DESC_CACHE_SIZE, desc->fd };
+	rz_event_send(desc->io->event, RZ_EVENT_IO_WRITE, &iow);
+	return true;
+}
+
 static bool __desc_fini_cb(void *user, void *data, ut32 id) {
 	RzIODesc *desc = (RzIODesc *)data;
 	if (desc->cache) {
+		if (desc->io) {
+			ht_up_foreach(desc->cache, __desc_cache_drop_cb, desc);
+		}
 		ht_up_free(desc->cache);
 		desc->cache = NULL;
 	}
@@ -229,6 +229,8 @@ static void rz_diff_show_help(bool usage_only) {
 		"",         "",             "   lines      | compare text files",
 		"",         "",             "   functions  | compare functions found in the files",
 		"",         "",             "              | optional -0 <fcn name|offset> to compare only one function",
+		"",         "",             "              | optional -e diff.lsh=<1-32> to compare only similar candidates",
+		"",         "",             "              | (fewer rows per band: slower, more matches)",
 		"",         "",             "   classes    | compare classes found in the files",
 		"",         "",             "   command    | compare command output returned when executed in both files",
 		"",         "",             "              | require -0 <cmd> and -1 <cmd> is optional",
@@ -2108,6 +2110,7 @@ static void core_diff_show(RzCore *core_a, RzCore *core_b, const char *addr_a, D
 	opts.callback = verbose ? diff_progess_status : diff_check_ctrl_c;
 	opts.analysis_a = core_a->analysis;
 	opts.analysis_b = core_b->analysis;
+	opts.lsh_rows = rz_config_get_i(core_a->config, "diff.lsh");
 
 	// calculate all the matches between the functions of the 2 different core files.
 	result = rz_analysis_match_functions(fcns_a, fcns_b, &opts);
@@ -2115,6 +2118,11 @@ static void core_diff_show(RzCore *core_a, RzCore *core_b, const char *addr_a, D
 		RZ_LOG_ERROR("rz-diff: cannot perform matching functions search\n");
 		goto fail;
 	}
+	if (verbose) {
+		ut64 n_pairs = (ut64)rz_list_length(fcns_a) * rz_list_length(fcns_b);
+		rz_cons_clear_line(true);
+		fprintf(stderr, "rz-diff: compared %" PFMT64u " of %" PFMT64u " function pairs\n", result->n_compared, n_pairs);
+	}
 
 	rz_list_sort(result->matches, (RzListComparator)comparePairFunctions, NULL);
 	rz_list_sort(result->unmatch_a, core_a->analysis->columnSort, NULL);
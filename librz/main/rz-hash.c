@@ -12,6 +12,9 @@
 #include <rz_lib.h>
 
 #define RZ_HASH_DEFAULT_BLOCK_SIZE 0x1000
+#define RZ_HASH_CHUNK_SIZE 0x100000 ///< Bytes read at once and shared by the hashing threads
+#define RZ_HASH_BATCH_MAX_SIZE 0x4000000 ///< Upper bound of the bytes of the blocks hashed at once in -B mode
+#define RZ_HASH_BATCH_MAX_DIGESTS 0x10000 ///< Upper bound of the digests (blocks times algorithms) kept per batch in -B mode
 
 typedef struct {
 	ut8 *buf;
@@ -745,16 +748,9 @@ static void hash_print_crypto(RzHashContext *ctx, const char *hname, const ut8 *
 	free(value);
 }
 
-static void hash_print_digest(RzHashContext *ctx, RzHashCfg *md, const char *hname, ut64 from, ut64 to, const char *filename) {
-	RzHashSize len = 0;
-	char *value = NULL;
+static void hash_print_result(RzHashContext *ctx, const char *hname, const ut8 *buffer, RzHashSize len, const char *value, ut64 from, ut64 to, const char *filename) {
 	char *rndart = NULL;
-	const ut8 *buffer;
-
-	buffer = rz_hash_cfg_get_result(md, hname, &len);
-	value = rz_hash_cfg_get_result_string(md, hname, NULL, ctx->little_endian);
 	if (!value || !buffer) {
-		free(value);
 		return;
 	}
 
@@ -784,10 +780,17 @@ static void hash_print_digest(RzHashContext *ctx, RzHashCfg *md, const char *hna
 		puts(value);
 		break;
 	}
-	free(value);
 	free(rndart);
 }
 
+static void hash_print_digest(RzHashContext *ctx, RzHashCfg *md, const char *hname, ut64 from, ut64 to, const char *filename) {
+	RzHashSize len = 0;
+	const ut8 *buffer = rz_hash_cfg_get_result(md, hname, &len);
+	char *value = rz_hash_cfg_get_result_string(md, hname, NULL, ctx->little_endian);
+	hash_print_result(ctx, hname, buffer, len, value, from, to, filename);
+	free(value);
+}
+
 static void hash_context_compare_hashes(RzHashContext *ctx, size_t filesize, bool result, const char *hname, const char *filename) {
 	ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
 	const char *hmac = ctx->key.len > 0 ? "hmac-" : "";
@@ -839,33 +842,385 @@ static RzList /*<char *>*/ *parse_hash_algorithms(RzHashContext *ctx) {
 	return list;
 }
 
+/**
+ * Returns the \p len bytes at \p addr, borrowed from the file when it is mapped
+ * in memory and read into \p block otherwise.
+ */
+static const ut8 *hash_block_at(RzIO *io, ut64 addr, ut8 *block, size_t len, int *read) {
+	const ut8 *data = rz_io_desc_borrow_at(io->desc, addr, len);
+	if (data) {
+		*read = (int)len;
+		return data;
+	}
+	*read = rz_io_pread_at(io, addr, block, len);
+	return block;
+}
+
+/**
+ * The input is read once, a chunk at a time, while the previous chunk is being
+ * hashed. When hashing a whole range the algorithms are spread over several
+ * RzHashCfg which consume each chunk on their own thread; in block mode each
+ * thread hashes a slice of the blocks of the chunk with its own RzHashCfg.
+ */
+typedef struct {
+	RzThreadScheduler *sched; ///< NULL when everything runs on the calling thread
+	RzThreadTaskGroup *group;
+	RzHashCfg **mds; ///< Hash configurations; each one is used by one task at a time
+	size_t n_mds;
+} HashPipeline;
+
+typedef struct {
+	RzHashCfg *md;
+	const ut8 *data;
+	ut64 size;
+	bool failed;
+} HashUpdateTask;
+
+typedef struct {
+	ut8 *digest;
+	RzHashSize size;
+	char *value;
+} HashDigest;
+
+typedef struct {
+	RzHashContext *ctx;
+	const RzList /*<char *>*/ *algorithms;
+	RzHashCfg *md;
+	const ut8 *data; ///< First byte of the first block
+	ut64 size; ///< Number of bytes available at data
+	size_t count; ///< Number of blocks to hash
+	HashDigest *digests; ///< One result for each block and algorithm
+	bool failed;
+} HashBlocksTask;
+
+static bool hash_algorithms_check(const RzList /*<char *>*/ *algorithms) {
+	RzListIter *it, *it2;
+	const char *algorithm, *other;
+	rz_list_foreach (algorithms, it, algorithm) {
+		if (!strcmp(algorithm, "all") && rz_list_length(algorithms) > 1) {
+			RZ_LOG_ERROR("rz-hash: error, 'all' cannot be combined with other algorithms\n");
+			return false;
+		}
+		rz_list_foreach (algorithms, it2, other) {
+			if (it2 == it) {
+				break;
+			}
+			if (!strcmp(algorithm, other)) {
+				RZ_LOG_ERROR("rz-hash: error, '%s' was requested more than once\n", algorithm);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void hash_pipeline_fini(HashPipeline *pl) {
+	rz_th_task_group_free(pl->group);
+	rz_th_scheduler_free(pl->sched);
+	for (size_t i = 0; i < pl->n_mds; i++) {
+		if (pl->mds[i]) {
+			rz_hash_cfg_free(pl->mds[i]);
+		}
+	}
+	free(pl->mds);
+}
+
+/**
+ * Creates \p n_mds hash configurations: when \p split is set the algorithms are
+ * distributed among them, otherwise each one computes all the algorithms.
+ * The threads are started only when \p threaded is set.
+ */
+static bool hash_pipeline_init(HashPipeline *pl, RzHashContext *ctx, const RzList /*<char *>*/ *algorithms, size_t n_mds, bool split, bool threaded) {
+	RzListIter *it;
+	const char *algorithm;
+	size_t index = 0;
+
+	memset(pl, 0, sizeof(HashPipeline));
+	pl->mds = RZ_NEWS0(RzHashCfg *, n_mds);
+	if (!pl->mds) {
+		RZ_LOG_ERROR("rz-hash: error, cannot allocate hash context memory\n");
+		return false;
+	}
+	pl->n_mds = n_mds;
+	for (size_t i = 0; i < n_mds; i++) {
+		pl->mds[i] = rz_hash_cfg_new(ctx->rh);
+		if (!pl->mds[i]) {
+			RZ_LOG_ERROR("rz-hash: error, cannot allocate hash context memory\n");
+			return false;
+		}
+	}
+
+	rz_list_foreach (algorithms, it, algorithm) {
+		for (size_t i = 0; i < n_mds; i++) {
+			if (split && i != index % n_mds) {
+				continue;
+			}
+			if (!rz_hash_cfg_configure(pl->mds[i], algorithm)) {
+				return false;
+			}
+		}
+		index++;
+	}
+
+	for (size_t i = 0; i < n_mds && ctx->key.len > 0; i++) {
+		if (!rz_hash_cfg_hmac(pl->mds[i], ctx->key.buf, ctx->key.len)) {
+			return false;
+		}
+	}
+
+	if (threaded) {
+		// on failure the tasks are just executed on the calling thread.
+		pl->sched = rz_th_scheduler_new(n_mds);
+		pl->group = pl->sched ? rz_th_task_group_new(pl->sched) : NULL;
+	}
+	return true;
+}
+
+static void hash_pipeline_run(HashPipeline *pl, RzThreadTask task, void *user) {
+	if (!pl->group || !rz_th_task_group_submit(pl->group, task, user)) {
+		task(user);
+	}
+}
+
+static void hash_pipeline_wait(HashPipeline *pl) {
+	if (pl->group) {
+		rz_th_task_group_wait(pl->group);
+	}
+}
+
+static void hash_update_task(void *user) {
+	HashUpdateTask *task = (HashUpdateTask *)user;
+	if (!rz_hash_cfg_update(task->md, task->data, task->size)) {
+		task->failed = true;
+	}
+}
+
+/**
+ * Hashes the bytes within [from, to) with all the configurations of \p pl,
+ * reading each chunk into one of the two \p buffers while the other one is
+ * being hashed.
+ */
+static bool hash_stream(RzHashContext *ctx, RzIO *io, HashPipeline *pl, ut64 from, ut64 to, ut8 **buffers, ut64 chunk) {
+	bool result = false;
+	size_t current = 0;
+	HashUpdateTask *tasks = RZ_NEWS0(HashUpdateTask, pl->n_mds);
+	if (!tasks) {
+		return false;
+	}
+
+	for (size_t i = 0; i < pl->n_mds; i++) {
+		RzHashCfg *md = pl->mds[i];
+		tasks[i].md = md;
+		if (!rz_hash_cfg_init(md) ||
+			(ctx->as_prefix && ctx->seed.buf &&
+				!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len))) {
+			goto hash_stream_end;
+		}
+	}
+
+	for (ut64 j = from; j < to; j += chunk) {
+		int read;
+		const ut8 *data = hash_block_at(io, j, buffers[current], to - j > chunk ? chunk : (to - j), &read);
+		// the previous chunk must be consumed before its buffer is reused
+		hash_pipeline_wait(pl);
+		if (read < 0) {
+			goto hash_stream_end;
+		}
+		for (size_t i = 0; i < pl->n_mds; i++) {
+			if (tasks[i].failed) {
+				goto hash_stream_end;
+			}
+			tasks[i].data = data;
+			tasks[i].size = read;
+			hash_pipeline_run(pl, hash_update_task, &tasks[i]);
+		}
+		current ^= 1;
+	}
+	hash_pipeline_wait(pl);
+
+	for (size_t i = 0; i < pl->n_mds; i++) {
+		RzHashCfg *md = pl->mds[i];
+		if (tasks[i].failed ||
+			(!ctx->as_prefix && ctx->seed.buf &&
+				!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) ||
+			!rz_hash_cfg_final(md) ||
+			!rz_hash_cfg_iterate(md, ctx->iterate)) {
+			goto hash_stream_end;
+		}
+	}
+	result = true;
+
+hash_stream_end:
+	hash_pipeline_wait(pl);
+	free(tasks);
+	return result;
+}
+
+static void hash_digests_clear(HashDigest *digests, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		free(digests[i].digest);
+		free(digests[i].value);
+	}
+	memset(digests, 0, sizeof(HashDigest) * count);
+}
+
+static void hash_blocks_task(void *user) {
+	HashBlocksTask *task = (HashBlocksTask *)user;
+	RzHashContext *ctx = task->ctx;
+	RzHashCfg *md = task->md;
+	HashDigest *digest = task->digests;
+	RzListIter *it;
+	const char *algorithm;
+	ut64 bsize = ctx->block_size;
+
+	for (size_t i = 0; i < task->count; i++) {
+		ut64 offset = i * bsize;
+		ut64 size = offset < task->size ? RZ_MIN(bsize, task->size - offset) : 0;
+		if (!rz_hash_cfg_init(md) ||
+			!rz_hash_cfg_update(md, task->data + (size ? offset : 0), size) ||
+			!rz_hash_cfg_final(md) ||
+			!rz_hash_cfg_iterate(md, ctx->iterate)) {
+			task->failed = true;
+			return;
+		}
+		rz_list_foreach (task->algorithms, it, algorithm) {
+			const ut8 *result = rz_hash_cfg_get_result(md, algorithm, &digest->size);
+			digest->digest = result ? rz_mem_dup(result, digest->size) : NULL;
+			digest->value = rz_hash_cfg_get_result_string(md, algorithm, NULL, ctx->little_endian);
+			digest++;
+		}
+	}
+}
+
+static void hash_blocks_print(RzHashContext *ctx, const RzList /*<char *>*/ *algorithms, HashDigest *digests, ut64 from, size_t count, const char *filename) {
+	RzListIter *it;
+	const char *algorithm;
+	ut64 bsize = ctx->block_size;
+
+	for (size_t i = 0; i < count; i++) {
+		ut64 addr = from + i * bsize;
+		rz_list_foreach (algorithms, it, algorithm) {
+			if (ctx->mode == RZ_HASH_MODE_JSON) {
+				pj_o(ctx->pj);
+			}
+			hash_print_result(ctx, algorithm, digests->digest, digests->size, digests->value, addr, addr + bsize, filename);
+			if (ctx->mode == RZ_HASH_MODE_JSON) {
+				pj_end(ctx->pj);
+			}
+			digests++;
+		}
+	}
+}
+
+/**
+ * Hashes and prints each block within [from, to); a batch of \p batch blocks
+ * is read into one of the two \p buffers while the previous batch is being
+ * hashed, and then printed while the new one is being hashed.
+ */
+static bool hash_blocks(RzHashContext *ctx, RzIO *io, HashPipeline *pl, const RzList /*<char *>*/ *algorithms, ut64 from, ut64 to, ut8 **buffers, size_t batch, const char *filename) {
+	bool result = false;
+	ut64 bsize = ctx->block_size;
+	size_t n_algorithms = rz_list_length(algorithms);
+	size_t per_task = (batch + pl->n_mds - 1) / pl->n_mds;
+	size_t current = 0;
+	HashDigest *digests[2] = { 0 };
+	HashBlocksTask *tasks[2] = { 0 };
+	ut64 starts[2] = { 0 };
+	size_t counts[2] = { 0 };
+
+	for (size_t k = 0; k < 2; k++) {
+		digests[k] = RZ_NEWS0(HashDigest, batch * n_algorithms);
+		tasks[k] = RZ_NEWS0(HashBlocksTask, pl->n_mds);
+		if (!digests[k] || !tasks[k]) {
+			RZ_LOG_ERROR("rz-hash: error, cannot allocate block memory\n");
+			goto hash_blocks_end;
+		}
+	}
+
+	for (ut64 j = from; j < to;) {
+		ut64 span = to - j > batch * bsize ? batch * bsize : (to - j);
+		size_t previous = current ^ 1;
+		int read;
+		const ut8 *data = hash_block_at(io, j, buffers[current], span, &read);
+		hash_pipeline_wait(pl);
+		if (read < 0) {
+			goto hash_blocks_end;
+		}
+		for (size_t t = 0; t < pl->n_mds; t++) {
+			if (tasks[previous][t].failed) {
+				goto hash_blocks_end;
+			}
+		}
+
+		counts[current] = (span + bsize - 1) / bsize;
+		starts[current] = j;
+		for (size_t t = 0; t < pl->n_mds && t * per_task < counts[current]; t++) {
+			HashBlocksTask *task = &tasks[current][t];
+			ut64 first = t * per_task;
+			task->ctx = ctx;
+			task->algorithms = algorithms;
+			task->md = pl->mds[t];
+			task->data = data + first * bsize;
+			task->size = (ut64)read > first * bsize ? read - first * bsize : 0;
+			task->count = RZ_MIN(per_task, counts[current] - first);
+			task->digests = digests[current] + first * n_algorithms;
+			task->failed = false;
+			hash_pipeline_run(pl, hash_blocks_task, task);
+		}
+
+		hash_blocks_print(ctx, algorithms, digests[previous], starts[previous], counts[previous], filename);
+		hash_digests_clear(digests[previous], counts[previous] * n_algorithms);
+		counts[previous] = 0;
+		current = previous;
+		j += span;
+	}
+	hash_pipeline_wait(pl);
+	for (size_t t = 0; t < pl->n_mds; t++) {
+		if (tasks[current ^ 1][t].failed) {
+			goto hash_blocks_end;
+		}
+	}
+	hash_blocks_print(ctx, algorithms, digests[current ^ 1], starts[current ^ 1], counts[current ^ 1], filename);
+	result = true;
+
+hash_blocks_end:
+	hash_pipeline_wait(pl);
+	for (size_t k = 0; k < 2; k++) {
+		if (digests[k]) {
+			hash_digests_clear(digests[k], counts[k] * n_algorithms);
+		}
+		free(digests[k]);
+		free(tasks[k]);
+	}
+	return result;
+}
+
 static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 	bool result = false;
 	const char *algorithm;
 	RzList *algorithms = NULL;
 	RzListIter *it;
-	RzHashCfg *md = NULL;
+	HashPipeline pl = { 0 };
 	ut64 bsize = 0;
+	ut64 chunk = 0;
 	ut64 filesize;
-	ut8 *block = NULL;
+	ut64 to;
+	ut8 *buffers[2] = { 0 };
 	ut8 *cmphash = NULL;
 	const ut8 *digest = NULL;
 	RzHashSize digest_size = 0;
+	size_t n_threads, index;
 
 	algorithms = parse_hash_algorithms(ctx);
 	if (!algorithms || rz_list_length(algorithms) < 1) {
 		RZ_LOG_ERROR("rz-hash: error, empty list of hash algorithms\n");
 		goto calculate_hash_end;
+	} else if (!hash_algorithms_check(algorithms)) {
+		goto calculate_hash_end;
 	}
 
 	filesize = rz_io_desc_size(io->desc);
 
-	md = rz_hash_cfg_new(ctx->rh);
-	if (!md) {
-		RZ_LOG_ERROR("rz-hash: error, cannot allocate hash context memory\n");
-		goto calculate_hash_end;
-	}
-
 	if (ctx->offset.to > filesize) {
 		RZ_LOG_ERROR("rz-hash: error, -t value is greater than file size\n");
 		goto calculate_hash_end;
@@ -876,25 +1231,47 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 		goto calculate_hash_end;
 	}
 
+	to = ctx->offset.to ? ctx->offset.to : filesize;
 	bsize = ctx->block_size;
-	block = malloc(bsize);
-	if (!block) {
-		RZ_LOG_ERROR("rz-hash: error, cannot allocate block memory\n");
-		goto calculate_hash_end;
-	}
-
-	rz_list_foreach (algorithms, it, algorithm) {
-		if (!rz_hash_cfg_configure(md, algorithm)) {
+	n_threads = rz_th_max_threads(RZ_THREAD_N_CORES_ALL_AVAILABLE);
+	// small inputs are hashed on the calling thread
+	bool threaded = to > ctx->offset.from && to - ctx->offset.from > RZ_HASH_CHUNK_SIZE;
+	if (!threaded) {
+		n_threads = 1;
+	}
+
+	if (ctx->show_blocks) {
+		// each thread hashes whole blocks, so the chunk is a batch of blocks
+		size_t batch = bsize < RZ_HASH_CHUNK_SIZE ? RZ_HASH_CHUNK_SIZE / bsize : 1;
+		batch *= n_threads;
+		if (batch > 1 && batch * bsize > RZ_HASH_BATCH_MAX_SIZE) {
+			batch = RZ_MAX(RZ_HASH_BATCH_MAX_SIZE / bsize, 1);
+		}
+		// every block of a batch keeps one digest and two strings per algorithm
+		size_t max_blocks = RZ_HASH_BATCH_MAX_DIGESTS / rz_list_length(algorithms);
+		batch = RZ_MAX(RZ_MIN(batch, max_blocks), 1);
+		n_threads = RZ_MIN(n_threads, batch);
+		chunk = batch * bsize;
+		if (!hash_pipeline_init(&pl, ctx, algorithms, n_threads, false, threaded)) {
+			goto calculate_hash_end;
+		}
+	} else {
+		// the digest does not depend on the size of the reads
+		chunk = bsize < RZ_HASH_CHUNK_SIZE ? bsize * (RZ_HASH_CHUNK_SIZE / bsize) : bsize;
+		n_threads = RZ_MIN(n_threads, rz_list_length(algorithms));
+		if (!hash_pipeline_init(&pl, ctx, algorithms, n_threads, true, threaded)) {
 			goto calculate_hash_end;
 		}
 	}
 
-	if (ctx->key.len > 0 && !rz_hash_cfg_hmac(md, ctx->key.buf, ctx->key.len)) {
+	buffers[0] = malloc(chunk);
+	buffers[1] = malloc(chunk);
+	if (!buffers[0] || !buffers[1]) {
+		RZ_LOG_ERROR("rz-hash: error, cannot allocate block memory\n");
 		goto calculate_hash_end;
 	}
 
 	if (ctx->compare) {
-		ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
 		size_t cmphashlen = 0;
 		bool result = false;
 
@@ -903,33 +1280,13 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 			goto calculate_hash_end;
 		}
 
-		if (!rz_hash_cfg_init(md)) {
-			goto calculate_hash_end;
-		}
-
-		if (ctx->as_prefix && ctx->seed.buf &&
-			!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
-		}
-
-		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-			int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-			if (!rz_hash_cfg_update(md, block, read)) {
-				goto calculate_hash_end;
-			}
-		}
-
-		if (!ctx->as_prefix && ctx->seed.buf &&
-			!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
-		}
-		if (!rz_hash_cfg_final(md) ||
-			!rz_hash_cfg_iterate(md, ctx->iterate)) {
+		if (!hash_stream(ctx, io, &pl, ctx->offset.from, to, buffers, chunk)) {
 			goto calculate_hash_end;
 		}
 
+		index = 0;
 		rz_list_foreach (algorithms, it, algorithm) {
-			digest = rz_hash_cfg_get_result(md, algorithm, &digest_size);
+			digest = rz_hash_cfg_get_result(pl.mds[index++ % pl.n_mds], algorithm, &digest_size);
 			if (digest_size != cmphashlen) {
 				result = false;
 			} else {
@@ -945,62 +1302,20 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 			}
 		}
 	} else if (ctx->show_blocks) {
-		ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
-		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-			int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-			if (!rz_hash_cfg_init(md) ||
-				!rz_hash_cfg_update(md, block, read) ||
-				!rz_hash_cfg_final(md) ||
-				!rz_hash_cfg_iterate(md, ctx->iterate)) {
-				goto calculate_hash_end;
-			}
-
-			rz_list_foreach (algorithms, it, algorithm) {
-				digest = rz_hash_cfg_get_result(md, algorithm, &digest_size);
-				if (ctx->mode == RZ_HASH_MODE_JSON) {
-					pj_o(ctx->pj);
-				}
-				hash_print_digest(ctx, md, algorithm, j, j + bsize, filename);
-				if (ctx->mode == RZ_HASH_MODE_JSON) {
-					pj_end(ctx->pj);
-				}
-			}
-		}
-	} else {
-		ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
-		if (!rz_hash_cfg_init(md)) {
-			goto calculate_hash_end;
-		}
-
-		if (ctx->as_prefix && ctx->seed.buf &&
-			!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
+		if (!hash_blocks(ctx, io, &pl, algorithms, ctx->offset.from, to, buffers, chunk / bsize, filename)) {
 			goto calculate_hash_end;
 		}
-
-		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-			int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-			if (!rz_hash_cfg_update(md, block, read)) {
-				goto calculate_hash_end;
-			}
-		}
-
-		if (!ctx->as_prefix && ctx->seed.buf &&
-			!rz_hash_cfg_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
-		}
-
-		if (!rz_hash_cfg_final(md) ||
-			!rz_hash_cfg_iterate(md, ctx->iterate)) {
+	} else {
+		if (!hash_stream(ctx, io, &pl, ctx->offset.from, to, buffers, chunk)) {
 			goto calculate_hash_end;
 		}
 
+		index = 0;
 		rz_list_foreach (algorithms, it, algorithm) {
-			digest = rz_hash_cfg_get_result(md, algorithm, &digest_size);
-
 			if (ctx->mode == RZ_HASH_MODE_JSON) {
 				pj_o(ctx->pj);
 			}
-			hash_print_digest(ctx, md, algorithm, ctx->offset.from, to, filename);
+			hash_print_digest(ctx, pl.mds[index++ % pl.n_mds], algorithm, ctx->offset.from, to, filename);
 			if (ctx->mode == RZ_HASH_MODE_JSON) {
 				pj_end(ctx->pj);
 			}
@@ -1009,10 +1324,11 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 	result = true;
 
 calculate_hash_end:
+	hash_pipeline_fini(&pl);
 	rz_list_free(algorithms);
-	free(block);
+	free(buffers[0]);
+	free(buffers[1]);
 	free(cmphash);
-	rz_hash_cfg_free(md);
 	return result;
 }
 
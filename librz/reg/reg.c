@@ -160,6 +160,7 @@ RZ_API bool rz_reg_set_name(RZ_NONNULL RzReg *reg, RzRegisterId role, RZ_NONNULL
 		char *tmp = rz_str_dup(name);
 		free(reg->name[role]);
 		reg->name[role] = tmp;
+		reg->items_gen++;
 		return true;
 	}
 	return false;
@@ -213,6 +214,7 @@ RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 	rz_return_if_fail(reg);
 	ut32 i;
 
+	reg->items_gen++;
 	rz_list_free(reg->roregs);
 	reg->roregs = NULL;
 	RZ_FREE(reg->reg_profile_str);
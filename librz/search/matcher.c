@@ -0,0 +1,323 @@
+// SPDX-FileCopyrightText: 2024 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/** \file matcher.c
+ * Multi-pattern prefilter for keyword searches.
+ *
+ * Every keyword contributes an anchor: the longest run of bytes that are
+ * fully specified by its binmask (capped to ANCHOR_MAX bytes). All the
+ * anchors are compiled into an Aho-Corasick automaton, so that one pass over
+ * a block finds the candidate positions of all the keywords at once. The
+ * automaton works on case folded bytes and the candidates are then verified
+ * against the whole keyword by the caller, so masks and icase keep their usual
+ * meaning. With a single keyword the scan is a memchr() of the first anchor
+ * byte, which the C library vectorizes.
+ *
+ * Keywords without any fully specified byte have no anchor and are left to
+ * the brute force search.
+ */
+
+#include <ctype.h>
+#include "search_private.h"
+
+#define ANCHOR_MAX 16
+#define NONE       UT32_MAX
+
+typedef struct {
+	ut32 off; ///< offset of the anchor in the keyword
+	ut32 len; ///< anchor length
+	ut32 kw_len; ///< keyword length
+	ut32 next; ///< next pattern ending in the same state
+	ut8 bytes[ANCHOR_MAX]; ///< anchor bytes, case folded when used by the automaton
+	bool icase;
+} MatcherPattern;
+
+struct rz_search_matcher_t {
+	MatcherPattern *pats; ///< one per keyword, in list order
+	ut32 n_pats;
+	ut32 n_anchored; ///< number of patterns with an anchor
+	ut8 cls[256]; ///< byte -> symbol class, 0 for bytes outside the anchors
+	ut32 n_cls;
+	ut32 n_states;
+	ut32 *delta; ///< n_states * n_cls transitions
+	ut32 *match; ///< first pattern whose anchor ends in a state, or NONE
+	ut32 *dict; ///< nearest state on the fail chain with a match, 0 if none
+	RzVector /*<ut32>*/ *candidates; ///< one per keyword, filled by search_matcher_scan()
+};
+
+static ut32 best_anchor(RzSearchKeyword *kw, ut32 *len) {
+	ut32 best = 0, best_len = 0, start = 0, run = 0;
+	for (ut32 j = 0; j < kw->keyword_length; j++) {
+		bool full = kw->binmask_length <= 0 || kw->bin_binmask[j % kw->binmask_length] == 0xff;
+		if (!full) {
+			run = 0;
+			continue;
+		}
+		if (!run) {
+			start = j;
+		}
+		if (++run > best_len) {
+			best = start;
+			best_len = run;
+		}
+	}
+	*len = RZ_MIN(best_len, ANCHOR_MAX);
+	return best;
+}
+
+static bool build_automaton(RzSearchMatcher *m) {
+	ut32 max_states = 1;
+	for (ut32 p = 0; p < m->n_pats; p++) {
+		MatcherPattern *pat = &m->pats[p];
+		for (ut32 j = 0; j < pat->len; j++) {
+			ut8 c = pat->bytes[j] = tolower(pat->bytes[j]);
+			if (!m->cls[c]) {
+				m->cls[c] = ++m->n_cls;
+				m->cls[toupper(c)] = m->n_cls;
+			}
+		}
+		max_states += pat->len;
+	}
+	m->n_cls++;
+	m->delta = malloc(sizeof(ut32) * max_states * m->n_cls);
+	m->match = malloc(sizeof(ut32) * max_states);
+	m->dict = calloc(max_states, sizeof(ut32));
+	ut32 *fail = calloc(max_states, sizeof(ut32));
+	ut32 *queue = malloc(sizeof(ut32) * max_states);
+	if (!m->delta || !m->match || !m->dict || !fail || !queue) {
+		free(fail);
+		free(queue);
+		return false;
+	}
+	memset(m->delta, 0xff, sizeof(ut32) * max_states * m->n_cls);
+	memset(m->match, 0xff, sizeof(ut32) * max_states);
+
+	// trie of the anchors
+	m->n_states = 1;
+	for (ut32 p = 0; p < m->n_pats; p++) {
+		MatcherPattern *pat = &m->pats[p];
+		if (!pat->len) {
+			continue;
+		}
+		ut32 st = 0;
+		for (ut32 j = 0; j < pat->len; j++) {
+			ut32 *edge = &m->delta[st * m->n_cls + m->cls[pat->bytes[j]]];
+			if (*edge == NONE) {
+				*edge = m->n_states++;
+			}
+			st = *edge;
+		}
+		// keep the patterns sharing an anchor in list order
+		ut32 *tail = &m->match[st];
+		while (*tail != NONE) {
+			tail = &m->pats[*tail].next;
+		}
+		*tail = p;
+	}
+
+	// breadth first completion of the transitions into a DFA
+	ut32 head = 0, count = 0;
+	for (ut32 c = 0; c < m->n_cls; c++) {
+		ut32 *edge = &m->delta[c];
+		if (*edge == NONE) {
+			*edge = 0;
+		} else {
+			fail[*edge] = 0;
+			queue[count++] = *edge;
+		}
+	}
+	while (head < count) {
+		ut32 st = queue[head++];
+		ut32 f = fail[st];
+		m->dict[st] = m->match[f] != NONE ? f : m->dict[f];
+		for (ut32 c = 0; c < m->n_cls; c++) {
+			ut32 *edge = &m->delta[st * m->n_cls + c];
+			ut32 fnext = m->delta[f * m->n_cls + c];
+			if (*edge == NONE) {
+				*edge = fnext;
+			} else {
+				fail[*edge] = fnext;
+				queue[count++] = *edge;
+			}
+		}
+	}
+	free(fail);
+	free(queue);
+	return true;
+}
+
+RZ_IPI void search_matcher_free(RzSearchMatcher *m) {
+	if (!m) {
+		return;
+	}
+	for (ut32 p = 0; m->candidates && p < m->n_pats; p++) {
+		rz_vector_fini(&m->candidates[p]);
+	}
+	free(m->candidates);
+	free(m->pats);
+	free(m->delta);
+	free(m->match);
+	free(m->dict);
+	free(m);
+}
+
+/**
+ * \brief Compiles the anchors of \p kws
+ *
+ * \return the matcher, or NULL if no keyword has an anchor
+ */
+RZ_IPI RzSearchMatcher *search_matcher_new(RzList /*<RzSearchKeyword *>*/ *kws) {
+	rz_return_val_if_fail(kws, NULL);
+	RzSearchMatcher *m = RZ_NEW0(RzSearchMatcher);
+	if (!m) {
+		return NULL;
+	}
+	m->pats = RZ_NEWS0(MatcherPattern, rz_list_length(kws));
+	m->candidates = RZ_NEWS0(RzVector, rz_list_length(kws));
+	if (!m->pats || !m->candidates) {
+		free(m->pats);
+		free(m->candidates);
+		free(m);
+		return NULL;
+	}
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	rz_list_foreach (kws, iter, kw) {
+		rz_vector_init(&m->candidates[m->n_pats], sizeof(ut32), NULL, NULL);
+		MatcherPattern *pat = &m->pats[m->n_pats++];
+		pat->off = best_anchor(kw, &pat->len);
+		pat->kw_len = kw->keyword_length;
+		pat->icase = kw->icase;
+		pat->next = NONE;
+		memcpy(pat->bytes, kw->bin_keyword + pat->off, pat->len);
+		if (pat->len) {
+			m->n_anchored++;
+		}
+	}
+	if (!m->n_anchored) {
+		search_matcher_free(m);
+		return NULL;
+	}
+	if (m->n_anchored > 1 && !build_automaton(m)) {
+		search_matcher_free(m);
+		return NULL;
+	}
+	return m;
+}
+
+static void push_candidate(MatcherPattern *pat, RzVector *candidates, ut32 end, int len) {
+	// end is the offset right after the anchor
+	if (end < pat->off + pat->len) {
+		return;
+	}
+	ut32 start = end - pat->len - pat->off;
+	if ((ut64)start + pat->kw_len <= (ut64)len) {
+		rz_vector_push(candidates, &start);
+	}
+}
+
+static void scan_single(MatcherPattern *pat, RzVector *candidates, const ut8 *buf, int len) {
+	const ut8 first = pat->bytes[0];
+	if (pat->icase && tolower(first) != toupper(first)) {
+		// the first byte has two cases, look for both
+		for (int i = 0; i + pat->len <= len; i++) {
+			int j = 0;
+			while (j < pat->len && tolower(buf[i + j]) == tolower(pat->bytes[j])) {
+				j++;
+			}
+			if (j == pat->len) {
+				push_candidate(pat, candidates, i + pat->len, len);
+			}
+		}
+		return;
+	}
+	const ut8 *p = buf, *end = buf + len;
+	while (end - p >= pat->len && (p = memchr(p, first, end - p - pat->len + 1))) {
+		int j = 1;
+		if (pat->icase) {
+			while (j < pat->len && tolower(p[j]) == tolower(pat->bytes[j])) {
+				j++;
+			}
+		} else if (!memcmp(p + 1, pat->bytes + 1, pat->len - 1)) {
+			j = pat->len;
+		}
+		if (j == pat->len) {
+			push_candidate(pat, candidates, p - buf + pat->len, len);
+		}
+		p++;
+	}
+}
+
+/**
+ * \brief Finds the candidate positions of every anchored keyword in \p buf
+ *
+ * The candidates are the starts of the keywords whose anchor is found in the
+ * block, in increasing order. They are stored in \p out, an array of one
+ * vector of ut32 per keyword, and still have to be verified against the whole
+ * keyword. The matcher itself is not modified, so several threads can scan
+ * different blocks at once, each one with its own \p out.
+ */
+RZ_IPI void search_matcher_scan_into(RzSearchMatcher *m, const ut8 *buf, int len, RzVector /*<ut32>*/ *out) {
+	rz_return_if_fail(m && buf && out);
+	for (ut32 p = 0; p < m->n_pats; p++) {
+		rz_vector_clear(&out[p]);
+	}
+	if (len <= 0) {
+		return;
+	}
+	if (!m->delta) {
+		for (ut32 p = 0; p < m->n_pats; p++) {
+			if (m->pats[p].len) {
+				scan_single(&m->pats[p], &out[p], buf, len);
+			}
+		}
+		return;
+	}
+	ut32 st = 0;
+	for (int i = 0; i < len; i++) {
+		st = m->delta[st * m->n_cls + m->cls[buf[i]]];
+		ut32 match = m->match[st] != NONE ? st : m->dict[st];
+		while (match) {
+			for (ut32 p = m->match[match]; p != NONE; p = m->pats[p].next) {
+				push_candidate(&m->pats[p], &out[p], i + 1, len);
+			}
+			match = m->dict[match];
+		}
+	}
+}
+
+/**
+ * \brief Finds the candidate positions of every anchored keyword in \p buf
+ *
+ * Same as search_matcher_scan_into(), keeping the candidates in the matcher,
+ * see search_matcher_candidates().
+ */
+RZ_IPI void search_matcher_scan(RzSearchMatcher *m, const ut8 *buf, int len) {
+	rz_return_if_fail(m && buf);
+	search_matcher_scan_into(m, buf, len, m->candidates);
+}
+
+/**
+ * \brief Tells whether the \p idx -th keyword has an anchor
+ *
+ * Keywords without an anchor get no candidates and have to be searched at
+ * every offset.
+ */
+RZ_IPI bool search_matcher_is_anchored(RzSearchMatcher *m, int idx) {
+	rz_return_val_if_fail(m && idx >= 0, false);
+	return idx < m->n_pats && m->pats[idx].len;
+}
+
+/**
+ * \brief Returns the candidates of the \p idx -th keyword found by the last scan
+ *
+ * \return the sorted start offsets, or NULL if the keyword has no anchor and
+ *         has to be searched at every offset
+ */
+RZ_IPI RzVector /*<ut32>*/ *search_matcher_candidates(RzSearchMatcher *m, int idx) {
+	rz_return_val_if_fail(m && idx >= 0, NULL);
+	if (!search_matcher_is_anchored(m, idx)) {
+		return NULL;
+	}
+	return &m->candidates[idx];
+}
@@ -4,6 +4,7 @@
 #include <rz_search.h>
 #include <rz_list.h>
 #include <ctype.h>
+#include "search_private.h"
 
 // Experimental search engine (fails, because stops at first hit of every block read
 #define USE_BMH 0
@@ -55,6 +56,7 @@ RZ_API RzSearch *rz_search_free(RzSearch *s) {
 	}
 	rz_list_free(s->hits);
 	rz_list_free(s->kws);
+	search_matcher_free(s->matcher);
 	// rz_io_free(s->iob.io); this is supposed to be a weak reference
 	free(s->data);
 	free(s);
@@ -112,6 +114,7 @@ RZ_API int rz_search_magic_update(RzSearch *s, ut64 from, const ut8 *buf, int le
 
 RZ_API int rz_search_set_mode(RzSearch *s, int mode) {
 	s->update = NULL;
+	RZ_FREE_CUSTOM(s->matcher, search_matcher_free);
 	switch (mode) {
 	case RZ_SEARCH_KEYWORD: s->update = rz_search_mybinparse_update; break;
 	case RZ_SEARCH_REGEXP: s->update = rz_search_regexp_update; break;
@@ -131,6 +134,8 @@ RZ_API int rz_search_set_mode(RzSearch *s, int mode) {
 RZ_API int rz_search_begin(RzSearch *s) {
 	RzListIter *iter;
 	RzSearchKeyword *kw;
+	// keywords may have been changed since the last search
+	RZ_FREE_CUSTOM(s->matcher, search_matcher_free);
 	rz_list_foreach (s->kws, iter, kw) {
 		kw->count = 0;
 		kw->last = 0;
@@ -345,12 +350,18 @@ static bool brute_force_match(RzSearch *s, RzSearchKeyword *kw, const ut8 *buf,
 	return j == kw->keyword_length;
 }
 
-// Supported search variants: backward, binmask, icase, inverse, overlap
-RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
+static bool is_scannable(RzSearch *s) {
+	return s->update == rz_search_mybinparse_update && !s->inverse && !s->distance && !s->bckwrds;
+}
+
+/**
+ * \param scanned NULL, or the matches of every keyword found in \p buf by rz_search_kw_scan()
+ */
+static int binparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len, RzVector /*<ut32>*/ *scanned) {
 	RzSearchKeyword *kw;
 	RzListIter *iter;
 	RzSearchLeftover *left;
-	int longest = 0, i;
+	int longest = 0, i, idx = 0;
 	const int old_nhits = s->nhits;
 
 	rz_list_foreach (s->kws, iter, kw) {
@@ -382,9 +393,24 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 		}
 	}
 
+	// the prefilter only finds matches, inverse and distance searches have to look at every offset
+	RzSearchMatcher *matcher = NULL;
+	if (!scanned && !s->inverse && !s->distance) {
+		if (!s->matcher) {
+			s->matcher = search_matcher_new(s->kws);
+		}
+		matcher = s->matcher;
+	}
+	if (matcher) {
+		search_matcher_scan(matcher, buf, len);
+	}
+
 	ut64 len1 = left->len + RZ_MIN(longest - 1, len);
 	memcpy(left->data + left->len, buf, len1 - left->len);
 	rz_list_foreach (s->kws, iter, kw) {
+		RzVector *candidates = scanned ? &scanned[idx] : matcher ? search_matcher_candidates(matcher, idx)
+									 : NULL;
+		idx++;
 		i = s->overlap || !kw->count ? 0 : s->bckwrds ? kw->last - from < left->len ? from + left->len - kw->last : 0
 			: from - kw->last < left->len         ? kw->last + left->len - from
 							      : 0;
@@ -405,6 +431,23 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 		i = s->overlap || !kw->count ? 0 : s->bckwrds ? from > kw->last ? from - kw->last : 0
 			: from < kw->last                     ? kw->last - from
 							      : 0;
+		if (candidates) {
+			ut32 *pos;
+			rz_vector_foreach (candidates, pos) {
+				if (*pos < i || (!scanned && !brute_force_match(s, kw, buf, *pos))) {
+					continue;
+				}
+				int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - *pos : from + *pos);
+				if (!t) {
+					return -1;
+				}
+				if (t > 1) {
+					return s->nhits - old_nhits;
+				}
+				i = s->overlap ? *pos + 1 : *pos + kw->keyword_length;
+			}
+			continue;
+		}
 		for (; i + kw->keyword_length <= len; i++) {
 			if (brute_force_match(s, kw, buf, i) != s->inverse) {
 				int t = rz_search_hit_new(s, kw, s->bckwrds ? from - kw->keyword_length - i : from + i);
@@ -436,6 +479,99 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 	return s->nhits - old_nhits;
 }
 
+// Supported search variants: backward, binmask, icase, inverse, overlap
+RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
+	return binparse_update(s, from, buf, len, NULL);
+}
+
+/**
+ * \brief Prepares a keyword search to be scanned by several threads
+ *
+ * Builds the state shared by the rz_search_kw_scan() calls, it has to be
+ * called after the keywords are added and before the threads are started.
+ *
+ * \return false if the search cannot be done by rz_search_kw_scan(), in which
+ *         case rz_search_update() has to be used. Only forward keyword searches
+ *         without inverse and distance are supported.
+ */
+RZ_API bool rz_search_kw_prepare(RZ_NONNULL RzSearch *s) {
+	rz_return_val_if_fail(s, false);
+	if (!is_scannable(s) || rz_list_empty(s->kws)) {
+		return false;
+	}
+	if (!s->matcher) {
+		// NULL when no keyword has an anchor, they are all searched by brute force then
+		s->matcher = search_matcher_new(s->kws);
+	}
+	return true;
+}
+
+/**
+ * \brief Finds all the matches of the keywords fully contained in \p buf
+ *
+ * Nothing is reported and the search state is left untouched, so that several
+ * threads can scan different blocks at once after rz_search_kw_prepare(). The
+ * matches are then reported in order by rz_search_kw_update_scanned().
+ *
+ * \param matches array of one vector of ut32 per keyword, in the order of
+ *        RzSearch.kws, receiving the offsets in \p buf of all the matches
+ */
+RZ_API bool rz_search_kw_scan(RZ_NONNULL RzSearch *s, RZ_NONNULL const ut8 *buf, int len, RZ_NONNULL RZ_OUT RzVector /*<ut32>*/ *matches) {
+	rz_return_val_if_fail(s && buf && matches, false);
+	if (!is_scannable(s)) {
+		return false;
+	}
+	if (s->matcher) {
+		search_matcher_scan_into(s->matcher, buf, len, matches);
+	}
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	int idx = 0;
+	rz_list_foreach (s->kws, iter, kw) {
+		RzVector *v = &matches[idx];
+		if (s->matcher && search_matcher_is_anchored(s->matcher, idx)) {
+			// keep the candidates matching the whole keyword
+			size_t n = 0;
+			ut32 *pos;
+			rz_vector_foreach (v, pos) {
+				if (brute_force_match(s, kw, buf, *pos)) {
+					*(ut32 *)rz_vector_index_ptr(v, n++) = *pos;
+				}
+			}
+			if (n < rz_vector_len(v)) {
+				rz_vector_remove_range(v, n, rz_vector_len(v) - n, NULL);
+			}
+			idx++;
+			continue;
+		}
+		rz_vector_clear(v);
+		for (ut32 i = 0; (st64)i + kw->keyword_length <= len; i++) {
+			if (brute_force_match(s, kw, buf, i) && !rz_vector_push(v, &i)) {
+				return false;
+			}
+		}
+		idx++;
+	}
+	return true;
+}
+
+/**
+ * \brief Same as rz_search_update() with the matches found by rz_search_kw_scan()
+ *
+ * \p buf and \p matches must come from the same rz_search_kw_scan() call, the
+ * blocks have to be given in the same order as for rz_search_update().
+ */
+RZ_API int rz_search_kw_update_scanned(RZ_NONNULL RzSearch *s, ut64 from, RZ_NONNULL const ut8 *buf, int len, RZ_NONNULL RzVector /*<ut32>*/ *matches) {
+	rz_return_val_if_fail(s && buf && matches, -1);
+	if (!is_scannable(s)) {
+		return -1;
+	}
+	if (s->maxhits && s->nhits >= s->maxhits) {
+		return 0;
+	}
+	return binparse_update(s, from, buf, len, matches);
+}
+
 RZ_API void rz_search_set_distance(RzSearch *s, int dist) {
 	if (dist >= RZ_SEARCH_DISTANCE_MAX) {
 		eprintf("Invalid distance\n");
@@ -499,6 +635,7 @@ RZ_API int rz_search_kw_add(RzSearch *s, RzSearchKeyword *kw) {
 	}
 	kw->kwidx = s->n_kws++;
 	rz_list_append(s->kws, kw);
+	RZ_FREE_CUSTOM(s->matcher, search_matcher_free);
 	return true;
 }
 
@@ -506,6 +643,7 @@ RZ_API int rz_search_kw_add(RzSearch *s, RzSearchKeyword *kw) {
 RZ_API void rz_search_string_prepare_backward(RzSearch *s) {
 	RzListIter *iter;
 	RzSearchKeyword *kw;
+	RZ_FREE_CUSTOM(s->matcher, search_matcher_free);
 	// Precondition: !kw->binmask_length || kw->keyword_length % kw->binmask_length == 0
 	rz_list_foreach (s->kws, iter, kw) {
 		ut8 *i = kw->bin_keyword, *j = kw->bin_keyword + kw->keyword_length;
@@ -535,4 +673,5 @@ RZ_API void rz_search_kw_reset(RzSearch *s) {
 	rz_list_purge(s->kws);
 	rz_list_purge(s->hits);
 	RZ_FREE(s->data);
+	RZ_FREE_CUSTOM(s->matcher, search_matcher_free);
 }
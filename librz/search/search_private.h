@@ -0,0 +1,16 @@
+// SPDX-FileCopyrightText: 2024 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef SEARCH_PRIVATE_H
+#define SEARCH_PRIVATE_H
+
+#include <rz_search.h>
+
+RZ_IPI RzSearchMatcher *search_matcher_new(RzList /*<RzSearchKeyword *>*/ *kws);
+RZ_IPI void search_matcher_free(RzSearchMatcher *m);
+RZ_IPI void search_matcher_scan(RzSearchMatcher *m, const ut8 *buf, int len);
+RZ_IPI void search_matcher_scan_into(RzSearchMatcher *m, const ut8 *buf, int len, RzVector /*<ut32>*/ *out);
+RZ_IPI bool search_matcher_is_anchored(RzSearchMatcher *m, int idx);
+RZ_IPI RzVector /*<ut32>*/ *search_matcher_candidates(RzSearchMatcher *m, int idx);
+
+#endif
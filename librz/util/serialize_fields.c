@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2024 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util/rz_serialize.h>
+
+/*
+ * Binary format of the fixed-size fields:
+ *
+ * The fields are written one after the other in the order of the table,
+ * every field as a little endian integer of the size of the field in its
+ * struct. Fields without a fixed size are skipped.
+ */
+
+/**
+ * \brief Register the keys of \p fields in \p parser, each with its index in \p fields as value
+ */
+RZ_API void rz_serialize_fields_key_parser_add(RZ_NONNULL RzKeyParser *parser, RZ_NONNULL const RzSerializeField *fields, size_t count) {
+	rz_return_if_fail(parser && fields);
+	for (size_t i = 0; i < count; i++) {
+		rz_key_parser_add(parser, fields[i].key, (int)i);
+	}
+}
+
+/**
+ * \brief Get the number of bytes written by rz_serialize_fields_write() for \p fields
+ */
+RZ_API ut64 rz_serialize_fields_size(RZ_NONNULL const RzSerializeField *fields, size_t count) {
+	rz_return_val_if_fail(fields, 0);
+	ut64 size = 0;
+	for (size_t i = 0; i < count; i++) {
+		size += fields[i].size;
+	}
+	return size;
+}
+
+/**
+ * \brief Write the fixed-size fields of the struct at \p obj to \p b
+ */
+RZ_API bool rz_serialize_fields_write(RZ_NONNULL RzBuffer *b, RZ_NONNULL const void *obj, RZ_NONNULL const RzSerializeField *fields, size_t count) {
+	rz_return_val_if_fail(b && obj && fields, false);
+	for (size_t i = 0; i < count; i++) {
+		const ut8 *p = (const ut8 *)obj + fields[i].offset;
+		bool ok;
+		switch (fields[i].size) {
+		case 0:
+			ok = true;
+			break;
+		case sizeof(ut8):
+			ok = rz_buf_write8(b, fields[i].is_bool ? *(const bool *)p : *p);
+			break;
+		case sizeof(ut16): {
+			ut16 v;
+			memcpy(&v, p, sizeof(v));
+			ok = rz_buf_write_le16(b, v);
+			break;
+		}
+		case sizeof(ut32): {
+			ut32 v;
+			memcpy(&v, p, sizeof(v));
+			ok = rz_buf_write_le32(b, v);
+			break;
+		}
+		case sizeof(ut64): {
+			ut64 v;
+			memcpy(&v, p, sizeof(v));
+			ok = rz_buf_write_le64(b, v);
+			break;
+		}
+		default:
+			rz_warn_if_reached();
+			ok = false;
+			break;
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Read the fixed-size fields written by rz_serialize_fields_write() into the struct at \p obj
+ *
+ * Fields without a fixed size are left untouched.
+ */
+RZ_API bool rz_serialize_fields_read(RZ_NONNULL RzBuffer *b, RZ_NONNULL void *obj, RZ_NONNULL const RzSerializeField *fields, size_t count) {
+	rz_return_val_if_fail(b && obj && fields, false);
+	for (size_t i = 0; i < count; i++) {
+		ut8 *p = (ut8 *)obj + fields[i].offset;
+		bool ok;
+		switch (fields[i].size) {
+		case 0:
+			ok = true;
+			break;
+		case sizeof(ut8): {
+			ut8 v;
+			ok = rz_buf_read8(b, &v);
+			if (ok && fields[i].is_bool) {
+				*(bool *)p = v != 0;
+			} else if (ok) {
+				*p = v;
+			}
+			break;
+		}
+		case sizeof(ut16): {
+			ut16 v;
+			ok = rz_buf_read_le16(b, &v);
+			if (ok) {
+				memcpy(p, &v, sizeof(v));
+			}
+			break;
+		}
+		case sizeof(ut32): {
+			ut32 v;
+			ok = rz_buf_read_le32(b, &v);
+			if (ok) {
+				memcpy(p, &v, sizeof(v));
+			}
+			break;
+		}
+		case sizeof(ut64): {
+			ut64 v;
+			ok = rz_buf_read_le64(b, &v);
+			if (ok) {
+				memcpy(p, &v, sizeof(v));
+			}
+			break;
+		}
+		default:
+			rz_warn_if_reached();
+			ok = false;
+			break;
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -347,6 +347,136 @@ static inline bool can_be_ebcdic(const ut8 *buf, ut64 size) {
 	return buf[0] < 0x20 || buf[0] > 0x3f;
 }
 
+/**
+ * Bytes that cannot start a string, used to skip padding and binary data
+ * without going through the per code point decoding of every offset.
+ */
+typedef struct {
+	bool dead[256]; ///< bytes that never start a string, whatever follows them
+	ut64 zero_run; ///< number of 0 bytes making their first offset a dead start, 0 if none
+} DeadStarts;
+
+static inline bool rune_is_dead(RzCodePoint r) {
+	// mirrors the checks of the first code point in process_one_string()
+	return !(rz_code_point_is_printable(r) && r != '\\') && !(r && r < 0x100 && is_c_escape_sequence((char)r));
+}
+
+static bool ebcdic_is_dead(RzStrEnc type, ut8 b) {
+	RzCodePoint r = 0;
+	int rc = 0;
+	switch (type) {
+	case RZ_STRING_ENC_IBM037: rc = rz_str_ibm037_to_unicode(b, &r); break;
+	case RZ_STRING_ENC_IBM290: rc = rz_str_ibm290_to_unicode(b, &r); break;
+	case RZ_STRING_ENC_EBCDIC_ES: rc = rz_str_ebcdic_es_to_unicode(b, &r); break;
+	case RZ_STRING_ENC_EBCDIC_UK: rc = rz_str_ebcdic_uk_to_unicode(b, &r); break;
+	case RZ_STRING_ENC_EBCDIC_US: rc = rz_str_ebcdic_us_to_unicode(b, &r); break;
+	default: break;
+	}
+	return !rc || rune_is_dead(r);
+}
+
+static inline bool utf8_is_dead(ut8 b) {
+	// lone continuation bytes, overlong and out of range leads never decode
+	return b < 0x80 ? rune_is_dead(b) : b < 0xc2 || b > 0xf7;
+}
+
+/**
+ * Fills \p ds for a scan of \p type strings. An offset is a dead start when
+ * the scan loop of rz_scan_strings_raw() would only move past it, leaving the
+ * list untouched.
+ */
+static bool dead_starts_init(DeadStarts *ds, RzStrEnc type, const RzUtilStrScanOptions *opt) {
+	memset(ds, 0, sizeof(*ds));
+	if (!opt->min_str_length) {
+		// empty strings are reported everywhere
+		return false;
+	}
+	switch (type) {
+	case RZ_STRING_ENC_GUESS:
+		for (int i = 1; i < 256; i++) {
+			// none of the can_be_*() is true or the first code point fails,
+			// and the IBM037 guess finds no printable character
+			ut8 b = i;
+			ds->dead[b] = utf8_is_dead(b) && (!can_be_ebcdic(&b, 1) || ebcdic_is_dead(RZ_STRING_ENC_IBM037, b));
+		}
+		// the big endian guesses need a non zero byte 3 bytes later
+		ds->zero_run = 4;
+		return true;
+	case RZ_STRING_ENC_UTF16LE:
+	case RZ_STRING_ENC_UTF16BE:
+		ds->zero_run = 2;
+		return true;
+	case RZ_STRING_ENC_UTF32LE:
+	case RZ_STRING_ENC_UTF32BE:
+		ds->zero_run = 4;
+		return true;
+	case RZ_STRING_ENC_IBM037:
+	case RZ_STRING_ENC_IBM290:
+	case RZ_STRING_ENC_EBCDIC_ES:
+	case RZ_STRING_ENC_EBCDIC_UK:
+	case RZ_STRING_ENC_EBCDIC_US:
+		for (int b = 0; b < 256; b++) {
+			ds->dead[b] = ebcdic_is_dead(type, b);
+		}
+		return true;
+	default:
+		for (int b = 0; b < 256; b++) {
+			ds->dead[b] = utf8_is_dead(b);
+		}
+		return true;
+	}
+}
+
+static inline ut64 read_word(const ut8 *p) {
+	ut64 w;
+	memcpy(&w, p, sizeof(w));
+	return w;
+}
+
+/**
+ * Skips the dead starts of [offset, size), eight offsets at a time while the
+ * same byte is repeated, as for padding.
+ *
+ * \return the offset of the first possible start
+ */
+static ut64 skip_dead_starts(const DeadStarts *ds, const ut8 *buf, ut64 offset, ut64 size) {
+	const ut64 zero_run = RZ_MAX(ds->zero_run, 1);
+	while (offset < size) {
+		ut8 b = buf[offset];
+		if (b || ds->dead[0]) {
+			if (!ds->dead[b]) {
+				break;
+			}
+			if (offset + 8 <= size && read_word(buf + offset) == b * 0x0101010101010101ULL) {
+				offset += 8;
+			} else {
+				offset++;
+			}
+			continue;
+		}
+		if (!ds->zero_run) {
+			break;
+		}
+		// the zero at offset + i is dead when the zero_run bytes from it are 0
+		if (offset + 8 + zero_run - 1 <= size && !read_word(buf + offset) && !read_word(buf + offset + zero_run - 1)) {
+			offset += 8;
+			continue;
+		}
+		if (offset + zero_run > size) {
+			break;
+		}
+		ut64 i = 1;
+		while (i < zero_run && !buf[offset + i]) {
+			i++;
+		}
+		if (i < zero_run) {
+			break;
+		}
+		offset++;
+	}
+	return offset;
+}
+
 /**
  * \brief Look for strings in a byte array, but returns only the first result.
  *
@@ -405,11 +535,23 @@ RZ_API int rz_scan_strings_raw(RZ_NONNULL const ut8 *buf, RZ_NONNULL RzList /*<R
 		return -1;
 	}
 
+	DeadStarts dead_starts;
+	bool skip_dead = dead_starts_init(&dead_starts, type, opt);
+
 	needle = from;
 	const ut8 *ptr = NULL;
 	ut64 size = 0;
 	int skip_ibm037 = 0;
 	while (needle < to) {
+		if (skip_dead) {
+			ut64 skipped = skip_dead_starts(&dead_starts, buf, needle - from, to - from) + from - needle;
+			if (skipped) {
+				// every dead start takes one step of the IBM037 back-off
+				skip_ibm037 = RZ_MAX((st64)skip_ibm037 - (st64)skipped, 0);
+				needle += skipped;
+				continue;
+			}
+		}
 		ptr = buf + needle - from;
 		size = to - needle;
 		--skip_ibm037;
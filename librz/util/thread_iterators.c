@@ -10,53 +10,72 @@
 #include <rz_th.h>
 #include <rz_util.h>
 
-static bool th_run_iterator(RzThreadFunction th_cb, void *context, RzThreadNCores max_threads) {
-	RzThreadPool *pool = rz_th_pool_new(max_threads);
-	if (!pool) {
-		RZ_LOG_ERROR("th: failed to allocate thread pool\n");
-		return false;
+/**
+ * Each worker is given several chunks of elements, so that the
+ * ones with cheap elements can steal the chunks of the others.
+ */
+#define TH_CHUNKS_PER_THREAD 8
+
+typedef struct th_chunk_s {
+	RzThreadIterator iterator;
+	void *user;
+	RzListIter /*<void *>*/ *head; ///< First element of a list chunk
+	const RzPVector /*<void *>*/ *pvec;
+	size_t index; ///< Index of the first element of the chunk
+	size_t length; ///< Number of elements of the chunk
+} th_chunk_t;
+
+static th_chunk_t *th_chunks_new(size_t length, RzThreadIterator iterator, RzThreadNCores max_threads, void *user, size_t *n_chunks) {
+	size_t n_threads = rz_th_max_threads(max_threads);
+	size_t chunk_size = (length + n_threads * TH_CHUNKS_PER_THREAD - 1) / (n_threads * TH_CHUNKS_PER_THREAD);
+	*n_chunks = (length + chunk_size - 1) / chunk_size;
+
+	th_chunk_t *chunks = RZ_NEWS0(th_chunk_t, *n_chunks);
+	if (!chunks) {
+		RZ_LOG_ERROR("th: failed to allocate the iteration chunks\n");
+		return NULL;
+	}
+	for (size_t i = 0; i < *n_chunks; ++i) {
+		chunks[i].iterator = iterator;
+		chunks[i].user = user;
+		chunks[i].index = i * chunk_size;
+		chunks[i].length = RZ_MIN(chunk_size, length - chunks[i].index);
 	}
+	return chunks;
+}
 
-	ut32 pool_size = rz_th_pool_size(pool);
-	RZ_LOG_VERBOSE("th: using %u threads for threaded iteration\n", pool_size);
-	for (ut32 i = 0; i < pool_size; ++i) {
-		RzThread *th = rz_th_new(th_cb, context);
-		rz_th_pool_add_thread(pool, th);
+static bool th_run_iterator(RzThreadTask task, th_chunk_t *chunks, size_t n_chunks, RzThreadNCores max_threads) {
+	RzThreadScheduler *sched = rz_th_scheduler_new(max_threads);
+	if (!sched) {
+		RZ_LOG_ERROR("th: failed to allocate thread scheduler\n");
+		return false;
+	}
+	RzThreadTaskGroup *group = rz_th_task_group_new(sched);
+	if (!group) {
+		RZ_LOG_ERROR("th: failed to allocate task group\n");
+		rz_th_scheduler_free(sched);
+		return false;
 	}
 
-	rz_th_pool_wait(pool);
-	rz_th_pool_free(pool);
-	return true;
+	RZ_LOG_VERBOSE("th: using %" PFMTSZu " threads for threaded iteration\n", rz_th_scheduler_size(sched));
+	bool retval = true;
+	for (size_t i = 0; i < n_chunks && retval; ++i) {
+		retval = rz_th_task_group_submit(group, task, &chunks[i]);
+	}
+	rz_th_task_group_wait(group);
+	rz_th_task_group_free(group);
+	rz_th_scheduler_free(sched);
+	return retval;
 }
 
-typedef struct th_list_ctx_s {
-	RzThreadLock *lock;
-	RzListIter /*<void *>*/ *head;
-	void *user;
-	RzThreadIterator iterator;
-} th_list_ctx_t;
-
-static void *thread_iterate_list_cb(th_list_ctx_t *context) {
-	void *element = NULL;
-	void *user = context->user;
-	RzThreadIterator iterator = context->iterator;
-	RzThreadLock *lock = context->lock;
-
-	do {
-		rz_th_lock_enter(lock);
-		if (!context->head) {
-			rz_th_lock_leave(lock);
-			break;
-		}
-		element = rz_list_iter_get_data(context->head);
-		context->head = rz_list_iter_get_next(context->head);
-		rz_th_lock_leave(lock);
-
+static void thread_iterate_list_cb(th_chunk_t *chunk) {
+	RzListIter *it = chunk->head;
+	for (size_t i = 0; i < chunk->length; ++i, it = rz_list_iter_get_next(it)) {
+		void *element = rz_list_iter_get_data(it);
 		if (element) {
-			iterator(element, user);
+			chunk->iterator(element, chunk->user);
 		}
-	} while (true);
-	return NULL;
+	}
 }
 
 /**
@@ -77,54 +96,32 @@ RZ_API bool rz_th_iterate_list(RZ_NONNULL const RzList /*<void *>*/ *list, RZ_NO
 		return true;
 	}
 
-	th_list_ctx_t context = {
-		.lock = rz_th_lock_new(true),
-		.head = list->head,
-		.iterator = iterator,
-		.user = user,
-	};
-
-	if (!context.lock) {
-		RZ_LOG_ERROR("th: failed to allocate list lock\n");
+	size_t n_chunks = 0;
+	th_chunk_t *chunks = th_chunks_new(rz_list_length(list), iterator, max_threads, user, &n_chunks);
+	if (!chunks) {
 		return false;
 	}
 
-	bool retval = th_run_iterator((RzThreadFunction)thread_iterate_list_cb, &context, max_threads);
-	rz_th_lock_free(context.lock);
+	RzListIter *it = list->head;
+	for (size_t i = 0; i < n_chunks; ++i) {
+		chunks[i].head = it;
+		for (size_t j = 0; j < chunks[i].length; ++j) {
+			it = rz_list_iter_get_next(it);
+		}
+	}
+
+	bool retval = th_run_iterator((RzThreadTask)thread_iterate_list_cb, chunks, n_chunks, max_threads);
+	free(chunks);
 	return retval;
 }
 
-typedef struct th_vec_ctx_s {
-	RzThreadLock *lock;
-	size_t index;
-	const RzPVector /*<void *>*/ *pvec;
-	void *user;
-	RzThreadIterator iterator;
-} th_vec_ctx_t;
-
-static void *thread_iterate_pvec_cb(th_vec_ctx_t *context) {
-	void *element = NULL;
-	void *user = context->user;
-	RzThreadIterator iterator = context->iterator;
-	RzThreadLock *lock = context->lock;
-	const RzPVector *pvec = context->pvec;
-	size_t length = rz_pvector_len(pvec);
-
-	do {
-		rz_th_lock_enter(lock);
-		if (context->index >= length) {
-			rz_th_lock_leave(lock);
-			break;
-		}
-		element = rz_pvector_at(pvec, context->index);
-		context->index++;
-		rz_th_lock_leave(lock);
-
+static void thread_iterate_pvec_cb(th_chunk_t *chunk) {
+	for (size_t i = chunk->index; i < chunk->index + chunk->length; ++i) {
+		void *element = rz_pvector_at(chunk->pvec, i);
 		if (element) {
-			iterator(element, user);
+			chunk->iterator(element, chunk->user);
 		}
-	} while (true);
-	return NULL;
+	}
 }
 
 /**
@@ -145,20 +142,16 @@ RZ_API bool rz_th_iterate_pvector(RZ_NONNULL const RzPVector /*<void *>*/ *pvec,
 		return true;
 	}
 
-	th_vec_ctx_t context = {
-		.lock = rz_th_lock_new(true),
-		.index = 0,
-		.pvec = pvec,
-		.iterator = iterator,
-		.user = user,
-	};
-
-	if (!context.lock) {
-		RZ_LOG_ERROR("th: failed to allocate vector lock\n");
+	size_t n_chunks = 0;
+	th_chunk_t *chunks = th_chunks_new(rz_pvector_len(pvec), iterator, max_threads, user, &n_chunks);
+	if (!chunks) {
 		return false;
 	}
+	for (size_t i = 0; i < n_chunks; ++i) {
+		chunks[i].pvec = pvec;
+	}
 
-	bool retval = th_run_iterator((RzThreadFunction)thread_iterate_pvec_cb, &context, max_threads);
-	rz_th_lock_free(context.lock);
+	bool retval = th_run_iterator((RzThreadTask)thread_iterate_pvec_cb, chunks, n_chunks, max_threads);
+	free(chunks);
 	return retval;
 }
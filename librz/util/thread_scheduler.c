@@ -0,0 +1,430 @@
+// SPDX-FileCopyrightText: 2026 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+/** \file thread_scheduler.c
+ * RzThreadScheduler runs small tasks on the threads of a RzThreadPool.
+ *
+ * Each worker thread owns a deque of tasks: it pops the newest task from its
+ * own deque and, once it is empty, steals the oldest tasks of the other
+ * workers, so tasks with uneven costs do not leave threads idle and the
+ * workers rarely compete for the same lock.
+ * Tasks are submitted to a RzThreadTaskGroup, which can be waited for or
+ * cancelled as a whole.
+ */
+
+#include <rz_th.h>
+#include <rz_util.h>
+
+#define TH_DEQUE_MIN_CAPACITY 32
+
+typedef struct th_task_s {
+	RzThreadTask function;
+	void *user;
+	RzThreadTaskGroup *group;
+} th_task_t;
+
+typedef struct th_deque_s {
+	RzThreadLock *lock;
+	th_task_t *tasks; ///< Ring buffer of tasks
+	size_t capacity; ///< Size of the ring buffer
+	size_t head; ///< Index of the oldest task, which is the one stolen
+	size_t length; ///< Number of queued tasks
+} th_deque_t;
+
+typedef struct th_worker_s {
+	RzThreadScheduler *sched;
+	size_t index; ///< Index of the deque owned by the worker
+} th_worker_t;
+
+struct rz_th_scheduler_t {
+	RzThreadPool *pool;
+	th_worker_t *workers;
+	th_deque_t *deques; ///< One deque for each worker
+	size_t size; ///< Number of workers
+	RzThreadLock *lock; ///< Guards the submissions and the fields below
+	RzThreadCond *wakeup; ///< Signalled when a task is submitted
+	size_t epoch; ///< Increased at each submission
+	size_t sleeping; ///< Number of workers waiting for tasks
+	size_t next; ///< Deque which receives the next submitted task
+	bool stop;
+};
+
+struct rz_th_task_group_t {
+	RzThreadScheduler *sched;
+	RzThreadLock *lock;
+	RzThreadCond *done; ///< Signalled when no task is pending
+	size_t pending; ///< Number of submitted tasks which did not complete
+	bool cancelled;
+};
+
+static bool th_deque_init(th_deque_t *deque) {
+	deque->lock = rz_th_lock_new(false);
+	deque->tasks = RZ_NEWS(th_task_t, TH_DEQUE_MIN_CAPACITY);
+	deque->capacity = TH_DEQUE_MIN_CAPACITY;
+	return deque->lock && deque->tasks;
+}
+
+static void th_deque_fini(th_deque_t *deque) {
+	rz_th_lock_free(deque->lock);
+	free(deque->tasks);
+}
+
+static bool th_deque_push(th_deque_t *deque, const th_task_t *task) {
+	bool res = true;
+	rz_th_lock_enter(deque->lock);
+	if (deque->length == deque->capacity) {
+		size_t capacity = deque->capacity * 2;
+		th_task_t *tasks = RZ_NEWS(th_task_t, capacity);
+		if (!tasks) {
+			res = false;
+			goto end;
+		}
+		for (size_t i = 0; i < deque->length; ++i) {
+			tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+		}
+		free(deque->tasks);
+		deque->tasks = tasks;
+		deque->capacity = capacity;
+		deque->head = 0;
+	}
+	deque->tasks[(deque->head + deque->length) % deque->capacity] = *task;
+	deque->length++;
+end:
+	rz_th_lock_leave(deque->lock);
+	return res;
+}
+
+/**
+ * Takes the newest task when the deque is owned by the caller,
+ * otherwise steals the oldest one.
+ */
+static bool th_deque_pop(th_deque_t *deque, bool owner, th_task_t *task) {
+	rz_th_lock_enter(deque->lock);
+	if (!deque->length) {
+		rz_th_lock_leave(deque->lock);
+		return false;
+	}
+	deque->length--;
+	if (owner) {
+		*task = deque->tasks[(deque->head + deque->length) % deque->capacity];
+	} else {
+		*task = deque->tasks[deque->head];
+		deque->head = (deque->head + 1) % deque->capacity;
+	}
+	rz_th_lock_leave(deque->lock);
+	return true;
+}
+
+/**
+ * Takes a task from the deque of the worker \p index, or steals one from
+ * the other workers. Threads which are not workers pass an index >= size.
+ */
+static bool th_scheduler_take(RzThreadScheduler *sched, size_t index, th_task_t *task) {
+	size_t start = 0;
+	if (index < sched->size) {
+		if (th_deque_pop(&sched->deques[index], true, task)) {
+			return true;
+		}
+		start = index + 1;
+	}
+	for (size_t i = 0; i < sched->size; ++i) {
+		size_t victim = (start + i) % sched->size;
+		if (victim != index && th_deque_pop(&sched->deques[victim], false, task)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void th_task_run(th_task_t *task) {
+	RzThreadTaskGroup *group = task->group;
+	if (!rz_th_task_group_is_cancelled(group)) {
+		task->function(task->user);
+	}
+	rz_th_lock_enter(group->lock);
+	group->pending--;
+	if (!group->pending) {
+		rz_th_cond_signal_all(group->done);
+	}
+	rz_th_lock_leave(group->lock);
+}
+
+static void *th_scheduler_worker(th_worker_t *worker) {
+	RzThreadScheduler *sched = worker->sched;
+	th_task_t task;
+
+	while (true) {
+		if (th_scheduler_take(sched, worker->index, &task)) {
+			th_task_run(&task);
+			continue;
+		}
+
+		rz_th_lock_enter(sched->lock);
+		size_t epoch = sched->epoch;
+		bool stop = sched->stop;
+		rz_th_lock_leave(sched->lock);
+		if (stop) {
+			break;
+		}
+
+		// a task submitted before reading the epoch might have been missed.
+		if (th_scheduler_take(sched, worker->index, &task)) {
+			th_task_run(&task);
+			continue;
+		}
+
+		rz_th_lock_enter(sched->lock);
+		if (!sched->stop && sched->epoch == epoch) {
+			sched->sleeping++;
+			rz_th_cond_wait(sched->wakeup, sched->lock);
+			sched->sleeping--;
+		}
+		rz_th_lock_leave(sched->lock);
+	}
+	return NULL;
+}
+
+/**
+ * \brief      Creates a new scheduler and starts its worker threads.
+ *
+ * \param[in]  max_threads  The maximum number of worker threads (0 for all the cores)
+ *
+ * \return     On success returns a valid pointer, otherwise NULL.
+ */
+RZ_API RZ_OWN RzThreadScheduler *rz_th_scheduler_new(RzThreadNCores max_threads) {
+	RzThreadScheduler *sched = RZ_NEW0(RzThreadScheduler);
+	if (!sched) {
+		return NULL;
+	}
+
+	sched->pool = rz_th_pool_new(max_threads);
+	sched->lock = rz_th_lock_new(false);
+	sched->wakeup = rz_th_cond_new();
+	if (!sched->pool || !sched->lock || !sched->wakeup) {
+		goto fail;
+	}
+
+	size_t size = rz_th_pool_size(sched->pool);
+	sched->workers = RZ_NEWS0(th_worker_t, size);
+	sched->deques = RZ_NEWS0(th_deque_t, size);
+	if (!sched->workers || !sched->deques) {
+		goto fail;
+	}
+	for (; sched->size < size; sched->size++) {
+		if (!th_deque_init(&sched->deques[sched->size])) {
+			th_deque_fini(&sched->deques[sched->size]);
+			goto fail;
+		}
+	}
+
+	for (size_t i = 0; i < size; ++i) {
+		th_worker_t *worker = &sched->workers[i];
+		worker->sched = sched;
+		worker->index = i;
+		RzThread *th = rz_th_new((RzThreadFunction)th_scheduler_worker, worker);
+		if (!th) {
+			goto fail;
+		}
+		rz_th_pool_add_thread(sched->pool, th);
+	}
+	RZ_LOG_VERBOSE("th: scheduler started with %" PFMTSZu " workers\n", size);
+	return sched;
+
+fail:
+	RZ_LOG_ERROR("th: failed to allocate the thread scheduler\n");
+	rz_th_scheduler_free(sched);
+	return NULL;
+}
+
+/**
+ * \brief  Stops the worker threads and frees the scheduler.
+ *
+ * All the task groups of the scheduler must have been freed before.
+ *
+ * \param  sched  The RzThreadScheduler to free
+ */
+RZ_API void rz_th_scheduler_free(RZ_NULLABLE RzThreadScheduler *sched) {
+	if (!sched) {
+		return;
+	}
+	if (sched->pool && sched->lock && sched->wakeup) {
+		rz_th_lock_enter(sched->lock);
+		sched->stop = true;
+		rz_th_cond_signal_all(sched->wakeup);
+		rz_th_lock_leave(sched->lock);
+		rz_th_pool_wait(sched->pool);
+	}
+	rz_th_pool_free(sched->pool);
+	for (size_t i = 0; i < sched->size; ++i) {
+		th_deque_fini(&sched->deques[i]);
+	}
+	free(sched->deques);
+	free(sched->workers);
+	rz_th_cond_free(sched->wakeup);
+	rz_th_lock_free(sched->lock);
+	free(sched);
+}
+
+/**
+ * \brief  Returns the number of worker threads of the scheduler
+ *
+ * \param  sched  The RzThreadScheduler to use
+ *
+ * \return The number of worker threads (always >= 1).
+ */
+RZ_API size_t rz_th_scheduler_size(RZ_NONNULL RzThreadScheduler *sched) {
+	rz_return_val_if_fail(sched, 1);
+	return sched->size;
+}
+
+/**
+ * \brief      Creates a new empty task group which runs its tasks on \p sched
+ *
+ * \param      sched  The scheduler which runs the tasks
+ *
+ * \return     On success returns a valid pointer, otherwise NULL.
+ */
+RZ_API RZ_OWN RzThreadTaskGroup *rz_th_task_group_new(RZ_NONNULL RzThreadScheduler *sched) {
+	rz_return_val_if_fail(sched, NULL);
+	RzThreadTaskGroup *group = RZ_NEW0(RzThreadTaskGroup);
+	if (!group) {
+		return NULL;
+	}
+	group->sched = sched;
+	group->lock = rz_th_lock_new(false);
+	group->done = rz_th_cond_new();
+	if (!group->lock || !group->done) {
+		rz_th_cond_free(group->done);
+		rz_th_lock_free(group->lock);
+		free(group);
+		return NULL;
+	}
+	return group;
+}
+
+/**
+ * \brief  Waits for the pending tasks of the group and frees it.
+ *
+ * \param  group  The RzThreadTaskGroup to free
+ */
+RZ_API void rz_th_task_group_free(RZ_NULLABLE RzThreadTaskGroup *group) {
+	if (!group) {
+		return;
+	}
+	rz_th_task_group_wait(group);
+	rz_th_cond_free(group->done);
+	rz_th_lock_free(group->lock);
+	free(group);
+}
+
+/**
+ * \brief      Submits a task to the group; the task will run on one of the
+ *             worker threads and can submit new tasks too.
+ *
+ * \param      group  The task group to use
+ * \param[in]  task   The function to run
+ * \param      user   The pointer passed to the function
+ *
+ * \return     Returns false when the group was cancelled or on allocation errors, otherwise true.
+ */
+RZ_API bool rz_th_task_group_submit(RZ_NONNULL RzThreadTaskGroup *group, RZ_NONNULL RzThreadTask task, RZ_NULLABLE void *user) {
+	rz_return_val_if_fail(group && task, false);
+	RzThreadScheduler *sched = group->sched;
+	th_task_t entry = {
+		.function = task,
+		.user = user,
+		.group = group,
+	};
+
+	rz_th_lock_enter(group->lock);
+	if (group->cancelled) {
+		rz_th_lock_leave(group->lock);
+		return false;
+	}
+	group->pending++;
+	rz_th_lock_leave(group->lock);
+
+	rz_th_lock_enter(sched->lock);
+	th_deque_t *deque = &sched->deques[sched->next];
+	sched->next = (sched->next + 1) % sched->size;
+	bool pushed = th_deque_push(deque, &entry);
+	if (pushed) {
+		sched->epoch++;
+		if (sched->sleeping) {
+			rz_th_cond_signal(sched->wakeup);
+		}
+	}
+	rz_th_lock_leave(sched->lock);
+
+	if (!pushed) {
+		RZ_LOG_ERROR("th: failed to submit the task\n");
+		rz_th_lock_enter(group->lock);
+		group->pending--;
+		if (!group->pending) {
+			rz_th_cond_signal_all(group->done);
+		}
+		rz_th_lock_leave(group->lock);
+	}
+	return pushed;
+}
+
+/**
+ * \brief  Waits until all the tasks submitted to the group have completed.
+ *
+ * While waiting, the calling thread runs the queued tasks too, thus a
+ * task can wait for the tasks it has submitted.
+ *
+ * \param  group  The task group to wait for
+ *
+ * \return Returns false when the group was cancelled, otherwise true.
+ */
+RZ_API bool rz_th_task_group_wait(RZ_NONNULL RzThreadTaskGroup *group) {
+	rz_return_val_if_fail(group, false);
+	RzThreadScheduler *sched = group->sched;
+	th_task_t task;
+
+	rz_th_lock_enter(group->lock);
+	while (group->pending) {
+		rz_th_lock_leave(group->lock);
+		bool found = th_scheduler_take(sched, SIZE_MAX, &task);
+		if (found) {
+			th_task_run(&task);
+		}
+		rz_th_lock_enter(group->lock);
+		if (!found && group->pending) {
+			rz_th_cond_wait(group->done, group->lock);
+		}
+	}
+	bool cancelled = group->cancelled;
+	rz_th_lock_leave(group->lock);
+	return !cancelled;
+}
+
+/**
+ * \brief  Cancels the group: the queued tasks are dropped without running
+ *         and new submissions are refused.
+ *
+ * Running tasks are not interrupted, but they can poll
+ * rz_th_task_group_is_cancelled() to stop early.
+ *
+ * \param  group  The task group to cancel
+ */
+RZ_API void rz_th_task_group_cancel(RZ_NONNULL RzThreadTaskGroup *group) {
+	rz_return_if_fail(group);
+	rz_th_lock_enter(group->lock);
+	group->cancelled = true;
+	rz_th_lock_leave(group->lock);
+}
+
+/**
+ * \brief  Returns true when the group was cancelled
+ *
+ * \param  group  The task group to check
+ */
+RZ_API bool rz_th_task_group_is_cancelled(RZ_NONNULL RzThreadTaskGroup *group) {
+	rz_return_val_if_fail(group, true);
+	rz_th_lock_enter(group->lock);
+	bool cancelled = group->cancelled;
+	rz_th_lock_leave(group->lock);
+	return cancelled;
+}
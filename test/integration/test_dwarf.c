@@ -1475,6 +1475,265 @@ bool test_dwarf4_loclists(void) {
 	mu_end;
 }
 
+bool test_dwarf4_resume_fbreg_after_release(void) {
+	RzBin *bin = rz_bin_new();
+	RzIO *io = rz_io_new();
+	rz_io_bind(io, &bin->iob);
+
+	RzBinOptions opt = { 0 };
+	rz_bin_options_init(&opt, 0, 0, 0, false);
+	RzBinFile *bf = rz_bin_open(bin, "bins/elf/dwarf4_many_comp_units.elf", &opt);
+	mu_assert_notnull(bf, "couldn't open file");
+
+	RzBinDWARF *dw = rz_bin_dwarf_from_file(bf);
+	mu_assert_notnull(dw->info, ".debug_info");
+
+	// a function whose frame base is DW_OP_call_frame_cfa
+	RzBinDwarfCompUnit *cu = NULL, *fn_cu = NULL;
+	RzBinDwarfDie *die = NULL, *fn_die = NULL;
+	rz_vector_foreach (&dw->info->units, cu) {
+		rz_vector_foreach (rz_bin_dwarf_unit_dies(dw, cu), die) {
+			RzBinDwarfAttr *fb = die->tag == DW_TAG_subprogram ? rz_bin_dwarf_die_get_attr(die, DW_AT_frame_base) : NULL;
+			if (fb && fb->value.kind == RzBinDwarfAttr_Block && rz_bin_dwarf_attr_block(fb)->length == 1 &&
+				rz_bin_dwarf_block_data(rz_bin_dwarf_attr_block(fb))[0] == DW_OP_call_frame_cfa) {
+				fn_die = die;
+				break;
+			}
+		}
+		if (fn_die) {
+			fn_cu = cu;
+			break;
+		}
+	}
+	mu_assert_notnull(fn_die, "function with a frame base");
+	ut64 fn_offset = fn_die->offset;
+
+	// DW_OP_form_tls_address waits, DW_OP_fbreg -20 is evaluated on resume
+	ut8 expr[] = { DW_OP_form_tls_address, DW_OP_fbreg, 0x6c };
+	RzBinDwarfBlock block = { .data = expr, .length = sizeof(expr) };
+	RzBinDwarfLocation *loc = rz_bin_dwarf_location_from_block(&block, dw, fn_cu, fn_die);
+	mu_assert_notnull(loc, "location");
+	mu_assert_eq(loc->kind, RzBinDwarfLocationKind_EVALUATION_WAITING, "waiting for the TLS address");
+
+	rz_bin_dwarf_unit_dies_release(dw->info, fn_cu);
+	mu_assert_false(rz_bin_dwarf_unit_dies_loaded(fn_cu), "DIEs released");
+
+	RzBinDwarfEvaluation *eval = loc->eval_waiting.eval;
+	mu_assert_true(rz_bin_dwarf_evaluation_evaluate(eval, loc->eval_waiting.result), "resumed evaluation");
+	RzVector *pieces = rz_bin_dwarf_evaluation_result(eval);
+	mu_assert_notnull(pieces, "evaluation complete");
+	mu_assert_eq(rz_vector_len(pieces), 1, "one piece");
+	RzBinDwarfPiece *piece = rz_vector_index_ptr(pieces, 0);
+	mu_assert_eq(piece->location->kind, RzBinDwarfLocationKind_CFA_OFFSET, "frame base resolved");
+	mu_assert_eq(piece->location->offset, -20, "frame offset");
+	mu_assert_eq(eval->fn_die->offset, fn_offset, "function DIE looked up again");
+	rz_bin_dwarf_location_free(loc);
+
+	rz_bin_dwarf_free(dw);
+	rz_bin_free(bin);
+	rz_io_free(io);
+	mu_end;
+}
+
+/**
+ * Three DWARF 5 units with location lists, built with gcc 12 by
+ * `gcc -gdwarf-5 -O2 -nostdlib -static a.c b.c c.c` from:
+ *
+ *	a.c: int scale(int v, int k) { int r = v * k; for (int i = 0; i < k; i++) { r ^= i; } return r; }
+ *	b.c: int sum(const int *a, int n) { int s = 0; for (int i = 0; i < n; i++) { s += scale(a[i], i); } return s; }
+ *	c.c: static int data[4] = { 1, 2, 3, 4 }; int _start(void) { return sum(data, 4); }
+ *
+ * and stripped to the debug sections with objcopy.
+ */
+static const char dwarf5_units_elf[] = "hex://"
+	"7f454c4602010100000000000000000002003e000100000080104000000000004000000000000000e0080000000000000000000040003800040040000b000a00"
+	"01000000040000000000000000000000000040000000000000004000000000002001000000000000200100000000000000100000000000000100000005000000"
+	"20010000000000000010400000000000000000000000000000000000000000000000000000000000001000000000000001000000060000002001000000000000"
+	"0020400000000000000000000000000000000000000000000000000000000000001000000000000051e574640600000000000000000000000000000000000000"
+	"00000000000000000000000000000000000000000000000008000000000000009d000000050001080000000003060000001d0900000000000000001040000000"
+	"00001a000000000000000000000004000000000101059900000000104000000000001a00000000000000019c990000000176000f990000000155016b00169900"
+	"000001540272000206990000000e0000000c0000000505104000000000001400000000000000026900030b9900000018000000140000000000060405696e7400"
+	"00d0000000050001086d00000004060000001d0d0000000000000020104000000000005700000000000000860000000500000000010105490000004900000001"
+	"49000000014900000000060405696e740007490000000873756d000102054900000020104000000000005700000000000000019ccd00000002610014cd000000"
+	"3800000030000000026e001b4900000058000000500000000373000306490000007800000070000000090c000000036900040b49000000970000008f0000000a"
+	"50104000000000002e00000000000b085000000000c4000000050001081201000003060000001d1100000000000000801040000000000011000000000000002a"
+	"01000004450000003e000000053e00000003000608076c000000070405696e74000845000000096000000001020c2e000000090300204000000000000a73756d"
+	"00010105450000008200000001820000000145000000000b084c0000000c650000000103054500000080104000000000001100000000000000019c0d91104000"
+	"000000006700000002015509030020400000000000020154013400000001050003083a21013b2101390b49130218000002340003083a21013b0b390b49130217"
+	"b742170000031101250e130b031f1b1f1101120710170000042e013f19030e3a0b3b0b390b271949131101120740187a1901130000050b011101120700000624"
+	"000b0b3e0b03080000000105004913000002050003083a21013b2102390b49130217b74217000003340003083a21013b0b390b49130217b74217000004110125"
+	"0e130b031f1b1f1101120710170000052e013f19030e3a0b3b0b390b271949133c19011300000624000b0b3e0b0308000007260049130000082e013f1903083a"
+	"0b3b0b390b271949131101120740187a1901130000090b01551700000a48007d017f1300000b0f000b0b49130000000105004913000002490002187e18000003"
+	"1101250e130b031f1b1f110112071017000004010149130113000005210049132f0b00000624000b0b3e0b030e00000724000b0b3e0b03080000082600491300"
+	"00093400030e3a0b3b0b390b4913021800000a2e013f1903083a0b3b0b390b271949133c19011300000b0f000b0b491300000c2e013f19030e3a0b3b0b390b27"
+	"1949131101120740187a1900000d48017d018201197f1300000082000000050008002a000000010101fb0e0d00010101010000000100000101011f0100000000"
+	"02011f020f020900000000090000000005190009020010400000000000010502130506060105020659050701051401050b064a05030002040306750505000204"
+	"030601051a00020403062d0514000204033c00020403064a0501160201000101a0000000050008002a000000010101fb0e0d0001010101000000010000010101"
+	"1f010000000002011f020f020d000000000d00000000051e00090220104000000000001305021313050701051401051e06100514a00506b905030002040306a0"
+	"0508000204030601051400020403730508000204034b05050002040358051a00020403062d051400020403010501065c822e2e58050645050206320501061302"
+	"090001014b000000050008002a000000010101fb0e0d00010101010000000100000101011f010000000002011f020f0211000000001100000000051200090280"
+	"104000000000001405021305090601080001017363616c6500474e55204331372031322e322e30202d6d74756e653d67656e65726963202d6d617263683d7838"
+	"362d3634202d6764776172662d35202d4f32202d666e6f2d6173796e6368726f6e6f75732d756e77696e642d7461626c65730064617461005f7374617274006c"
+	"6f6e6720756e7369676e656420696e74002f746d702f64356d00612e6300622e6300632e6300200000000500080000000000000004051a015000020000000405"
+	"0b02309f040b1901510086000000050008000000000000000000000000000400180155041843015d04434404a301559f04445701550000000000000000000400"
+	"180154041841015c04414404a301549f044457015400020000000000000004001802309f04183f0156043f44015004445702309f000400000000000000040018"
+	"02309f04182b0153042b2f015404445702309f00120000000500080000000000040000040a160420370000000000000000000000000000000000000000000000"
+	"0000000000000000010000000400f1ff00000000000000000000000000000000050000000400f1ff00000000000000000000000000000000090000000400f1ff"
+	"0000000000000000000000000000000000612e6300622e6300632e6300002e73796d746162002e737472746162002e7368737472746162002e64656275675f69"
+	"6e666f002e64656275675f616262726576002e64656275675f6c696e65002e64656275675f737472002e64656275675f6c696e655f737472002e64656275675f"
+	"6c6f636c69737473002e64656275675f726e676c6973747300000000000000000000000000000000000000000000000000000000000000000000000000000000"
+	"00000000000000000000000000000000000000000000000000000000000000001b00000001000000000000000000000000000000000000002001000000000000"
+	"3d020000000000000000000000000000010000000000000000000000000000002700000001000000000000000000000000000000000000005d03000000000000"
+	"bd010000000000000000000000000000010000000000000000000000000000003500000001000000000000000000000000000000000000001a05000000000000"
+	"79010000000000000000000000000000010000000000000000000000000000004100000001000000300000000000000000000000000000009306000000000000"
+	"7e000000000000000000000000000000010000000000000001000000000000004c00000001000000300000000000000000000000000000001107000000000000"
+	"15000000000000000000000000000000010000000000000001000000000000005c00000001000000000000000000000000000000000000002607000000000000"
+	"ae000000000000000000000000000000010000000000000000000000000000006c0000000100000000000000000000000000000000000000d407000000000000"
+	"1600000000000000000000000000000001000000000000000000000000000000010000000200000000000000000000000000000000000000f007000000000000"
+	"60000000000000000900000004000000080000000000000018000000000000000900000003000000000000000000000000000000000000005008000000000000"
+	"0d000000000000000000000000000000010000000000000000000000000000001100000003000000000000000000000000000000000000005d08000000000000"
+	"7c00000000000000000000000000000001000000000000000000000000000000";
+
+static size_t location_unit_index(const RzBinDwarfInfo *info, const RzBinDwarfEncoding *encoding) {
+	size_t index = 0;
+	RzBinDwarfCompUnit *unit = NULL;
+	rz_vector_foreach (&info->units, unit) {
+		if (&unit->hdr.encoding == encoding) {
+			return index;
+		}
+		index++;
+	}
+	return SIZE_MAX;
+}
+
+typedef struct {
+	const RzBinDwarfInfo *info;
+	const RzBinDwarfInfo *other;
+	size_t mismatches;
+} LocationsCmp;
+
+static bool location_encoding_cmp_cb(void *user, const ut64 offset, const void *value) {
+	LocationsCmp *cmp = user;
+	const RzBinDwarfEncoding *other = ht_up_find(cmp->other->location_encoding, offset, NULL);
+	if (!other || location_unit_index(cmp->info, value) != location_unit_index(cmp->other, other)) {
+		cmp->mismatches++;
+	}
+	return true;
+}
+
+/**
+ * \brief Loads the DWARF of \p bf, then decodes all its DIEs and line programs with \p max_threads threads
+ */
+static RzBinDWARF *dwarf_load_all(RzBinFile *bf, RzThreadNCores max_threads) {
+	RzBinDWARF *dw = rz_bin_dwarf_from_file(bf);
+	if (!dw || !dw->info) {
+		return dw;
+	}
+	dw->max_threads = max_threads;
+	rz_bin_dwarf_line_free(dw->line);
+	dw->line = rz_bin_dwarf_line_from_file(dw, bf);
+
+	RzPVector units;
+	rz_pvector_init(&units, NULL);
+	RzBinDwarfCompUnit *unit = NULL;
+	rz_vector_foreach (&dw->info->units, unit) {
+		rz_pvector_push(&units, unit);
+	}
+	rz_bin_dwarf_units_dies_load(dw, &units);
+	rz_pvector_fini(&units);
+	return dw;
+}
+
+/**
+ * \brief Checks that the units of \p path are decoded the same way serially and by several threads
+ */
+static bool check_dwarf_threads_eq(const char *path, ut16 version) {
+	RzBin *bin = rz_bin_new();
+	RzIO *io = rz_io_new();
+	rz_io_bind(io, &bin->iob);
+
+	RzBinOptions opt = { 0 };
+	rz_bin_options_init(&opt, 0, 0, 0, false);
+	RzBinFile *bf = rz_bin_open(bin, path, &opt);
+	mu_assert_notnull(bf, "couldn't open file");
+
+	RzBinDWARF *serial = dwarf_load_all(bf, 1);
+	RzBinDWARF *threaded = dwarf_load_all(bf, 4);
+	mu_assert_notnull(serial, "serial dwarf");
+	mu_assert_notnull(threaded, "threaded dwarf");
+	mu_assert_notnull(serial->info, "serial .debug_info");
+	mu_assert_notnull(threaded->info, "threaded .debug_info");
+
+	// units and DIEs
+	size_t n_units = rz_vector_len(&serial->info->units);
+	mu_assert_true(n_units > 1, "several units");
+	mu_assert_eq(rz_vector_len(&threaded->info->units), n_units, "units count");
+	mu_assert_eq(threaded->info->die_count, serial->info->die_count, "DIEs count");
+	for (size_t i = 0; i < n_units; i++) {
+		RzBinDwarfCompUnit *su = rz_vector_index_ptr(&serial->info->units, i);
+		RzBinDwarfCompUnit *tu = rz_vector_index_ptr(&threaded->info->units, i);
+		mu_assert_eq(su->hdr.encoding.version, version, "unit version");
+		mu_assert_eq(tu->offset, su->offset, "unit offset");
+		mu_assert_eq(tu->hdr.length, su->hdr.length, "unit length");
+		mu_assert_eq(tu->hdr.encoding.version, su->hdr.encoding.version, "unit version");
+		mu_assert_eq(tu->hdr.encoding.address_size, su->hdr.encoding.address_size, "unit address size");
+		mu_assert_nullable_streq(tu->name, su->name, "unit name");
+		mu_assert_eq(tu->low_pc, su->low_pc, "unit low pc");
+		mu_assert_eq(tu->stmt_list, su->stmt_list, "unit stmt list");
+
+		RzVector *sdies = rz_bin_dwarf_unit_dies(serial, su);
+		RzVector *tdies = rz_bin_dwarf_unit_dies(threaded, tu);
+		mu_assert_true(rz_vector_len(sdies) > 1, "unit DIEs");
+		mu_assert_eq(rz_vector_len(tdies), rz_vector_len(sdies), "unit DIEs count");
+		for (size_t j = 0; j < rz_vector_len(sdies); j++) {
+			RzBinDwarfDie *sd = rz_vector_index_ptr(sdies, j);
+			RzBinDwarfDie *td = rz_vector_index_ptr(tdies, j);
+			mu_assert_eq(td->offset, sd->offset, "DIE offset");
+			mu_assert_eq(td->tag, sd->tag, "DIE tag");
+			mu_assert_eq(td->abbrev_code, sd->abbrev_code, "DIE abbrev code");
+			mu_assert_eq(td->depth, sd->depth, "DIE depth");
+			mu_assert_eq(td->sibling, sd->sibling, "DIE sibling");
+			mu_assert_eq(rz_vector_len(&td->attrs), rz_vector_len(&sd->attrs), "DIE attributes count");
+		}
+	}
+
+	// every location refers to the encoding of the same unit
+	mu_assert_eq(threaded->info->location_encoding->count, serial->info->location_encoding->count, "locations count");
+	LocationsCmp cmp = { .info = serial->info, .other = threaded->info };
+	ht_up_foreach(serial->info->location_encoding, location_encoding_cmp_cb, &cmp);
+	mu_assert_eq(cmp.mismatches, 0, "location encodings");
+
+	// line programs
+	mu_assert_notnull(serial->line, "serial .debug_line");
+	mu_assert_notnull(threaded->line, "threaded .debug_line");
+	mu_assert_true(rz_pvector_len(serial->line->units) > 1, "several line programs");
+	mu_assert_eq(rz_pvector_len(threaded->line->units), rz_pvector_len(serial->line->units), "line programs count");
+	RzBinSourceLineInfo *lines = serial->line->lines;
+	mu_assert_notnull(lines, "serial line samples");
+	mu_assert_true(lines->samples_count > 0, "line samples");
+	assert_line_samples_eq(threaded->line->lines, lines->samples_count, lines->samples);
+
+	rz_bin_dwarf_free(serial);
+	rz_bin_dwarf_free(threaded);
+	rz_bin_free(bin);
+	rz_io_free(io);
+	return true;
+}
+
+bool test_dwarf4_units_threads(void) {
+	if (!check_dwarf_threads_eq("bins/elf/dwarf4_many_comp_units.elf", 4)) {
+		return false;
+	}
+	mu_end;
+}
+
+bool test_dwarf5_units_threads(void) {
+	if (!check_dwarf_threads_eq(dwarf5_units_elf, 5)) {
+		return false;
+	}
+	mu_end;
+}
+
 bool all_tests() {
 	srand(time(0));
 	mu_run_test(test_dwarf3_c_basic);
@@ -1488,6 +1747,9 @@ bool all_tests() {
 	mu_run_test(test_dwarf3_aranges);
 	mu_run_test(test_dwarf5_loclists);
 	mu_run_test(test_dwarf4_loclists);
+	mu_run_test(test_dwarf4_resume_fbreg_after_release);
+	mu_run_test(test_dwarf4_units_threads);
+	mu_run_test(test_dwarf5_units_threads);
 	return tests_passed != tests_run;
 }
 
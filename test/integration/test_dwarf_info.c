@@ -7,7 +7,7 @@
 #include "../unit/minunit.h"
 
 #define UNIT(i) cu = rz_vector_index_ptr(&dw->info->units, i);
-#define DIE(i)  die = rz_vector_index_ptr(&cu->dies, i);
+#define DIE(i)  die = rz_vector_index_ptr(rz_bin_dwarf_unit_dies(dw, cu), i);
 #define ATTR(i) attr = rz_vector_index_ptr(&die->attrs, i);
 
 #define check_attr_string(attr_idx, expect_string) \
@@ -85,8 +85,17 @@ bool test_dwarf3_c(void) {
 
 	check_basic_unit_header(3, 0xa9, false, 8, 0x0);
 
-	mu_assert_eq(rz_vector_len(&cu->dies), 11, "Wrong attribute information");
+	// only the unit DIE is read while loading, the others are decoded on demand
+	mu_assert_false(rz_bin_dwarf_unit_dies_loaded(cu), "DIEs decoded before being accessed");
+	mu_assert_streq(cu->name, "main.c", "Wrong compilation unit name");
+	mu_assert_eq(rz_vector_len(rz_bin_dwarf_unit_dies(dw, cu)), 11, "Wrong attribute information");
+	mu_assert_true(rz_bin_dwarf_unit_dies_loaded(cu), "DIEs not decoded");
 	mu_assert_eq(cu->offset, 0x0, "Wrong attribute information");
+	mu_assert_ptreq(rz_bin_dwarf_unit_at(dw->info, 0x40), cu, "Wrong unit at offset");
+	mu_assert_null(rz_bin_dwarf_unit_at(dw->info, 0xad), "Unit past the end of the section");
+	RzBinDwarfDie *last = rz_vector_tail(rz_bin_dwarf_unit_dies(dw, cu));
+	mu_assert_ptreq(rz_bin_dwarf_die_at(dw, last->offset), last, "Wrong DIE at offset");
+	mu_assert_null(rz_bin_dwarf_die_at(dw, last->offset + 1), "DIE in the middle of another");
 
 	// check some of the attributes
 	int i = 0;
@@ -154,7 +163,7 @@ bool test_dwarf4_cpp_multiple_modules(void) {
 	check_basic_unit_header(4, 0x2c0, false, 8, 0x0);
 
 	// check some of the attributes
-	mu_assert_eq(rz_vector_len(&cu->dies), 73, "Wrong attribute information");
+	mu_assert_eq(rz_vector_len(rz_bin_dwarf_unit_dies(dw, cu)), 73, "Wrong attribute information");
 	mu_assert_eq(cu->offset, 0x0, "Wrong attribute information");
 
 	int i = 0;
@@ -283,7 +292,7 @@ bool test_dwarf4_cpp_multiple_modules(void) {
 	check_basic_unit_header(4, 0x192, false, 8, 0xfd);
 
 	// check some of the attributes
-	mu_assert_eq(rz_vector_len(&cu->dies), 42, "Wrong attribute information");
+	mu_assert_eq(rz_vector_len(rz_bin_dwarf_unit_dies(dw, cu)), 42, "Wrong attribute information");
 	mu_assert_eq(cu->offset, 0x2c4, "Wrong attribute information");
 
 	i = 0;
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2024 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include "minunit.h"
+
+static RzAnalysisEsil *esil_new(RzAnalysis *analysis) {
+	RzAnalysisEsil *esil = rz_analysis_esil_new(32, 0, 64);
+	if (esil) {
+		rz_analysis_esil_setup(esil, analysis, 0, 0, 0);
+	}
+	return esil;
+}
+
+/* the whole stack joined by spaces, from the bottom */
+static char *esil_stack_str(RzAnalysisEsil *esil) {
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	for (int i = 0; i < esil->stackptr; i++) {
+		rz_strbuf_appendf(&sb, "%s%s", i ? " " : "", esil->stack[i]);
+	}
+	rz_analysis_esil_stack_free(esil);
+	return rz_strbuf_drain_nofree(&sb);
+}
+
+static const struct {
+	const char *expr;
+	bool ret;
+	int trap;
+	const char *stack;
+} esil_tests[] = {
+	{ "1,2,+,3,*", true, 0, "0x9" },
+	{ "1,?{,5,}{,6,}", true, 0, "5" },
+	{ "0,?{,5,?{,7,},}{,6,}", true, 0, "6" },
+	{ "1,2,BREAK,3", false, 0, "1 2" },
+	{ "1,3,GOTO,9,8", true, 0, "1 9 8" },
+	{ "1,9,GOTO", false, 0, "1" },
+	{ "0,GOTO", false, 1, "0" },
+	{ "0,1,+,DUP,3,-,!,?{,BREAK,},1,GOTO", false, 0, "0x3" },
+	// not compiled
+	{ "1,,2", true, 0, "1" },
+	{ "1;2", false, 0, "1" },
+};
+
+static bool test_esil_parse(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisEsil *esil = esil_new(analysis);
+	mu_assert_notnull(esil, "esil");
+	// the second round runs the cached expressions
+	for (int round = 0; round < 2; round++) {
+		for (size_t i = 0; i < RZ_ARRAY_SIZE(esil_tests); i++) {
+			bool ret = rz_analysis_esil_parse(esil, esil_tests[i].expr);
+			mu_assert_eq(ret, esil_tests[i].ret, esil_tests[i].expr);
+			mu_assert_eq(esil->trap, esil_tests[i].trap, esil_tests[i].expr);
+			char *stack = esil_stack_str(esil);
+			mu_assert_streq(stack, esil_tests[i].stack, esil_tests[i].expr);
+			free(stack);
+		}
+	}
+	rz_analysis_esil_free(esil);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+static bool esil_answer(RzAnalysisEsil *esil) {
+	return rz_analysis_esil_pushnum(esil, 42);
+}
+
+static bool test_esil_parse_new_op(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzAnalysisEsil *esil = esil_new(analysis);
+	mu_assert_notnull(esil, "esil");
+	mu_assert_true(rz_analysis_esil_parse(esil, "1,ANSWER"), "parse");
+	char *stack = esil_stack_str(esil);
+	mu_assert_streq(stack, "1 ANSWER", "unknown word is pushed");
+	free(stack);
+
+	// registering an operation must not be hidden by the cached expression
+	rz_analysis_esil_set_op(esil, "ANSWER", esil_answer, 1, 0, RZ_ANALYSIS_ESIL_OP_TYPE_CUSTOM);
+	mu_assert_true(rz_analysis_esil_parse(esil, "1,ANSWER"), "parse");
+	stack = esil_stack_str(esil);
+	mu_assert_streq(stack, "1 0x2a", "new operation is run");
+	free(stack);
+	rz_analysis_esil_free(esil);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+static bool test_esil_parse_regs(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	rz_reg_set_profile_string(analysis->reg,
+		"=PC pc\n=SP sp\n=BP bp\n"
+		"gpr a .64 0 0\ngpr b .64 8 0\ngpr al .8 0 0\n"
+		"gpr pc .64 16 0\ngpr sp .64 24 0\ngpr bp .64 32 0\n");
+	RzAnalysisEsil *esil = esil_new(analysis);
+	mu_assert_notnull(esil, "esil");
+	// the second round runs the cached expressions, with the registers already resolved
+	for (int round = 0; round < 2; round++) {
+		mu_assert_true(rz_analysis_esil_parse(esil, "0x10,a,=,a,2,+,b,="), "parse");
+		mu_assert_eq(rz_reg_getv(analysis->reg, "b"), 0x12, "b");
+		mu_assert_true(rz_analysis_esil_parse(esil, "-3,b,=,0x1234,al,=,PC,pc,="), "parse");
+		mu_assert_eq(rz_reg_getv(analysis->reg, "b"), (ut64)-3, "negative immediate");
+		mu_assert_eq(rz_reg_getv(analysis->reg, "a"), 0x34, "packed register");
+		mu_assert_false(rz_analysis_esil_parse(esil, "1,nope,="), "unknown register");
+	}
+
+	// a new profile frees the registers the cached expressions were resolved to
+	rz_reg_set_profile_string(analysis->reg,
+		"=PC pc\n=SP sp\n=BP bp\n"
+		"gpr b .64 0 0\ngpr a .32 8 0\n"
+		"gpr pc .64 16 0\ngpr sp .64 24 0\ngpr bp .64 32 0\n");
+	mu_assert_true(rz_analysis_esil_parse(esil, "0x10,a,=,a,2,+,b,="), "parse");
+	mu_assert_eq(rz_reg_getv(analysis->reg, "a"), 0x10, "a");
+	mu_assert_eq(rz_reg_getv(analysis->reg, "b"), 0x12, "b");
+	mu_assert_false(rz_analysis_esil_parse(esil, "-3,b,=,0x1234,al,=,PC,pc,="), "al is gone");
+	rz_analysis_esil_free(esil);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool all_tests() {
+	mu_run_test(test_esil_parse);
+	mu_run_test(test_esil_parse_new_op);
+	mu_run_test(test_esil_parse_regs);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
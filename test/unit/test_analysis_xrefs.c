@@ -21,8 +21,104 @@ bool test_rz_analysis_xrefs_count() {
 	mu_end;
 }
 
+static bool collect_xref_cb(const RzAnalysisXRef *xref, void *user) {
+	rz_vector_push(user, (void *)xref);
+	return true;
+}
+
+bool test_rz_analysis_xrefs_range() {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzVector xrefs;
+	rz_vector_init(&xrefs, sizeof(RzAnalysisXRef), NULL, NULL);
+
+	rz_analysis_xrefs_set(analysis, 0x30, 0x200, RZ_ANALYSIS_XREF_TYPE_CALL);
+	rz_analysis_xrefs_set(analysis, 0x10, 0x100, RZ_ANALYSIS_XREF_TYPE_CODE);
+	rz_analysis_xrefs_set(analysis, 0x20, 0x100, RZ_ANALYSIS_XREF_TYPE_DATA);
+	rz_analysis_xrefs_set(analysis, 0x10, 0x180, RZ_ANALYSIS_XREF_TYPE_STRING);
+	rz_analysis_xrefs_set(analysis, 0x10, 0x100, RZ_ANALYSIS_XREF_TYPE_CALL); // replaces the type
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 4, "xrefs count");
+
+	mu_assert_true(rz_analysis_xrefs_foreach_to(analysis, 0x100, 0x200, collect_xref_cb, &xrefs), "foreach to");
+	mu_assert_eq(rz_vector_len(&xrefs), 3, "xrefs into [0x100, 0x200)");
+	RzAnalysisXRef *xref = rz_vector_index_ptr(&xrefs, 0);
+	mu_assert_eq(xref->from, 0x10, "sorted by to, then from");
+	mu_assert_eq(xref->to, 0x100, "sorted by to, then from");
+	mu_assert_eq(xref->type, RZ_ANALYSIS_XREF_TYPE_CALL, "last set type");
+	xref = rz_vector_index_ptr(&xrefs, 1);
+	mu_assert_eq(xref->from, 0x20, "sorted by to, then from");
+	xref = rz_vector_index_ptr(&xrefs, 2);
+	mu_assert_eq(xref->to, 0x180, "sorted by to, then from");
+	rz_vector_clear(&xrefs);
+
+	mu_assert_true(rz_analysis_xrefs_foreach_from(analysis, 0x10, 0x11, collect_xref_cb, &xrefs), "foreach from");
+	mu_assert_eq(rz_vector_len(&xrefs), 2, "xrefs from [0x10, 0x11)");
+	xref = rz_vector_index_ptr(&xrefs, 1);
+	mu_assert_eq(xref->to, 0x180, "sorted by from, then to");
+	rz_vector_clear(&xrefs);
+
+	rz_analysis_xref_del(analysis, 0x10, 0x100);
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 3, "xrefs count after delete");
+	mu_assert_true(rz_analysis_xrefs_foreach_to(analysis, 0x100, 0x101, collect_xref_cb, &xrefs), "foreach to");
+	mu_assert_eq(rz_vector_len(&xrefs), 1, "xrefs into 0x100 after delete");
+	xref = rz_vector_index_ptr(&xrefs, 0);
+	mu_assert_eq(xref->from, 0x20, "remaining xref");
+	rz_vector_clear(&xrefs);
+
+	RzList *list = rz_analysis_xrefs_list(analysis);
+	mu_assert_eq(rz_list_length(list), 3, "all xrefs");
+	xref = rz_list_first(list);
+	mu_assert_eq(xref->from, 0x10, "sorted by from");
+	xref = rz_list_last(list);
+	mu_assert_eq(xref->from, 0x30, "sorted by from");
+	rz_list_free(list);
+
+	rz_vector_fini(&xrefs);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
+bool test_rz_analysis_xrefs_pending() {
+	RzAnalysis *analysis = rz_analysis_new();
+	RzVector xrefs;
+	rz_vector_init(&xrefs, sizeof(RzAnalysisXRef), NULL, NULL);
+
+	// enough xrefs to have some of them stored and some still pending
+	for (ut64 i = 0; i < 1500; i++) {
+		rz_analysis_xrefs_set(analysis, 0x1000 + i, 0x10, RZ_ANALYSIS_XREF_TYPE_CODE);
+	}
+	rz_analysis_xrefs_set(analysis, 0x1000, 0x10, RZ_ANALYSIS_XREF_TYPE_CALL); // replaces a stored xref
+	rz_analysis_xrefs_set(analysis, 0x800, 0x10, RZ_ANALYSIS_XREF_TYPE_DATA);
+	mu_assert_eq(rz_analysis_xrefs_count(analysis), 1501, "stored and pending xrefs count");
+
+	mu_assert_true(rz_analysis_xrefs_foreach_to(analysis, 0x10, 0x11, collect_xref_cb, &xrefs), "foreach to");
+	mu_assert_eq(rz_vector_len(&xrefs), 1501, "xrefs into 0x10");
+	RzAnalysisXRef *xref = rz_vector_index_ptr(&xrefs, 0);
+	mu_assert_eq(xref->from, 0x800, "pending xref merged in order");
+	xref = rz_vector_index_ptr(&xrefs, 1);
+	mu_assert_eq(xref->from, 0x1000, "sorted by from");
+	mu_assert_eq(xref->type, RZ_ANALYSIS_XREF_TYPE_CALL, "pending type replaces the stored one");
+	bool sorted = true;
+	for (size_t i = 1; i < rz_vector_len(&xrefs); i++) {
+		RzAnalysisXRef *prev = rz_vector_index_ptr(&xrefs, i - 1);
+		xref = rz_vector_index_ptr(&xrefs, i);
+		sorted &= prev->from < xref->from;
+	}
+	mu_assert_true(sorted, "sorted without duplicates");
+	rz_vector_clear(&xrefs);
+
+	RzList *list = rz_analysis_xrefs_get_from(analysis, 0x1000 + 1499);
+	mu_assert_eq(rz_list_length(list), 1, "pending xref from");
+	rz_list_free(list);
+
+	rz_vector_fini(&xrefs);
+	rz_analysis_free(analysis);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_analysis_xrefs_count);
+	mu_run_test(test_rz_analysis_xrefs_range);
+	mu_run_test(test_rz_analysis_xrefs_pending);
 	return tests_passed != tests_run;
 }
 
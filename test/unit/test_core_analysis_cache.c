@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: 2024 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include "minunit.h"
+
+static char *cache_dir_new(void) {
+	char *tmp = rz_file_tmpdir();
+	char *name = rz_str_newf("rz-test-analysis-cache-%d", rz_sys_getpid());
+	char *dir = rz_file_path_join(tmp, name);
+	free(name);
+	free(tmp);
+	return dir;
+}
+
+static void rm_tree(const char *dir) {
+	RzList *files = rz_sys_dir(dir);
+	RzListIter *it;
+	const char *file;
+	rz_list_foreach (files, it, file) {
+		if (!strcmp(file, ".") || !strcmp(file, "..")) {
+			continue;
+		}
+		char *path = rz_file_path_join(dir, file);
+		if (rz_file_is_directory(path)) {
+			rm_tree(path);
+		} else {
+			rz_file_rm(path);
+		}
+		free(path);
+	}
+	rz_list_free(files);
+	rz_file_rm(dir);
+}
+
+static RzCore *core_new_with_file(const char *cache_dir) {
+	RzCore *core = rz_core_new();
+	if (!core) {
+		return NULL;
+	}
+	RzCoreFile *f = rz_core_file_open(core, "hex://554889e5c3c3", RZ_PERM_R, 0);
+	if (!f || !rz_core_bin_load(core, NULL, 0)) {
+		rz_core_free(core);
+		return NULL;
+	}
+	rz_config_set(core->config, "asm.arch", "x86");
+	rz_config_set_i(core->config, "asm.bits", 64);
+	rz_config_set(core->config, "analysis.cache.dir", cache_dir);
+	return core;
+}
+
+bool test_analysis_cache_roundtrip(void) {
+	char *cache_dir = cache_dir_new();
+	RzCore *core = core_new_with_file(cache_dir);
+	mu_assert_notnull(core, "core");
+
+	RzAnalysisFunction *fcn = rz_analysis_create_function(core->analysis, "cached_fcn", 0, RZ_ANALYSIS_FCN_TYPE_FCN);
+	mu_assert_notnull(fcn, "function");
+	RzAnalysisBlock *block = rz_analysis_create_block(core->analysis, 0, 5);
+	rz_analysis_function_add_block(fcn, block);
+	rz_analysis_block_unref(block);
+	rz_analysis_xrefs_set(core->analysis, 4, 5, RZ_ANALYSIS_XREF_TYPE_CODE);
+	rz_flag_set(core->flags, "cached_flag", 1, 1);
+	rz_meta_set_string(core->analysis, RZ_META_TYPE_COMMENT, 2, "cached comment");
+
+	char *dir = rz_core_analysis_cache_path(core);
+	mu_assert_notnull(dir, "cache path");
+	mu_assert_true(rz_core_analysis_cache_save(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "save");
+
+	rz_analysis_purge(core->analysis);
+	rz_flag_unset_all(core->flags);
+	mu_assert_true(rz_list_empty(core->analysis->fcns), "purged");
+
+	mu_assert_true(rz_core_analysis_cache_load(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "load");
+	fcn = rz_analysis_get_function_at(core->analysis, 0);
+	mu_assert_notnull(fcn, "function loaded");
+	mu_assert_streq(fcn->name, "cached_fcn", "function name");
+	mu_assert_eq(rz_pvector_len(fcn->bbs), 1, "function blocks");
+	RzList *xrefs = rz_analysis_xrefs_get_to(core->analysis, 5);
+	mu_assert_eq(rz_list_length(xrefs), 1, "xrefs loaded");
+	rz_list_free(xrefs);
+	RzFlagItem *fi = rz_flag_get(core->flags, "cached_flag");
+	mu_assert_notnull(fi, "flag loaded");
+	mu_assert_eq(fi->offset, 1, "flag offset");
+	mu_assert_streq(rz_meta_get_string(core->analysis, RZ_META_TYPE_COMMENT, 2), "cached comment", "comment loaded");
+
+	// the cache is bound to the analysis level and configuration
+	mu_assert_false(rz_core_analysis_cache_load(core, dir, RZ_CORE_ANALYSIS_DEEP), "other level");
+	rz_config_set_b(core->config, "analysis.cache", true);
+	mu_assert_true(rz_core_analysis_cache_load(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "cache settings are not part of the key");
+	rz_config_set(core->config, "analysis.fcnprefix", "other");
+	mu_assert_false(rz_core_analysis_cache_load(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "stale after a config change");
+	rz_config_set(core->config, "analysis.fcnprefix", "fcn");
+	mu_assert_true(rz_core_analysis_cache_load(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "fresh again");
+	rz_config_set_i(core->config, "esil.stack.depth", 42);
+	mu_assert_false(rz_core_analysis_cache_load(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "stale after an esil change");
+	rz_config_set_i(core->config, "esil.stack.depth", 256);
+	rz_config_set_b(core->config, "emu.str", true);
+	mu_assert_false(rz_core_analysis_cache_load(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "stale after an emu change");
+
+	rz_core_free(core);
+	free(dir);
+	rm_tree(cache_dir);
+	free(cache_dir);
+	mu_end;
+}
+
+bool test_analysis_cache_other_file(void) {
+	char *cache_dir = cache_dir_new();
+	RzCore *core = core_new_with_file(cache_dir);
+	mu_assert_notnull(core, "core");
+	rz_analysis_create_function(core->analysis, "cached_fcn", 0, RZ_ANALYSIS_FCN_TYPE_FCN);
+	char *dir = rz_core_analysis_cache_path(core);
+	mu_assert_notnull(dir, "cache path");
+	mu_assert_true(rz_core_analysis_cache_save(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "save");
+	rz_core_free(core);
+	free(dir);
+
+	core = rz_core_new();
+	rz_core_file_open(core, "hex://9090c3", RZ_PERM_R, 0);
+	rz_core_bin_load(core, NULL, 0);
+	rz_config_set(core->config, "asm.arch", "x86");
+	rz_config_set_i(core->config, "asm.bits", 64);
+	rz_config_set(core->config, "analysis.cache.dir", cache_dir);
+	dir = rz_core_analysis_cache_path(core);
+	mu_assert_notnull(dir, "cache path");
+	mu_assert_false(rz_core_analysis_cache_load(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "different file");
+	mu_assert_true(rz_list_empty(core->analysis->fcns), "nothing loaded");
+	rz_core_free(core);
+	free(dir);
+
+	rm_tree(cache_dir);
+	free(cache_dir);
+	mu_end;
+}
+
+bool test_analysis_cache_corrupted(void) {
+	char *cache_dir = cache_dir_new();
+	RzCore *core = core_new_with_file(cache_dir);
+	mu_assert_notnull(core, "core");
+	rz_analysis_create_function(core->analysis, "cached_fcn", 0, RZ_ANALYSIS_FCN_TYPE_FCN);
+	rz_flag_set(core->flags, "cached_flag", 1, 1);
+	char *dir = rz_core_analysis_cache_path(core);
+	mu_assert_notnull(dir, "cache path");
+	mu_assert_true(rz_core_analysis_cache_save(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "save");
+
+	// cut the records in the middle of the flags
+	char *records = rz_file_path_join(dir, "records");
+	size_t size = 0;
+	char *data = rz_file_slurp(records, &size);
+	mu_assert_notnull(data, "records written");
+	mu_assert_true(rz_file_dump(records, (const ut8 *)data, size - 4, false), "truncate records");
+	free(data);
+	free(records);
+
+	rz_analysis_purge(core->analysis);
+	rz_flag_unset_all(core->flags);
+	rz_analysis_create_function(core->analysis, "current_fcn", 2, RZ_ANALYSIS_FCN_TYPE_FCN);
+	rz_flag_set(core->flags, "current_flag", 3, 1);
+	mu_assert_false(rz_core_analysis_cache_load(core, dir, RZ_CORE_ANALYSIS_SIMPLE), "corrupted");
+
+	// the corruption is found before anything is replaced
+	mu_assert_eq(rz_list_length(core->analysis->fcns), 1, "functions untouched");
+	RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, 2);
+	mu_assert_notnull(fcn, "function untouched");
+	mu_assert_streq(fcn->name, "current_fcn", "function name untouched");
+	mu_assert_notnull(rz_flag_get(core->flags, "current_flag"), "flag untouched");
+	mu_assert_null(rz_flag_get(core->flags, "cached_flag"), "no cached flag");
+
+	rz_core_free(core);
+	free(dir);
+	rm_tree(cache_dir);
+	free(cache_dir);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_analysis_cache_roundtrip);
+	mu_run_test(test_analysis_cache_other_file);
+	mu_run_test(test_analysis_cache_corrupted);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -602,7 +602,140 @@ bool test_cfile_close_manual_cfile_map_multiple(void) {
 	mu_end;
 }
 
+static RzBinInfo *info_cxx(RzBinFile *bf) {
+	RzBinInfo *ret = info(bf);
+	if (ret) {
+		ret->lang = "c++";
+	}
+	return ret;
+}
+
+static RzPVector *symbols_cxx(RzBinFile *bf) {
+	RzPVector *ret = rz_pvector_new((RzPVectorFree)rz_bin_symbol_free);
+	rz_pvector_push(ret, rz_bin_symbol_new("_ZN3Foo3barEv", 0x10, 0x1010));
+	rz_pvector_push(ret, rz_bin_symbol_new("main", 0x20, 0x1020));
+	return ret;
+}
+
+RzBinPlugin mock_cxx_plugin = {
+	.name = "mock_cxx",
+	.desc = "Testing Plugin",
+	.license = "LGPL3",
+	.load_buffer = load_buffer,
+	.check_buffer = check_buffer,
+	.symbols = symbols_cxx,
+	.info = info_cxx,
+};
+
+// the batch demangler calls the plugin from several threads
+static RzThreadLock *demangled_lock = NULL;
+static int demangled_count = 0;
+
+static char *mock_demangle(const char *symbol, RzDemanglerFlag flags) {
+	rz_th_lock_enter(demangled_lock);
+	demangled_count++;
+	rz_th_lock_leave(demangled_lock);
+	return !strcmp(symbol, "_ZN3Foo3barEv") ? strdup("Foo::bar()") : NULL;
+}
+
+RzDemanglerPlugin mock_demangler = {
+	.language = "c++",
+	.author = "rizin",
+	.license = "LGPL3",
+	.demangle = mock_demangle,
+};
+
+/// the symbols are demangled on the first access to them and not at load time
+bool test_lazy_demangle(void) {
+	RzBin *bin = rz_bin_new();
+	rz_bin_plugin_add(bin, &mock_cxx_plugin);
+	rz_demangler_plugin_add(bin->demangler, &mock_demangler);
+	bin->demangle = true;
+	demangled_count = 0;
+
+	RzBuffer *buf = rz_buf_new_with_bytes((const ut8 *)"\x42\x42\x13\x37", 4);
+	RzBinOptions opt;
+	rz_bin_options_init(&opt, 0, 0, 0, false);
+	opt.filename = "<internal>";
+	opt.pluginname = "mock_cxx";
+	RzBinFile *bf = rz_bin_open_buf(bin, buf, &opt);
+	mu_assert_notnull(bf, "binfile");
+	mu_assert_streq(bf->o->plugin->name, "mock_cxx", "binfile with mock plugin");
+	mu_assert_eq(demangled_count, 0, "nothing demangled at load time");
+	mu_assert_true(bf->o->demangle_pending, "demangling is pending");
+	mu_assert_notnull(rz_bin_object_get_info(bf->o), "info");
+	mu_assert_eq(demangled_count, 0, "info does not demangle");
+
+	const RzPVector *symbols = rz_bin_object_get_symbols(bf->o);
+	mu_assert_eq(rz_pvector_len(symbols), 2, "symbols count");
+	mu_assert_eq(demangled_count, 2, "symbols demangled");
+	mu_assert_false(bf->o->demangle_pending, "demangling is done");
+	RzBinSymbol *sym = rz_pvector_at(symbols, 0);
+	mu_assert_streq(sym->dname, "Foo::bar()", "demangled name");
+	sym = rz_pvector_at(symbols, 1);
+	mu_assert_null(sym->dname, "not mangled");
+
+	RzBinClass *klass = rz_bin_object_find_class(bf->o, "Foo");
+	mu_assert_notnull(klass, "class from the demangled symbol");
+	mu_assert_eq(rz_list_length(klass->methods), 1, "methods count");
+	RzBinSymbol *method = rz_list_first(klass->methods);
+	mu_assert_streq(method->name, "bar()", "method name");
+	mu_assert_eq(method->vaddr, 0x1010, "method vaddr");
+
+	rz_bin_object_get_symbols(bf->o);
+	mu_assert_eq(demangled_count, 2, "symbols demangled only once");
+
+	rz_buf_free(buf);
+	rz_bin_free(bin);
+	mu_end;
+}
+
+/// identical names are demangled once, even when the batch is split across threads
+bool test_demangle_batch(void) {
+	RzPVector names;
+	rz_pvector_init(&names, NULL);
+	rz_pvector_push(&names, "_ZN3Foo3barEv");
+	rz_pvector_push(&names, "");
+	rz_pvector_push(&names, "main");
+	rz_pvector_push(&names, "_ZN3Foo3barEv");
+	demangled_count = 0;
+
+	HtSP *table = rz_demangler_plugin_demangle_batch(&mock_demangler, &names, RZ_DEMANGLER_FLAG_BASE, RZ_THREAD_N_CORES_ALL_AVAILABLE);
+	mu_assert_notnull(table, "batch");
+	mu_assert_eq(demangled_count, 2, "distinct names demangled once");
+	mu_assert_eq(table->count, 2, "distinct names");
+	bool found = false;
+	mu_assert_streq(ht_sp_find(table, "_ZN3Foo3barEv", &found), "Foo::bar()", "demangled name");
+	mu_assert_null(ht_sp_find(table, "main", &found), "not mangled");
+	mu_assert_true(found, "failed demangling is kept");
+	ht_sp_find(table, "", &found);
+	mu_assert_false(found, "empty names are skipped");
+	ht_sp_free(table);
+
+	// large enough to be demangled in parallel
+	rz_pvector_clear(&names);
+	char *strs[0x400];
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(strs); i++) {
+		strs[i] = rz_str_newf("_Z%" PFMTSZu, i / 2);
+		rz_pvector_push(&names, strs[i]);
+		rz_pvector_push(&names, "_ZN3Foo3barEv");
+	}
+	table = rz_demangler_plugin_demangle_batch(&mock_demangler, &names, RZ_DEMANGLER_FLAG_BASE, RZ_THREAD_N_CORES_ALL_AVAILABLE);
+	mu_assert_notnull(table, "batch");
+	mu_assert_eq(table->count, RZ_ARRAY_SIZE(strs) / 2 + 1, "distinct names");
+	mu_assert_streq(ht_sp_find(table, "_ZN3Foo3barEv", NULL), "Foo::bar()", "demangled name");
+	mu_assert_null(ht_sp_find(table, "_Z7", &found), "not mangled");
+	mu_assert_true(found, "failed demangling is kept");
+	ht_sp_free(table);
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(strs); i++) {
+		free(strs[i]);
+	}
+	rz_pvector_fini(&names);
+	mu_end;
+}
+
 bool all_tests() {
+	demangled_lock = rz_th_lock_new(false);
 	mu_run_test(test_map);
 	mu_run_test(test_cfile_close);
 	mu_run_test(test_cfile_close_multiple);
@@ -611,6 +744,9 @@ bool all_tests() {
 	mu_run_test(test_cfile_close_manual_vfile_fd);
 	mu_run_test(test_cfile_close_manual_vfile_map);
 	mu_run_test(test_cfile_close_manual_cfile_map_multiple);
+	mu_run_test(test_lazy_demangle);
+	mu_run_test(test_demangle_batch);
+	rz_th_lock_free(demangled_lock);
 	return tests_passed != tests_run;
 }
 
@@ -46,6 +46,64 @@ bool test_rz_diff_distances(void) {
 	mu_end;
 }
 
+/* plain dynamic programming versions, to check the results over multiple 64 bytes blocks */
+static ut32 reference_distance(const ut8 *a, ut32 la, const ut8 *b, ut32 lb, bool substitution) {
+	ut32 *d = malloc((lb + 1) * sizeof(ut32));
+	for (ut32 j = 0; j <= lb; j++) {
+		d[j] = j;
+	}
+	for (ut32 i = 0; i < la; i++) {
+		ut32 diag = d[0];
+		d[0] = i + 1;
+		for (ut32 j = 0; j < lb; j++) {
+			ut32 up = d[j + 1];
+			ut32 best = RZ_MIN(up, d[j]) + 1;
+			if (a[i] == b[j]) {
+				best = RZ_MIN(best, diag);
+			} else if (substitution) {
+				best = RZ_MIN(best, diag + 1);
+			}
+			d[j + 1] = best;
+			diag = up;
+		}
+	}
+	ut32 res = d[lb];
+	free(d);
+	return res;
+}
+
+bool test_rz_diff_distances_long(void) {
+	ut8 a[256], b[256];
+	ut32 distance;
+	ut32 seed = 1;
+	for (ut32 i = 0; i < 50; i++) {
+		ut32 la = 3 + i * 5;
+		ut32 lb = la + (i % 7) - 3;
+		for (ut32 j = 0; j < la; j++) {
+			seed = seed * 1103515245 + 12345;
+			a[j] = (seed >> 16) % (i % 2 ? 4 : 256);
+		}
+		for (ut32 j = 0; j < lb; j++) {
+			seed = seed * 1103515245 + 12345;
+			b[j] = (seed >> 16) % 3 || j >= la ? (seed >> 20) % 4 : a[j];
+		}
+		ut32 expected = reference_distance(a, la, b, lb, true);
+		mu_assert_true(rz_diff_levenshtein_distance(a, la, b, lb, &distance, NULL), "rz_diff_levenshtein_distance");
+		mu_assert_eq(distance, expected, "levenshtein distance");
+		mu_assert_true(rz_diff_levenshtein_distance_max(a, la, b, lb, expected, &distance, NULL), "rz_diff_levenshtein_distance_max");
+		mu_assert_eq(distance, expected, "levenshtein distance within the bound");
+		if (expected) {
+			mu_assert_true(rz_diff_levenshtein_distance_max(a, la, b, lb, expected - 1, &distance, NULL), "rz_diff_levenshtein_distance_max");
+			mu_assert_eq(distance, expected, "levenshtein distance above the bound");
+		}
+
+		expected = reference_distance(a, la, b, lb, false);
+		mu_assert_true(rz_diff_myers_distance(a, la, b, lb, &distance, NULL), "rz_diff_myers_distance");
+		mu_assert_eq(distance, expected, "myers distance");
+	}
+	mu_end;
+}
+
 bool test_rz_diff_unified_lines(void) {
 	RzDiff *diff = NULL;
 	char *result = NULL;
@@ -259,6 +317,7 @@ bool test_rz_diff_unified_bytes(void) {
 
 int all_tests() {
 	mu_run_test(test_rz_diff_distances);
+	mu_run_test(test_rz_diff_distances_long);
 	mu_run_test(test_rz_diff_unified_lines);
 	mu_run_test(test_rz_diff_unified_bytes);
 	return tests_passed != tests_run;
@@ -240,11 +240,114 @@ bool test_message_digest_small_block_stringified() {
 	mu_end;
 }
 
+bool test_message_digest_chunked_update() {
+	const char *algos[] = { "md5", "sha256", "crc32", "fletcher16", "fletcher32", "adler32", "entropy" };
+	char message[256];
+	size_t size = 0x10000;
+	ut8 *buffer = malloc(size);
+	RzHash *rh = rz_hash_new();
+	mu_assert_notnull(buffer, "buffer");
+	for (size_t i = 0; i < size; i++) {
+		buffer[i] = 0xff - (i % 7);
+	}
+
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(algos); ++i) {
+		char *expected = rz_hash_cfg_calculate_small_block_string(rh, algos[i], buffer, size, NULL, false);
+		RzHashCfg *md = rz_hash_cfg_new_with_algo2(rh, algos[i]);
+		snprintf(message, sizeof(message), "rz_hash_cfg_new_with_algo %s digest", algos[i]);
+		mu_assert_notnull(md, message);
+		for (size_t j = 0; j < size; j += 0x1000) {
+			rz_hash_cfg_update(md, buffer + j, 0x1000);
+		}
+		rz_hash_cfg_final(md);
+		char *result = rz_hash_cfg_get_result_string(md, algos[i], NULL, false);
+		snprintf(message, sizeof(message), "%s digest does not depend on the size of the updates", algos[i]);
+		mu_assert_streq(result, expected, message);
+		free(result);
+		free(expected);
+		rz_hash_cfg_free(md);
+	}
+	free(buffer);
+	rz_hash_free(rh);
+
+	mu_end;
+}
+
+static bool hash_tree_read(void *user, ut64 offset, ut8 *buf, ut64 len) {
+	memcpy(buf, (ut8 *)user + offset, len);
+	return true;
+}
+
+bool test_hash_tree() {
+	ut8 data[10000];
+	ut8 leaf[1 + 1024];
+	ut8 node[1 + 32 * 2];
+	RzHashSize size = 0;
+	RzHash *rh = rz_hash_new();
+	for (size_t i = 0; i < sizeof(data); i++) {
+		data[i] = i * 7;
+	}
+
+	// a single chunk is the digest of the prefixed data
+	RzHashTree *tree = rz_hash_tree_new(rh, "sha256", 1000, 1024);
+	mu_assert_notnull(tree, "tree");
+	mu_assert_null(rz_hash_tree_root(tree, NULL), "no root before the first update");
+	mu_assert_true(rz_hash_tree_update_buffer(tree, data), "update");
+	leaf[0] = 0;
+	memcpy(leaf + 1, data, 1000);
+	ut8 *expected = rz_hash_cfg_calculate_small_block(rh, "sha256", leaf, 1 + 1000, &size);
+	mu_assert_memeq(rz_hash_tree_root(tree, NULL), expected, size, "single chunk root");
+	free(expected);
+	rz_hash_tree_free(tree);
+
+	// two chunks are combined by the root
+	tree = rz_hash_tree_new(rh, "sha256", 2000, 1024);
+	mu_assert_true(rz_hash_tree_update(tree, hash_tree_read, data), "update");
+	node[0] = 1;
+	memcpy(leaf + 1, data, 1024);
+	expected = rz_hash_cfg_calculate_small_block(rh, "sha256", leaf, sizeof(leaf), &size);
+	memcpy(node + 1, expected, size);
+	free(expected);
+	memcpy(leaf + 1, data + 1024, 2000 - 1024);
+	expected = rz_hash_cfg_calculate_small_block(rh, "sha256", leaf, 1 + 2000 - 1024, &size);
+	memcpy(node + 1 + size, expected, size);
+	free(expected);
+	expected = rz_hash_cfg_calculate_small_block(rh, "sha256", node, sizeof(node), &size);
+	mu_assert_memeq(rz_hash_tree_root(tree, &size), expected, size, "two chunks root");
+	mu_assert_eq(size, 32, "digest size");
+	free(expected);
+	rz_hash_tree_free(tree);
+
+	// only the modified chunks are hashed again
+	tree = rz_hash_tree_new(rh, "md5", sizeof(data), 512);
+	mu_assert_eq(rz_hash_tree_dirty_chunks(tree), 20, "all the chunks are dirty");
+	mu_assert_true(rz_hash_tree_update_buffer(tree, data), "update");
+	mu_assert_eq(rz_hash_tree_dirty_chunks(tree), 0, "no dirty chunk");
+	data[5000] ^= 0xff;
+	data[9999] ^= 0xff;
+	rz_hash_tree_invalidate(tree, 5000, 1);
+	rz_hash_tree_invalidate(tree, 9999, 100);
+	rz_hash_tree_invalidate(tree, 20000, 100);
+	mu_assert_eq(rz_hash_tree_dirty_chunks(tree), 2, "two dirty chunks");
+	mu_assert_true(rz_hash_tree_update(tree, hash_tree_read, data), "update");
+	RzHashTree *fresh = rz_hash_tree_new(rh, "md5", sizeof(data), 512);
+	mu_assert_true(rz_hash_tree_update_buffer(fresh, data), "update");
+	mu_assert_memeq(rz_hash_tree_root(tree, NULL), rz_hash_tree_root(fresh, NULL), 16, "incremental root");
+	rz_hash_tree_free(fresh);
+	rz_hash_tree_free(tree);
+
+	mu_assert_null(rz_hash_tree_new(rh, "entropy", sizeof(data), 512), "entropy is not a digest");
+	rz_hash_free(rh);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_message_digest_configure);
 	mu_run_test(test_message_digest_api_stringified);
 	mu_run_test(test_message_digest_hmac_stringified);
 	mu_run_test(test_message_digest_small_block_stringified);
+	mu_run_test(test_message_digest_chunked_update);
+	mu_run_test(test_hash_tree);
 	return tests_passed != tests_run;
 }
 
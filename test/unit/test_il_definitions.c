@@ -343,6 +343,94 @@ static bool test_il_value_eq() {
 	mu_end;
 }
 
+static bool test_il_var_set_slots() {
+	RzILVarSet vs;
+	mu_assert_true(rz_il_var_set_init(&vs), "init");
+	mu_assert_eq(rz_il_var_set_resolve(&vs, "x", false), RZ_IL_VAR_SLOT_INVALID, "unknown name");
+	mu_assert_notnull(rz_il_var_set_create_var(&vs, "x", rz_il_sort_pure_bv(8)), "create x");
+	mu_assert_notnull(rz_il_var_set_create_var(&vs, "y", rz_il_sort_pure_bool()), "create y");
+	mu_assert_null(rz_il_var_set_create_var(&vs, "x", rz_il_sort_pure_bv(8)), "create existing");
+	RzILVarSlot x = rz_il_var_set_resolve(&vs, "x", false);
+	RzILVarSlot y = rz_il_var_set_resolve(&vs, "y", false);
+	mu_assert_neq(x, RZ_IL_VAR_SLOT_INVALID, "x slot");
+	mu_assert_neq(x, y, "distinct slots");
+	char name[] = "x";
+	mu_assert_eq(rz_il_var_set_resolve(&vs, name, false), x, "resolve by content");
+
+	mu_assert_true(rz_il_var_set_bind_at(&vs, x, rz_il_value_new_bitv(rz_bv_new_from_ut64(8, 42))), "bind");
+	mu_assert_false(rz_il_var_set_bind_at(&vs, y, rz_il_value_new_bitv(rz_bv_new_from_ut64(8, 42))), "bind mis-sorted");
+	RzILVal *val = rz_il_var_set_get_value(&vs, "x");
+	mu_assert_ptreq(val, rz_il_var_set_get_value_at(&vs, x), "value by name and slot");
+	mu_assert_eq(rz_bv_to_ut64(val->data.bv), 42, "value");
+	mu_assert_streq(rz_il_var_set_get_at(&vs, x)->name, "x", "var at slot");
+
+	// removing and resetting keeps the slots
+	val = rz_il_var_set_remove_var(&vs, "x");
+	mu_assert_notnull(val, "removed value");
+	rz_il_value_free(val);
+	mu_assert_null(rz_il_var_set_get_at(&vs, x), "removed");
+	mu_assert_eq(rz_il_var_set_resolve(&vs, "x", false), x, "slot after remove");
+	rz_il_var_set_reset(&vs);
+	mu_assert_null(rz_il_var_set_get_at(&vs, y), "reset");
+	RzPVector *vars = rz_il_var_set_get_all(&vs);
+	mu_assert_eq(rz_pvector_len(vars), 0, "no vars after reset");
+	rz_pvector_free(vars);
+	mu_assert_eq(rz_il_var_set_resolve(&vs, "y", false), y, "slot after reset");
+	rz_il_var_set_create_var(&vs, "y", rz_il_sort_pure_bool());
+	mu_assert_true(rz_il_var_set_bind(&vs, "y", rz_il_value_new_bool(rz_il_bool_new(true))), "bind by name");
+	mu_assert_true(rz_il_var_set_get_value_at(&vs, y)->data.b->b, "value after reset");
+
+	// no slot to bind to
+	val = rz_il_value_new_bool(rz_il_bool_new(true));
+	mu_assert_false(rz_il_var_set_bind_at(&vs, RZ_IL_VAR_SLOT_INVALID, val), "bind invalid slot");
+	rz_il_value_free(val);
+
+	rz_il_var_set_fini(&vs);
+	mu_end;
+}
+
+static bool test_il_var_set_slot_cache() {
+	RzILVarSet vs, other;
+	mu_assert_true(rz_il_var_set_init(&vs), "init");
+	mu_assert_true(rz_il_var_set_init(&other), "init other");
+	mu_assert_neq(vs.id, other.id, "distinct ids");
+
+	RzILVarSlotCache cache = RZ_IL_VAR_SLOT_CACHE_INIT;
+	mu_assert_eq(rz_il_var_set_resolve_cached(&vs, "x", &cache, false), RZ_IL_VAR_SLOT_INVALID, "unknown name");
+	mu_assert_eq(cache, RZ_IL_VAR_SLOT_CACHE_INIT, "invalid slot not cached");
+	RzILVarSlot x = rz_il_var_set_resolve_cached(&vs, "x", &cache, true);
+	mu_assert_neq(x, RZ_IL_VAR_SLOT_INVALID, "x slot");
+	mu_assert_eq(rz_il_var_set_resolve_cached(&vs, "x", &cache, false), x, "cached slot");
+
+	// another set resolves the name again and takes over the cache
+	rz_il_var_set_resolve(&other, "y", true);
+	RzILVarSlot other_x = rz_il_var_set_resolve_cached(&other, "x", &cache, true);
+	mu_assert_eq(other_x, rz_il_var_set_resolve(&other, "x", false), "slot in other set");
+	mu_assert_neq(other_x, x, "slot differs from the first set");
+	mu_assert_eq(rz_il_var_set_resolve_cached(&vs, "x", &cache, false), x, "back to the first set");
+
+	// generated names are dropped on reset once there are too many of them
+	ut32 id = vs.id;
+	char name[32];
+	for (int i = 0; i < 0x1001; i++) {
+		snprintf(name, sizeof(name), "tmp_%d", i);
+		mu_assert_notnull(rz_il_var_set_create_var(&vs, name, rz_il_sort_pure_bool()), "create generated");
+	}
+	rz_il_var_set_reset(&vs);
+	mu_assert_neq(vs.id, id, "new id after dropping slots");
+	mu_assert_eq(rz_vector_len(&vs.entries), 0, "slots dropped");
+	mu_assert_eq(rz_il_var_set_resolve(&vs, "tmp_0", false), RZ_IL_VAR_SLOT_INVALID, "generated name dropped");
+	RzILVarSlot z = rz_il_var_set_resolve(&vs, "z", true);
+	mu_assert_eq(z, 0, "slots reused");
+	x = rz_il_var_set_resolve_cached(&vs, "x", &cache, true);
+	mu_assert_eq(x, 1, "stale cache not used");
+	mu_assert_eq(rz_il_var_set_resolve_cached(&vs, "x", &cache, false), x, "cached again");
+
+	rz_il_var_set_fini(&other);
+	rz_il_var_set_fini(&vs);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_il_bool_init);
 	mu_run_test(test_il_bool_logic);
@@ -353,6 +441,8 @@ bool all_tests() {
 	mu_run_test(test_il_seqn);
 	mu_run_test(test_il_sort_pure_eq);
 	mu_run_test(test_il_value_eq);
+	mu_run_test(test_il_var_set_slots);
+	mu_run_test(test_il_var_set_slot_cache);
 	return tests_passed != tests_run;
 }
 
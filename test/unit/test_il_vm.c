@@ -1086,6 +1086,152 @@ static bool test_rzil_vm_op_fexcept() {
 	mu_end;
 }
 
+static bool test_rzil_vm_pool() {
+	RzILVM *vm = rz_il_vm_new(0, 16, false);
+	rz_il_vm_create_global_var(vm, "r0", rz_il_sort_pure_bv(32));
+	rz_il_vm_create_global_var(vm, "r1", rz_il_sort_pure_bv(32));
+	rz_il_vm_create_global_var(vm, "f", rz_il_sort_pure_bool());
+	RzILOpEffect *op = rz_il_op_new_seqn(4,
+		rz_il_op_new_set("r0", false, rz_il_op_new_add(rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL), rz_il_op_new_bitv_from_ut64(32, 1))),
+		rz_il_op_new_set("f", false, rz_il_op_new_ule(rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL), rz_il_op_new_bitv_from_ut64(32, 50))),
+		rz_il_op_new_branch(rz_il_op_new_var("f", RZ_IL_VAR_KIND_GLOBAL),
+			rz_il_op_new_set("r1", false,
+				rz_il_op_new_log_xor(rz_il_op_new_var("r1", RZ_IL_VAR_KIND_GLOBAL),
+					rz_il_op_new_shiftl(rz_il_op_new_b0(), rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL), rz_il_op_new_bitv_from_ut64(8, 3)))),
+			NULL),
+		rz_il_op_new_jmp(rz_il_op_new_bitv_from_ut64(16, 0)));
+
+	// the first step fills the pool
+	mu_assert_true(rz_il_vm_step(vm, op, 4), "step");
+	ut64 warmup_allocs = vm->pool.allocs;
+	mu_assert_true(warmup_allocs > 0, "warmup allocs");
+
+	const ut64 steps = 100;
+	for (ut64 i = 0; i < steps; i++) {
+		mu_assert_true(rz_il_vm_step(vm, op, 4), "step");
+	}
+	mu_assert_eq(vm->pool.allocs, warmup_allocs, "no temporaries allocated after the first step");
+	mu_assert_eq(rz_bv_to_ut64(rz_il_vm_get_var_value(vm, RZ_IL_VAR_KIND_GLOBAL, "r0")->data.bv), steps + 1, "r0");
+
+	rz_il_op_effect_free(op);
+	rz_il_vm_free(vm);
+	mu_end;
+}
+
+static RzILVM *compiled_test_vm_new(ut8 *data, size_t size) {
+	RzILVM *vm = rz_il_vm_new(0x100, 16, false);
+	RzBuffer *buf = rz_buf_new_with_pointers(data, size, false);
+	rz_il_vm_add_mem(vm, 0, rz_il_mem_new(buf, 16));
+	rz_buf_free(buf);
+	rz_il_vm_create_global_var(vm, "r0", rz_il_sort_pure_bv(32));
+	rz_il_vm_create_global_var(vm, "r1", rz_il_sort_pure_bv(32));
+	rz_il_vm_create_global_var(vm, "f", rz_il_sort_pure_bool());
+	rz_il_vm_create_global_var(vm, "w", rz_il_sort_pure_bv(128));
+	return vm;
+}
+
+static char *compiled_test_events(RzILVM *vm) {
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	void **it;
+	rz_pvector_foreach (vm->events, it) {
+		rz_il_event_stringify(*it, &sb);
+		rz_strbuf_append(&sb, "\n");
+	}
+	return rz_strbuf_drain_nofree(&sb);
+}
+
+static bool test_rzil_vm_compiled() {
+	RzILOpEffect *op = rz_il_op_new_seqn(11,
+		rz_il_op_new_set("r0", false, rz_il_op_new_add(rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL), rz_il_op_new_bitv_from_ut64(32, 0x10))),
+		rz_il_op_new_set("tmp", true, rz_il_op_new_sdiv(rz_il_op_new_bitv_from_st64(32, -7), rz_il_op_new_bitv_from_ut64(32, 2))),
+		rz_il_op_new_set("r1", false, rz_il_op_new_smod(rz_il_op_new_var("tmp", RZ_IL_VAR_KIND_LOCAL), rz_il_op_new_bitv_from_ut64(32, 2))),
+		rz_il_op_new_set("f", false, rz_il_op_new_sle(rz_il_op_new_var("tmp", RZ_IL_VAR_KIND_LOCAL), rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL))),
+		rz_il_op_new_set("r1", false,
+			rz_il_op_new_let("x", rz_il_op_new_cast(16, rz_il_op_new_b1(), rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL)),
+				rz_il_op_new_append(rz_il_op_new_var("x", RZ_IL_VAR_KIND_LOCAL_PURE),
+					rz_il_op_new_shiftr(rz_il_op_new_msb(rz_il_op_new_var("x", RZ_IL_VAR_KIND_LOCAL_PURE)),
+						rz_il_op_new_var("x", RZ_IL_VAR_KIND_LOCAL_PURE), rz_il_op_new_bitv_from_ut64(8, 3))))),
+		rz_il_op_new_repeat(rz_il_op_new_ule(rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL), rz_il_op_new_bitv_from_ut64(32, 0x40)),
+			rz_il_op_new_set("r0", false, rz_il_op_new_add(rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL), rz_il_op_new_bitv_from_ut64(32, 0x18)))),
+		rz_il_op_new_branch(rz_il_op_new_var("f", RZ_IL_VAR_KIND_GLOBAL),
+			rz_il_op_new_store(0, rz_il_op_new_bitv_from_ut64(16, 1), rz_il_op_new_cast(8, rz_il_op_new_b0(), rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL))),
+			rz_il_op_new_storew(0, rz_il_op_new_bitv_from_ut64(16, 2), rz_il_op_new_bitv_from_ut64(16, 0xbeef))),
+		rz_il_op_new_set("r1", false, rz_il_op_new_div(rz_il_op_new_var("r1", RZ_IL_VAR_KIND_GLOBAL), rz_il_op_new_bitv_from_ut64(32, 0))),
+		// 128 bits wide, evaluated without compilation
+		rz_il_op_new_set("w", false, rz_il_op_new_cast(128, rz_il_op_new_b1(), rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL))),
+		rz_il_op_new_set("r0", false, rz_il_op_new_loadw(0, rz_il_op_new_bitv_from_ut64(16, 1), 32)),
+		rz_il_op_new_jmp(rz_il_op_new_bitv_from_ut64(16, 0x1234)));
+
+	ut8 data_tree[] = { 0x10, 0x11, 0x12, 0x42, 0x14, 0x15 };
+	ut8 data_compiled[] = { 0x10, 0x11, 0x12, 0x42, 0x14, 0x15 };
+	RzILVM *vm_tree = compiled_test_vm_new(data_tree, sizeof(data_tree));
+	RzILVM *vm_compiled = compiled_test_vm_new(data_compiled, sizeof(data_compiled));
+	RzILCompiledEffect *ce = rz_il_compile_effect(vm_compiled, op);
+	mu_assert_notnull(ce, "compile");
+
+	// step twice, so the second step starts from the state left by the first one
+	for (int i = 0; i < 2; i++) {
+		mu_assert_true(rz_il_vm_step(vm_tree, op, 0x200), "tree step");
+		mu_assert_true(rz_il_vm_step_compiled(vm_compiled, ce, 0x200), "compiled step");
+		char *events_tree = compiled_test_events(vm_tree);
+		char *events_compiled = compiled_test_events(vm_compiled);
+		mu_assert_streq(events_compiled, events_tree, "events");
+		free(events_tree);
+		free(events_compiled);
+		mu_assert_memeq(data_compiled, data_tree, sizeof(data_tree), "mem");
+		mu_assert_true(rz_bv_eq(vm_compiled->pc, vm_tree->pc), "pc");
+		const char *vars[] = { "r0", "r1", "f", "w" };
+		for (size_t v = 0; v < RZ_ARRAY_SIZE(vars); v++) {
+			RzILVal *val_tree = rz_il_vm_get_var_value(vm_tree, RZ_IL_VAR_KIND_GLOBAL, vars[v]);
+			RzILVal *val_compiled = rz_il_vm_get_var_value(vm_compiled, RZ_IL_VAR_KIND_GLOBAL, vars[v]);
+			mu_assert_eq(val_compiled->type, val_tree->type, "var type");
+			if (val_tree->type == RZ_IL_TYPE_PURE_BOOL) {
+				mu_assert_eq(val_compiled->data.b->b, val_tree->data.b->b, "var bool");
+			} else {
+				mu_assert_true(rz_bv_eq(val_compiled->data.bv, val_tree->data.bv), "var bv");
+			}
+		}
+	}
+	mu_assert_eq(rz_bv_to_ut64(vm_tree->pc), 0x1234, "jumped");
+
+	rz_il_compiled_effect_free(ce);
+	rz_il_vm_free(vm_tree);
+	rz_il_vm_free(vm_compiled);
+	rz_il_op_effect_free(op);
+	mu_end;
+}
+
+static void *custom_add(RzILVM *vm, RzILOpPure *op, RzILTypePure *type) {
+	*type = RZ_IL_TYPE_PURE_BITVECTOR;
+	return rz_bv_new_from_ut64(32, 0x1337);
+}
+
+static bool test_rzil_vm_compiled_custom_handler() {
+	RzILOpEffect *op = rz_il_op_new_set("r0", false, rz_il_op_new_add(rz_il_op_new_var("r0", RZ_IL_VAR_KIND_GLOBAL), rz_il_op_new_bitv_from_ut64(32, 0x10)));
+	ut8 data[] = { 0 };
+	RzILVM *vm = compiled_test_vm_new(data, sizeof(data));
+	RzILVM *vm_custom = compiled_test_vm_new(data, sizeof(data));
+	RzILCompiledEffect *ce = rz_il_compile_effect(vm, op);
+	mu_assert_notnull(ce, "compile");
+
+	// the handler is replaced after compiling, like in a vm sharing the compiled effect
+	vm_custom->op_handler_pure_table[RZ_IL_OP_ADD] = custom_add;
+	mu_assert_true(rz_il_vm_step_compiled(vm_custom, ce, 0x200), "custom step");
+	RzILVal *val = rz_il_vm_get_var_value(vm_custom, RZ_IL_VAR_KIND_GLOBAL, "r0");
+	mu_assert_eq(rz_bv_to_ut64(val->data.bv), 0x1337, "custom handler");
+
+	mu_assert_true(rz_il_vm_step_compiled(vm, ce, 0x200), "default step");
+	val = rz_il_vm_get_var_value(vm, RZ_IL_VAR_KIND_GLOBAL, "r0");
+	mu_assert_eq(rz_bv_to_ut64(val->data.bv), 0x10, "default handler");
+
+	rz_il_compiled_effect_free(ce);
+	rz_il_vm_free(vm);
+	rz_il_vm_free(vm_custom);
+	rz_il_op_effect_free(op);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rzil_vm_init);
 	mu_run_test(test_rzil_vm_global_vars);
@@ -1115,6 +1261,9 @@ bool all_tests() {
 	mu_run_test(test_rzil_vm_op_float);
 	mu_run_test(test_rzil_vm_op_fcast);
 	mu_run_test(test_rzil_vm_op_fexcept);
+	mu_run_test(test_rzil_vm_pool);
+	mu_run_test(test_rzil_vm_compiled);
+	mu_run_test(test_rzil_vm_compiled_custom_handler);
 	return tests_passed != tests_run;
 }
 
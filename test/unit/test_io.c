@@ -58,6 +58,43 @@ bool test_rz_io_cache(void) {
 	mu_end;
 }
 
+bool test_rz_io_cache_drop(void) {
+	ut8 buf[8];
+	RzIO *io = rz_io_new();
+	rz_io_open(io, "malloc://8", RZ_PERM_RW, 0);
+	rz_io_write(io, (ut8 *)"ZZZZZZZZ", 8);
+	io->cached = RZ_PERM_R;
+	mu_assert_true(rz_io_cache_write(io, 0, (ut8 *)"AAAAAA", 6), "Cache write at 0 failed");
+	mu_assert_true(rz_io_cache_write(io, 4, (ut8 *)"BBBB", 4), "Cache write at 4 failed");
+	mu_assert_true(rz_io_cache_write(io, 2, (ut8 *)"CC", 2), "Cache write at 2 failed");
+	mu_assert_eq(rz_pvector_len(&io->cache), 3, "Cache writes are kept apart");
+	mu_assert_eq(rz_io_cache_invalidate(io, 5, 6), 2, "Invalidate drops the writes covering 5");
+	rz_io_read_at(io, 0, buf, sizeof(buf));
+	mu_assert_memeq(buf, (ut8 *)"ZZCCZZZZ", sizeof(buf), "The other writes stay visible");
+	mu_assert_true(rz_io_cache_write(io, 0, (ut8 *)"DDDD", 4), "Cache write at 0 failed");
+	rz_io_cache_commit(io, 0, 8);
+	mu_assert_true(rz_io_cache_push(io), "Cache push failed");
+	mu_assert_true(rz_io_cache_write(io, 1, (ut8 *)"EEEEEE", 6), "Cache write at 1 failed");
+	rz_io_read_at(io, 0, buf, sizeof(buf));
+	mu_assert_memeq(buf, (ut8 *)"DEEEEEEZ", sizeof(buf), "Cache read after push");
+	mu_assert_true(rz_io_cache_pop(io), "Cache pop failed");
+	rz_io_read_at(io, 0, buf, sizeof(buf));
+	mu_assert_memeq(buf, (ut8 *)"DDDDZZZZ", sizeof(buf), "Cache pop drops the writes done after push");
+	mu_assert_false(rz_io_cache_pop(io), "Cache pop without push");
+	mu_assert_eq(rz_io_cache_invalidate(io, 0, 8), 2, "Invalidate drops the remaining writes");
+	io->cached = 0;
+	rz_io_read_at(io, 0, buf, sizeof(buf));
+	mu_assert_memeq(buf, (ut8 *)"ZZZZZZZZ", sizeof(buf), "Invalidate restores the committed bytes");
+	io->cached = RZ_PERM_R;
+	mu_assert_true(rz_io_cache_push(io), "Cache push failed");
+	mu_assert_true(rz_io_cache_write(io, 0, (ut8 *)"FF", 2), "Cache write at 0 failed");
+	rz_io_cache_reset(io, RZ_PERM_R);
+	mu_assert_eq(io->cache_seq, 0, "Cache reset restarts the seqs");
+	mu_assert_false(rz_io_cache_pop(io), "Cache reset drops the pushed states");
+	rz_io_free(io);
+	mu_end;
+}
+
 bool test_rz_io_mapsplit(void) {
 	RzIO *io = rz_io_new();
 	io->va = true;
@@ -353,6 +390,114 @@ bool test_rz_io_default(void) {
 	mu_end;
 }
 
+bool test_rz_io_borrow(void) {
+	char *filename = rz_file_temp(NULL);
+	int fd = open(filename, O_RDWR | O_CREAT, 0644);
+	rz_xwrite(fd, "1234567890ABCDEF", 0x10);
+	close(fd);
+
+	RzIO *io = rz_io_new();
+	io->va = true;
+	RzIODesc *desc = rz_io_open_at(io, filename, RZ_PERM_R, 0, 0x1000, NULL);
+	mu_assert_notnull(desc, "temp file has been opened");
+	const ut8 *data = rz_io_borrow_at(io, 0x1004, 4);
+	mu_assert_notnull(data, "bytes of a read-only file are borrowed");
+	mu_assert_memeq(data, (ut8 *)"5678", 4, "borrowed bytes");
+	mu_assert_ptreq(rz_io_desc_borrow_at(desc, 4, 4), data, "same bytes through the desc");
+	mu_assert_null(rz_io_borrow_at(io, 0x100c, 8), "range past the end of the map");
+	mu_assert_null(rz_io_borrow_at(io, 0xffc, 8), "range starting before the map");
+
+	io->cached = RZ_PERM_RW;
+	rz_io_write_at(io, 0x1006, (ut8 *)"X", 1);
+	mu_assert_null(rz_io_borrow_at(io, 0x1004, 4), "range overlaid by io.cache");
+	mu_assert_notnull(rz_io_borrow_at(io, 0x1008, 4), "range after the cached write");
+	rz_io_cache_reset(io, 0);
+
+	RzIODesc *desc2 = rz_io_open_at(io, filename, RZ_PERM_RW, 0, 0x2000, NULL);
+	mu_assert_notnull(desc2, "temp file has been opened in RW mode");
+	mu_assert_null(rz_io_borrow_at(io, 0x2004, 4), "writable files are not borrowed");
+	rz_io_free(io);
+
+	rz_file_rm(filename);
+	free(filename);
+	mu_end;
+}
+
+bool test_rz_io_page_cache(void) {
+	ut8 buf[0x20];
+	RzIO *io = rz_io_new();
+	io->va = true;
+	rz_io_page_cache_set_size(io, 2);
+
+	RzIODesc *desc = rz_io_open_at(io, "malloc://0x3000", RZ_PERM_RW, 0, 0x10000, NULL);
+	mu_assert_notnull(desc, "malloc desc opened");
+	// same desc mapped twice shares the cached pages
+	rz_io_map_new(io, desc->fd, RZ_PERM_RW, 0, 0x20000, 0x3000);
+	mu_assert_true(rz_io_write_at(io, 0x10ff8, (ut8 *)"AAAAAAAABBBBBBBB", 0x10), "write across the page boundary");
+
+	mu_assert_true(rz_io_read_at(io, 0x10ff8, buf, 0x10), "read across the page boundary");
+	mu_assert_memeq(buf, (ut8 *)"AAAAAAAABBBBBBBB", 0x10, "cached read");
+	mu_assert_eq(io->page_cache.misses, 2, "two pages read from the desc");
+	mu_assert_eq(io->page_cache.hits, 0, "nothing served from the cache yet");
+	mu_assert_true(rz_io_read_at(io, 0x20ff8, buf, 0x10), "read through the second map");
+	mu_assert_memeq(buf, (ut8 *)"AAAAAAAABBBBBBBB", 0x10, "cached read from the second map");
+	mu_assert_eq(io->page_cache.misses, 2, "no new page read");
+	mu_assert_eq(io->page_cache.hits, 2, "both pages served from the cache");
+
+	mu_assert_true(rz_io_write_at(io, 0x21000, (ut8 *)"CC", 2), "write invalidates the page");
+	mu_assert_true(rz_io_read_at(io, 0x10ff8, buf, 0x10), "read after write");
+	mu_assert_memeq(buf, (ut8 *)"AAAAAAAACCBBBBBB", 0x10, "written data is visible");
+	mu_assert_eq(io->page_cache.misses, 3, "written page read again");
+
+	mu_assert_true(rz_io_read_at(io, 0x12000, buf, 0x10), "read of a third page");
+	mu_assert_eq(io->page_cache.n_pages, 2, "cache size is bounded");
+	mu_assert_true(rz_io_read_at(io, 0x10ff8, buf, 8), "read of the evicted page");
+	mu_assert_eq(io->page_cache.misses, 5, "least recently used page was evicted");
+
+	rz_io_desc_close(desc);
+	mu_assert_eq(io->page_cache.n_pages, 0, "closing the desc drops its pages");
+
+	rz_io_page_cache_set_size(io, 0);
+	mu_assert_null(io->page_cache.descs, "cache disabled");
+	rz_io_free(io);
+	mu_end;
+}
+
+bool test_rz_io_page_cache_backends(void) {
+	ut8 buf[0x10];
+	char *filename = rz_file_temp(NULL);
+	int fd = open(filename, O_RDWR | O_CREAT, 0644);
+	rz_xwrite(fd, "1234567890ABCDEF", 0x10);
+	close(fd);
+
+	RzIO *io = rz_io_new();
+	io->va = true;
+	rz_io_page_cache_set_size(io, 4);
+
+	// regular files only change through RzIO and are cached
+	RzIODesc *file = rz_io_open_at(io, filename, RZ_PERM_R, 0, 0, NULL);
+	mu_assert_notnull(file, "temp file opened");
+	mu_assert_true(rz_io_read_at(io, 0, buf, 0x10), "read the file");
+	mu_assert_memeq(buf, (ut8 *)"1234567890ABCDEF", 0x10, "file content");
+	mu_assert_true(rz_io_read_at(io, 4, buf, 4), "read the file again");
+	mu_assert_eq(io->page_cache.misses, 1, "file page read once");
+	mu_assert_eq(io->page_cache.hits, 1, "file page served from the cache");
+
+	// other backends are read from the plugin every time
+	RzIODesc *null = rz_io_open_at(io, "null://0x100", RZ_PERM_R, 0, 0x10000, NULL);
+	mu_assert_notnull(null, "null desc opened");
+	mu_assert_true(rz_io_read_at(io, 0x10000, buf, 0x10), "read the null desc");
+	mu_assert_true(rz_io_read_at(io, 0x10000, buf, 0x10), "read the null desc again");
+	mu_assert_eq(io->page_cache.misses, 1, "null desc not cached");
+	mu_assert_eq(io->page_cache.hits, 1, "null desc not cached");
+	mu_assert_eq(io->page_cache.n_pages, 1, "only the file page is cached");
+
+	rz_io_free(io);
+	rz_file_rm(filename);
+	free(filename);
+	mu_end;
+}
+
 typedef struct {
 	RzList /*<RzIODesc/RzIOMap>*/ *expect; /// things whose close events are expected now
 	bool failed_unexpected;
@@ -427,6 +572,110 @@ bool test_rz_io_event_desc_close(void) {
 	mu_end;
 }
 
+static void event_io_write_cb(RzEvent *ev, int type, void *user, void *data) {
+	rz_vector_push(user, data);
+}
+
+bool test_rz_io_event_write(void) {
+	RzIO *io = rz_io_new();
+	io->va = true;
+	RzVector events;
+	rz_vector_init(&events, sizeof(RzEventIOWrite), NULL, NULL);
+	RzIODesc *desc = rz_io_open_at(io, "malloc://0x100", RZ_PERM_RW, 0644, 0x1000, NULL);
+	mu_assert_notnull(desc, "opened");
+	rz_event_hook(io->event, RZ_EVENT_IO_WRITE, event_io_write_cb, &events);
+
+	mu_assert_true(rz_io_write_at(io, 0x1010, (ut8 *)"AB", 2), "desc write");
+	mu_assert_eq(rz_vector_len(&events), 1, "desc write event");
+	RzEventIOWrite *iow = rz_vector_index_ptr(&events, 0);
+	mu_assert_eq(iow->fd, desc->fd, "desc write fd");
+	mu_assert_eq(iow->addr, 0x10, "desc write at the desc offset");
+	mu_assert_eq(iow->len, 2, "desc write len");
+	mu_assert_notnull(iow->buf, "desc write bytes");
+	rz_vector_clear(&events);
+
+	io->cached = RZ_PERM_RW;
+	mu_assert_true(rz_io_write_at(io, 0x1020, (ut8 *)"CD", 2), "cache write");
+	mu_assert_eq(rz_vector_len(&events), 1, "cache write event");
+	iow = rz_vector_index_ptr(&events, 0);
+	mu_assert_eq(iow->fd, -1, "cache write fd");
+	mu_assert_eq(iow->addr, 0x1020, "cache write at the address");
+	rz_vector_clear(&events);
+
+	mu_assert_eq(rz_io_cache_invalidate(io, 0x1020, 0x1022), 1, "invalidate");
+	mu_assert_eq(rz_vector_len(&events), 1, "invalidate event");
+	iow = rz_vector_index_ptr(&events, 0);
+	mu_assert_eq(iow->fd, -1, "invalidate fd");
+	mu_assert_eq(iow->addr, 0x1020, "invalidated address");
+	mu_assert_eq(iow->len, 2, "invalidated len");
+	mu_assert_null(iow->buf, "dropped writes have no bytes");
+	rz_vector_clear(&events);
+
+	mu_assert_true(rz_io_write_at(io, 0x1030, (ut8 *)"EF", 2), "cache write");
+	rz_vector_clear(&events);
+	rz_io_cache_reset(io, io->cached);
+	mu_assert_eq(rz_vector_len(&events), 1, "reset event");
+	iow = rz_vector_index_ptr(&events, 0);
+	mu_assert_true(iow->addr <= 0x1030 && iow->addr + iow->len >= 0x1032, "reset covers the dropped write");
+	mu_assert_null(iow->buf, "dropped writes have no bytes");
+	io->cached = 0;
+	rz_vector_clear(&events);
+
+	io->p_cache = 2;
+	mu_assert_eq(rz_io_desc_cache_write(desc, 0x40, (ut8 *)"GH", 2), 2, "desc cache write");
+	mu_assert_eq(rz_vector_len(&events), 1, "desc cache write event");
+	iow = rz_vector_index_ptr(&events, 0);
+	mu_assert_eq(iow->fd, desc->fd, "desc cache write fd");
+	mu_assert_eq(iow->addr, 0x40, "desc cache write at the desc offset");
+	rz_vector_clear(&events);
+	rz_io_desc_cache_fini(desc);
+	mu_assert_eq(rz_vector_len(&events), 1, "desc cache drop event");
+	iow = rz_vector_index_ptr(&events, 0);
+	mu_assert_eq(iow->fd, desc->fd, "desc cache drop fd");
+	mu_assert_true(iow->addr <= 0x40 && iow->addr + iow->len >= 0x42, "desc cache drop covers the write");
+	mu_assert_null(iow->buf, "dropped writes have no bytes");
+
+	rz_vector_fini(&events);
+	rz_io_free(io);
+	mu_end;
+}
+
+static void event_maps_update_cb(RzEvent *ev, int type, void *user, void *data) {
+	RzEventIOMapsUpdate *mev = data;
+	rz_pvector_push(user, mev->map);
+}
+
+bool test_rz_io_event_maps_update(void) {
+	RzIO *io = rz_io_new();
+	io->va = true;
+	RzPVector events;
+	rz_pvector_init(&events, NULL);
+	rz_event_hook(io->event, RZ_EVENT_IO_MAPS_UPDATE, event_maps_update_cb, &events);
+	RzIODesc *desc = rz_io_open_nomap(io, "malloc://0x100", RZ_PERM_R, 0644);
+	mu_assert_notnull(desc, "opened");
+	mu_assert_eq(rz_pvector_len(&events), 0, "no map yet");
+
+	RzIOMap *map0 = rz_io_map_add(io, desc->fd, RZ_PERM_R, 0, 0x1000, 0x100);
+	RzIOMap *map1 = rz_io_map_add(io, desc->fd, RZ_PERM_R, 0x10, 0x1000, 0x100);
+	mu_assert_eq(rz_pvector_len(&events), 2, "map add events");
+	mu_assert_ptreq(rz_pvector_at(&events, 0), map0, "first added map");
+	mu_assert_ptreq(rz_pvector_at(&events, 1), map1, "second added map");
+	rz_pvector_clear(&events);
+
+	mu_assert_true(rz_io_map_priorize(io, map0->id), "priorize");
+	mu_assert_eq(rz_pvector_len(&events), 1, "priorize event");
+	mu_assert_ptreq(rz_pvector_at(&events, 0), map0, "raised map");
+	rz_pvector_clear(&events);
+
+	rz_io_map_remap(io, map1->id, 0x2000);
+	mu_assert_true(rz_pvector_len(&events) > 0, "remap event");
+	mu_assert_null(rz_pvector_tail(&events), "remap may change any address");
+
+	rz_pvector_fini(&events);
+	rz_io_free(io);
+	mu_end;
+}
+
 static void event_map_del_cb(RzEvent *ev, int type, void *user, void *data) {
 	CloseTracker *tracker = user;
 	if (type != RZ_EVENT_IO_MAP_DEL) {
@@ -632,6 +881,7 @@ bool test_rz_io_map_del_on_close_all(void) {
 
 bool all_tests(void) {
 	mu_run_test(test_rz_io_cache);
+	mu_run_test(test_rz_io_cache_drop);
 	mu_run_test(test_rz_io_mapsplit);
 	mu_run_test(test_rz_io_mapsplit2);
 	mu_run_test(test_rz_io_mapsplit3);
@@ -642,7 +892,12 @@ bool all_tests(void) {
 	mu_run_test(test_rz_io_priority2);
 	mu_run_test(test_va_malloc_zero);
 	mu_run_test(test_rz_io_default);
+	mu_run_test(test_rz_io_borrow);
+	mu_run_test(test_rz_io_page_cache);
+	mu_run_test(test_rz_io_page_cache_backends);
 	mu_run_test(test_rz_io_event_desc_close);
+	mu_run_test(test_rz_io_event_write);
+	mu_run_test(test_rz_io_event_maps_update);
 	mu_run_test(test_rz_io_map_del);
 	mu_run_test(test_rz_io_map_del_for_fd);
 	mu_run_test(test_rz_io_map_del_on_close);
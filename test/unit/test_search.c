@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2024 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_search.h>
+#include <ctype.h>
+#include "minunit.h"
+
+static int hit_cb(RzSearchKeyword *kw, void *user, ut64 addr) {
+	RzSearchHit *hit = RZ_NEW0(RzSearchHit);
+	hit->kw = kw;
+	hit->addr = addr;
+	rz_list_append(user, hit);
+	return 1;
+}
+
+static bool naive_match(RzSearchKeyword *kw, const ut8 *buf) {
+	for (ut32 j = 0; j < kw->keyword_length; j++) {
+		ut8 a = buf[j], b = kw->bin_keyword[j];
+		ut8 m = kw->binmask_length ? kw->bin_binmask[j % kw->binmask_length] : 0xff;
+		if (kw->icase) {
+			a = tolower(a);
+			b = tolower(b);
+		}
+		if ((a & m) != (b & m)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_rz_search_keywords(void) {
+	const ut8 buf[] = "xxABCyyabcABCzzDEF\x90\x13-\x90\x37";
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	rz_search_kw_add(s, rz_search_keyword_new_str("ABC", NULL, NULL, false));
+	rz_search_kw_add(s, rz_search_keyword_new_str("def", NULL, NULL, true));
+	rz_search_kw_add(s, rz_search_keyword_new_hex("9000", "ff00", NULL));
+	rz_search_begin(s);
+	RzList *hits = rz_list_newf(free);
+	rz_search_set_callback(s, hit_cb, hits);
+	rz_search_update(s, 0x1000, buf, sizeof(buf) - 1);
+
+	mu_assert_eq(rz_list_length(hits), 5, "number of hits");
+	ut64 expected[] = { 0x1002, 0x100a, 0x100f, 0x1012, 0x1015 };
+	int kws[] = { 0, 0, 1, 2, 2 };
+	int i = 0;
+	RzListIter *it;
+	RzSearchHit *hit;
+	rz_list_foreach (hits, it, hit) {
+		mu_assert_eq(hit->addr, expected[i], "hit address");
+		mu_assert_eq(hit->kw->kwidx, kws[i], "hit keyword");
+		i++;
+	}
+	rz_list_free(hits);
+	rz_search_free(s);
+	mu_end;
+}
+
+bool test_rz_search_single_keyword(void) {
+	const ut8 buf[] = "--aBc--ABC--abx";
+	const char *kws[] = { "abc", "ab?", "b" };
+	const char *bms[] = { NULL, "ffff00", NULL };
+	int icase[] = { true, false, true };
+	ut64 expected[][3] = { { 2, 7, UT64_MAX }, { 12, UT64_MAX }, { 3, 8, 13 } };
+	for (int k = 0; k < RZ_ARRAY_SIZE(kws); k++) {
+		RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+		RzSearchKeyword *kw = rz_search_keyword_new((const ut8 *)kws[k], strlen(kws[k]), NULL, 0, NULL);
+		if (bms[k]) {
+			rz_search_keyword_free(kw);
+			kw = rz_search_keyword_new_hex("616200", bms[k], NULL);
+		}
+		kw->icase = icase[k];
+		rz_search_kw_add(s, kw);
+		rz_search_begin(s);
+		RzList *hits = rz_search_find(s, 0, buf, sizeof(buf) - 1);
+		hits->free = free;
+		int i = 0;
+		RzListIter *it;
+		RzSearchHit *hit;
+		rz_list_foreach (hits, it, hit) {
+			mu_assert_eq(hit->addr, expected[k][i], "hit address");
+			i++;
+		}
+		mu_assert_true(i == 3 || expected[k][i] == UT64_MAX, "number of hits");
+		rz_list_free(hits);
+		rz_search_free(s);
+	}
+	mu_end;
+}
+
+bool test_rz_search_across_blocks(void) {
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	rz_search_kw_add(s, rz_search_keyword_new_str("ABC", NULL, NULL, false));
+	rz_search_kw_add(s, rz_search_keyword_new_str("xA", NULL, NULL, false));
+	rz_search_begin(s);
+	RzList *hits = rz_list_newf(free);
+	rz_search_set_callback(s, hit_cb, hits);
+	rz_search_update(s, 0, (const ut8 *)"xxAB", 4);
+	rz_search_update(s, 4, (const ut8 *)"CxxABC", 6);
+	mu_assert_eq(rz_list_length(hits), 4, "number of hits");
+	RzSearchHit *hit = rz_list_get_n(hits, 0);
+	mu_assert_eq(hit->addr, 1, "xA in the first block");
+	hit = rz_list_get_n(hits, 1);
+	mu_assert_eq(hit->addr, 2, "ABC across the blocks");
+	hit = rz_list_get_n(hits, 2);
+	mu_assert_eq(hit->addr, 7, "ABC in the second block");
+	hit = rz_list_get_n(hits, 3);
+	mu_assert_eq(hit->addr, 6, "xA in the second block");
+	rz_list_free(hits);
+	rz_search_free(s);
+	mu_end;
+}
+
+bool test_rz_search_many_keywords(void) {
+	const char alphabet[] = "aAbB\x00\xff";
+	ut8 buf[0x2000];
+	ut32 seed = 1337;
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+	}
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	for (int k = 0; k < 200; k++) {
+		ut8 kw[8], bm[8];
+		seed = seed * 1103515245 + 12345;
+		int len = 1 + (seed >> 16) % 6;
+		for (int j = 0; j < len; j++) {
+			seed = seed * 1103515245 + 12345;
+			kw[j] = alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+			bm[j] = (seed >> 24) % 5 ? 0xff : 0x0f;
+		}
+		RzSearchKeyword *skw = rz_search_keyword_new(kw, len, bm, k % 3 ? len : 0, NULL);
+		skw->icase = k % 4 == 0;
+		rz_search_kw_add(s, skw);
+	}
+	s->contiguous = true;
+	rz_search_begin(s);
+	RzList *hits = rz_list_newf(free);
+	rz_search_set_callback(s, hit_cb, hits);
+	rz_search_update(s, 0, buf, sizeof(buf));
+
+	// hits are reported keyword after keyword, without overlaps
+	RzListIter *it, *hit_it = rz_list_iterator(hits);
+	RzSearchKeyword *kw;
+	rz_list_foreach (s->kws, it, kw) {
+		for (size_t i = 0; i + kw->keyword_length <= sizeof(buf); i++) {
+			if (!naive_match(kw, buf + i)) {
+				continue;
+			}
+			mu_assert_notnull(hit_it, "missing hit");
+			RzSearchHit *hit = rz_list_iter_get_data(hit_it);
+			mu_assert_ptreq(hit->kw, kw, "hit keyword");
+			mu_assert_eq(hit->addr, i, "hit address");
+			hit_it = rz_list_iter_get_next(hit_it);
+			i += kw->keyword_length - 1;
+		}
+	}
+	mu_assert_null(hit_it, "unexpected hit");
+	rz_list_free(hits);
+	rz_search_free(s);
+	mu_end;
+}
+
+bool test_rz_search_kw_scan(void) {
+	const char alphabet[] = "aAbB\x00\xff";
+	ut8 buf[0x1000];
+	ut32 seed = 42;
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+	}
+	RzSearch *s = rz_search_new(RZ_SEARCH_KEYWORD);
+	rz_search_kw_add(s, rz_search_keyword_new_str("aAb", NULL, NULL, true));
+	rz_search_kw_add(s, rz_search_keyword_new_hex("ff00", NULL, NULL));
+	rz_search_kw_add(s, rz_search_keyword_new_hex("0000", "0f0f", NULL));
+	rz_search_kw_add(s, rz_search_keyword_new_str("BBBBB", NULL, NULL, false));
+	RzList *expected = rz_list_newf(free);
+	RzList *hits = rz_list_newf(free);
+	RzVector matches[4];
+	for (int i = 0; i < RZ_ARRAY_SIZE(matches); i++) {
+		rz_vector_init(&matches[i], sizeof(ut32), NULL, NULL);
+	}
+	for (int overlap = 0; overlap < 2; overlap++) {
+		s->overlap = overlap;
+		rz_search_begin(s);
+		rz_search_set_callback(s, hit_cb, expected);
+		for (int at = 0; at < sizeof(buf); at += 0x33) {
+			rz_search_update(s, 0x1000 + at, buf + at, RZ_MIN(0x33, sizeof(buf) - at));
+		}
+
+		// same blocks, scanned first and reported afterwards
+		rz_search_begin(s);
+		rz_search_set_callback(s, hit_cb, hits);
+		mu_assert_true(rz_search_kw_prepare(s), "keyword search is scannable");
+		for (int at = 0; at < sizeof(buf); at += 0x33) {
+			int len = RZ_MIN(0x33, sizeof(buf) - at);
+			mu_assert_true(rz_search_kw_scan(s, buf + at, len, matches), "scan");
+			rz_search_kw_update_scanned(s, 0x1000 + at, buf + at, len, matches);
+		}
+
+		mu_assert_eq(rz_list_length(hits), rz_list_length(expected), "number of hits");
+		mu_assert_true(rz_list_length(hits) > 10, "enough hits");
+		RzListIter *it, *exp_it = rz_list_iterator(expected);
+		RzSearchHit *hit;
+		rz_list_foreach (hits, it, hit) {
+			RzSearchHit *exp = rz_list_iter_get_data(exp_it);
+			mu_assert_ptreq(hit->kw, exp->kw, "hit keyword");
+			mu_assert_eq(hit->addr, exp->addr, "hit address");
+			exp_it = rz_list_iter_get_next(exp_it);
+		}
+		rz_list_purge(expected);
+		rz_list_purge(hits);
+	}
+	s->inverse = true;
+	mu_assert_false(rz_search_kw_prepare(s), "inverse search is not scannable");
+	for (int i = 0; i < RZ_ARRAY_SIZE(matches); i++) {
+		rz_vector_fini(&matches[i]);
+	}
+	rz_list_free(expected);
+	rz_list_free(hits);
+	rz_search_free(s);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_rz_search_keywords);
+	mu_run_test(test_rz_search_single_keyword);
+	mu_run_test(test_rz_search_across_blocks);
+	mu_run_test(test_rz_search_many_keywords);
+	mu_run_test(test_rz_search_kw_scan);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
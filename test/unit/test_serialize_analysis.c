@@ -73,6 +73,31 @@ Sdb *blocks_ref_db() {
 	return db;
 }
 
+bool test_analysis_switch_op_fields() {
+	size_t count;
+	const RzSerializeField *fields = rz_serialize_analysis_switch_op_fields(&count);
+	mu_assert_eq(rz_serialize_fields_size(fields, count), 4 * sizeof(ut64), "fixed size");
+
+	RzAnalysisSwitchOp *op = rz_analysis_switch_op_new(1337, 42, 45, 46);
+	RzBuffer *b = rz_buf_new_empty(0);
+	mu_assert_true(rz_serialize_fields_write(b, op, fields, count), "write");
+	mu_assert_eq(rz_buf_size(b), 4 * sizeof(ut64), "written size");
+
+	RzAnalysisSwitchOp *sop = rz_analysis_switch_op_new(0, 0, 0, 0);
+	rz_buf_seek(b, 0, RZ_BUF_SET);
+	mu_assert_true(rz_serialize_fields_read(b, sop, fields, count), "read");
+	mu_assert_eq(sop->addr, 1337, "addr");
+	mu_assert_eq(sop->min_val, 42, "min val");
+	mu_assert_eq(sop->max_val, 45, "max val");
+	mu_assert_eq(sop->def_val, 46, "def val");
+	mu_assert_false(rz_serialize_fields_read(b, sop, fields, count), "read past the end");
+
+	rz_analysis_switch_op_free(sop);
+	rz_buf_free(b);
+	rz_analysis_switch_op_free(op);
+	mu_end;
+}
+
 bool test_analysis_block_save() {
 	RzAnalysis *analysis = rz_analysis_new();
 
@@ -1478,6 +1503,7 @@ bool test_analysis_load() {
 int all_tests() {
 	mu_run_test(test_analysis_switch_op_save);
 	mu_run_test(test_analysis_switch_op_load);
+	mu_run_test(test_analysis_switch_op_fields);
 	mu_run_test(test_analysis_block_save);
 	mu_run_test(test_analysis_block_load);
 	mu_run_test(test_analysis_function_save);
@@ -343,6 +343,45 @@ bool test_rz_scan_strings_extended_ascii(void) {
 	mu_end;
 }
 
+bool test_rz_scan_strings_padding(void) {
+	ut8 data[0x400];
+	memset(data, 0, sizeof(data));
+	memset(data + 0x200, 0xff, 0x100);
+	// UTF-32BE right after a zero run, UTF-16LE and ASCII right after 0xff
+	static const ut8 utf32be[] = { 0, 0, 0, 'P', 0, 0, 0, 'a', 0, 0, 0, 'd', 0, 0, 0, 's' };
+	static const ut8 utf16le[] = { 'P', 0, 'a', 0, 'd', 0, 's', 0 };
+	memcpy(data + 0x83, utf32be, sizeof(utf32be));
+	memcpy(data + 0x240, utf16le, sizeof(utf16le));
+	memcpy(data + 0x2ff, "padding", 7);
+
+	RzList *str_list = rz_list_newf((RzListFree)rz_detected_string_free);
+	g_opt.prefer_big_endian = true;
+	int n = rz_scan_strings_raw(data, str_list, &g_opt, 0x1000, 0x1000 + sizeof(data), RZ_STRING_ENC_GUESS);
+	mu_assert_eq(n, 3, "rz_scan_strings padding, number of strings");
+
+	RzDetectedString *s = rz_list_get_n(str_list, 0);
+	mu_assert_streq(s->string, "Pads", "rz_scan_strings padding, utf32be string");
+	mu_assert_eq(s->addr, 0x1083, "rz_scan_strings padding, utf32be address");
+	mu_assert_eq(s->type, RZ_STRING_ENC_UTF32BE, "rz_scan_strings padding, utf32be type");
+	s = rz_list_get_n(str_list, 1);
+	mu_assert_streq(s->string, "Pads", "rz_scan_strings padding, utf16le string");
+	mu_assert_eq(s->addr, 0x1240, "rz_scan_strings padding, utf16le address");
+	mu_assert_eq(s->type, RZ_STRING_ENC_UTF16LE, "rz_scan_strings padding, utf16le type");
+	s = rz_list_get_n(str_list, 2);
+	mu_assert_streq(s->string, "padding", "rz_scan_strings padding, ascii string");
+	mu_assert_eq(s->addr, 0x12ff, "rz_scan_strings padding, ascii address");
+	rz_list_purge(str_list);
+
+	n = rz_scan_strings_raw(data, str_list, &g_opt, 0x1000, 0x1000 + sizeof(data), RZ_STRING_ENC_8BIT);
+	mu_assert_eq(n, 1, "rz_scan_strings padding, number of 8bit strings");
+	s = rz_list_get_n(str_list, 0);
+	mu_assert_eq(s->addr, 0x12ff, "rz_scan_strings padding, 8bit address");
+	mu_assert_streq(s->string, "padding", "rz_scan_strings padding, 8bit string");
+	rz_list_free(str_list);
+
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_scan_strings_detect_ascii);
 	mu_run_test(test_rz_scan_strings_detect_ibm037);
@@ -354,6 +393,7 @@ bool all_tests() {
 	mu_run_test(test_rz_scan_strings_detect_utf32_be);
 	mu_run_test(test_rz_scan_strings_utf16_be);
 	mu_run_test(test_rz_scan_strings_extended_ascii);
+	mu_run_test(test_rz_scan_strings_padding);
 
 	return tests_passed != tests_run;
 }
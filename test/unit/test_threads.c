@@ -239,6 +239,78 @@ bool test_thread_iterator_pvec(void) {
 	mu_end;
 }
 
+typedef struct {
+	RzThreadLock *lock;
+	RzThreadScheduler *sched;
+	RzThreadTaskGroup *group;
+	size_t count;
+	size_t work;
+} thread_task_ctx_t;
+
+static void thread_task_count(thread_task_ctx_t *ctx) {
+	// tasks with uneven costs
+	volatile size_t work = 0;
+	for (size_t i = 0; i < ctx->work; ++i) {
+		work += i;
+	}
+	rz_th_lock_enter(ctx->lock);
+	ctx->count++;
+	ctx->work = (ctx->work * 7 + 13) % 100000;
+	rz_th_lock_leave(ctx->lock);
+}
+
+static void thread_task_spawn(thread_task_ctx_t *ctx) {
+	// nested submission and wait from a task
+	RzThreadTaskGroup *group = rz_th_task_group_new(ctx->sched);
+	for (size_t i = 0; i < 10; ++i) {
+		rz_th_task_group_submit(group, (RzThreadTask)thread_task_count, ctx);
+	}
+	rz_th_task_group_wait(group);
+	rz_th_task_group_free(group);
+}
+
+bool test_thread_scheduler(void) {
+	thread_task_ctx_t ctx = { 0 };
+	ctx.lock = rz_th_lock_new(false);
+
+	RzThreadScheduler *sched = rz_th_scheduler_new(RZ_THREAD_N_CORES_ALL_AVAILABLE);
+	mu_assert_notnull(sched, "rz_th_scheduler_new() null check");
+	mu_assert_eq(rz_th_scheduler_size(sched), rz_th_physical_core_number(), "scheduler size is the core count");
+
+	RzThreadTaskGroup *group = rz_th_task_group_new(sched);
+	mu_assert_notnull(group, "rz_th_task_group_new() null check");
+	mu_assert_true(rz_th_task_group_wait(group), "empty group can be waited");
+	for (size_t i = 0; i < 1000; ++i) {
+		mu_assert_true(rz_th_task_group_submit(group, (RzThreadTask)thread_task_count, &ctx), "task is submitted");
+	}
+	mu_assert_true(rz_th_task_group_wait(group), "group was not cancelled");
+	mu_assert_eq(ctx.count, 1000, "all the tasks did run");
+	rz_th_task_group_free(group);
+
+	ctx.count = 0;
+	ctx.sched = sched;
+	ctx.group = rz_th_task_group_new(sched);
+	for (size_t i = 0; i < 2 * rz_th_scheduler_size(sched); ++i) {
+		rz_th_task_group_submit(ctx.group, (RzThreadTask)thread_task_spawn, &ctx);
+	}
+	mu_assert_true(rz_th_task_group_wait(ctx.group), "nested group was not cancelled");
+	mu_assert_eq(ctx.count, 20 * rz_th_scheduler_size(sched), "all the nested tasks did run");
+	rz_th_task_group_free(ctx.group);
+
+	ctx.count = 0;
+	group = rz_th_task_group_new(sched);
+	rz_th_task_group_cancel(group);
+	mu_assert_true(rz_th_task_group_is_cancelled(group), "group is cancelled");
+	mu_assert_false(rz_th_task_group_submit(group, (RzThreadTask)thread_task_count, &ctx), "cancelled group refuses tasks");
+	mu_assert_false(rz_th_task_group_wait(group), "cancelled group returns false");
+	mu_assert_eq(ctx.count, 0, "no task did run");
+	rz_th_task_group_free(group);
+
+	rz_th_scheduler_free(sched);
+	rz_th_lock_free(ctx.lock);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_thread_limit);
 	mu_run_test(test_thread_pool_cores);
@@ -246,6 +318,7 @@ int all_tests() {
 	mu_run_test(test_thread_ht);
 	mu_run_test(test_thread_iterator_list);
 	mu_run_test(test_thread_iterator_pvec);
+	mu_run_test(test_thread_scheduler);
 	return tests_passed != tests_run;
 }
 